@@ -54,4 +54,13 @@ int Cl_GameReady();
  */
 void Cl_SendHello();
 
+/**
+ * Offers to use the preset deflate dictionary (see Net_DeflateDictionary()) for the
+ * messages sent to and from the server. Servers that do not know about dictionaries
+ * ignore the PCL_DEFLATE_DICTIONARY packet. Messages sent to the server are only
+ * compressed with the dictionary after the server has accepted the offer with
+ * PSV_DEFLATE_DICTIONARY.
+ */
+void Cl_OfferDeflateDictionary();
+
 #endif // DENG_CLIENT_H
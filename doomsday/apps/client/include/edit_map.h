@@ -19,6 +19,7 @@
 #ifndef DENG_WORLD_EDITMAP_H
 #define DENG_WORLD_EDITMAP_H
 
+#include <de/Block>
 #include "world/map.h"
 
 /**
@@ -36,4 +37,31 @@ world::Map *MPE_Map();
  */
 world::Map *MPE_TakeMap();
 
+/**
+ * Begin recording the calls made to the runtime map editing interface into
+ * @a recording (which is cleared first). The recording can be replayed later with
+ * MPE_Replay() to rebuild the same map without the help of a converter plugin.
+ * The recording uses native byte order for property values, so it is only valid
+ * on the machine where it was made.
+ *
+ * @see MPE_EndRecording()
+ */
+void MPE_BeginRecording(de::Block &recording);
+
+/**
+ * Stop recording calls to the runtime map editing interface.
+ *
+ * @return  @c true if every call since MPE_BeginRecording() was recorded and the
+ * recording can be replayed.
+ */
+bool MPE_EndRecording();
+
+/**
+ * Repeat the calls of a recording made with MPE_BeginRecording() on the current
+ * map being built. MPE_Begin() must be called first.
+ *
+ * @return  @c true if the whole recording was replayed.
+ */
+bool MPE_Replay(de::Block const &recording);
+
 #endif  // DENG_WORLD_EDITMAP_H
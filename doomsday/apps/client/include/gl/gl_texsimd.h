@@ -0,0 +1,99 @@
+/** @file gl_texsimd.h  Vectorized texture image kernels.
+ *
+ * @ingroup gl
+ *
+ * SIMD versions of the inner loops of the image manipulation algorithms in
+ * gl_tex.cpp and hq2x.cpp. The instruction set is chosen at runtime (see
+ * Simd_Level()).
+ *
+ * Each kernel processes as much of its input as fits in whole vectors and returns
+ * the number of elements it processed; the caller completes the remainder with
+ * its scalar loop. At the SIMD_SCALAR level the kernels process nothing. All levels
+ * produce bit-identical results.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_GL_TEXSIMD_H
+#define DENG_GL_TEXSIMD_H
+
+#include "dd_types.h"
+#include "misc/simdlevel.h"
+
+/**
+ * Linear interpolation between two rows of 8-bit components:
+ * out = (row1 * (0x10000 - weight) + row2 * weight) >> 16.
+ *
+ * @param weight  Weight of @a row2, in the range [0, 0xffff].
+ *
+ * @return  Number of components processed.
+ */
+int TexSimd_LerpRow(uint8_t *out, uint8_t const *row1, uint8_t const *row2, int count,
+                    int weight);
+
+/**
+ * Averages 2x2 blocks of RGBA pixels from two consecutive rows. @a out may be the
+ * same buffer as @a row1 (written behind the read position).
+ *
+ * @param outCount  Number of output pixels (half the input row width).
+ *
+ * @return  Number of output pixels processed.
+ */
+int TexSimd_DownMipmapRowRGBA(uint8_t *out, uint8_t const *row1, uint8_t const *row2,
+                              int outCount);
+
+/**
+ * Replaces the RGB of each RGBA pixel with the average of its smallest and
+ * largest component. Alpha is not changed.
+ *
+ * @return  Number of pixels processed.
+ */
+long TexSimd_DesaturateRGBA(uint8_t *pixels, long count);
+
+/**
+ * Clears the RGBA pixels whose color is (0,255,255) or (255,0,255).
+ *
+ * @return  Number of pixels processed.
+ */
+long TexSimd_ColorKeyRGBA(uint8_t *pixels, long count);
+
+/**
+ * Adds the sums of the red, green and blue components of RGBA pixels to @a sums.
+ *
+ * @return  Number of pixels processed.
+ */
+long TexSimd_SumRGBA(uint8_t const *pixels, long count, long sums[3]);
+
+/**
+ * Determines the hq2x neighborhood patterns of a row of pixels. The pixels are
+ * represented by comparison keys (see hq2x.cpp) in a padded image that has one
+ * extra key on each side of each row, and one extra row above and below.
+ *
+ * Bit N of a pattern is set if the Nth neighbor (in reading order, skipping the
+ * center) is distinct from the center pixel, i.e., if any byte of the two keys
+ * differs by more than the corresponding byte of @a thresholds.
+ *
+ * @param keys    Key of the upper left neighbor of the first pixel.
+ * @param stride  Number of keys per padded row.
+ *
+ * @return  Number of patterns determined.
+ */
+int TexSimd_Hq2xPatterns(uint8_t *patterns, uint32_t const *keys, int stride, int count,
+                         uint32_t thresholds);
+
+#endif // DENG_GL_TEXSIMD_H
@@ -24,6 +24,7 @@
 #include "api_gl.h"
 #include "gl/gl_defer.h"
 #include <doomsday/res/TextureManifest>
+#include <de/Vector>
 
 /**
  * @defgroup textureContentFlags  Texture Content Flags
@@ -69,23 +70,32 @@ texturecontent_t *GL_ConstructTextureContentCopy(texturecontent_t const *other);
 void GL_DestroyTextureContent(texturecontent_t *content);
 
 /**
- * Prepare the texture content @a c, using the given image in accordance with
- * the supplied specification. The image data will be transformed in-place.
+ * Prepares an image for use as a GL texture in accordance with the supplied
+ * specification. The image data will be transformed in-place.
  *
- * @param c             Texture content to be completed.
- * @param glTexName     GL name for the texture we intend to upload.
- * @param image         Source image containing the pixel data to be prepared.
- * @param spec          Specification describing any transformations which
- *                      should be applied to the image.
+ * @param image        Source image containing the pixel data to be prepared.
+ * @param spec         Specification describing any transformations which
+ *                     should be applied to the image.
+ * @param lumaFactors  Luminance equalization factors of a detail texture are
+ *                     written here (balance, high amp, low amp).
  *
- * @param textureManifest  Manifest for the logical texture being prepared.
- *                      (for informational purposes, i.e., logging)
+ * @return  DGL texture format of the prepared image.
  */
-void GL_PrepareTextureContent(texturecontent_t &c,
-                              GLuint glTexName,
-                              image_t &image,
-                              TextureVariantSpec const &spec,
-                              res::TextureManifest const &textureManifest);
+dgltexformat_t GL_PrepareTextureImage(image_t &image, TextureVariantSpec const &spec,
+                                      de::Vector3f &lumaFactors);
+
+/**
+ * Configures the texture content @a c for uploading an image that has been
+ * prepared with GL_PrepareTextureImage(). The content refers to the pixel data
+ * of the image.
+ */
+void GL_ConfigureTextureContent(texturecontent_t &c,
+                                GLuint glTexName,
+                                image_t const &image,
+                                dgltexformat_t dglFormat,
+                                de::Vector3f const &lumaFactors,
+                                TextureVariantSpec const &spec,
+                                res::TextureManifest const &textureManifest);
 
 /**
  * @param method  GL upload method. By default the upload is deferred.
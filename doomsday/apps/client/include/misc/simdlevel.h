@@ -0,0 +1,60 @@
+/** @file simdlevel.h  Runtime selection of the SIMD instruction set.
+ *
+ * The vectorized kernels (texture images, model vertices, particles) choose the
+ * instruction set at runtime according to what the CPU supports: SSE2 or AVX2 on
+ * x86, NEON on ARM.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef DENG_MISC_SIMDLEVEL_H
+#define DENG_MISC_SIMDLEVEL_H
+
+#include "dd_types.h"
+
+/**
+ * Instruction sets used by the vectorized kernels.
+ */
+typedef enum simdlevel_e {
+    SIMD_SCALAR,    ///< Plain C++ loops only.
+    SIMD_SSE2,
+    SIMD_AVX2,      ///< SSE2 is used for the kernels that have no AVX2 version.
+    SIMD_NEON,
+    SIMDLEVEL_COUNT
+} simdlevel_t;
+
+/**
+ * Returns the instruction set currently used by the kernels. Unless changed with
+ * Simd_SetLevel(), this is the best one supported by the CPU.
+ */
+simdlevel_t Simd_Level(void);
+
+/**
+ * Returns the best instruction set supported by the CPU.
+ */
+simdlevel_t Simd_BestLevel(void);
+
+/**
+ * Changes the instruction set used by the kernels (e.g., for benchmarking).
+ *
+ * @return  @c true, if @a level is supported by the CPU and was applied.
+ */
+dd_bool Simd_SetLevel(simdlevel_t level);
+
+char const *Simd_LevelName(simdlevel_t level);
+
+#endif // DENG_MISC_SIMDLEVEL_H
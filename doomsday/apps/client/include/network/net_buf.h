@@ -37,12 +37,11 @@ extern "C" {
 
 // Incoming messages are stored in netmessage_s structs.
 typedef struct netmessage_s {
-    struct netmessage_s *next;
     nodeid_t        sender;
     uint            player;        // Set in N_GetMessage().
     size_t          size;
     byte           *data;
-    void           *handle;
+    void           *handle;         // Pooled buffer that owns the message.
     double          receivedAt;     // Time when received (seconds).
 } netmessage_t;
 
@@ -127,8 +126,25 @@ void N_PrintBufferInfo(void);
 void N_PrintTransmissionStats(void);
 
 /**
- * Adds the given netmessage_s to the queue of received messages. Uses a mutex to
- * synchronize access to the message queue.
+ * Allocates a new message for posting into the message queue. Message buffers are
+ * recycled from a pool, so this does not usually allocate memory.
+ *
+ * @param size  Size of the message payload in bytes. The payload buffer is available
+ *              in netmessage_t::data.
+ *
+ * @return  New message. It must be posted with N_PostMessage().
+ *
+ * @note This can be called in any thread.
+ */
+netmessage_t *N_NewMessage(size_t size);
+
+/**
+ * Adds the given netmessage_s to the queue of received messages. The queue is
+ * lock-free: any number of threads can post messages while the messages are
+ * being read in the main thread.
+ *
+ * @param msg  Message allocated with N_NewMessage(). The message queue gets
+ *             ownership of the message.
  *
  * @note This is called in the network receiver thread.
  */
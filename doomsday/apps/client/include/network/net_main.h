@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include "dd_share.h"
 #include "net_msg.h"
+#include <de/Block>
 #include <de/Record>
 #include <de/smoother.h>
 
@@ -106,6 +107,8 @@ enum {
     PCL_GOODBYE = 31,
     PSV_MOBJ_TYPE_ID_LIST = 32,
     PSV_MOBJ_STATE_ID_LIST = 33,
+    PCL_DEFLATE_DICTIONARY = 34,    // Offer to use the preset deflate dictionary.
+    PSV_DEFLATE_DICTIONARY = 35,    // Server accepts the preset deflate dictionary.
 
     // Game specific events.
     PKT_GAME_MARKER = DDPT_FIRST_GAME_EVENT, // 64
@@ -193,4 +196,13 @@ dd_bool Net_IsLocalPlayer(int pNum);
 
 de::String Net_UserAgent();
 
+/**
+ * Returns the preset deflate dictionary for network messages. The dictionary is
+ * trained from captured frame packets using the netdict tool. Both the client and
+ * the server must have the same dictionary for it to be used.
+ *
+ * @return Dictionary, or an empty block if one is not available.
+ */
+de::Block Net_DeflateDictionary();
+
 #endif /* LIBDENG_NETWORK_H */
@@ -0,0 +1,86 @@
+/** @file modelsimd.h  Vectorized frame model vertex kernels.
+ *
+ * @ingroup render
+ *
+ * SIMD versions of the per-vertex loops of rend_model.cpp: frame interpolation,
+ * vertex lighting and shiny texture coordinates. The instruction set is chosen at
+ * runtime (see Simd_Level()).
+ *
+ * Each kernel processes as much of its input as fits in whole vectors and returns
+ * the number of vertices it processed; the caller completes the remainder with its
+ * scalar loop. At the SIMD_SCALAR level the kernels process nothing. All levels
+ * produce bit-identical results, unless the compiler fuses the multiply-adds of the
+ * scalar loops (as GCC does by default on ARM).
+ *
+ * Vectors are stored as consecutive floats (x, y, z), i.e., as de::Vector3f.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2007-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_CLIENT_RENDER_MODELSIMD_H
+#define DENG_CLIENT_RENDER_MODELSIMD_H
+
+#include "dd_types.h"
+
+/**
+ * Vector light in model space, as used by ModelSimd_VertexColors().
+ */
+typedef struct modelsimdlight_s {
+    float direction[3];
+    float offset;       ///< Added to the strength (shift a bit towards the light).
+    float lightSide;
+    float darkSide;
+    float color[3];
+    int accum;          ///< Index of the accumulated color: 0 = color, 1 = extra.
+} modelsimdlight_t;
+
+/**
+ * Linear interpolation between two frames: out = to * inter + from * (1 - inter).
+ *
+ * @param from  Vertices of the first frame, each as a position followed by a normal.
+ * @param to    Vertices of the second frame (same layout).
+ *
+ * @return  Number of vertices processed.
+ */
+int ModelSimd_LerpVertices(float *posOut, float *normOut, float const *from,
+                           float const *to, int count, float inter);
+
+/**
+ * Lights vertices with a set of vector lights. Each output color is
+ * min(max(color, ambient) + extra, 1) * 255 in RGBA order, where color and extra
+ * are the sums of the light contributions.
+ *
+ * @param normals  Vertex normals in model space.
+ * @param ambient  Ambient color (RGBA).
+ *
+ * @return  Number of vertices processed.
+ */
+int ModelSimd_VertexColors(uint8_t *out, float const *normals, int count,
+                           modelsimdlight_t const *lights, int numLights,
+                           float const ambient[4]);
+
+/**
+ * Calculates cylindrically mapped, shiny texture coordinates (x + 1, z) of normals
+ * rotated by yaw and pitch (see M_RotateVector()).
+ *
+ * @return  Number of vertices processed.
+ */
+int ModelSimd_ShinyCoords(float *out, float const *normals, int count,
+                          float yawCos, float yawSin, float pitchCos, float pitchSin);
+
+#endif // DENG_CLIENT_RENDER_MODELSIMD_H
@@ -51,6 +51,7 @@
 #include "resource/framemodeldef.h"
 
 class ClientMaterial;
+class PreparedImageBank;
 
 /**
  * Subsystem for managing client-side resources.
@@ -413,6 +414,11 @@ public:
      */
     void purgeCacheQueue();
 
+    /**
+     * Returns the persistent cache of prepared texture images.
+     */
+    PreparedImageBank &preparedImageBank();
+
 public:  /// @todo Should be private:
     void initModels();
     void clearAllRawTextures();
@@ -84,6 +84,19 @@ public:
          */
         uint prepare();
 
+        /**
+         * Prepare several variants for render. The source images are loaded and
+         * analyzed one at a time, but the image content is converted and filtered
+         * concurrently in background threads. The finished content is then
+         * submitted for uploading like in prepare(), meaning the uploads are
+         * deferred while busy. Variants that are already prepared are skipped.
+         * The variants are processed in fixed-size batches so that only a limited
+         * number of images is held in memory at a time.
+         *
+         * @param variants  Variants to prepare.
+         */
+        static void prepareAll(QList<Variant *> const &variants);
+
         /**
          * Release any uploaded GL-texture and clear the associated GL-name
          * for the variant.
@@ -164,8 +164,20 @@ public:
      */
     void prepare(bool forceUpdate = false);
 
+    /**
+     * Prepares all the texture variants needed for drawing the material in any of
+     * its animation stages, and updates the animation state.
+     */
     void cacheAssets();
 
+    /**
+     * Returns the texture variants that are needed for drawing the material in any
+     * of its animation stages. Missing variants are created but not prepared.
+     *
+     * @see cacheAssets(), ClientTexture::Variant::prepareAll()
+     */
+    QList<TextureVariant *> assetTextureVariants() const;
+
     /**
      * Returns @c true if the Material is currently thought to be fully "opaque", i.e., the
      * composited layer stack has no translucent gaps.
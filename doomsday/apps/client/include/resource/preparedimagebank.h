@@ -0,0 +1,106 @@
+/** @file preparedimagebank.h  Persistent cache of prepared texture images.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_RESOURCE_PREPAREDIMAGEBANK_H
+#define DENG_RESOURCE_PREPAREDIMAGEBANK_H
+
+#include <de/Bank>
+#include <de/Block>
+#include <de/Vector>
+
+#include "api_gl.h"
+#include "resource/image.h"
+
+class TextureVariantSpec;
+
+/**
+ * Persistent cache of texture images that have been prepared for uploading to
+ * GL (see GL_PrepareTextureImage()). The prepared images are kept in hot storage,
+ * so filtering that was done in a previous session does not need to be repeated.
+ *
+ * Images are identified by the contents of the source image and the parts of the
+ * variant specification that affect the preparation. Only images whose preparation
+ * involves costly filtering are cached. The hot storage is limited in size; the
+ * least recently used images are removed first when purging.
+ *
+ * @ingroup resource
+ */
+class PreparedImageBank : protected de::Bank
+{
+public:
+    PreparedImageBank();
+
+    /**
+     * Removes the least recently used images if the hot storage is too large.
+     */
+    ~PreparedImageBank();
+
+    /**
+     * Composes the identifier of a prepared image.
+     *
+     * @param source  Source image, before preparation.
+     * @param spec    Specification for preparing the image.
+     *
+     * @return Identifier, or an empty Block if the image should not be cached.
+     */
+    static de::Block composeId(image_t const &source, TextureVariantSpec const &spec);
+
+    /**
+     * Looks up a prepared image. If found, the pixel data of @a image is replaced
+     * with a copy of the prepared pixel data.
+     *
+     * @param id           Identifier from composeId().
+     * @param image        Source image.
+     * @param format       DGL texture format of the prepared image is written here.
+     * @param lumaFactors  Luminance equalization factors are written here.
+     *
+     * @return @c true if the prepared image was found.
+     */
+    bool find(de::Block const &id, image_t &image, dgltexformat_t &format,
+              de::Vector3f &lumaFactors);
+
+    /**
+     * Adds a prepared image to the bank. Nothing is done if @a id is empty.
+     *
+     * @param id           Identifier from composeId().
+     * @param image        Prepared image.
+     * @param format       DGL texture format of the prepared image.
+     * @param lumaFactors  Luminance equalization factors of the prepared image.
+     */
+    void add(de::Block const &id, image_t const &image, dgltexformat_t format,
+             de::Vector3f const &lumaFactors);
+
+    /**
+     * Removes the least recently used images from hot storage until it no longer
+     * exceeds the maximum size.
+     */
+    void purge();
+
+    void clear();
+
+protected:
+    IData *loadFromSource(ISource &source) override;
+
+    IData *newData() override;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+#endif // DENG_RESOURCE_PREPAREDIMAGEBANK_H
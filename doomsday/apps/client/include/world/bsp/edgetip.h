@@ -97,6 +97,10 @@ public:
     inline void setFront(LineSegmentSide *lineSeg) { setSide(Front, lineSeg); }
     inline void setBack (LineSegmentSide *lineSeg) { setSide(Back , lineSeg); }
 
+    bool operator == (EdgeTip const &other) const {
+        return _angle == other._angle && _front == other._front && _back == other._back;
+    }
+
 private:
     /// Angle that line makes at vertex (degrees; 0 is E, 90 is N).
     de::ddouble _angle = 0;
@@ -190,6 +194,29 @@ public:
      */
     void clear() { _tips.clear(); }
 
+    /**
+     * Returns a copy of the set in which the line segment sides of the tips have
+     * been substituted. The angles and the order of the tips are unchanged.
+     *
+     * @param substitute  Returns the substitute for a line segment side.
+     */
+    template <typename SubstituteFunc>
+    EdgeTips copy(SubstituteFunc substitute) const {
+        EdgeTips copied;
+        for(EdgeTip const &tip : _tips)
+        {
+            EdgeTip tipCopy = tip;
+            if(tip.hasFront()) tipCopy.setFront(substitute(&tip.front()));
+            if(tip.hasBack())  tipCopy.setBack (substitute(&tip.back()));
+            copied._tips.push_back(tipCopy);
+        }
+        return copied;
+    }
+
+    bool operator == (EdgeTips const &other) const {
+        return _tips == other._tips;
+    }
+
     /**
      * Clear all tips attributed to the specified line segment @a seg.
      */
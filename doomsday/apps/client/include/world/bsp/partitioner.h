@@ -24,6 +24,7 @@
 #define DENG_WORLD_BSP_PARTITIONER_H
 
 #include <QSet>
+#include <QVector>
 #include <de/Observers>
 #include <de/Vector>
 
@@ -57,6 +58,16 @@ public:
     /// Notified when an unclosed sector is first found.
     DENG2_DEFINE_AUDIENCE(UnclosedSectorFound, void unclosedSectorFound(Sector &sector, de::Vector2d const &nearPoint))
 
+    /**
+     * Partition choices made during a build, in the order the half-spaces were visited.
+     * Each choice identifies the line segment side chosen as the partition (segment
+     * ordinal * 2 + side); a negative value marks a convex subspace (i.e., a leaf).
+     *
+     * Given the same input geometry, replaying the choices reproduces an identical tree
+     * without evaluating the partition candidates again.
+     */
+    typedef QVector<de::dint32> Choices;
+
 public:
     /**
      * Construct a new binary space partitioner.
@@ -72,6 +83,37 @@ public:
      */
     void setSplitCostFactor(de::dint newFactor);
 
+    /**
+     * Provide previously recorded partition choices to be replayed during the next build.
+     * Should a choice prove to be invalid for the geometry (e.g., the choices were recorded
+     * for some other map) the replay is abandoned and the remaining partitions are chosen
+     * by evaluating the candidates, as usual.
+     *
+     * @param choices  Partition choices to replay. Use an empty set to disable replay.
+     */
+    void setReplayChoices(Choices const &choices);
+
+    /**
+     * Returns the partition choices made during the last build.
+     *
+     * @see setReplayChoices()
+     */
+    Choices const &choices() const;
+
+    /**
+     * Returns @c true if all the partition choices of the last build were replayed.
+     */
+    bool choicesWereReplayed() const;
+
+    /**
+     * Enable or disable verification of the concurrent build. When enabled, each build
+     * is first carried out serially using a private copy of the geometry, after which
+     * the partition choices and the new vertexes of the actual build (where subspaces
+     * are partitioned concurrently) are checked to be identical. Any difference is
+     * logged as an error.
+     */
+    void setVerifyParallelBuild(bool enable);
+
     /**
      * Build a new BspTree for the given geometry.
      *
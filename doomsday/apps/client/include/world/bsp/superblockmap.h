@@ -60,6 +60,11 @@ public:
 
     void decRef(LineSegmentSide const &seg);
 
+    /**
+     * Copy the running totals of line segments at/under the @a other block.
+     */
+    void copyRefs(LineSegmentBlock const &other);
+
     /**
      * Pop (unlink) the next line segment from the FIFO list of segments
      * linked to the node.
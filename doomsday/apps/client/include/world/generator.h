@@ -47,6 +47,29 @@ struct ParticleInfo
     de::dushort yaw, pitch;   ///< Rotation angles (0-65536 => 0-360).
 };
 
+/**
+ * State of the particles of a generator as a structure of arrays, so that the
+ * particles can be stepped with vector instructions (see particlesimd.h). Element
+ * @em i of each array belongs to the particle with index @em i. All the arrays are
+ * allocated in one block.
+ */
+struct ParticleStore
+{
+    world::BspLeaf **bspLeaf;  ///< Updated when needed.
+    Line **contact;            ///< Updated when lines hit/avoided.
+    de::dint *stage;           ///< -1 => particle doesn't exist
+    fixed_t *origin[3];        ///< Coordinates.
+    fixed_t *mov[3];           ///< Momentum.
+    fixed_t *gravity;          ///< Gravity factor of the current stage.
+    fixed_t *resistance;       ///< Resistance of the current stage.
+    fixed_t *stepZ;            ///< New Z coordinate, if the particle can move (see stepParticles()).
+    fixed_t *floorLimit;       ///< Lowest Z before touching the floor.
+    fixed_t *ceilLimit;        ///< Highest Z before touching the ceiling.
+    de::dshort *tics;
+    de::dushort *yaw, *pitch;  ///< Rotation angles (0-65536 => 0-360).
+    de::duint8 *touch;         ///< Nonzero if the particle touches a plane in the step.
+};
+
 /**
  * Particle generator.
  */
@@ -149,10 +172,19 @@ public:
     void configureFromDef(ded_ptcgen_t const *def);
 
     /**
-     * Generate and/or move the particles.
+     * Generate particles and advance the particle stages. The particles are moved
+     * afterwards with stepParticles() and moveParticles(). The map does this
+     * for all its generators at once, after the thinkers have been run (see
+     * Map::moveGeneratorParticles()).
      */
     void runTick();
 
+    /**
+     * Returns @c true if runTick() has been called but the particles have not yet
+     * been moved.
+     */
+    bool isMovePending() const;
+
     /**
      * Run the generator's thinker for the given number of @a tics.
      */
@@ -200,9 +232,14 @@ public:
     de::dint activeParticleCount() const;
 
     /**
-     * Provides readonly access to the generator particle info data.
+     * Returns the current state of the particle at @a index.
+     */
+    ParticleInfo particleInfo(de::dint index) const;
+
+    /**
+     * Provides readonly access to the generator particle data.
      */
-    ParticleInfo const *particleInfo() const;
+    ParticleStore const &particles() const;
 
 public: /// @todo make private:
     /**
@@ -217,17 +254,51 @@ public: /// @todo make private:
      */
     de::dint newParticle();
 
+    /**
+     * Applies spin and the forces of the current stage, except gravity and
+     * resistance, to the particle's momentum. Only the particle itself is modified,
+     * so different particles can be accelerated concurrently.
+     *
+     * @param index  Index of the particle.
+     */
+    void accelerateParticle(de::dint index);
+
+    /**
+     * Accelerates the particles in use in the index range [@a first, @a end), and
+     * computes their Z movement and plane contacts for moveParticles(). Ranges of
+     * particles of the same or different generators can be stepped concurrently.
+     *
+     * Gravity, resistance and the Z movement are applied to whole arrays with the
+     * vector kernels (see particlesimd.h).
+     *
+     * @param first    Index of the first particle.
+     * @param end      Index after the last particle.
+     * @param gravity  Gravity of the map.
+     */
+    void stepParticles(de::dint first, de::dint end, fixed_t gravity);
+
+    /**
+     * Moves all the particles in use, after they have been stepped. Collisions
+     * play sounds and use the map's validCount, so generators must be moved one at
+     * a time.
+     */
+    void moveParticles();
+
     /**
      * The movement is done in two steps:
      * Z movement is done first. Skyflat kills the particle.
      * XY movement checks for hits with solid walls (no backsector).
      * This is supposed to be fast and simple (but not too simple).
+     *
+     * The new Z coordinate and whether it touches a plane have been determined
+     * by stepParticles().
      */
     void moveParticle(de::dint index);
 
-    void spinParticle(ParticleInfo &pt);
+    void spinParticle(de::dint index);
 
     de::dfloat particleZ(ParticleInfo const &pt) const;
+    de::dfloat particleZ(de::dint index) const;
 
     de::Vector3f particleOrigin(ParticleInfo const &pt) const;
     de::Vector3f particleMomentum(ParticleInfo const &pt) const;
@@ -245,7 +316,8 @@ private:
     de::dfloat _spawnCount;
     bool _untriggered;       ///< @c true= consider this as not yet triggered.
     de::dint _spawnCP;       ///< Particle spawn cursor.
-    ParticleInfo *_pinfo;    ///< Info about each generated particle.
+    bool _movePending;       ///< Particles have been advanced but not yet moved.
+    ParticleStore _pinfo;    ///< Info about each generated particle.
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Generator::Flags)
@@ -26,6 +26,7 @@
 #include <QHash>
 #include <QList>
 #include <QSet>
+#include <QVector>
 #include <doomsday/BspNode>
 #include <doomsday/world/map.h>
 #include <doomsday/world/ithinkermapping.h>
@@ -75,6 +76,7 @@ namespace world {
 class Blockmap;
 class ConvexSubspace;
 class LineBlockmap;
+class Reject;
 class Subsector;
 class Sky;
 class Thinkers;
@@ -476,6 +478,14 @@ public:  //- Particle generators -----------------------------------------------
 
     void unlink(Generator &generator);
 
+    /**
+     * Accelerates and moves the particles of all the generators that have run their
+     * tick (see Generator::runTick()). To be called after the thinkers have been run.
+     * The particles of all the generators are stepped concurrently, and then moved
+     * one generator at a time.
+     */
+    void moveGeneratorParticles();
+
 #endif  // __CLIENT__
 
 public:  //- Polyobjects ----------------------------------------------------------------
@@ -683,6 +693,19 @@ public:  //- Data structures ---------------------------------------------------
      */
     BspTree const &bspTree() const;
 
+    /**
+     * Provides access to the sector line-of-sight reject LUT. It is empty (rejects
+     * nothing) until one is provided with setReject().
+     */
+    Reject const &reject() const;
+
+    /**
+     * Change the sector line-of-sight reject LUT of the map.
+     *
+     * @param reject  Reject LUT, built for this map (see Reject::build()).
+     */
+    void setReject(Reject const &reject);
+
     /**
      * Determine the BSP leaf on the back side of the BS partition that lies in front of
      * the specified point within the map's coordinate space.
@@ -972,6 +995,24 @@ public:  //- Editing -----------------------------------------------------------
     inline de::dint editablePolyobjCount() const { return editablePolyobjs().count(); }
     inline de::dint editableSectorCount () const { return editableSectors ().count(); }
 
+    /**
+     * Partition choices made when the BSP tree was built. These can be cached and later
+     * provided to an editable map with identical geometry, so that the same BSP can be
+     * rebuilt without evaluating partition candidates.
+     *
+     * @see setBspBuildChoices()
+     */
+    typedef QVector<de::dint32> BspBuildChoices;
+    BspBuildChoices const &bspBuildChoices() const;
+
+    /**
+     * Provide previously recorded partition choices to be replayed when the BSP tree is
+     * built in @ref endEditing().
+     *
+     * @see isEditable()
+     */
+    void setBspBuildChoices(BspBuildChoices const &choices);
+
 //- Multiplayer -------------------------------------------------------------------------
 
     void initMapOutlinePacket(de::shell::MapOutlinePacket &packet);
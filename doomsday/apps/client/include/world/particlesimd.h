@@ -0,0 +1,64 @@
+/** @file particlesimd.h  Vectorized particle stepping kernels.
+ *
+ * @ingroup world
+ *
+ * SIMD versions of the per-particle arithmetic of world::Generator, operating on
+ * the arrays of a ParticleStore. The instruction set is chosen at runtime (see
+ * Simd_Level()).
+ *
+ * Each kernel processes as much of its input as fits in whole vectors and returns
+ * the number of particles it processed; the caller completes the remainder with
+ * its scalar loop. At the SIMD_SCALAR level the kernels process nothing. All levels
+ * produce bit-identical results.
+ *
+ * FixedMul() is emulated as it is compiled with DENG_NO_FIXED_ASM (in double
+ * precision). With the assembler fixed-point routines the kernels process nothing.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef CLIENT_WORLD_PARTICLESIMD_H
+#define CLIENT_WORLD_PARTICLESIMD_H
+
+#include "dd_types.h"
+
+/**
+ * Applies gravity and resistance to the momentum of particles:
+ * movZ -= FixedMul(mapGravity, gravity); mov = FixedMul(mov, resistance).
+ *
+ * @param gravity     Gravity factor of each particle.
+ * @param resistance  Resistance of each particle (FRACUNIT for none).
+ *
+ * @return  Number of particles processed.
+ */
+int ParticleSimd_Accelerate(fixed_t *movX, fixed_t *movY, fixed_t *movZ,
+                            fixed_t const *gravity, fixed_t const *resistance,
+                            int count, fixed_t mapGravity);
+
+/**
+ * Moves particles along the Z axis and tests them against the planes:
+ * z = originZ + movZ. A particle touches a plane if z > ceilLimit or z < floorLimit,
+ * in which case its @a touch flag is set to nonzero (otherwise zero).
+ *
+ * @return  Number of particles processed.
+ */
+int ParticleSimd_StepZ(fixed_t *z, uint8_t *touch, fixed_t const *originZ,
+                       fixed_t const *movZ, fixed_t const *floorLimit,
+                       fixed_t const *ceilLimit, int count);
+
+#endif // CLIENT_WORLD_PARTICLESIMD_H
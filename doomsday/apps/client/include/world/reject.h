@@ -1,4 +1,4 @@
-/** @file reject.h World map sector LOS reject LUT building.
+/** @file reject.h  World map sector LOS reject LUT.
  *
  * @authors Copyright © 2007-2013 Daniel Swanson <danij@dengine.net>
  * @authors Copyright © 2000-2007 Andrew Apted <ajapted@gmail.com>
@@ -23,55 +23,115 @@
 #ifndef DENG_WORLD_REJECT_H
 #define DENG_WORLD_REJECT_H
 
-#if 0 // Needs updating
+#include <de/Block>
+#include <de/ISerializable>
+#include <de/Vector>
+#include <vector>
+
+namespace world {
+
 class Map;
 
 /**
- * The REJECT resource is a LUT that provides the results of trivial
- * line-of-sight tests between sectors. This is done with a matrix of sector
- * pairs i.e. if a monster in sector 4 can see the player in sector 2; the
- * inverse should be true.
- *
- * Note however, some PWADS have carefully constructed REJECT data to create
- * special effects. For example it is possible to make a player completely
- * invissible in certain sectors.
- *
- * The format of the table is a simple matrix of dd_bool values, a (true)
- * value indicates that it is impossible for mobjs in sector A to see mobjs
- * in sector B (and vice-versa). A (false) value indicates that a
- * line-of-sight MIGHT be possible and a more accurate (thus more expensive)
- * calculation will have to be made.
- *
- * The table itself is constructed as follows:
- *
- *     X = sector num player is in
- *     Y = sector num monster is in
- *
- *         X
- *
- *       0 1 2 3 4 ->
- *     0 1 - 1 - -
- *  Y  1 - - 1 - -
- *     2 1 1 - - 1
- *     3 - - - 1 -
- *    \|/
- *
- * These results are read left-to-right, top-to-bottom and are packed into
- * bytes (each byte represents eight results). As are all lumps in WAD the
- * data is in little-endian order.
- *
- * Thus the size of a valid REJECT lump can be calculated as:
- *
- *     ceiling(numSectors^2)
+ * The reject LUT provides the results of trivial line-of-sight tests between
+ * sectors: a set bit for a pair of sectors means that it is impossible for mobjs
+ * in one of the sectors to see mobjs in the other (and vice versa). A clear bit
+ * means that a line-of-sight MIGHT be possible and a more accurate (thus more
+ * expensive) test will have to be made.
  *
- * For now we only do very basic reject processing, limited to determining
- * all isolated sector groups (islands that are surrounded by void space).
+ * Unlike the REJECT lump of the original map format, the LUT is built by the
+ * engine from the map geometry. The results are conservative: sight lines are
+ * blocked only by one-sided lines, as the heights of the sectors may change
+ * during play. Each row of the matrix is padded to a whole number of bytes.
+ * If building the LUT would take too long, the REJECT lump of the map can be
+ * used instead (see fromLump()).
  *
- * @note Algorithm:
- * Initially all sectors are in individual groups. Next, we scan the line
- * list. For each 2-sectored line, merge the two sector groups into one.
+ * An empty Reject rejects nothing.
  */
-byte *BuildRejectForMap(Map const &map);
-#endif
+class Reject : public de::ISerializable
+{
+public:
+    /// Maps with more sectors than this have no reject LUT (because of its size).
+    static de::dint const MAX_SECTORS = 16384;
+
+    /**
+     * Opening between two regions of a map through which lines of sight may pass.
+     * The regions are the sectors, plus the void outside the map, whose index is
+     * the number of sectors. The portal faces the target region: it is on the left
+     * side of the portal when looking from @ref from to @ref to.
+     */
+    struct Portal
+    {
+        de::Vector2d from;
+        de::Vector2d to;
+        de::dint region;    ///< Region on the back side.
+        de::dint target;    ///< Region on the front side.
+        de::dint twin;      ///< Portal in the opposite direction, or -1.
+    };
+    typedef std::vector<Portal> Portals;
+
+public:
+    Reject();
+
+    /**
+     * Builds the reject LUT for a map by tracing the potential lines of sight
+     * through the openings between sectors. The sectors are processed in parallel.
+     *
+     * @param map  Map whose BSP has been built (not editable).
+     *
+     * @return  Reject LUT, or an empty one if the map has too many sectors or the
+     * lines of sight are too complicated to trace in reasonable time.
+     */
+    static Reject build(Map const &map);
+
+    /**
+     * Builds a reject LUT by tracing the potential lines of sight through
+     * @a portals. See build(Map const &).
+     *
+     * @param sectorCount  Number of sectors.
+     * @param portals      Openings between the regions.
+     */
+    static Reject build(de::dint sectorCount, Portals const &portals);
+
+    /**
+     * Reads a reject LUT from the REJECT lump of the original map format. Bits
+     * missing from a truncated lump do not reject anything.
+     *
+     * @param lump         Contents of the REJECT lump.
+     * @param sectorCount  Number of sectors in the map.
+     */
+    static Reject fromLump(de::Block const &lump, de::dint sectorCount);
+
+    bool isEmpty() const;
+
+    /**
+     * Returns the number of sectors in the LUT.
+     */
+    de::dint sectorCount() const;
+
+    /**
+     * Determines whether it is impossible for the sectors @a from and @a to to see
+     * each other. Always returns @c false if the LUT is empty.
+     *
+     * @param from  Index of the first sector.
+     * @param to    Index of the second sector.
+     */
+    inline bool isRejected(de::dint from, de::dint to) const
+    {
+        if (from < 0 || from >= _sectorCount || to < 0 || to >= _sectorCount) return false;
+        return (_matrix.data()[from * _rowSize + (to >> 3)] & (1 << (to & 7))) != 0;
+    }
+
+    // Implements ISerializable.
+    void operator >> (de::Writer &to) const override;
+    void operator << (de::Reader &from) override;
+
+private:
+    de::dint _sectorCount;
+    de::dint _rowSize;      ///< Bytes per row.
+    de::Block _matrix;
+};
+
+}  // namespace world
 
-#endif // DENG_WORLD_REJECT_H
+#endif  // DENG_WORLD_REJECT_H
@@ -40,6 +40,7 @@
 #include "world/linesighttest.h"
 #include "world/maputil.h"
 #include "world/p_players.h"
+#include "world/reject.h"
 #include "world/clientserverworld.h"
 #include "BspLeaf"
 #include "ConvexSubspace"
@@ -1636,14 +1637,43 @@ DENG_EXTERN_C int P_PathTraverse(const_pvec2d_t from, const_pvec2d_t to,
                 .trace(App_World().map());
 }
 
+/**
+ * Returns the sector whose geometry contains @a point, if any.
+ */
+static Sector const *sectorContaining(Map const &map, Vector2d const &point)
+{
+    BspLeaf const &bspLeaf = map.bspLeafAt(point);
+    if(bspLeaf.hasSubspace() && bspLeaf.subspace().hasSubsector() &&
+       bspLeaf.subspace().contains(point))
+    {
+        return &bspLeaf.subspace().sector();
+    }
+    return nullptr;
+}
+
 #undef P_CheckLineSight
 DENG_EXTERN_C dd_bool P_CheckLineSight(const_pvec3d_t from, const_pvec3d_t to, coord_t bottomSlope,
     coord_t topSlope, int flags)
 {
     if(!App_World().hasMap()) return false;  // Continue iteration.
 
+    Map const &map = App_World().map();
+
+    // Sectors that cannot possibly see each other need no trace. The reject LUT
+    // does not apply to rays that may pass one-sided lines.
+    if(!map.reject().isEmpty() && !(flags & (LS_PASSLEFT | LS_PASSOVER | LS_PASSUNDER)))
+    {
+        Sector const *fromSector = sectorContaining(map, Vector2d(from[0], from[1]));
+        Sector const *toSector   = sectorContaining(map, Vector2d(to[0], to[1]));
+        if(fromSector && toSector &&
+           map.reject().isRejected(fromSector->indexInMap(), toSector->indexInMap()))
+        {
+            return false;
+        }
+    }
+
     return LineSightTest(from, to, bottomSlope, topSlope, flags)
-                .trace(App_World().map().bspTree());
+                .trace(map.bspTree());
 }
 
 #undef Interceptor_Origin
@@ -35,7 +35,9 @@
 #include <doomsday/EntityDatabase>
 #include <de/Error>
 #include <de/Log>
+#include <de/Reader>
 #include <de/StringPool>
+#include <de/Writer>
 
 using namespace de;
 using namespace world;
@@ -164,6 +166,88 @@ static inline Material *findMaterialInDict(const char *materialUriStr)
     return findMaterialInDict(String(materialUriStr));
 }
 
+/**
+ * Calls made to the runtime map editing interface can be recorded, so that the same
+ * map can later be rebuilt without the help of a map converter plugin.
+ *
+ * @see MPE_BeginRecording(), MPE_Replay()
+ */
+enum RecordedCall
+{
+    RecVertexCreate = 1,
+    RecLineCreate,
+    RecLineAddSide,
+    RecSectorCreate,
+    RecPlaneCreate,
+    RecPolyobjCreate,
+    RecGameObjProperty
+};
+
+static Writer *recorder;
+static bool recordingFailed;
+
+/**
+ * Returns the size of a value of @a type in bytes, or zero if values of the type
+ * cannot be recorded.
+ */
+static dsize recordableValueSize(valuetype_t type)
+{
+    switch(type)
+    {
+    case DDVT_BYTE:   return sizeof(byte);
+    case DDVT_SHORT:  return sizeof(short);
+    case DDVT_INT:    return sizeof(int);
+    case DDVT_FIXED:  return sizeof(fixed_t);
+    case DDVT_ANGLE:  return sizeof(angle_t);
+    case DDVT_FLOAT:  return sizeof(float);
+    case DDVT_DOUBLE: return sizeof(double);
+    default:          return 0;
+    }
+}
+
+static void recordCString(char const *text)
+{
+    *recorder << duint8(text? 1 : 0);
+    if(text) *recorder << Block(text);
+}
+
+static void recordSideSection(de_api_side_section_s const &section)
+{
+    recordCString(section.material);
+    *recorder << section.offset[0] << section.offset[1];
+    for(int i = 0; i < 4; ++i) *recorder << section.color[i];
+}
+
+static bool readCString(Reader &from, Block &text)
+{
+    duint8 present;
+    from >> present;
+    if(present) from >> text;
+    return present != 0;
+}
+
+static void readSideSection(Reader &from, Block &material, de_api_side_section_s &section)
+{
+    section.material = readCString(from, material)? material.constData() : nullptr;
+    from >> section.offset[0] >> section.offset[1];
+    for(int i = 0; i < 4; ++i) from >> section.color[i];
+}
+
+void MPE_BeginRecording(Block &recording)
+{
+    delete recorder;
+    recording.clear();
+    recorder = new Writer(recording);
+    recordingFailed = false;
+}
+
+bool MPE_EndRecording()
+{
+    bool const ok = recorder && !recordingFailed;
+    delete recorder; recorder = nullptr;
+    return ok;
+}
+
 Map *MPE_Map()
 {
     return editMapInited? editMap : 0;
@@ -212,6 +296,11 @@ dd_bool MPE_End()
 int MPE_VertexCreate(coord_t x, coord_t y, int archiveIndex)
 {
     ERROR_IF_NOT_INITIALIZED();
+
+    if(recorder)
+    {
+        *recorder << duint8(RecVertexCreate) << ddouble(x) << ddouble(y) << dint32(archiveIndex);
+    }
     return editMap->createVertex(Vector2d(x, y), archiveIndex)->indexInMap();
 }
 
@@ -226,6 +315,12 @@ dd_bool MPE_VertexCreatev(int num, coord_t const *values, int *archiveIndices, i
     // Create many vertexes.
     for(int n = 0; n < num; ++n)
     {
+        if(recorder)
+        {
+            *recorder << duint8(RecVertexCreate) << ddouble(values[n * 2]) << ddouble(values[n * 2 + 1])
+                      << dint32(archiveIndices[n]);
+        }
+
         Vertex *vertex = editMap->createVertex(Vector2d(values[n * 2], values[n * 2 + 1]),
                                                archiveIndices[n]);
         if(retIndices)
@@ -243,6 +338,13 @@ int MPE_LineCreate(int v1, int v2, int frontSectorIdx, int backSectorIdx, int fl
 {
     ERROR_IF_NOT_INITIALIZED();
 
+    if(recorder)
+    {
+        *recorder << duint8(RecLineCreate) << dint32(v1) << dint32(v2)
+                  << dint32(frontSectorIdx) << dint32(backSectorIdx) << dint32(flags)
+                  << dint32(archiveIndex);
+    }
+
     if(frontSectorIdx >= editMap->editableSectorCount()) return -1;
     if(backSectorIdx  >= editMap->editableSectorCount()) return -1;
     if(v1 < 0 || v1 >= editMap->vertexCount()) return -1;
@@ -271,6 +373,15 @@ void MPE_LineAddSide(int lineIdx, int sideId, short flags,
 {
     ERROR_IF_NOT_INITIALIZED();
 
+    if(recorder)
+    {
+        *recorder << duint8(RecLineAddSide) << dint32(lineIdx) << dint32(sideId) << dint16(flags);
+        recordSideSection(*top);
+        recordSideSection(*middle);
+        recordSideSection(*bottom);
+        *recorder << dint32(archiveIndex);
+    }
+
     if(lineIdx < 0 || lineIdx >= editMap->editableLineCount()) return;
 
     Line *line = editMap->editableLines().at(lineIdx);
@@ -307,6 +418,14 @@ int MPE_PlaneCreate(int sectorIdx, coord_t height, const char *materialUri,
 {
     ERROR_IF_NOT_INITIALIZED();
 
+    if(recorder)
+    {
+        *recorder << duint8(RecPlaneCreate) << dint32(sectorIdx) << ddouble(height);
+        recordCString(materialUri);
+        *recorder << matOffsetX << matOffsetY << tintRed << tintGreen << tintBlue << opacity
+                  << normalX << normalY << normalZ << dint32(archiveIndex);
+    }
+
     if(sectorIdx < 0 || sectorIdx >= editMap->editableSectorCount()) return -1;
 
     Sector *sector = editMap->editableSectors().at(sectorIdx);
@@ -333,6 +452,24 @@ int MPE_SectorCreate(float lightlevel, float red, float green, float blue,
                      int archiveIndex)
 {
     ERROR_IF_NOT_INITIALIZED();
+
+    if(recorder)
+    {
+        *recorder << duint8(RecSectorCreate) << lightlevel << red << green << blue
+                  << duint8(hacks? 1 : 0);
+        if(hacks)
+        {
+            *recorder << duint8((hacks->flags.linkFloorPlane?       0x01 : 0)
+                              | (hacks->flags.linkCeilingPlane?     0x02 : 0)
+                              | (hacks->flags.missingInsideTop?     0x04 : 0)
+                              | (hacks->flags.missingInsideBottom?  0x08 : 0)
+                              | (hacks->flags.missingOutsideTop?    0x10 : 0)
+                              | (hacks->flags.missingOutsideBottom? 0x20 : 0))
+                      << dint32(hacks->visPlaneLinkTargetSector);
+        }
+        *recorder << dint32(archiveIndex);
+    }
+
     return editMap
         ->createSector(lightlevel,
                        {red, green, blue},
@@ -349,6 +486,14 @@ int MPE_PolyobjCreate(int const *lines, int lineCount, int tag, int sequenceType
 
     ERROR_IF_NOT_INITIALIZED();
 
+    if(recorder)
+    {
+        *recorder << duint8(RecPolyobjCreate) << dint32(lines? lineCount : 0);
+        for(int i = 0; lines && i < lineCount; ++i) *recorder << dint32(lines[i]);
+        *recorder << dint32(tag) << dint32(sequenceType) << ddouble(originX) << ddouble(originY)
+                  << dint32(archiveIndex);
+    }
+
     if(lineCount <= 0 || !lines) return -1;
 
     // First check that all the line indices are valid and that they arn't
@@ -388,6 +533,20 @@ dd_bool MPE_GameObjProperty(char const *entityName, int elementIndex,
     if(!entityName || !propertyName || !valueAdr)
         return false; // Hmm...
 
+    if(recorder)
+    {
+        if(dsize const size = recordableValueSize(valueType))
+        {
+            *recorder << duint8(RecGameObjProperty) << Block(entityName) << dint32(elementIndex)
+                      << Block(propertyName) << dint32(valueType) << Block(valueAdr, size);
+        }
+        else
+        {
+            // The map cannot be rebuilt from this recording.
+            recordingFailed = true;
+        }
+    }
+
     // Is this a known entity?
     MapEntityDef *entityDef = P_MapEntityDefByName(entityName);
     if(!entityDef)
@@ -418,6 +577,122 @@ dd_bool MPE_GameObjProperty(char const *entityName, int elementIndex,
     return false;
 }
 
+bool MPE_Replay(Block const &recording)
+{
+    LOG_AS("MPE_Replay");
+
+    ERROR_IF_NOT_INITIALIZED();
+    DENG2_ASSERT(!recorder);
+
+    try
+    {
+        Reader from(recording);
+        while(!from.atEnd())
+        {
+            duint8 call;
+            from >> call;
+            switch(call)
+            {
+            case RecVertexCreate: {
+                ddouble x, y;
+                dint32 archiveIndex;
+                from >> x >> y >> archiveIndex;
+                MPE_VertexCreate(x, y, archiveIndex);
+                break; }
+
+            case RecLineCreate: {
+                dint32 v1, v2, frontSector, backSector, flags, archiveIndex;
+                from >> v1 >> v2 >> frontSector >> backSector >> flags >> archiveIndex;
+                MPE_LineCreate(v1, v2, frontSector, backSector, flags, archiveIndex);
+                break; }
+
+            case RecLineAddSide: {
+                dint32 lineIdx, sideId, archiveIndex;
+                dint16 flags;
+                Block materials[3];
+                de_api_side_section_s sections[3];
+                from >> lineIdx >> sideId >> flags;
+                for(int i = 0; i < 3; ++i) readSideSection(from, materials[i], sections[i]);
+                from >> archiveIndex;
+                MPE_LineAddSide(lineIdx, sideId, flags, &sections[0], &sections[1], &sections[2],
+                                archiveIndex);
+                break; }
+
+            case RecSectorCreate: {
+                dfloat lightLevel, red, green, blue;
+                duint8 haveHacks;
+                de_api_sector_hacks_s hacks;
+                zap(hacks);
+                dint32 archiveIndex;
+                from >> lightLevel >> red >> green >> blue >> haveHacks;
+                if(haveHacks)
+                {
+                    duint8 flags;
+                    dint32 linkTarget;
+                    from >> flags >> linkTarget;
+                    hacks.flags.linkFloorPlane       = (flags & 0x01) != 0;
+                    hacks.flags.linkCeilingPlane     = (flags & 0x02) != 0;
+                    hacks.flags.missingInsideTop     = (flags & 0x04) != 0;
+                    hacks.flags.missingInsideBottom  = (flags & 0x08) != 0;
+                    hacks.flags.missingOutsideTop    = (flags & 0x10) != 0;
+                    hacks.flags.missingOutsideBottom = (flags & 0x20) != 0;
+                    hacks.visPlaneLinkTargetSector   = linkTarget;
+                }
+                from >> archiveIndex;
+                MPE_SectorCreate(lightLevel, red, green, blue, haveHacks? &hacks : nullptr,
+                                 archiveIndex);
+                break; }
+
+            case RecPlaneCreate: {
+                dint32 sectorIdx, archiveIndex;
+                ddouble height;
+                Block material;
+                dfloat offsetX, offsetY, red, green, blue, opacity, normalX, normalY, normalZ;
+                from >> sectorIdx >> height;
+                bool const haveMaterial = readCString(from, material);
+                from >> offsetX >> offsetY >> red >> green >> blue >> opacity
+                     >> normalX >> normalY >> normalZ >> archiveIndex;
+                MPE_PlaneCreate(sectorIdx, height, haveMaterial? material.constData() : nullptr,
+                                offsetX, offsetY, red, green, blue, opacity,
+                                normalX, normalY, normalZ, archiveIndex);
+                break; }
+
+            case RecPolyobjCreate: {
+                dint32 lineCount, tag, sequenceType, archiveIndex;
+                ddouble originX, originY;
+                from >> lineCount;
+                QVector<int> lines(de::max(0, lineCount));
+                for(int &line : lines) { dint32 idx; from >> idx; line = idx; }
+                from >> tag >> sequenceType >> originX >> originY >> archiveIndex;
+                MPE_PolyobjCreate(lines.isEmpty()? nullptr : lines.constData(), lineCount,
+                                  tag, sequenceType, originX, originY, archiveIndex);
+                break; }
+
+            case RecGameObjProperty: {
+                Block entityName, propertyName, value;
+                dint32 elementIndex, valueType;
+                from >> entityName >> elementIndex >> propertyName >> valueType >> value;
+                if(value.size() != recordableValueSize(valuetype_t(valueType)))
+                {
+                    throw Error("MPE_Replay", "Invalid property value");
+                }
+                MPE_GameObjProperty(entityName.constData(), elementIndex, propertyName.constData(),
+                                    valuetype_t(valueType), value.data());
+                break; }
+
+            default:
+                throw Error("MPE_Replay", String("Unknown recorded call %1").arg(call));
+            }
+        }
+        return true;
+    }
+    catch(Error const &er)
+    {
+        LOG_MAP_WARNING("Failed to replay the recorded map: %s") << er.asText();
+    }
+    return false;
+}
+
 DENG_DECLARE_API(MPE) =
 {
     { DE_API_MAP_EDIT },
@@ -30,6 +30,8 @@
 #include "network/net_main.h"
 #include "network/net_buf.h"
 #include "network/net_demo.h"
+#include "network/serverlink.h"
+#include "network/sys_network.h"
 
 #include "world/map.h"
 #include "world/p_players.h"
@@ -138,6 +140,42 @@ void Cl_SendHello()
     Net_SendBuffer(0, 0);
 }
 
+void Cl_OfferDeflateDictionary()
+{
+    Block const dictionary = Net_DeflateDictionary();
+    if (dictionary.isEmpty()) return;
+
+    LOG_AS("Cl_OfferDeflateDictionary");
+
+    // The server may compress its messages with the dictionary as soon as it has
+    // accepted the offer.
+    Net_ServerLink().setInflateDictionary(dictionary);
+
+    Block const hash = dictionary.md5Hash();
+    Msg_Begin(PCL_DEFLATE_DICTIONARY);
+    Writer_Write(msgWriter, hash.data(), hash.size());
+    Msg_End();
+
+    Net_SendBuffer(0, 0);
+}
+
+/**
+ * The server has accepted to use the preset deflate dictionary.
+ */
+static void Cl_HandleDeflateDictionaryAccepted()
+{
+    Block const dictionary = Net_DeflateDictionary();
+
+    Block hash(16);
+    Reader_Read(msgReader, hash.data(), hash.size());
+
+    if (!dictionary.isEmpty() && hash == dictionary.md5Hash())
+    {
+        Net_ServerLink().setDeflateDictionary(dictionary);
+        LOG_NET_VERBOSE("Using the preset deflate dictionary");
+    }
+}
+
 void Cl_AnswerHandshake()
 {
     LOG_AS("Cl_AnswerHandshake");
@@ -313,6 +351,10 @@ void Cl_GetPackets()
             Cl_AnswerHandshake();
             break;
 
+        case PSV_DEFLATE_DICTIONARY:
+            Cl_HandleDeflateDictionaryAccepted();
+            break;
+
         case PSV_MATERIAL_ARCHIVE:
             Cl_ReadServerMaterials();
             break;
@@ -1427,6 +1427,10 @@ static dint DD_StartupWorker(void * /*context*/)
     // files are needed, they will be decompressed and cached again.
     DoomsdayApp::app().uncacheFilesFromMemory();
 
+    // Packages loaded from now on have their contents decompressed in advance. This
+    // would be wasted on the startup packages, which were released above.
+    App::packageLoader().setPrefetchEnabled(true);
+
 #ifdef WIN32
     // This thread has finished using COM.
     CoUninitialize();
@@ -30,12 +30,18 @@
 #include <de/findfile.h>
 #include <de/c_wrapper.h>
 #include <de/App>
+#include <de/FS>
+#include <de/Folder>
 #include <de/PackageLoader>
+#include <de/Reader>
 #include <de/ScriptSystem>
 #include <de/NativePath>
 #include <de/RecordValue>
+#include <de/Version>
+#include <de/Writer>
 #include <doomsday/doomsdayapp.h>
 #include <doomsday/console/cmd.h>
+#include <doomsday/console/var.h>
 #include <doomsday/defs/decoration.h>
 #include <doomsday/defs/dedfile.h>
 #include <doomsday/defs/dedparser.h>
@@ -81,6 +87,12 @@ RuntimeDefs runtimeDefs;
 static bool defsInited;
 static mobjinfo_t *gettingFor;
 
+// Should we be caching snapshots of the processed definitions?
+static byte defsCache = true; // cvar
+
+/// Version of the definition snapshot file format. Increment when the format changes.
+static duint32 const DEFS_SNAPSHOT_VERSION = 1;
+
 static inline FS1 &fileSys()
 {
     return App_FileSystem();
@@ -362,20 +374,24 @@ static String defCountMsg(dint count, String const &label)
 
 /**
  * Read all DD_DEFNS lumps in the primary lump index.
+ *
+ * @return @c true, if all the lumps were parsed without errors.
  */
-static void Def_ReadLumpDefs()
+static bool Def_ReadLumpDefs()
 {
     LOG_AS("Def_ReadLumpDefs");
 
     LumpIndex const &lumpIndex = fileSys().nameIndex();
     LumpIndex::FoundIndices foundDefns;
     lumpIndex.findAll("DD_DEFNS.lmp", foundDefns);
+    bool ok = true;
     DENG2_FOR_EACH_CONST(LumpIndex::FoundIndices, i, foundDefns)
     {
         if (!DED_ReadLump(DED_Definitions(), *i))
         {
             QByteArray path = NativePath(lumpIndex[*i].container().composePath()).pretty().toUtf8();
             LOG_RES_ERROR("Parse error reading \"%s:DD_DEFNS\": %s") << path.constData() << DED_Error();
+            ok = false;
         }
     }
 
@@ -385,6 +401,7 @@ static void Def_ReadLumpDefs()
         LOG_RES_NOTE("Processed %i %s")
                 << numProcessedLumps << (numProcessedLumps != 1 ? "lumps" : "lump");
     }
+    return ok;
 }
 
 /**
@@ -530,9 +547,39 @@ static void translateMapInfos(QStringList const &mapInfoUrns, String &xlat, Stri
     Str_Free(&parm.paths);
 }
 
-static void readAllDefinitions()
+/**
+ * Returns the definition files in the current game's /auto directory, unless they
+ * are disabled with -noauto.
+ */
+static QStringList autoDefinitionPaths()
+{
+    QStringList paths;
+    if (App_GameLoaded() && !CommandLine_Exists("-noauto"))
+    {
+        FS1::PathList foundPaths;
+        if (fileSys().findAllPaths(de::makeUri("$(App.DefsPath)/$(GamePlugin.Name)/auto/*.ded").resolved(), 0, foundPaths))
+        {
+            for (FS1::PathListItem const &found : foundPaths)
+            {
+                // Ignore directories.
+                if (found.attrib & A_SUBDIR) continue;
+
+                paths << found.path;
+            }
+        }
+    }
+    return paths;
+}
+
+/**
+ * Reads all the definition files and lumps.
+ *
+ * @return @c true, if no errors were encountered.
+ */
+static bool readAllDefinitions()
 {
     Time begunAt;
+    bool ok = true;
 
     // Start with engine's own top-level definition file.
     readDefinitionFile(App::packageLoader().package("net.dengine.base").root()
@@ -558,6 +605,7 @@ static void readAllDefinitions()
                                  "[TranslatedMapInfos]", false /*not custom*/))
                 {
                     LOG_RES_ERROR("DED parse error: %s") << DED_Error();
+                    ok = false;
                 }
             }
 
@@ -570,6 +618,7 @@ static void readAllDefinitions()
                                  "[TranslatedMapInfos]", true /*custom*/))
                 {
                     LOG_RES_ERROR("DED parse error: %s") << DED_Error();
+                    ok = false;
                 }
             }
         }
@@ -587,25 +636,16 @@ static void readAllDefinitions()
             {
                 const auto names = record.names().join(";");
                 LOG_RES_ERROR("Failed to locate required game definition \"%s\"") << names;
+                ok = false;
             }
 
             readDefinitionFile(path);
         }
 
         // Next are definition files in the games' /auto directory.
-        if (!CommandLine_Exists("-noauto"))
+        for (String const &path : autoDefinitionPaths())
         {
-            FS1::PathList foundPaths;
-            if (fileSys().findAllPaths(de::makeUri("$(App.DefsPath)/$(GamePlugin.Name)/auto/*.ded").resolved(), 0, foundPaths))
-            {
-                for (FS1::PathListItem const &found : foundPaths)
-                {
-                    // Ignore directories.
-                    if (found.attrib & A_SUBDIR) continue;
-
-                    readDefinitionFile(found.path);
-                }
-            }
+            readDefinitionFile(path);
         }
     }
 
@@ -647,9 +687,206 @@ static void readAllDefinitions()
 
     // Last are DD_DEFNS definition lumps from loaded add-ons.
     /// @todo Shouldn't these be processed before definitions on the command line?
-    Def_ReadLumpDefs();
+    if (!Def_ReadLumpDefs()) ok = false;
 
     LOG_RES_VERBOSE("readAllDefinitions: Completed in %.2f seconds") << begunAt.since();
+    return ok;
+}
+
+/**
+ * Definition file that was read while parsing the definitions.
+ */
+struct DefinitionSource
+{
+    String path;
+    Block hash; ///< MD5 of the source text.
+};
+typedef QList<DefinitionSource> DefinitionSources;
+
+static FS1::Scheme &modelScheme()
+{
+    return fileSys().scheme(App_ResourceClass("RC_MODEL").defaultScheme());
+}
+
+static String definitionsSnapshotPath()
+{
+    return String("/home/cache/defs") /
+           (App_GameLoaded()? App_CurrentGame().id() : String("none")) + ".dsnap";
+}
+
+/**
+ * Composes a key that identifies the sources of the definitions. The key changes when
+ * the build, the layout of the definition structures (see ded_t::serialLayout()), the
+ * game, the command line, or any of the loaded files, packages, or data bundles change. This covers the definition lumps, the MAPINFO and DeHackEd
+ * translations, and the command line options tested in definition conditions (e.g.,
+ * `SkipIf -nodefaultfx`). The listing of each package's definitions folder is included
+ * as well, since folder packages have no single source file whose status would reflect
+ * added or removed files. The contents of the definition files are checked separately,
+ * because they may include other files.
+ */
+static Block definitionsSnapshotKey()
+{
+    Block data;
+    Writer writer(data);
+    writer << DEFS_SNAPSHOT_VERSION << ded_t::serialLayout()
+           << Version::currentBuild().fullNumber()
+           << (App_GameLoaded()? App_CurrentGame().id() : String());
+
+    writer << duint32(CommandLine_Count());
+    for (int i = 0; i < CommandLine_Count(); ++i)
+    {
+        writer << String(CommandLine_At(i));
+    }
+
+    for (FileHandle *hndl : fileSys().loadedFiles())
+    {
+        File1 const &file = hndl->file();
+        writer << file.composePath() << duint32(file.size()) << duint32(file.lastModified());
+    }
+    for (Package const *pkg : App::packageLoader().loadedPackagesInOrder())
+    {
+        File const &source = pkg->sourceFile();
+        writer << pkg->identifier() << duint64(source.status().size) << source.status().modifiedAt;
+
+        res::DoomsdayPackage ddPkg(*pkg);
+        if (ddPkg.hasDefinitions())
+        {
+            Folder const &defsFolder = pkg->root().locate<Folder const>(ddPkg.defsPath());
+            defsFolder.forContents([&writer] (String name, File &file)
+            {
+                writer << name << duint64(file.status().size) << file.status().modifiedAt;
+                return LoopContinue;
+            });
+        }
+    }
+    for (DataBundle const *bundle : DataBundle::loadedBundles())
+    {
+        File const &source = bundle->sourceFile();
+        writer << source.path() << duint64(source.status().size) << source.status().modifiedAt;
+    }
+    for (String const &path : autoDefinitionPaths())
+    {
+        writer << path;
+    }
+    return data.md5Hash();
+}
+
+/**
+ * Attempts to restore the definitions from a snapshot written in a previous session.
+ * The snapshot is used only if the sources of the definitions are unchanged.
+ *
+ * @param key  Key of the current definition sources.
+ *
+ * @return @c true, if the definitions were restored.
+ */
+static bool readDefinitionsSnapshot(Block const &key)
+{
+    String const path = definitionsSnapshotPath();
+    auto &defs = *DED_Definitions();
+    try
+    {
+        File const *file = FS::tryLocate<File const>(path);
+        if (!file) return false;
+
+        Time begunAt;
+        Block data;
+        *file >> data;
+
+        Reader reader(data);
+        duint32 version;
+        Block cachedKey;
+        reader.withHeader() >> version;
+        if (version != DEFS_SNAPSHOT_VERSION) return false;
+        reader >> cachedKey;
+        if (cachedKey != key) return false;
+
+        // Have any of the definition files been modified?
+        duint32 count;
+        reader >> count;
+        while (count-- > 0)
+        {
+            DefinitionSource src;
+            reader >> src.path >> src.hash;
+
+            Block text;
+            if (!DED_ReadSource(src.path, text) || text.md5Hash() != src.hash)
+            {
+                LOG_RES_VERBOSE("Definitions snapshot is outdated: \"%s\" has changed")
+                        << NativePath(src.path).pretty();
+                return false;
+            }
+        }
+
+        // Model search paths defined with ModelPath. Newest is first.
+        QList<SearchPath> modelPaths;
+        reader >> count;
+        while (count-- > 0)
+        {
+            de::Uri uri;
+            duint32 flags;
+            reader >> uri >> flags;
+            modelPaths.prepend(SearchPath(uri, SearchPath::Flags(flags)));
+        }
+
+        reader >> defs;
+
+        for (SearchPath const &searchPath : modelPaths)
+        {
+            modelScheme().addSearchPath(searchPath, FS1::ExtraPaths);
+        }
+
+        LOG_RES_VERBOSE("Definitions restored from \"%s\" in %.2f seconds")
+                << path << begunAt.since();
+        return true;
+    }
+    catch (Error const &er)
+    {
+        LOG_RES_WARNING("Failed reading definitions snapshot \"%s\": %s") << path << er.asText();
+    }
+    defs.clear();
+    return false;
+}
+
+/**
+ * Writes a snapshot of the processed definitions.
+ *
+ * @param key      Key of the current definition sources.
+ * @param sources  Definition files that were read.
+ */
+static void writeDefinitionsSnapshot(Block const &key, DefinitionSources const &sources)
+{
+    String const path = definitionsSnapshotPath();
+    try
+    {
+        Block data;
+        Writer writer(data);
+        writer.withHeader() << DEFS_SNAPSHOT_VERSION << key;
+
+        writer << duint32(sources.size());
+        for (DefinitionSource const &src : sources)
+        {
+            writer << src.path << src.hash;
+        }
+
+        auto const modelPaths = modelScheme().allSearchPaths().values(FS1::ExtraPaths);
+        writer << duint32(modelPaths.size());
+        for (SearchPath const &searchPath : modelPaths)
+        {
+            writer << static_cast<de::Uri const &>(searchPath) << duint32(searchPath.flags());
+        }
+
+        writer << *DED_Definitions();
+
+        File &file = FS::get().makeFolder(path.fileNamePath()).replaceFile(path.fileName());
+        file << data;
+        file.flush();
+
+        LOG_RES_VERBOSE("Definitions snapshot written to \"%s\"") << path;
+    }
+    catch (Error const &er)
+    {
+        LOG_RES_WARNING("Failed writing definitions snapshot \"%s\": %s") << path << er.asText();
+    }
 }
 
 static void defineFlaremap(de::Uri const &resourceUri)
@@ -1194,8 +1431,7 @@ void Def_Read()
     {
         // We've already initialized the definitions once.
         // Get rid of everything.
-        FS1::Scheme &scheme = fileSys().scheme(App_ResourceClass("RC_MODEL").defaultScheme());
-        scheme.reset();
+        modelScheme().reset();
 
         invalidateAllMaterials();
 #ifdef __CLIENT__
@@ -1210,15 +1446,39 @@ void Def_Read()
     defs.clear();
     runtimeDefs.clear();
 
-    // Generate definitions.
-    generateMaterialDefs();
+    // The processed definitions may be restored from a snapshot.
+    Block const snapshotKey = (defsCache? definitionsSnapshotKey() : Block());
+    if (snapshotKey.isEmpty() || !readDefinitionsSnapshot(snapshotKey))
+    {
+        // Generate definitions.
+        generateMaterialDefs();
 
-    // Read all definitions files and lumps.
-    LOG_RES_MSG("Parsing definition files...");
-    readAllDefinitions();
+        // Read all definitions files and lumps.
+        LOG_RES_MSG("Parsing definition files...");
+        DefinitionSources sources;
+        DED_SetSourceObserver([&sources] (String const &path, Block const &source)
+        {
+            sources << DefinitionSource{ path, source.md5Hash() };
+        });
+        bool const readOk = readAllDefinitions();
+        DED_SetSourceObserver(nullptr);
 
-    // Any definition hooks?
-    DoomsdayApp::plugins().callAllHooks(HOOK_DEFS, 0, &defs);
+        // Any definition hooks?
+        DoomsdayApp::plugins().callAllHooks(HOOK_DEFS, 0, &defs);
+
+        if (!snapshotKey.isEmpty())
+        {
+            if (readOk)
+            {
+                writeDefinitionsSnapshot(snapshotKey, sources);
+            }
+            else
+            {
+                // Errors should be reported again the next time.
+                LOG_RES_VERBOSE("Definitions snapshot not written due to errors");
+            }
+        }
+    }
 
 #ifdef __CLIENT__
     // Composite fonts.
@@ -2008,6 +2268,8 @@ D_CMD(ListMobjs)
 
 void Def_ConsoleRegister()
 {
+    C_VAR_BYTE("def-cache", &defsCache, 0, 0, 1);
+
     C_CMD("listmobjtypes", "", ListMobjs);
 }
 
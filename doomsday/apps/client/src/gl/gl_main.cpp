@@ -1488,6 +1488,8 @@ D_CMD(Fog)
     return false;
 }
 
+D_CMD(BenchmarkTextureKernels);  // texkernelbench.cpp
+
 void GL_Register()
 {
     // Cvars
@@ -1518,6 +1520,7 @@ void GL_Register()
     C_CMD_FLAGS("fog",              nullptr,   Fog,                CMDF_NO_NULLGAME|CMDF_NO_DEDICATED);
     C_CMD      ("displaymode",      "",     DisplayModeInfo);
     C_CMD      ("listdisplaymodes", "",     ListDisplayModes);
+    C_CMD_FLAGS("texkernelbench",   "",     BenchmarkTextureKernels, CMDF_NO_NULLGAME|CMDF_NO_DEDICATED);
 #if !defined (DENG_MOBILE)
     C_CMD      ("setcolordepth",    "i",    SetBPP);
     C_CMD      ("setbpp",           "i",    SetBPP);
@@ -19,6 +19,7 @@
 
 #include "de_platform.h"
 #include "gl/gl_tex.h"
+#include "gl/gl_texsimd.h"
 #include "dd_main.h"
 
 #include "misc/color.h"
@@ -28,31 +29,26 @@
 
 #include <doomsday/resource/colorpalette.h>
 #include <de/memory.h>
-#include <de/memoryzone.h>
 #include <de/vector1.h>
 #include <de/texgamma.h>
 #include <cstdlib>
 #include <cmath>
 #include <cctype>
-
-static uint8_t *scratchBuffer;
-static size_t scratchBufferSize;
+#include <cstring>
 
 /**
- * Provides a persistent scratch buffer for use by texture manipulation
- * routines e.g. scaleLine().
+ * Copies the colors of @a palette into a 256-entry lookup table, so that pixel
+ * loops do not need to go through ColorPalette::color(). Indices beyond the
+ * end of the palette are clamped, like ColorPalette::color() does.
  */
-static uint8_t *GetScratchBuffer(size_t size)
+static void loadPaletteTable(res::ColorPalette const &palette, de::Vector3ub *table)
 {
-    // Need to enlarge?
-    if(size > scratchBufferSize)
+    int const count = palette.colorCount();
+    for(int i = 0; i < 256; ++i)
     {
-        scratchBuffer = (uint8_t *) Z_Realloc(scratchBuffer, size, PU_APPSTATIC);
-        scratchBufferSize = size;
+        table[i] = (count > 0? palette.color(de::min(i, count - 1)) : de::Vector3ub());
     }
-    return scratchBuffer;
 }
-
 /**
  * Len is measured in out units. Comps is the number of components per
  * pixel, or rather the number of bytes per pixel (3 or 4). The strides must
@@ -135,7 +131,88 @@ static void scaleLine(const uint8_t* in, int inStride, uint8_t* out, int outStri
     }
 }
 
-/// \todo Avoid use of a secondary buffer by scaling directly to output.
+/**
+ * Same as scaleLine() when each whole row of @a rowSize bytes is treated as one
+ * pixel, i.e., scales vertically from @a inLen to @a outLen rows. The rows are
+ * processed in memory order so the inner loops are contiguous.
+ */
+static void scaleRows(uint8_t const *in, uint8_t *out, int rowSize, int outLen, int inLen)
+{
+    float inToOutScale = outLen / (float) inLen;
+    int i, c;
+
+    if(inToOutScale > 1)
+    {
+        // Magnification is done using linear interpolation.
+        fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
+        fixed_t inPos = inPosDelta;
+
+        // The first row.
+        memcpy(out, in, rowSize);
+        out += rowSize;
+
+        // Step at each out row between the first and last ones.
+        for(i = 1; i < outLen - 1; ++i, out += rowSize, inPos += inPosDelta)
+        {
+            uint8_t const *row1 = in + (inPos >> FRACBITS) * rowSize;
+            uint8_t const *row2 = row1 + rowSize;
+            int const weight = inPos & 0xffff;
+            int const invWeight = 0x10000 - weight;
+
+            if(!weight)
+            {
+                // Exactly on an in row (always the case if there is only one,
+                // in which case row2 would be past the end).
+                memcpy(out, row1, rowSize);
+                continue;
+            }
+            for(c = TexSimd_LerpRow(out, row1, row2, rowSize, weight); c < rowSize; ++c)
+                out[c] = (uint8_t)((row1[c] * invWeight + row2[c] * weight) >> 16);
+        }
+
+        // The last row.
+        memcpy(out, in + (inLen - 1) * rowSize, rowSize);
+        return;
+    }
+
+    if(inToOutScale < 1)
+    {
+        // Minification needs to calculate the average of each of
+        // the rows contained by the out row.
+        uint *cumul = (uint *) M_Calloc(sizeof(*cumul) * rowSize);
+        uint count = 0;
+        int outpos = 0;
+
+        for(i = 0; i < inLen; ++i, in += rowSize)
+        {
+            if((int) (i * inToOutScale) != outpos)
+            {
+                outpos = (int) (i * inToOutScale);
+
+                for(c = 0; c < rowSize; ++c)
+                {
+                    out[c] = (count? uint8_t(cumul[c] / count) : 0);
+                    cumul[c] = 0;
+                }
+                count = 0;
+                out += rowSize;
+            }
+            for(c = 0; c < rowSize; ++c)
+                cumul[c] += in[c];
+            count++;
+        }
+        // Fill in the last row, too.
+        if(count)
+            for(c = 0; c < rowSize; ++c)
+                out[c] = (uint8_t)(cumul[c] / count);
+        M_Free(cumul);
+        return;
+    }
+
+    // No need for scaling.
+    memcpy(out, in, rowSize * outLen);
+}
+
 uint8_t* GL_ScaleBuffer(const uint8_t* in, int width, int height, int comps,
     int outWidth, int outHeight)
 {
@@ -145,12 +222,13 @@ uint8_t* GL_ScaleBuffer(const uint8_t* in, int width, int height, int comps,
     uint8_t* outOff, *buffer;
     const uint8_t* inOff;
     uint8_t* out;
-    int stride;
 
     if(width <= 0 || height <= 0)
         return (uint8_t*)in;
 
-    buffer = GetScratchBuffer(comps * outWidth * height);
+    // The intermediate buffer is private so that images can be scaled in
+    // several threads at once.
+    buffer = (uint8_t *) M_Malloc(comps * outWidth * height);
 
     out = (uint8_t *) M_Malloc(comps * outWidth * outHeight);
 
@@ -166,16 +244,9 @@ uint8_t* GL_ScaleBuffer(const uint8_t* in, int width, int height, int comps,
     }}
 
     // Then scale vertically, to outHeight, into the out buffer.
-    inOff = buffer;
-    outOff = out;
-    stride = outWidth * comps;
-    inOffsetSize = comps;
-    outOffsetSize = comps;
-    { int i;
-    for(i = 0; i < outWidth; ++i, inOff += inOffsetSize, outOff += outOffsetSize)
-    {
-        scaleLine(inOff, stride, outOff, stride, outHeight, height, comps);
-    }}
+    scaleRows(buffer, out, outWidth * comps, outHeight, height);
+
+    M_Free(buffer);
     return out;
     }
 }
@@ -687,12 +758,26 @@ void GL_DownMipmap32(uint8_t* in, int width, int height, int comps)
     }
 
     // Unconstrained, 2x2 -> 1x1 reduction?
+    // Each out row is produced from two in rows (an odd last column is skipped
+    // over, so for odd widths the next pair of rows starts one pixel early).
+    int const inRowStride = (width + outW * 2) * comps;
     out = in;
-    for(y = 0; y < outH; ++y, in += width * comps)
-        for(x = 0; x < outW; ++x, in += comps * 2)
+    for(y = 0; y < outH; ++y, in += inRowStride)
+    {
+        uint8_t const *row1 = in;
+        uint8_t const *row2 = in + width * comps;
+        x = 0;
+        if(comps == 4)
+        {
+            x = TexSimd_DownMipmapRowRGBA(out, row1, row2, outW);
+            out += x * 4;
+            row1 += x * 8;
+            row2 += x * 8;
+        }
+        for(; x < outW; ++x, row1 += comps * 2, row2 += comps * 2)
             for(c = 0; c < comps; ++c, out++)
-                *out = (uint8_t)((in[c] + in[comps + c] + in[comps * width + c] +
-                              in[comps * (width + 1) + c]) >> 2);
+                *out = (uint8_t)((row1[c] + row1[comps + c] + row2[c] + row2[comps + c]) >> 2);
+    }
     }
 }
 
@@ -749,21 +834,27 @@ dd_bool GL_PalettizeImage(uint8_t *out, int outformat, res::ColorPalette const *
         int const inSize   = (informat == 2 ? 1 : informat);
         int const outSize  = (outformat == 2 ? 1 : outformat);
 
+        // Look up the (gamma corrected) colors only once per palette index.
+        de::Vector3ub colors[256];
+        loadPaletteTable(*palette, colors);
+        if(applyTexGamma)
+        {
+            for(de::Vector3ub &color : colors)
+            {
+                color = de::Vector3ub(R_TexGammaLut(color.x),
+                                      R_TexGammaLut(color.y),
+                                      R_TexGammaLut(color.z));
+            }
+        }
+
         for(long i = 0; i < numPels; ++i)
         {
-            de::Vector3ub palColor = palette->color(*in);
+            de::Vector3ub const &palColor = colors[*in];
 
             out[0] = palColor.x;
             out[1] = palColor.y;
             out[2] = palColor.z;
 
-            if(applyTexGamma)
-            {
-                out[0] = R_TexGammaLut(out[0]);
-                out[1] = R_TexGammaLut(out[1]);
-                out[2] = R_TexGammaLut(out[2]);
-            }
-
             if(outformat == 4)
             {
                 if(informat == 2)
@@ -791,10 +882,20 @@ dd_bool GL_QuantizeImageToPalette(uint8_t *out, int outformat, res::ColorPalette
         int outSize = (outformat == 2 ? 1 : outformat);
         int i, numPixels = width * height;
 
+        // Neighboring pixels often have the same color, in which case the
+        // previous match can be reused.
+        uint8_t prevColor[3] = { 0, 0, 0 };
+        uint8_t prevIndex = uint8_t(palette->nearestIndex(de::Vector3ub(prevColor)));
+
         for(i = 0; i < numPixels; ++i, in += inSize, out += outSize)
         {
             // Convert the color value.
-            *out = palette->nearestIndex(de::Vector3ub(in));
+            if(in[0] != prevColor[0] || in[1] != prevColor[1] || in[2] != prevColor[2])
+            {
+                std::memcpy(prevColor, in, 3);
+                prevIndex = uint8_t(palette->nearestIndex(de::Vector3ub(in)));
+            }
+            *out = prevIndex;
 
             // Alpha channel?
             if(outformat == 2)
@@ -819,37 +920,51 @@ void GL_DeSaturatePalettedImage(uint8_t *pixels, res::ColorPalette const &palett
 
     long const numPels = width * height;
 
-    // What is the maximum color value?
-    int max = 0;
-    for(long i = 0; i < numPels; ++i)
+    // The weighted average of each palette color; -1 for grays, which are
+    // left unchanged.
+    int gray[256];
     {
-        de::Vector3ub palColor = palette[pixels[i]];
-        if(palColor.x == palColor.y && palColor.x == palColor.z)
+        de::Vector3ub colors[256];
+        loadPaletteTable(palette, colors);
+        for(int i = 0; i < 256; ++i)
         {
-            if(palColor.x > max)
+            de::Vector3ub const &palColor = colors[i];
+            if(palColor.x == palColor.y && palColor.x == palColor.z)
             {
-                max = palColor.x;
+                gray[i] = -1 - palColor.x;
+                continue;
             }
-            continue;
+            gray[i] = (2 * int( palColor.x ) + 4 * int( palColor.y ) + 3 * int( palColor.z )) / 9;
         }
+    }
 
-        int temp = (2 * int( palColor.x ) + 4 * int( palColor.y ) + 3 * int( palColor.z )) / 9;
-        if(temp > max) max = temp;
+    // What is the maximum color value?
+    int max = 0;
+    for(long i = 0; i < numPels; ++i)
+    {
+        int const temp = gray[pixels[i]];
+        int const value = (temp < 0? -1 - temp : temp);
+        if(value > max) max = value;
     }
 
+    // The desaturated index of each palette index, looked up when first needed.
+    int desaturated[256];
+    std::memset(desaturated, -1, sizeof(desaturated));
+
     for(long i = 0; i < numPels; ++i)
     {
-        de::Vector3ub palColor = palette[pixels[i]];
-        if(palColor.x == palColor.y && palColor.x == palColor.z)
-        {
-            continue;
-        }
+        uint8_t const index = pixels[i];
+        if(gray[index] < 0) continue;
 
-        // Calculate a weighted average.
-        int temp = (2 * int( palColor.x ) + 4 * int( palColor.y ) + 3 * int( palColor.z )) / 9;
-        if(max) temp *= 255.f / max;
+        if(desaturated[index] < 0)
+        {
+            // Calculate a weighted average.
+            int temp = gray[index];
+            if(max) temp *= 255.f / max;
 
-        pixels[i] = palette.nearestIndex(de::Vector3ub(temp, temp, temp));
+            desaturated[index] = palette.nearestIndex(de::Vector3ub(temp, temp, temp));
+        }
+        pixels[i] = uint8_t(desaturated[index]);
     }
 }
 
@@ -875,6 +990,9 @@ void FindAverageLineColorIdx(uint8_t const *data, int w, int h, int line,
         return;
     }
 
+    de::Vector3ub colors[256];
+    loadPaletteTable(palette, colors);
+
     numpels = w * h;
     start = data + w * line;
     alphaStart = data + numpels + w * line;
@@ -883,7 +1001,7 @@ void FindAverageLineColorIdx(uint8_t const *data, int w, int h, int line,
     {
         if(!hasAlpha || alphaStart[i])
         {
-            de::Vector3ub palColor = palette[start[i]];
+            de::Vector3ub const &palColor = colors[start[i]];
             avg[0] += palColor.x;
             avg[1] += palColor.y;
             avg[2] += palColor.z;
@@ -923,7 +1041,13 @@ void FindAverageLineColor(const uint8_t* pixels, int width, int height,
     }
 
     src = pixels + pixelSize * width * line;
-    for(i = 0; i < width; ++i, src += pixelSize)
+    i = 0;
+    if(pixelSize == 4)
+    {
+        i = int(TexSimd_SumRGBA(src, width, avg));
+        src += 4 * i;
+    }
+    for(; i < width; ++i, src += pixelSize)
     {
         avg[0] += src[0];
         avg[1] += src[1];
@@ -959,7 +1083,13 @@ void FindAverageColor(const uint8_t* pixels, int width, int height,
 
     numpels = width * height;
     src = pixels;
-    for(i = 0; i < numpels; ++i, src += pixelSize)
+    i = 0;
+    if(pixelSize == 4)
+    {
+        i = TexSimd_SumRGBA(src, numpels, avg);
+        src += 4 * i;
+    }
+    for(; i < numpels; ++i, src += pixelSize)
     {
         avg[0] += src[0];
         avg[1] += src[1];
@@ -985,6 +1115,9 @@ void FindAverageColorIdx(uint8_t const *data, int w, int h, res::ColorPalette co
         return;
     }
 
+    de::Vector3ub colors[256];
+    loadPaletteTable(palette, colors);
+
     numpels = w * h;
     alphaStart = data + numpels;
     count = 0;
@@ -992,7 +1125,7 @@ void FindAverageColorIdx(uint8_t const *data, int w, int h, res::ColorPalette co
     {
         if(!hasAlpha || alphaStart[i])
         {
-            de::Vector3ub palColor = palette[data[i]];
+            de::Vector3ub const &palColor = colors[data[i]];
             avg[0] += palColor.x;
             avg[1] += palColor.y;
             avg[2] += palColor.z;
@@ -1387,7 +1520,12 @@ void Desaturate(uint8_t* pixels, int width, int height, int comps)
         return;
 
     numpels = width * height;
-    for(i = 0, pix = pixels; i < numpels; ++i, pix += comps)
+    i = 0;
+    if(comps == 4)
+    {
+        i = TexSimd_DesaturateRGBA(pixels, numpels);
+    }
+    for(pix = pixels + comps * i; i < numpels; ++i, pix += comps)
     {
         int min = MIN_OF(pix[0], MIN_OF(pix[1], pix[2]));
         int max = MAX_OF(pix[0], MAX_OF(pix[1], pix[2]));
@@ -1436,11 +1574,17 @@ void AmplifyLuma(uint8_t* pixels, int width, int height, dd_bool hasAlpha)
     if(0 == max || 255 == max)
         return;
 
-    { uint8_t* pix = pixels;
-    long i;
-    for(i = 0; i < numPels; ++i, pix++)
+    { uint8_t amplified[256];
+    int i;
+    for(i = 0; i < 256; ++i)
+    {
+        amplified[i] = (uint8_t) MINMAX_OF(0, (float)i / max * 255, 255);
+    }
+    uint8_t* pix = pixels;
+    long k;
+    for(k = 0; k < numPels; ++k, pix++)
     {
-        *pix = (uint8_t) MINMAX_OF(0, (float)*pix / max * 255, 255);
+        *pix = amplified[*pix];
     }}
     }
 }
@@ -1462,23 +1606,26 @@ void EnhanceContrast(uint8_t* pixels, int width, int height, int comps)
         return;
     }
 
+    // The adjustment only depends on the component value.
+    uint8_t enhanced[256];
+    for(i = 0; i < 256; ++i)
+    {
+        if(i < 60) // Darken dark parts.
+            enhanced[i] = (uint8_t) MINMAX_OF(0, ((float)i - 70) * 1.0125f + 70, 255);
+        else if(i > 185) // Lighten light parts.
+            enhanced[i] = (uint8_t) MINMAX_OF(0, ((float)i - 185) * 1.0125f + 185, 255);
+        else
+            enhanced[i] = (uint8_t) i;
+    }
+
     pix = pixels;
     numpels = width * height;
 
     for(i = 0; i < numpels; ++i, pix += comps)
     {
-        int c;
-        for(c = 0; c < 3; ++c)
-        {
-            uint8_t out;
-            if(pix[c] < 60) // Darken dark parts.
-                out = (uint8_t) MINMAX_OF(0, ((float)pix[c] - 70) * 1.0125f + 70, 255);
-            else if(pix[c] > 185) // Lighten light parts.
-                out = (uint8_t) MINMAX_OF(0, ((float)pix[c] - 185) * 1.0125f + 185, 255);
-            else
-                out = pix[c];
-            pix[c] = out;
-        }
+        pix[0] = enhanced[pix[0]];
+        pix[1] = enhanced[pix[1]];
+        pix[2] = enhanced[pix[2]];
     }
     }
 }
@@ -1548,7 +1695,8 @@ static void doColorKeying(uint8_t *rgbaBuf, int width)
 {
     DENG2_ASSERT(rgbaBuf);
 
-    for(int i = 0; i < width; ++i, rgbaBuf += 4)
+    int i = int(TexSimd_ColorKeyRGBA(rgbaBuf, width));
+    for(rgbaBuf += 4 * i; i < width; ++i, rgbaBuf += 4)
     {
         if(!isKeyedColor(rgbaBuf)) continue;
 
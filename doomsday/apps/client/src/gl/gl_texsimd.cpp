@@ -0,0 +1,479 @@
+/** @file gl_texsimd.cpp  Vectorized texture image kernels.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2005-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "gl/gl_texsimd.h"
+
+#include <de/math.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define DENG_TEXSIMD_X86
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+     // MSVC does not need the instruction sets to be enabled for the intrinsics.
+#    define TEXSIMD_TARGET(isa)
+#  else
+#    define TEXSIMD_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+      (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+   // The kernels treat RGBA pixels as little-endian 32-bit words.
+#  define DENG_TEXSIMD_NEON
+#  include <arm_neon.h>
+#endif
+
+/*
+ * In the interpolation kernels, (a * (0x10000 - w) + b * w) >> 16 is evaluated as
+ * a + floor((b - a) * w / 0x10000), which is the same value but fits in 16-bit
+ * lanes. The signed high multiply sees weights of 0x8000 and above as w - 0x10000;
+ * the difference is compensated by adding (b - a) back.
+ */
+
+#ifdef DENG_TEXSIMD_X86
+
+TEXSIMD_TARGET("sse2")
+static int lerpRowSSE2(uint8_t *out, uint8_t const *row1, uint8_t const *row2, int count,
+                       int weight)
+{
+    __m128i const zero = _mm_setzero_si128();
+    bool const upper = (weight >= 0x8000);
+    __m128i const w = _mm_set1_epi16(short(upper? weight - 0x10000 : weight));
+    int i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i const a = _mm_loadu_si128((__m128i const *) (row1 + i));
+        __m128i const b = _mm_loadu_si128((__m128i const *) (row2 + i));
+        __m128i const aLo = _mm_unpacklo_epi8(a, zero);
+        __m128i const aHi = _mm_unpackhi_epi8(a, zero);
+        __m128i const dLo = _mm_sub_epi16(_mm_unpacklo_epi8(b, zero), aLo);
+        __m128i const dHi = _mm_sub_epi16(_mm_unpackhi_epi8(b, zero), aHi);
+        __m128i tLo = _mm_mulhi_epi16(dLo, w);
+        __m128i tHi = _mm_mulhi_epi16(dHi, w);
+        if(upper)
+        {
+            tLo = _mm_add_epi16(tLo, dLo);
+            tHi = _mm_add_epi16(tHi, dHi);
+        }
+        _mm_storeu_si128((__m128i *) (out + i),
+                         _mm_packus_epi16(_mm_add_epi16(aLo, tLo), _mm_add_epi16(aHi, tHi)));
+    }
+    return i;
+}
+
+TEXSIMD_TARGET("avx2")
+static int lerpRowAVX2(uint8_t *out, uint8_t const *row1, uint8_t const *row2, int count,
+                       int weight)
+{
+    __m256i const zero = _mm256_setzero_si256();
+    bool const upper = (weight >= 0x8000);
+    __m256i const w = _mm256_set1_epi16(short(upper? weight - 0x10000 : weight));
+    int i = 0;
+    for(; i + 32 <= count; i += 32)
+    {
+        // Unpacking and packing both work within 128-bit lanes, so the order
+        // of the components is preserved.
+        __m256i const a = _mm256_loadu_si256((__m256i const *) (row1 + i));
+        __m256i const b = _mm256_loadu_si256((__m256i const *) (row2 + i));
+        __m256i const aLo = _mm256_unpacklo_epi8(a, zero);
+        __m256i const aHi = _mm256_unpackhi_epi8(a, zero);
+        __m256i const dLo = _mm256_sub_epi16(_mm256_unpacklo_epi8(b, zero), aLo);
+        __m256i const dHi = _mm256_sub_epi16(_mm256_unpackhi_epi8(b, zero), aHi);
+        __m256i tLo = _mm256_mulhi_epi16(dLo, w);
+        __m256i tHi = _mm256_mulhi_epi16(dHi, w);
+        if(upper)
+        {
+            tLo = _mm256_add_epi16(tLo, dLo);
+            tHi = _mm256_add_epi16(tHi, dHi);
+        }
+        _mm256_storeu_si256((__m256i *) (out + i),
+                            _mm256_packus_epi16(_mm256_add_epi16(aLo, tLo),
+                                                _mm256_add_epi16(aHi, tHi)));
+    }
+    return i;
+}
+
+TEXSIMD_TARGET("sse2")
+static inline __m128i downMipmapPairSSE2(uint8_t const *row1, uint8_t const *row2)
+{
+    // Two output pixels from 4 input pixels of both rows.
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const a = _mm_loadu_si128((__m128i const *) row1);
+    __m128i const b = _mm_loadu_si128((__m128i const *) row2);
+    __m128i const sLo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    __m128i const sHi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    __m128i const sum = _mm_add_epi16(_mm_unpacklo_epi64(sLo, sHi), _mm_unpackhi_epi64(sLo, sHi));
+    return _mm_srli_epi16(sum, 2);
+}
+
+TEXSIMD_TARGET("sse2")
+static int downMipmapRowSSE2(uint8_t *out, uint8_t const *row1, uint8_t const *row2,
+                             int outCount)
+{
+    int x = 0;
+    for(; x + 4 <= outCount; x += 4, out += 16, row1 += 32, row2 += 32)
+    {
+        // All input is loaded before anything is stored.
+        __m128i const first  = downMipmapPairSSE2(row1,      row2);
+        __m128i const second = downMipmapPairSSE2(row1 + 16, row2 + 16);
+        _mm_storeu_si128((__m128i *) out, _mm_packus_epi16(first, second));
+    }
+    return x;
+}
+
+TEXSIMD_TARGET("sse2")
+static long desaturateSSE2(uint8_t *pixels, long count)
+{
+    __m128i const lowByte = _mm_set1_epi32(0xff);
+    __m128i const alpha   = _mm_set1_epi32(int(0xff000000));
+    long i = 0;
+    for(; i + 4 <= count; i += 4, pixels += 16)
+    {
+        __m128i const v = _mm_loadu_si128((__m128i const *) pixels);
+        __m128i const g = _mm_srli_epi32(v, 8);
+        __m128i const b = _mm_srli_epi32(v, 16);
+        // The lowest byte of each pixel has the min/max of R, G and B.
+        __m128i const min = _mm_and_si128(_mm_min_epu8(v, _mm_min_epu8(g, b)), lowByte);
+        __m128i const max = _mm_and_si128(_mm_max_epu8(v, _mm_max_epu8(g, b)), lowByte);
+        __m128i const avg = _mm_srli_epi32(_mm_add_epi32(min, max), 1);
+        __m128i const rgb = _mm_or_si128(avg, _mm_or_si128(_mm_slli_epi32(avg, 8),
+                                                           _mm_slli_epi32(avg, 16)));
+        _mm_storeu_si128((__m128i *) pixels, _mm_or_si128(_mm_and_si128(v, alpha), rgb));
+    }
+    return i;
+}
+
+TEXSIMD_TARGET("sse2")
+static long colorKeySSE2(uint8_t *pixels, long count)
+{
+    __m128i const rgbMask = _mm_set1_epi32(0x00ffffff);
+    __m128i const key1    = _mm_set1_epi32(0x00ff00ff); // (255,0,255)
+    __m128i const key2    = _mm_set1_epi32(0x00ffff00); // (0,255,255)
+    long i = 0;
+    for(; i + 4 <= count; i += 4, pixels += 16)
+    {
+        __m128i const v = _mm_loadu_si128((__m128i const *) pixels);
+        __m128i const rgb = _mm_and_si128(v, rgbMask);
+        __m128i const keyed = _mm_or_si128(_mm_cmpeq_epi32(rgb, key1), _mm_cmpeq_epi32(rgb, key2));
+        _mm_storeu_si128((__m128i *) pixels, _mm_andnot_si128(keyed, v));
+    }
+    return i;
+}
+
+TEXSIMD_TARGET("sse2")
+static long sumRGBASSE2(uint8_t const *pixels, long count, long sums[3])
+{
+    __m128i const zero = _mm_setzero_si128();
+    long i = 0;
+    while(i + 4 <= count)
+    {
+        // Each 32-bit lane grows by at most 1020 per round, so the sums are
+        // moved out before they could overflow.
+        long const end = i + de::min(count - i, 4L << 20) / 4 * 4;
+        __m128i acc = zero;
+        for(; i < end; i += 4, pixels += 16)
+        {
+            __m128i const v = _mm_loadu_si128((__m128i const *) pixels);
+            __m128i const s = _mm_add_epi16(_mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero));
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(s, zero));
+            acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(s, zero));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i *) lanes, acc);
+        sums[0] += lanes[0];
+        sums[1] += lanes[1];
+        sums[2] += lanes[2];
+    }
+    return i;
+}
+
+/*
+ * hq2x keys are compared with saturating byte arithmetic: |a - b| is the sum of
+ * the two saturated differences, and subtracting the thresholds leaves a nonzero
+ * byte only where the difference is larger than the threshold.
+ */
+
+TEXSIMD_TARGET("sse2")
+static int hq2xPatternsSSE2(uint8_t *patterns, uint32_t const *keys, int stride, int count,
+                            uint32_t thresholds)
+{
+    int const offsets[8] = { 0, 1, 2, stride, stride + 2, 2 * stride, 2 * stride + 1, 2 * stride + 2 };
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const thr  = _mm_set1_epi32(int(thresholds));
+    int x = 0;
+    for(; x + 4 <= count; x += 4, keys += 4)
+    {
+        __m128i const center = _mm_loadu_si128((__m128i const *) (keys + stride + 1));
+        __m128i pattern = zero;
+        for(int n = 0; n < 8; ++n)
+        {
+            __m128i const k = _mm_loadu_si128((__m128i const *) (keys + offsets[n]));
+            __m128i const diff = _mm_or_si128(_mm_subs_epu8(center, k), _mm_subs_epu8(k, center));
+            __m128i const same = _mm_cmpeq_epi32(_mm_subs_epu8(diff, thr), zero);
+            pattern = _mm_or_si128(pattern, _mm_andnot_si128(same, _mm_set1_epi32(1 << n)));
+        }
+        pattern = _mm_packs_epi32(pattern, pattern);
+        pattern = _mm_packus_epi16(pattern, pattern);
+        uint32_t const packed = uint32_t(_mm_cvtsi128_si32(pattern));
+        std::memcpy(patterns + x, &packed, 4);
+    }
+    return x;
+}
+
+TEXSIMD_TARGET("avx2")
+static int hq2xPatternsAVX2(uint8_t *patterns, uint32_t const *keys, int stride, int count,
+                            uint32_t thresholds)
+{
+    int const offsets[8] = { 0, 1, 2, stride, stride + 2, 2 * stride, 2 * stride + 1, 2 * stride + 2 };
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const thr  = _mm256_set1_epi32(int(thresholds));
+    int x = 0;
+    for(; x + 8 <= count; x += 8, keys += 8)
+    {
+        __m256i const center = _mm256_loadu_si256((__m256i const *) (keys + stride + 1));
+        __m256i pattern = zero;
+        for(int n = 0; n < 8; ++n)
+        {
+            __m256i const k = _mm256_loadu_si256((__m256i const *) (keys + offsets[n]));
+            __m256i const diff = _mm256_or_si256(_mm256_subs_epu8(center, k),
+                                                 _mm256_subs_epu8(k, center));
+            __m256i const same = _mm256_cmpeq_epi32(_mm256_subs_epu8(diff, thr), zero);
+            pattern = _mm256_or_si256(pattern, _mm256_andnot_si256(same, _mm256_set1_epi32(1 << n)));
+        }
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(pattern),
+                                         _mm256_extracti128_si256(pattern, 1));
+        packed = _mm_packus_epi16(packed, packed);
+        _mm_storel_epi64((__m128i *) (patterns + x), packed);
+    }
+    return x;
+}
+
+#endif // DENG_TEXSIMD_X86
+
+#ifdef DENG_TEXSIMD_NEON
+
+static int lerpRowNEON(uint8_t *out, uint8_t const *row1, uint8_t const *row2, int count,
+                       int weight)
+{
+    // The products are formed in 32-bit lanes, so the weight needs no adjustment.
+    int32x4_t const w = vdupq_n_s32(weight);
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        int16x8_t const a = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(row1 + i)));
+        int16x8_t const d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(row2 + i))), a);
+        int16x4_t const tLo = vshrn_n_s32(vmulq_s32(vmovl_s16(vget_low_s16(d)),  w), 16);
+        int16x4_t const tHi = vshrn_n_s32(vmulq_s32(vmovl_s16(vget_high_s16(d)), w), 16);
+        vst1_u8(out + i, vqmovun_s16(vaddq_s16(a, vcombine_s16(tLo, tHi))));
+    }
+    return i;
+}
+
+static int downMipmapRowNEON(uint8_t *out, uint8_t const *row1, uint8_t const *row2,
+                             int outCount)
+{
+    int x = 0;
+    for(; x + 2 <= outCount; x += 2, out += 8, row1 += 16, row2 += 16)
+    {
+        uint8x16_t const a = vld1q_u8(row1);
+        uint8x16_t const b = vld1q_u8(row2);
+        uint16x8_t const sLo = vaddl_u8(vget_low_u8(a),  vget_low_u8(b));
+        uint16x8_t const sHi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+        uint16x8_t const sum = vcombine_u16(vadd_u16(vget_low_u16(sLo), vget_high_u16(sLo)),
+                                            vadd_u16(vget_low_u16(sHi), vget_high_u16(sHi)));
+        vst1_u8(out, vmovn_u16(vshrq_n_u16(sum, 2)));
+    }
+    return x;
+}
+
+static long desaturateNEON(uint8_t *pixels, long count)
+{
+    long i = 0;
+    for(; i + 16 <= count; i += 16, pixels += 64)
+    {
+        uint8x16x4_t v = vld4q_u8(pixels);
+        uint8x16_t const min = vminq_u8(v.val[0], vminq_u8(v.val[1], v.val[2]));
+        uint8x16_t const max = vmaxq_u8(v.val[0], vmaxq_u8(v.val[1], v.val[2]));
+        v.val[0] = v.val[1] = v.val[2] = vhaddq_u8(min, max);
+        vst4q_u8(pixels, v);
+    }
+    return i;
+}
+
+static long colorKeyNEON(uint8_t *pixels, long count)
+{
+    uint32x4_t const rgbMask = vdupq_n_u32(0x00ffffff);
+    uint32x4_t const key1    = vdupq_n_u32(0x00ff00ff); // (255,0,255)
+    uint32x4_t const key2    = vdupq_n_u32(0x00ffff00); // (0,255,255)
+    long i = 0;
+    for(; i + 4 <= count; i += 4, pixels += 16)
+    {
+        uint32x4_t const v = vreinterpretq_u32_u8(vld1q_u8(pixels));
+        uint32x4_t const rgb = vandq_u32(v, rgbMask);
+        uint32x4_t const keyed = vorrq_u32(vceqq_u32(rgb, key1), vceqq_u32(rgb, key2));
+        vst1q_u8(pixels, vreinterpretq_u8_u32(vbicq_u32(v, keyed)));
+    }
+    return i;
+}
+
+static long sumRGBANEON(uint8_t const *pixels, long count, long sums[3])
+{
+    long i = 0;
+    while(i + 16 <= count)
+    {
+        // Each 32-bit lane grows by at most 1020 per round, so the sums are
+        // moved out before they could overflow.
+        long const end = i + de::min(count - i, 16L << 20) / 16 * 16;
+        uint32x4_t acc[3] = { vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0) };
+        for(; i < end; i += 16, pixels += 64)
+        {
+            uint8x16x4_t const v = vld4q_u8(pixels);
+            for(int c = 0; c < 3; ++c)
+            {
+                acc[c] = vpadalq_u16(acc[c], vpaddlq_u8(v.val[c]));
+            }
+        }
+        for(int c = 0; c < 3; ++c)
+        {
+            uint32_t lanes[4];
+            vst1q_u32(lanes, acc[c]);
+            sums[c] += long(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+    return i;
+}
+
+static int hq2xPatternsNEON(uint8_t *patterns, uint32_t const *keys, int stride, int count,
+                            uint32_t thresholds)
+{
+    int const offsets[8] = { 0, 1, 2, stride, stride + 2, 2 * stride, 2 * stride + 1, 2 * stride + 2 };
+    uint8x16_t const thr = vreinterpretq_u8_u32(vdupq_n_u32(thresholds));
+    int x = 0;
+    for(; x + 4 <= count; x += 4, keys += 4)
+    {
+        uint8x16_t const center = vreinterpretq_u8_u32(vld1q_u32(keys + stride + 1));
+        uint32x4_t pattern = vdupq_n_u32(0);
+        for(int n = 0; n < 8; ++n)
+        {
+            uint8x16_t const k = vreinterpretq_u8_u32(vld1q_u32(keys + offsets[n]));
+            uint32x4_t const same = vceqq_u32(vreinterpretq_u32_u8(vqsubq_u8(vabdq_u8(center, k), thr)),
+                                              vdupq_n_u32(0));
+            pattern = vorrq_u32(pattern, vbicq_u32(vdupq_n_u32(1u << n), same));
+        }
+        uint16x4_t const narrow = vmovn_u32(pattern);
+        uint8x8_t const bytes = vmovn_u16(vcombine_u16(narrow, narrow));
+        vst1_lane_u32((uint32_t *) (patterns + x), vreinterpret_u32_u8(bytes), 0);
+    }
+    return x;
+}
+
+#endif // DENG_TEXSIMD_NEON
+
+int TexSimd_LerpRow(uint8_t *out, uint8_t const *row1, uint8_t const *row2, int count,
+                    int weight)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_TEXSIMD_X86
+    case SIMD_AVX2: return lerpRowAVX2(out, row1, row2, count, weight);
+    case SIMD_SSE2: return lerpRowSSE2(out, row1, row2, count, weight);
+#endif
+#ifdef DENG_TEXSIMD_NEON
+    case SIMD_NEON: return lerpRowNEON(out, row1, row2, count, weight);
+#endif
+    default: return 0;
+    }
+}
+
+int TexSimd_DownMipmapRowRGBA(uint8_t *out, uint8_t const *row1, uint8_t const *row2,
+                              int outCount)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_TEXSIMD_X86
+    case SIMD_AVX2:
+    case SIMD_SSE2: return downMipmapRowSSE2(out, row1, row2, outCount);
+#endif
+#ifdef DENG_TEXSIMD_NEON
+    case SIMD_NEON: return downMipmapRowNEON(out, row1, row2, outCount);
+#endif
+    default: return 0;
+    }
+}
+
+long TexSimd_DesaturateRGBA(uint8_t *pixels, long count)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_TEXSIMD_X86
+    case SIMD_AVX2:
+    case SIMD_SSE2: return desaturateSSE2(pixels, count);
+#endif
+#ifdef DENG_TEXSIMD_NEON
+    case SIMD_NEON: return desaturateNEON(pixels, count);
+#endif
+    default: return 0;
+    }
+}
+
+long TexSimd_ColorKeyRGBA(uint8_t *pixels, long count)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_TEXSIMD_X86
+    case SIMD_AVX2:
+    case SIMD_SSE2: return colorKeySSE2(pixels, count);
+#endif
+#ifdef DENG_TEXSIMD_NEON
+    case SIMD_NEON: return colorKeyNEON(pixels, count);
+#endif
+    default: return 0;
+    }
+}
+
+long TexSimd_SumRGBA(uint8_t const *pixels, long count, long sums[3])
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_TEXSIMD_X86
+    case SIMD_AVX2:
+    case SIMD_SSE2: return sumRGBASSE2(pixels, count, sums);
+#endif
+#ifdef DENG_TEXSIMD_NEON
+    case SIMD_NEON: return sumRGBANEON(pixels, count, sums);
+#endif
+    default: return 0;
+    }
+}
+
+int TexSimd_Hq2xPatterns(uint8_t *patterns, uint32_t const *keys, int stride, int count,
+                         uint32_t thresholds)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_TEXSIMD_X86
+    case SIMD_AVX2: return hq2xPatternsAVX2(patterns, keys, stride, count, thresholds);
+    case SIMD_SSE2: return hq2xPatternsSSE2(patterns, keys, stride, count, thresholds);
+#endif
+#ifdef DENG_TEXSIMD_NEON
+    case SIMD_NEON: return hq2xPatternsNEON(patterns, keys, stride, count, thresholds);
+#endif
+    default: return 0;
+    }
+}
@@ -0,0 +1,198 @@
+/** @file texkernelbench.cpp  Benchmark of the texture image kernels.
+ *
+ * The kernels are run with the plain scalar loops and with the best SIMD
+ * instruction set supported by the CPU, and their outputs compared.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2005-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de_base.h"
+#include "gl/gl_tex.h"
+#include "gl/gl_texsimd.h"
+#include "dd_main.h"
+
+#include <doomsday/console/cmd.h>
+#include <doomsday/resource/colorpalettes.h>
+#include <de/LogBuffer>
+#include <de/Time>
+#include <de/memory.h>
+#include <functional>
+
+#include "render/rend_main.h"
+#include "resource/clientresources.h"
+#include "resource/hq2x.h"
+#include "resource/image.h"
+#include "ClientTexture"
+#include "MaterialVariantSpec"
+
+using namespace de;
+
+static inline ClientResources &resSys()
+{
+    return App_Resources();
+}
+
+/**
+ * Times the CPU image processing routines used when preparing textures with the
+ * scalar loops against the best SIMD instruction set supported by the CPU, using
+ * the original map textures and flats (converted to RGBA) as input. The outputs
+ * of the two are also compared.
+ */
+D_CMD(BenchmarkTextureKernels)
+{
+    DENG2_UNUSED3(src, argc, argv);
+
+    enum {
+        Scale, DownMipmap, Desaturation, ColorKeying, AverageColor, AverageLineColor,
+        SmartFilter, KernelCount
+    };
+    static char const *kernelNames[KernelCount] = {
+        "GL_ScaleBuffer (2x)", "GL_DownMipmap32", "Desaturate", "ApplyColorKeying",
+        "FindAverageColor", "FindAverageLineColor", "GL_SmartFilterHQ2x"
+    };
+    ddouble scalarSeconds[KernelCount] = {};
+    ddouble simdSeconds[KernelCount] = {};
+    dint mismatches[KernelCount] = {};
+    dint64 pixelCount = 0;
+    dint imageCount = 0;
+
+    simdlevel_t const oldLevel  = Simd_Level();
+    simdlevel_t const simdLevel = Simd_BestLevel();
+    if(simdLevel == SIMD_SCALAR)
+    {
+        LOG_GL_WARNING("No SIMD instruction set is available for the texture kernels");
+        return false;
+    }
+
+    /*
+     * Runs a kernel with both instruction sets. Each run processes its own copy
+     * of @a input, and the results are compared.
+     */
+    auto compare = [&] (dint kernel, Block const &input, std::function<Block (Block &)> func)
+    {
+        Block scalarData = input;
+        Block simdData   = input;
+        {
+            Simd_SetLevel(SIMD_SCALAR);
+            Time const begunAt;
+            scalarData = func(scalarData);
+            scalarSeconds[kernel] += begunAt.since();
+        }
+        {
+            Simd_SetLevel(simdLevel);
+            Time const begunAt;
+            simdData = func(simdData);
+            simdSeconds[kernel] += begunAt.since();
+        }
+        if(scalarData != simdData) mismatches[kernel]++;
+    };
+    auto colorBlock = [] (ColorRawf const &color)
+    {
+        return Block(&color, sizeof(color));
+    };
+
+    TextureVariantSpec const &spec = *Rend_MapSurfaceMaterialSpec().primarySpec;
+    for(res::Texture *tex : resSys().textures().allTextures())
+    {
+        String const schemeName = tex->manifest().schemeName();
+        if(schemeName.compareWithoutCase("Textures") && schemeName.compareWithoutCase("Flats"))
+            continue;
+
+        image_t image;
+        Image_Init(image);
+        if(GL_LoadSourceImage(image, static_cast<ClientTexture &>(*tex), spec) == res::None ||
+           !image.paletteId || image.pixelSize > 2)
+        {
+            Image_ClearPixelData(image);
+            continue;
+        }
+
+        dint const width  = image.size.x;
+        dint const height = image.size.y;
+        dint const numPels = width * height;
+        res::ColorPalette const &palette = resSys().colorPalettes().colorPalette(image.paletteId);
+
+        Block rgba(4 * numPels);
+        GL_PalettizeImage(rgba.data(), 4, &palette, false, image.pixels, image.pixelSize, width, height);
+        Image_ClearPixelData(image);
+
+        compare(Scale, rgba, [&] (Block &pixels) {
+            uint8_t *scaled = GL_ScaleBuffer(pixels.data(), width, height, 4,
+                                             width * 2, height * 2);
+            Block out(scaled, 4 * numPels * 4);
+            M_Free(scaled);
+            return out;
+        });
+        if(width > 1 || height > 1)
+        {
+            dsize const mipSize = 4 * de::max(1, width >> 1) * de::max(1, height >> 1);
+            compare(DownMipmap, rgba, [&] (Block &pixels) {
+                GL_DownMipmap32(pixels.data(), width, height, 4);
+                return pixels.left(mipSize);
+            });
+        }
+        compare(Desaturation, rgba, [&] (Block &pixels) {
+            Desaturate(pixels.data(), width, height, 4);
+            return pixels;
+        });
+        // Keying is done in the buffer for RGBA, so no new one is allocated.
+        compare(ColorKeying, rgba, [&] (Block &pixels) {
+            ApplyColorKeying(pixels.data(), width, height, 4);
+            return pixels;
+        });
+        compare(AverageColor, rgba, [&] (Block &pixels) {
+            ColorRawf color;
+            FindAverageColor(pixels.data(), width, height, 4, &color);
+            return colorBlock(color);
+        });
+        compare(AverageLineColor, rgba, [&] (Block &pixels) {
+            Block colors;
+            for(dint line = 0; line < height; ++line)
+            {
+                ColorRawf color;
+                FindAverageLineColor(pixels.data(), width, height, 4, line, &color);
+                colors += colorBlock(color);
+            }
+            return colors;
+        });
+        compare(SmartFilter, rgba, [&] (Block &pixels) {
+            uint8_t *filtered = GL_SmartFilterHQ2x(pixels.data(), width, height,
+                                                   ICF_UPSCALE_SAMPLE_WRAP);
+            Block out(filtered, 4 * numPels * 4);
+            M_Free(filtered);
+            return out;
+        });
+
+        pixelCount += numPels;
+        imageCount++;
+    }
+    Simd_SetLevel(oldLevel);
+
+    LOG_GL_MSG("Processed %i images (%i pixels), scalar vs. %s:")
+            << imageCount << pixelCount << Simd_LevelName(simdLevel);
+    for(dint i = 0; i < KernelCount; ++i)
+    {
+        LOG_GL_MSG("  %s: %.1f ms vs. " _E(b) "%.1f" _E(.) " ms (%.2fx)")
+                << kernelNames[i] << scalarSeconds[i] * 1000 << simdSeconds[i] * 1000
+                << (simdSeconds[i] > 0? scalarSeconds[i] / simdSeconds[i] : 0.0);
+        if(mismatches[i])
+        {
+            LOG_GL_WARNING("  %s: output differs in %i images") << kernelNames[i] << mismatches[i];
+        }
+    }
+    return true;
+}
@@ -317,11 +317,36 @@ static dgltexformat_t prepareImageAsDetailTexture(image_t &image,
     return DGL_LUMINANCE;
 }
 
-void GL_PrepareTextureContent(texturecontent_t &c,
-                              GLuint glTexName,
-                              image_t &image,
-                              TextureVariantSpec const &spec,
-                              res::TextureManifest const &textureManifest)
+dgltexformat_t GL_PrepareTextureImage(image_t &image, TextureVariantSpec const &spec,
+                                      Vector3f &lumaFactors)
+{
+    DENG_ASSERT(image.pixels != 0);
+
+    lumaFactors = Vector3f(1, 1, 1);
+
+    switch (spec.type)
+    {
+    case TST_GENERAL:
+        return prepareImageAsTexture(image, spec.variant);
+
+    case TST_DETAIL:
+        return prepareImageAsDetailTexture(image, spec.detailVariant,
+                                           &lumaFactors.x, &lumaFactors.y, &lumaFactors.z);
+
+    default:
+        // Invalid spec type.
+        DENG_ASSERT(false);
+    }
+    return DGL_RGBA;
+}
+
+void GL_ConfigureTextureContent(texturecontent_t &c,
+                                GLuint glTexName,
+                                image_t const &image,
+                                dgltexformat_t dglFormat,
+                                Vector3f const &lumaFactors,
+                                TextureVariantSpec const &spec,
+                                res::TextureManifest const &textureManifest)
 {
     DENG_ASSERT(glTexName != 0);
     DENG_ASSERT(image.pixels != 0);
@@ -339,9 +364,6 @@ void GL_PrepareTextureContent(texturecontent_t &c,
         // implicitly by prepareImageAsTexture(), so don't do it again.
         bool const noSmartFilter = (vspec.flags & TSF_UPSCALE_AND_SHARPEN) != 0;
 
-        // Prepare the image for upload.
-        dgltexformat_t dglFormat = prepareImageAsTexture(image, vspec);
-
         // Configure the texture content.
         c.format      = dglFormat;
         c.width       = image.size.x;
@@ -365,10 +387,9 @@ void GL_PrepareTextureContent(texturecontent_t &c,
 
     case TST_DETAIL: {
         detailvariantspecification_t const &dspec = spec.detailVariant;
-
-        // Prepare the image for upload.
-        float baMul, hiMul, loMul;
-        dgltexformat_t dglFormat = prepareImageAsDetailTexture(image, dspec, &baMul, &hiMul, &loMul);
+        float const baMul = lumaFactors.x;
+        float const hiMul = lumaFactors.y;
+        float const loMul = lumaFactors.z;
 
         // Determine the gray mipmap factor.
         int grayMipmapFactor = dspec.contrast;
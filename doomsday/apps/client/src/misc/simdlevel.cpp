@@ -0,0 +1,112 @@
+/** @file simdlevel.cpp  Runtime selection of the SIMD instruction set.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2005-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "misc/simdlevel.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define DENG_SIMD_X86
+#  ifdef _MSC_VER
+#    include <immintrin.h>
+#    include <intrin.h>
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define DENG_SIMD_NEON
+#endif
+
+static std::atomic<int> simdLevel(-1);
+
+static bool isSupported(simdlevel_t level)
+{
+    switch(level)
+    {
+    case SIMD_SCALAR:
+        return true;
+
+#ifdef DENG_SIMD_X86
+# ifdef _MSC_VER
+    case SIMD_SSE2: {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0; }
+
+    case SIMD_AVX2: {
+        int info[4];
+        __cpuid(info, 0);
+        if(info[0] < 7) return false;
+        __cpuid(info, 1);
+        // The OS must also save the YMM registers on context switches.
+        bool const osxsave = (info[2] & (1 << 27)) != 0;
+        if(!osxsave || (_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0; }
+# else
+    case SIMD_SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2") != 0;
+
+    case SIMD_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+# endif
+#endif
+
+#ifdef DENG_SIMD_NEON
+    case SIMD_NEON:
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+simdlevel_t Simd_BestLevel(void)
+{
+    if(isSupported(SIMD_AVX2)) return SIMD_AVX2;
+    if(isSupported(SIMD_SSE2)) return SIMD_SSE2;
+    if(isSupported(SIMD_NEON)) return SIMD_NEON;
+    return SIMD_SCALAR;
+}
+
+simdlevel_t Simd_Level(void)
+{
+    int level = simdLevel.load(std::memory_order_relaxed);
+    if(level < 0)
+    {
+        level = Simd_BestLevel();
+        simdLevel.store(level, std::memory_order_relaxed);
+    }
+    return simdlevel_t(level);
+}
+
+dd_bool Simd_SetLevel(simdlevel_t level)
+{
+    if(!isSupported(level)) return false;
+    simdLevel.store(level, std::memory_order_relaxed);
+    return true;
+}
+
+char const *Simd_LevelName(simdlevel_t level)
+{
+    static char const *names[SIMDLEVEL_COUNT] = { "scalar", "SSE2", "AVX2", "NEON" };
+    if(level < 0 || level >= SIMDLEVEL_COUNT) return "(invalid)";
+    return names[level];
+}
@@ -27,36 +27,157 @@
 #include <de/timer.h>
 #include <de/ByteRefArray>
 #include <de/Loop>
+#include <atomic>
+#include <memory>
+#include <new>
 
 #ifdef __CLIENT__
 #  include "network/sys_network.h"
 #endif
 #include "network/masterserver.h"
 #include "network/net_event.h"
+#include "network/net_main.h"
 #ifdef __CLIENT__
 #  include "network/serverlink.h"
 #endif
 
 #ifdef __SERVER__
 #  include "serversystem.h"
+#  include "remoteuser.h"
 #endif
 
 #include "world/p_players.h"
 
 using namespace de;
 
-#define MSG_MUTEX_NAME  "MsgQueueMutex"
-
 dd_bool allowSending;
 netbuffer_t netBuffer;
 
-// The message queue: list of incoming messages waiting for processing.
-static netmessage_t *msgHead, *msgTail;
-static dint entryCount;
+/**
+ * Pooled memory for a received message. The payload is stored right after the
+ * PooledMessage in the same allocation.
+ */
+struct PooledMessage
+{
+    netmessage_t msg;
+    std::atomic<PooledMessage *> next;  ///< Next in the message queue or in the pool.
+    dint sizeClass;                     ///< Index of the pool, or -1 if not pooled.
+};
+
+/// Payload capacities of the pooled messages. Larger messages are not pooled.
+static dsize const MESSAGE_SIZE_CLASSES[] = { 256, 1024, 4096, 16384, 65536 };
+static dint const MESSAGE_SIZE_CLASS_COUNT = dint(sizeof(MESSAGE_SIZE_CLASSES) / sizeof(dsize));
+
+/// Maximum number of unused messages kept in each pool.
+static dint const MESSAGE_POOL_LIMIT = 256;
+
+/**
+ * Unused messages of one size class. Messages are released only in the main thread
+ * but may be allocated in any thread. Taking a message out of the pool is limited to
+ * one thread at a time, which rules out the ABA problem of lock-free stacks; if the
+ * pool is busy, a new message is allocated instead.
+ */
+struct MessagePool
+{
+    std::atomic<PooledMessage *> top { nullptr };
+    std::atomic<dint> count { 0 };
+    std::atomic_flag taking = ATOMIC_FLAG_INIT;
 
-// A mutex is used to protect the addition and removal of messages from
-// the message queue.
-static mutex_t msgMutex;
+    PooledMessage *take()
+    {
+        if (taking.test_and_set(std::memory_order_acquire)) return nullptr;
+
+        PooledMessage *msg = top.load(std::memory_order_acquire);
+        while (msg && !top.compare_exchange_weak(msg, msg->next.load(std::memory_order_relaxed),
+                                                 std::memory_order_acquire))
+        {}
+        taking.clear(std::memory_order_release);
+
+        if (msg) count--;
+        return msg;
+    }
+
+    bool put(PooledMessage *msg)
+    {
+        if (count >= MESSAGE_POOL_LIMIT) return false;
+        count++;
+
+        PooledMessage *old = top.load(std::memory_order_relaxed);
+        do { msg->next.store(old, std::memory_order_relaxed); }
+        while (!top.compare_exchange_weak(old, msg, std::memory_order_release,
+                                          std::memory_order_relaxed));
+        return true;
+    }
+};
+
+static MessagePool msgPools[MESSAGE_SIZE_CLASS_COUNT];
+
+/**
+ * The message queue: received messages waiting for processing. This is a lock-free
+ * multiple producer, single consumer queue (by Dmitry Vyukov). Messages are posted
+ * at the head and read from the tail. The stub node is needed so that the queue is
+ * never empty.
+ */
+static struct MessageQueue
+{
+    PooledMessage stub;
+    std::atomic<PooledMessage *> head;
+    PooledMessage *tail;      ///< Only accessed by the reader.
+    PooledMessage *delayed;   ///< Oldest message whose reception is being delayed.
+
+    MessageQueue() : head(&stub), tail(&stub), delayed(nullptr)
+    {
+        stub.next = nullptr;
+    }
+
+    void push(PooledMessage *msg)
+    {
+        msg->next.store(nullptr, std::memory_order_relaxed);
+        PooledMessage *prev = head.exchange(msg, std::memory_order_acq_rel);
+        prev->next.store(msg, std::memory_order_release);
+    }
+
+    PooledMessage *pop()
+    {
+        PooledMessage *last = tail;
+        PooledMessage *next = last->next.load(std::memory_order_acquire);
+        if (last == &stub)
+        {
+            if (!next) return nullptr; // Empty.
+            tail = last = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next)
+        {
+            tail = next;
+            return last;
+        }
+        if (last != head.load(std::memory_order_acquire))
+        {
+            // A message is being posted right now; it will be available soon.
+            return nullptr;
+        }
+        push(&stub);
+        next = last->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            tail = next;
+            return last;
+        }
+        return nullptr;
+    }
+} msgQueue;
+
+/// Statistics about the message queue and buffers.
+static struct MessageStats
+{
+    std::atomic<dint> queued    { 0 };
+    std::atomic<dint> peakQueued{ 0 };
+    std::atomic<duint64> posted { 0 };
+    std::atomic<duint64> recycled { 0 };
+    std::atomic<duint64> allocated { 0 };
+    std::atomic<duint64> oversized { 0 };
+} msgStats;
 
 reader_s *Reader_NewWithNetworkBuffer()
 {
@@ -65,9 +186,6 @@ reader_s *Reader_NewWithNetworkBuffer()
 
 void N_Init()
 {
-    // Create a mutex for the message queue.
-    ::msgMutex = Sys_CreateMutex(MSG_MUTEX_NAME);
-
     ::allowSending = false;
 
     //N_SockInit();
@@ -83,54 +201,79 @@ void N_Shutdown()
 
     ::allowSending = false;
 
-    // Close the handle of the message queue mutex.
-    Sys_DestroyMutex(msgMutex);
-    msgMutex = 0;
+    // Free the recycled message buffers.
+    for (MessagePool &pool : msgPools)
+    {
+        while (PooledMessage *msg = pool.take())
+        {
+            M_Free(msg);
+        }
+    }
 }
 
-/**
- * Acquire or release ownership of the message queue mutex.
- *
- * @return  @c true if successful.
- */
-static dd_bool N_LockQueue(dd_bool doAcquire)
+static dint sizeClassForMessage(dsize size)
 {
-    if(doAcquire)
-        Sys_Lock(msgMutex);
-    else
-        Sys_Unlock(msgMutex);
-    return true;
+    for (dint i = 0; i < MESSAGE_SIZE_CLASS_COUNT; ++i)
+    {
+        if (size <= MESSAGE_SIZE_CLASSES[i]) return i;
+    }
+    return -1;
 }
 
-void N_PostMessage(netmessage_t *msg)
+netmessage_t *N_NewMessage(size_t size)
 {
-    DENG2_ASSERT(msg);
+    dint const sizeClass = sizeClassForMessage(size);
 
-    N_LockQueue(true);
+    PooledMessage *pooled = (sizeClass >= 0? msgPools[sizeClass].take() : nullptr);
+    if (pooled)
+    {
+        msgStats.recycled++;
+    }
+    else
+    {
+        dsize const capacity = (sizeClass >= 0? MESSAGE_SIZE_CLASSES[sizeClass] : size);
+        pooled = new (M_Malloc(sizeof(PooledMessage) + capacity)) PooledMessage;
+        pooled->sizeClass = sizeClass;
+        msgStats.allocated++;
+        if (sizeClass < 0) msgStats.oversized++;
+    }
 
-    // This will be the latest message.
-    msg->next = nullptr;
+    netmessage_t *msg = &pooled->msg;
+    std::memset(msg, 0, sizeof(*msg));
+    msg->size   = size;
+    msg->data   = reinterpret_cast<byte *>(pooled + 1);
+    msg->handle = pooled;
+    return msg;
+}
 
-    // Set the timestamp for reception.
-    msg->receivedAt = Timer_RealSeconds();
+static void N_ReleaseMessage(netmessage_t *msg)
+{
+    DENG2_ASSERT(msg);
+    PooledMessage *pooled = reinterpret_cast<PooledMessage *>(msg->handle);
+    DENG2_ASSERT(&pooled->msg == msg);
 
-    if(::msgTail)
+    if (pooled->sizeClass < 0 || !msgPools[pooled->sizeClass].put(pooled))
     {
-        // There are previous messages.
-        ::msgTail->next = msg;
+        pooled->~PooledMessage();
+        M_Free(pooled);
     }
+}
 
-    // The tail pointer points to the last message.
-    ::msgTail = msg;
+void N_PostMessage(netmessage_t *msg)
+{
+    DENG2_ASSERT(msg);
+    DENG2_ASSERT(msg->handle);
 
-    // If there is no head, this'll be the first message.
-    if(::msgHead == nullptr)
-        ::msgHead = msg;
+    // Set the timestamp for reception.
+    msg->receivedAt = Timer_RealSeconds();
 
     // One new message available.
-    ::entryCount++;
+    dint const queued = ++msgStats.queued;
+    dint peak = msgStats.peakQueued;
+    while (queued > peak && !msgStats.peakQueued.compare_exchange_weak(peak, queued)) {}
+    msgStats.posted++;
 
-    N_LockQueue(false);
+    msgQueue.push(reinterpret_cast<PooledMessage *>(msg->handle));
 }
 
 /**
@@ -138,69 +281,40 @@ void N_PostMessage(netmessage_t *msg)
  * The caller must release the message when it's no longer needed,
  * using N_ReleaseMessage().
  *
- * We use a mutex to synchronize access to the message queue. This is
- * called in the Doomsday thread.
+ * This is called in the main thread, which is the only reader of the queue.
  *
  * @return  @c nullptr if no message is found.
  */
 static netmessage_t *N_GetMessage()
 {
-    // This is the message we'll return.
-    netmessage_t *msg = nullptr;
-
-    N_LockQueue(true);
-    if(::msgHead != nullptr)
+    PooledMessage *pooled = msgQueue.delayed;
+    if (!pooled)
     {
-        msg = ::msgHead;
-
-        // Check for simulated latency.
-        if(::netSimulatedLatencySeconds > 0 &&
-           (Timer_RealSeconds() - msg->receivedAt < ::netSimulatedLatencySeconds))
-        {
-            // This message has not been received yet.
-            msg = nullptr;
-        }
-        else
-        {
-            // If there are no more messages, the tail pointer must be cleared, too.
-            if(!::msgHead->next)
-                ::msgTail = nullptr;
-
-            // Advance the head pointer.
-            ::msgHead = ::msgHead->next;
-
-            if(msg)
-            {
-                // One less message available.
-                ::entryCount--;
-            }
-        }
+        pooled = msgQueue.pop();
+        if (!pooled) return nullptr;
     }
-    N_LockQueue(false);
 
-    // Identify the sender.
-    if(msg)
+    // Check for simulated latency.
+    if (::netSimulatedLatencySeconds > 0 &&
+        (Timer_RealSeconds() - pooled->msg.receivedAt < ::netSimulatedLatencySeconds))
     {
-        msg->player = N_IdentifyPlayer(msg->sender);
+        // This message has not been received yet.
+        msgQueue.delayed = pooled;
+        return nullptr;
     }
-    return msg;
-}
+    msgQueue.delayed = nullptr;
 
-static void N_ReleaseMessage(netmessage_t *msg)
-{
-    DENG2_ASSERT(msg);
-    if(msg->handle)
-    {
-        delete [] reinterpret_cast<byte *>(msg->handle);
-        msg->handle = nullptr;
-    }
-    M_Free(msg);
+    // One less message available.
+    msgStats.queued--;
+
+    // Identify the sender.
+    netmessage_t *msg = &pooled->msg;
+    msg->player = N_IdentifyPlayer(msg->sender);
+    return msg;
 }
 
 void N_ClearMessages()
 {
-    if(!msgMutex) return;  // Not initialized yet.
-
     dfloat const oldSim = ::netSimulatedLatencySeconds;
 
     // No simulated latency now.
@@ -213,10 +327,6 @@ void N_ClearMessages()
     }
 
     ::netSimulatedLatencySeconds = oldSim;
-
-    // The queue is now empty.
-    ::msgHead = ::msgTail = nullptr;
-    ::entryCount = 0;
 }
 
 void N_SendPacket(dint flags)
@@ -246,14 +356,42 @@ void N_SendPacket(dint flags)
         }
         else
         {
-            // Broadcast to all non-local players, using recursive calls.
+            // Broadcast to all non-local players. The message is compressed
+            // only once and the same data is sent to everyone. Users with the
+            // preset deflate dictionary need their own version of the message.
+            de::ByteRefArray const data(&::netBuffer.msg, ::netBuffer.headerLength + ::netBuffer.length);
+            std::unique_ptr<Socket::PreparedMessage> plain;
+            std::unique_ptr<Socket::PreparedMessage> withDictionary;
+
             for(dint i = 0; i < DDMAXPLAYERS; ++i)
             {
-                ::netBuffer.player = i;
-                N_SendPacket(flags);
+                // Do not send anything to disconnected players.
+                if(!DD_Player(i)->isConnected()) continue;
+
+                try
+                {
+                    RemoteUser &user = App_ServerSystem().user(DD_Player(i)->remoteUserId);
+                    if(user.usesDeflateDictionary())
+                    {
+                        if(!withDictionary)
+                        {
+                            withDictionary.reset(new Socket::PreparedMessage(data, Net_DeflateDictionary()));
+                        }
+                        user.send(*withDictionary);
+                    }
+                    else
+                    {
+                        if(!plain) plain.reset(new Socket::PreparedMessage(data));
+                        user.send(*plain);
+                    }
+                }
+                catch(Error const &er)
+                {
+                    LOGDEV_NET_WARNING("N_SendPacket failed: ") << er.asText();
+                }
             }
 
-            // Reset back to -1 to notify of the broadcast.
+            // Keep -1 to notify of the broadcast.
             ::netBuffer.player = NSP_BROADCAST;
             return;
         }
@@ -360,6 +498,27 @@ void N_PrintBufferInfo()
 {
     N_PrintTransmissionStats();
 
+    LOG_NET_MSG("Message queue: %i waiting (peak %i), %i received in total")
+            << msgStats.queued.load()
+            << msgStats.peakQueued.load()
+            << msgStats.posted.load();
+
+    dint pooledCount = 0;
+    dsize pooledBytes = 0;
+    for (dint i = 0; i < MESSAGE_SIZE_CLASS_COUNT; ++i)
+    {
+        dint const count = msgPools[i].count;
+        pooledCount += count;
+        pooledBytes += dsize(count) * (sizeof(PooledMessage) + MESSAGE_SIZE_CLASSES[i]);
+    }
+    LOG_NET_MSG("Message buffers: %i recycled, %i allocated (%i oversized); "
+                "%i unused in pools (%.1f KB)")
+            << msgStats.recycled.load()
+            << msgStats.allocated.load()
+            << msgStats.oversized.load()
+            << pooledCount
+            << pooledBytes / 1000.0;
+
     double const loopRate = Loop::get().rate();
     if (loopRate > 0)
     {
@@ -26,6 +26,8 @@
 #include <de/concurrency.h>
 #include <de/timer.h>
 #include <de/charsymbols.h>
+#include <de/App>
+#include <de/Folder>
 #include <de/Value>
 #include <de/Version>
 #include <doomsday/console/cmd.h>
@@ -839,6 +841,31 @@ String Net_UserAgent()
     return Version::currentBuild().userAgent();
 }
 
+Block Net_DeflateDictionary()
+{
+    static bool loaded = false;
+    static Block dictionary;
+
+    if (!loaded)
+    {
+        loaded = true;
+        try
+        {
+            if (File const *file = App::rootFolder().tryLocate<File const>(
+                    "/packs/net.dengine.base/netdeltas.dict"))
+            {
+                *file >> dictionary;
+            }
+        }
+        catch (Error const &er)
+        {
+            LOG_NET_WARNING("Failed to load the network deflate dictionary: %s") << er.asText();
+            dictionary.clear();
+        }
+    }
+    return dictionary;
+}
+
 /**
  * Composes a PKT_CHAT network message.
  */
@@ -232,6 +232,7 @@ DENG2_PIMPL(ServerLink)
 
         // G'day mate!  The client is responsible for beginning the handshake.
         Cl_SendHello();
+        Cl_OfferDeflateDictionary();
 
         return true;
     }
@@ -781,13 +782,9 @@ void ServerLink::handleIncomingPackets()
             /// @todo The incoming packets should be handled immediately.
 
             // Post the data into the queue.
-            netmessage_t *msg = reinterpret_cast<netmessage_t *>(M_Calloc(sizeof(netmessage_t)));
-
+            netmessage_t *msg = N_NewMessage(packetData.size());
             msg->sender = 0; // the server
-            msg->data = new byte[packetData.size()];
-            memcpy(msg->data, packetData.data(), packetData.size());
-            msg->size = packetData.size();
-            msg->handle = msg->data; // needs delete[]
+            memcpy(msg->data, packetData.data(), msg->size);
 
             // The message queue will handle the message from now on.
             N_PostMessage(msg);
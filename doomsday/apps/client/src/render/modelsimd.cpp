@@ -0,0 +1,438 @@
+/** @file modelsimd.cpp  Vectorized frame model vertex kernels.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2007-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "render/modelsimd.h"
+#include "misc/simdlevel.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define DENG_MODELSIMD_X86
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    define MODELSIMD_TARGET(isa)
+#  else
+#    define MODELSIMD_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+      (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+   // Colors are packed as little-endian 32-bit words.
+#  define DENG_MODELSIMD_NEON
+#  include <arm_neon.h>
+#endif
+
+/*
+ * The kernels use the same operations in the same order as the scalar loops in
+ * rend_model.cpp, and no fused multiply-adds, so the results are bit-identical.
+ * Products of two floats are exact in double precision, so the scalar code's
+ * promotions to double (e.g., Vector3f * float) round the same way as a float
+ * multiply. Min/max follow de::min()/de::max(): the second operand is returned
+ * unless the comparison holds.
+ *
+ * In the interpolation kernels each vertex is processed with unaligned 4-wide
+ * loads and stores that reach one float into the next vertex. The vectors are
+ * written in ascending order, so the overlapping float is overwritten by the
+ * next vertex; the last vertex is left for the scalar loop.
+ */
+
+#ifdef DENG_MODELSIMD_X86
+
+MODELSIMD_TARGET("sse2")
+static int lerpVerticesSSE2(float *posOut, float *normOut, float const *from,
+                            float const *to, int count, float inter)
+{
+    __m128 const w  = _mm_set1_ps(inter);
+    __m128 const w1 = _mm_set1_ps(1.f - inter);
+    int i = 0;
+    for(; i + 1 < count; ++i, from += 6, to += 6, posOut += 3, normOut += 3)
+    {
+        __m128 const pos  = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(to),     w),
+                                       _mm_mul_ps(_mm_loadu_ps(from),     w1));
+        __m128 const norm = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(to + 3), w),
+                                       _mm_mul_ps(_mm_loadu_ps(from + 3), w1));
+        _mm_storeu_ps(posOut,  pos);
+        _mm_storeu_ps(normOut, norm);
+    }
+    return i;
+}
+
+MODELSIMD_TARGET("avx2")
+static int lerpVerticesAVX2(float *posOut, float *normOut, float const *from,
+                            float const *to, int count, float inter)
+{
+    __m256 const w  = _mm256_set1_ps(inter);
+    __m256 const w1 = _mm256_set1_ps(1.f - inter);
+    // [pos, norm, next pos.xy] => [pos, -, norm, -]
+    __m256i const split = _mm256_setr_epi32(0, 1, 2, 6, 3, 4, 5, 7);
+    int i = 0;
+    for(; i + 1 < count; ++i, from += 6, to += 6, posOut += 3, normOut += 3)
+    {
+        __m256 const v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(to),   w),
+                                       _mm256_mul_ps(_mm256_loadu_ps(from), w1));
+        __m256 const out = _mm256_permutevar8x32_ps(v, split);
+        _mm_storeu_ps(posOut,  _mm256_castps256_ps128(out));
+        _mm_storeu_ps(normOut, _mm256_extractf128_ps(out, 1));
+    }
+    return i;
+}
+
+/**
+ * Loads the components of four consecutive vectors into separate registers.
+ */
+MODELSIMD_TARGET("sse2")
+static inline void loadVectorsSSE2(float const *vecs, __m128 &x, __m128 &y, __m128 &z)
+{
+    __m128 const a = _mm_loadu_ps(vecs);     // x0 y0 z0 x1
+    __m128 const b = _mm_loadu_ps(vecs + 4); // y1 z1 x2 y2
+    __m128 const c = _mm_loadu_ps(vecs + 8); // z2 x3 y3 z3
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                       _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+/**
+ * Loads the components of eight consecutive vectors into separate registers.
+ */
+MODELSIMD_TARGET("avx2")
+static inline void loadVectorsAVX2(float const *vecs, __m256 &x, __m256 &y, __m256 &z)
+{
+    __m256i const idx = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    x = _mm256_i32gather_ps(vecs,     idx, 4);
+    y = _mm256_i32gather_ps(vecs + 1, idx, 4);
+    z = _mm256_i32gather_ps(vecs + 2, idx, 4);
+}
+
+MODELSIMD_TARGET("sse2")
+static inline __m128i packColorsSSE2(__m128 r, __m128 g, __m128 b, __m128 a)
+{
+    // Converted like dbyte(float): truncated to an integer, keeping the low byte.
+    __m128i const lowByte = _mm_set1_epi32(0xff);
+    __m128 const scale = _mm_set1_ps(255);
+    __m128i const ri = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(r, scale)), lowByte);
+    __m128i const gi = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(g, scale)), lowByte);
+    __m128i const bi = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(b, scale)), lowByte);
+    __m128i const ai = _mm_cvttps_epi32(_mm_mul_ps(a, scale));
+    return _mm_or_si128(_mm_or_si128(ri, _mm_slli_epi32(gi, 8)),
+                        _mm_or_si128(_mm_slli_epi32(bi, 16), _mm_slli_epi32(ai, 24)));
+}
+
+MODELSIMD_TARGET("sse2")
+static int vertexColorsSSE2(uint8_t *out, float const *normals, int count,
+                            modelsimdlight_t const *lights, int numLights,
+                            float const ambient[4])
+{
+    __m128 const zero   = _mm_setzero_ps();
+    __m128 const one    = _mm_set1_ps(1);
+    __m128 const negOne = _mm_set1_ps(-1);
+    __m128 const ambR   = _mm_set1_ps(ambient[0]);
+    __m128 const ambG   = _mm_set1_ps(ambient[1]);
+    __m128 const ambB   = _mm_set1_ps(ambient[2]);
+    __m128 const alpha  = _mm_min_ps(_mm_set1_ps(ambient[3]), one);
+    int i = 0;
+    for(; i + 4 <= count; i += 4, normals += 12, out += 16)
+    {
+        __m128 nx, ny, nz;
+        loadVectorsSSE2(normals, nx, ny, nz);
+
+        // Accumulated [color, extra].
+        __m128 accR[2] = { zero, zero }, accG[2] = { zero, zero }, accB[2] = { zero, zero };
+        for(int k = 0; k < numLights; ++k)
+        {
+            modelsimdlight_t const &light = lights[k];
+            __m128 strength = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(light.direction[0]), nx),
+                                                    _mm_mul_ps(_mm_set1_ps(light.direction[1]), ny)),
+                                         _mm_mul_ps(_mm_set1_ps(light.direction[2]), nz));
+            strength = _mm_add_ps(strength, _mm_set1_ps(light.offset));
+
+            __m128 const lit = _mm_cmpgt_ps(strength, zero);
+            strength = _mm_mul_ps(strength,
+                                  _mm_or_ps(_mm_and_ps(lit, _mm_set1_ps(light.lightSide)),
+                                            _mm_andnot_ps(lit, _mm_set1_ps(light.darkSide))));
+            strength = _mm_min_ps(_mm_max_ps(strength, negOne), one);
+
+            int const a = light.accum;
+            accR[a] = _mm_add_ps(accR[a], _mm_mul_ps(_mm_set1_ps(light.color[0]), strength));
+            accG[a] = _mm_add_ps(accG[a], _mm_mul_ps(_mm_set1_ps(light.color[1]), strength));
+            accB[a] = _mm_add_ps(accB[a], _mm_mul_ps(_mm_set1_ps(light.color[2]), strength));
+        }
+
+        __m128 const r = _mm_min_ps(_mm_add_ps(_mm_max_ps(accR[0], ambR), accR[1]), one);
+        __m128 const g = _mm_min_ps(_mm_add_ps(_mm_max_ps(accG[0], ambG), accG[1]), one);
+        __m128 const b = _mm_min_ps(_mm_add_ps(_mm_max_ps(accB[0], ambB), accB[1]), one);
+        _mm_storeu_si128((__m128i *) out, packColorsSSE2(r, g, b, alpha));
+    }
+    return i;
+}
+
+MODELSIMD_TARGET("avx2")
+static int vertexColorsAVX2(uint8_t *out, float const *normals, int count,
+                            modelsimdlight_t const *lights, int numLights,
+                            float const ambient[4])
+{
+    __m256 const zero   = _mm256_setzero_ps();
+    __m256 const one    = _mm256_set1_ps(1);
+    __m256 const negOne = _mm256_set1_ps(-1);
+    __m256 const scale  = _mm256_set1_ps(255);
+    __m256i const lowByte = _mm256_set1_epi32(0xff);
+    __m256 const ambR   = _mm256_set1_ps(ambient[0]);
+    __m256 const ambG   = _mm256_set1_ps(ambient[1]);
+    __m256 const ambB   = _mm256_set1_ps(ambient[2]);
+    __m256i const alpha = _mm256_slli_epi32(_mm256_cvttps_epi32(
+            _mm256_mul_ps(_mm256_min_ps(_mm256_set1_ps(ambient[3]), one), scale)), 24);
+    int i = 0;
+    for(; i + 8 <= count; i += 8, normals += 24, out += 32)
+    {
+        __m256 nx, ny, nz;
+        loadVectorsAVX2(normals, nx, ny, nz);
+
+        // Accumulated [color, extra].
+        __m256 accR[2] = { zero, zero }, accG[2] = { zero, zero }, accB[2] = { zero, zero };
+        for(int k = 0; k < numLights; ++k)
+        {
+            modelsimdlight_t const &light = lights[k];
+            __m256 strength = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(light.direction[0]), nx),
+                                  _mm256_mul_ps(_mm256_set1_ps(light.direction[1]), ny)),
+                    _mm256_mul_ps(_mm256_set1_ps(light.direction[2]), nz));
+            strength = _mm256_add_ps(strength, _mm256_set1_ps(light.offset));
+
+            __m256 const lit = _mm256_cmp_ps(strength, zero, _CMP_GT_OQ);
+            strength = _mm256_mul_ps(strength, _mm256_blendv_ps(_mm256_set1_ps(light.darkSide),
+                                                                _mm256_set1_ps(light.lightSide),
+                                                                lit));
+            strength = _mm256_min_ps(_mm256_max_ps(strength, negOne), one);
+
+            int const a = light.accum;
+            accR[a] = _mm256_add_ps(accR[a], _mm256_mul_ps(_mm256_set1_ps(light.color[0]), strength));
+            accG[a] = _mm256_add_ps(accG[a], _mm256_mul_ps(_mm256_set1_ps(light.color[1]), strength));
+            accB[a] = _mm256_add_ps(accB[a], _mm256_mul_ps(_mm256_set1_ps(light.color[2]), strength));
+        }
+
+        __m256 const r = _mm256_min_ps(_mm256_add_ps(_mm256_max_ps(accR[0], ambR), accR[1]), one);
+        __m256 const g = _mm256_min_ps(_mm256_add_ps(_mm256_max_ps(accG[0], ambG), accG[1]), one);
+        __m256 const b = _mm256_min_ps(_mm256_add_ps(_mm256_max_ps(accB[0], ambB), accB[1]), one);
+        __m256i const ri = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(r, scale)), lowByte);
+        __m256i const gi = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(g, scale)), lowByte);
+        __m256i const bi = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(b, scale)), lowByte);
+        _mm256_storeu_si256((__m256i *) out,
+                            _mm256_or_si256(_mm256_or_si256(ri, _mm256_slli_epi32(gi, 8)),
+                                            _mm256_or_si256(_mm256_slli_epi32(bi, 16), alpha)));
+    }
+    return i;
+}
+
+MODELSIMD_TARGET("sse2")
+static int shinyCoordsSSE2(float *out, float const *normals, int count,
+                           float yawCos, float yawSin, float pitchCos, float pitchSin)
+{
+    __m128 const yc = _mm_set1_ps(yawCos),   ys = _mm_set1_ps(yawSin);
+    __m128 const pc = _mm_set1_ps(pitchCos), ps = _mm_set1_ps(pitchSin);
+    __m128 const negPs = _mm_set1_ps(-pitchSin);
+    __m128 const one = _mm_set1_ps(1);
+    int i = 0;
+    for(; i + 4 <= count; i += 4, normals += 12, out += 8)
+    {
+        __m128 nx, ny, nz;
+        loadVectorsSSE2(normals, nx, ny, nz);
+
+        __m128 const x = _mm_add_ps(_mm_mul_ps(nx, yc), _mm_mul_ps(ny, ys));
+        __m128 const s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nz, negPs), _mm_mul_ps(x, pc)), one);
+        __m128 const t = _mm_add_ps(_mm_mul_ps(nz, pc), _mm_mul_ps(x, ps));
+        _mm_storeu_ps(out,     _mm_unpacklo_ps(s, t));
+        _mm_storeu_ps(out + 4, _mm_unpackhi_ps(s, t));
+    }
+    return i;
+}
+
+MODELSIMD_TARGET("avx2")
+static int shinyCoordsAVX2(float *out, float const *normals, int count,
+                           float yawCos, float yawSin, float pitchCos, float pitchSin)
+{
+    __m256 const yc = _mm256_set1_ps(yawCos),   ys = _mm256_set1_ps(yawSin);
+    __m256 const pc = _mm256_set1_ps(pitchCos), ps = _mm256_set1_ps(pitchSin);
+    __m256 const negPs = _mm256_set1_ps(-pitchSin);
+    __m256 const one = _mm256_set1_ps(1);
+    int i = 0;
+    for(; i + 8 <= count; i += 8, normals += 24, out += 16)
+    {
+        __m256 nx, ny, nz;
+        loadVectorsAVX2(normals, nx, ny, nz);
+
+        __m256 const x = _mm256_add_ps(_mm256_mul_ps(nx, yc), _mm256_mul_ps(ny, ys));
+        __m256 const s = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nz, negPs),
+                                                     _mm256_mul_ps(x, pc)), one);
+        __m256 const t = _mm256_add_ps(_mm256_mul_ps(nz, pc), _mm256_mul_ps(x, ps));
+        // Unpacking works within 128-bit lanes: lo has vertices 0,1,4,5 and hi 2,3,6,7.
+        __m256 const lo = _mm256_unpacklo_ps(s, t);
+        __m256 const hi = _mm256_unpackhi_ps(s, t);
+        _mm256_storeu_ps(out,     _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    return i;
+}
+
+#endif // DENG_MODELSIMD_X86
+
+#ifdef DENG_MODELSIMD_NEON
+
+static inline float32x4_t minNEON(float32x4_t a, float32x4_t b)
+{
+    return vbslq_f32(vcltq_f32(a, b), a, b); // Same as de::min().
+}
+
+static inline float32x4_t maxNEON(float32x4_t a, float32x4_t b)
+{
+    return vbslq_f32(vcgtq_f32(a, b), a, b); // Same as de::max().
+}
+
+static int lerpVerticesNEON(float *posOut, float *normOut, float const *from,
+                            float const *to, int count, float inter)
+{
+    float32x4_t const w  = vdupq_n_f32(inter);
+    float32x4_t const w1 = vdupq_n_f32(1.f - inter);
+    int i = 0;
+    for(; i + 1 < count; ++i, from += 6, to += 6, posOut += 3, normOut += 3)
+    {
+        vst1q_f32(posOut,  vaddq_f32(vmulq_f32(vld1q_f32(to),     w),
+                                     vmulq_f32(vld1q_f32(from),     w1)));
+        vst1q_f32(normOut, vaddq_f32(vmulq_f32(vld1q_f32(to + 3), w),
+                                     vmulq_f32(vld1q_f32(from + 3), w1)));
+    }
+    return i;
+}
+
+static int vertexColorsNEON(uint8_t *out, float const *normals, int count,
+                            modelsimdlight_t const *lights, int numLights,
+                            float const ambient[4])
+{
+    float32x4_t const zero   = vdupq_n_f32(0);
+    float32x4_t const one    = vdupq_n_f32(1);
+    float32x4_t const negOne = vdupq_n_f32(-1);
+    float32x4_t const scale  = vdupq_n_f32(255);
+    uint32x4_t const lowByte = vdupq_n_u32(0xff);
+    float32x4_t const ambR   = vdupq_n_f32(ambient[0]);
+    float32x4_t const ambG   = vdupq_n_f32(ambient[1]);
+    float32x4_t const ambB   = vdupq_n_f32(ambient[2]);
+    uint32x4_t const alpha   = vshlq_n_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(
+            vmulq_f32(minNEON(vdupq_n_f32(ambient[3]), one), scale))), 24);
+    int i = 0;
+    for(; i + 4 <= count; i += 4, normals += 12, out += 16)
+    {
+        float32x4x3_t const n = vld3q_f32(normals);
+
+        // Accumulated [color, extra].
+        float32x4_t accR[2] = { zero, zero }, accG[2] = { zero, zero }, accB[2] = { zero, zero };
+        for(int k = 0; k < numLights; ++k)
+        {
+            modelsimdlight_t const &light = lights[k];
+            float32x4_t strength = vaddq_f32(vaddq_f32(vmulq_n_f32(n.val[0], light.direction[0]),
+                                                       vmulq_n_f32(n.val[1], light.direction[1])),
+                                             vmulq_n_f32(n.val[2], light.direction[2]));
+            strength = vaddq_f32(strength, vdupq_n_f32(light.offset));
+            strength = vmulq_f32(strength, vbslq_f32(vcgtq_f32(strength, zero),
+                                                     vdupq_n_f32(light.lightSide),
+                                                     vdupq_n_f32(light.darkSide)));
+            strength = minNEON(maxNEON(strength, negOne), one);
+
+            int const a = light.accum;
+            accR[a] = vaddq_f32(accR[a], vmulq_n_f32(strength, light.color[0]));
+            accG[a] = vaddq_f32(accG[a], vmulq_n_f32(strength, light.color[1]));
+            accB[a] = vaddq_f32(accB[a], vmulq_n_f32(strength, light.color[2]));
+        }
+
+        // Converted like dbyte(float): truncated to an integer, keeping the low byte.
+        float32x4_t const r = minNEON(vaddq_f32(maxNEON(accR[0], ambR), accR[1]), one);
+        float32x4_t const g = minNEON(vaddq_f32(maxNEON(accG[0], ambG), accG[1]), one);
+        float32x4_t const b = minNEON(vaddq_f32(maxNEON(accB[0], ambB), accB[1]), one);
+        uint32x4_t const ri = vandq_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(vmulq_f32(r, scale))), lowByte);
+        uint32x4_t const gi = vandq_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(vmulq_f32(g, scale))), lowByte);
+        uint32x4_t const bi = vandq_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(vmulq_f32(b, scale))), lowByte);
+        vst1q_u8(out, vreinterpretq_u8_u32(vorrq_u32(vorrq_u32(ri, vshlq_n_u32(gi, 8)),
+                                                     vorrq_u32(vshlq_n_u32(bi, 16), alpha))));
+    }
+    return i;
+}
+
+static int shinyCoordsNEON(float *out, float const *normals, int count,
+                           float yawCos, float yawSin, float pitchCos, float pitchSin)
+{
+    float32x4_t const one = vdupq_n_f32(1);
+    int i = 0;
+    for(; i + 4 <= count; i += 4, normals += 12, out += 8)
+    {
+        float32x4x3_t const n = vld3q_f32(normals);
+
+        float32x4_t const x = vaddq_f32(vmulq_n_f32(n.val[0], yawCos), vmulq_n_f32(n.val[1], yawSin));
+        float32x4x2_t st;
+        st.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(n.val[2], -pitchSin), vmulq_n_f32(x, pitchCos)), one);
+        st.val[1] = vaddq_f32(vmulq_n_f32(n.val[2], pitchCos), vmulq_n_f32(x, pitchSin));
+        vst2q_f32(out, st);
+    }
+    return i;
+}
+
+#endif // DENG_MODELSIMD_NEON
+
+int ModelSimd_LerpVertices(float *posOut, float *normOut, float const *from,
+                           float const *to, int count, float inter)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_MODELSIMD_X86
+    case SIMD_AVX2: return lerpVerticesAVX2(posOut, normOut, from, to, count, inter);
+    case SIMD_SSE2: return lerpVerticesSSE2(posOut, normOut, from, to, count, inter);
+#endif
+#ifdef DENG_MODELSIMD_NEON
+    case SIMD_NEON: return lerpVerticesNEON(posOut, normOut, from, to, count, inter);
+#endif
+    default: return 0;
+    }
+}
+
+int ModelSimd_VertexColors(uint8_t *out, float const *normals, int count,
+                           modelsimdlight_t const *lights, int numLights,
+                           float const ambient[4])
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_MODELSIMD_X86
+    case SIMD_AVX2: return vertexColorsAVX2(out, normals, count, lights, numLights, ambient);
+    case SIMD_SSE2: return vertexColorsSSE2(out, normals, count, lights, numLights, ambient);
+#endif
+#ifdef DENG_MODELSIMD_NEON
+    case SIMD_NEON: return vertexColorsNEON(out, normals, count, lights, numLights, ambient);
+#endif
+    default: return 0;
+    }
+}
+
+int ModelSimd_ShinyCoords(float *out, float const *normals, int count,
+                          float yawCos, float yawSin, float pitchCos, float pitchSin)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_MODELSIMD_X86
+    case SIMD_AVX2: return shinyCoordsAVX2(out, normals, count, yawCos, yawSin, pitchCos, pitchSin);
+    case SIMD_SSE2: return shinyCoordsSSE2(out, normals, count, yawCos, yawSin, pitchCos, pitchSin);
+#endif
+#ifdef DENG_MODELSIMD_NEON
+    case SIMD_NEON: return shinyCoordsNEON(out, normals, count, yawCos, yawSin, pitchCos, pitchSin);
+#endif
+    default: return 0;
+    }
+}
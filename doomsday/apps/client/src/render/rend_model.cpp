@@ -36,6 +36,8 @@
 #include "render/vissprite.h"
 #include "render/vectorlightdata.h"
 #include "render/modelrenderer.h"
+#include "render/modelsimd.h"
+#include "render/viewports.h"
 #include "gl/gl_main.h"
 #include "gl/gl_texmanager.h"
 #include "MaterialVariantSpec"
@@ -50,6 +52,8 @@
 #include <de/binangle.h>
 #include <de/memory.h>
 #include <de/concurrency.h>
+#include <QHash>
+#include <QVarLengthArray>
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
@@ -90,7 +94,7 @@ static bool inited;
 struct array_t
 {
     bool enabled;
-    void *data;
+    void const *data;
 };
 #define MAX_ARRAYS (2 + MAX_TEX_UNITS)
 static array_t arrays[MAX_ARRAYS];
@@ -111,6 +115,44 @@ static uint vertexBufferSize; ///< Current number of vertices supported by the r
 static bool announcedVertexBufferMaxBreach; ///< @c true if an attempt has been made to expand beyond our capability.
 #endif
 
+/// Number of steps the interpolation between two frames is divided into. Instances
+/// of a model in the same step of an animation share the interpolated vertices.
+static dint const INTER_STEPS = 64;
+
+struct InterpolationKey
+{
+    FrameModelFrame const *from;
+    FrameModelFrame const *to;
+    dint step;
+
+    bool operator == (InterpolationKey const &other) const {
+        return from == other.from && to == other.to && step == other.step;
+    }
+};
+
+inline uint qHash(InterpolationKey const &key)
+{
+    return ::qHash(key.from) ^ (::qHash(key.to) * 31) ^ uint(key.step);
+}
+
+/// Vertices interpolated between two frames.
+struct InterpolatedFrame
+{
+    QVector<Vector3f> posCoords;
+    QVector<Vector3f> normCoords;
+};
+
+/// Number of interpolations the lookup is sized for up front.
+static dint const INTERPOLATIONS_RESERVED = 256;
+
+/// Interpolations done during the current render frame (indices to interpolationBuffers).
+static QHash<InterpolationKey, dint> interpolations;
+static dint interpolationsFrame = -1;
+
+/// Vertex storage for the interpolations. Buffers are reused in later render frames.
+static QList<InterpolatedFrame> interpolationBuffers;
+static dint interpolationBuffersUsed;
+
 /*static void modelAspectModChanged()
 {
     /// @todo Reload and resize all models.
@@ -157,6 +199,11 @@ void Rend_ModelShutdown()
     M_Free(modelColorCoords); modelColorCoords = 0;
     M_Free(modelTexCoords); modelTexCoords = 0;
 
+    interpolations.clear();
+    interpolationsFrame = -1;
+    interpolationBuffers.clear();
+    interpolationBuffersUsed = 0;
+
     vertexBufferMax = vertexBufferSize = 0;
 #ifdef DENG_DEBUG
     announcedVertexBufferMaxBreach = false;
@@ -283,8 +330,8 @@ static void selectTexUnits(int count)
 /**
  * Enable, set and optionally lock all enabled arrays.
  */
-static void configureArrays(void *vertices, void *colors, int numCoords = 0,
-                            void **coords = 0)
+static void configureArrays(void const *vertices, void const *colors, int numCoords = 0,
+                            void const **coords = 0)
 {
     DENG_ASSERT_IN_MAIN_THREAD();
     DENG_ASSERT_GL_CONTEXT_ACTIVE();
@@ -367,9 +414,9 @@ static FrameModelFrame &visibleModelFrame(FrameModelDef &modef, int subnumber, i
  */
 static void drawPrimitives(rendcmd_t mode,
                            FrameModel::Primitives const &primitives,
-                           Vector3f *posCoords,
-                           Vector4ub *colorCoords,
-                           Vector2f *texCoords = 0)
+                           Vector3f const *posCoords,
+                           Vector4ub const *colorCoords,
+                           Vector2f const *texCoords = 0)
 {
     DENG_ASSERT_IN_MAIN_THREAD();
     DENG_ASSERT_GL_CONTEXT_ACTIVE();
@@ -378,7 +425,7 @@ static void drawPrimitives(rendcmd_t mode,
     disableArrays(true, true, DDMAXINT);
 
     // Load the vertex array.
-    void *coords[2];
+    void const *coords[2];
     switch (mode)
     {
     case RC_OTHER_COORDS:
@@ -466,42 +513,93 @@ static void drawPrimitives(rendcmd_t mode,
 }
 
 /**
- * Interpolate linearly between two sets of vertices.
+ * Interpolate linearly between two sets of vertices. All the vertices are processed
+ * regardless of the active LOD, so that the result can be shared by all instances.
  */
 static void Mod_LerpVertices(float inter, int count, FrameModelFrame const &from,
     FrameModelFrame const &to, Vector3f *posOut, Vector3f *normOut)
 {
     DENG2_ASSERT(&from.model == &to.model); // sanity check.
-    DENG2_ASSERT(!activeLod || &activeLod->model == &from.model); // sanity check.
     DENG2_ASSERT(from.vertices.count() == to.vertices.count()); // sanity check.
 
-    FrameModelFrame::VertexBuf::const_iterator startIt = from.vertices.begin();
-    FrameModelFrame::VertexBuf::const_iterator endIt   = to.vertices.begin();
+    FrameModelFrame::Vertex const *start = from.vertices.constData();
+    FrameModelFrame::Vertex const *end   = to.vertices.constData();
 
     if (&from == &to || de::fequal(inter, 0))
     {
-        for (int i = 0; i < count; ++i, startIt++, posOut++, normOut++)
+        for (int i = 0; i < count; ++i)
         {
-            if (!activeLod || activeLod->hasVertex(i))
-            {
-                *posOut  = startIt->pos;
-                *normOut = startIt->norm;
-            }
+            posOut[i]  = start[i].pos;
+            normOut[i] = start[i].norm;
         }
     }
     else
     {
-        for (int i = 0; i < count; ++i, startIt++, endIt++, posOut++, normOut++)
+        static_assert(sizeof(FrameModelFrame::Vertex) == 6 * sizeof(float),
+                      "ModelSimd_LerpVertices() expects vertices as six floats");
+
+        int i = ModelSimd_LerpVertices(&posOut->x, &normOut->x,
+                                       start->pos.constPtr(), end->pos.constPtr(),
+                                       count, inter);
+        for (; i < count; ++i)
         {
-            if (!activeLod || activeLod->hasVertex(i))
-            {
-                *posOut  = de::lerp(startIt->pos,  endIt->pos,  inter);
-                *normOut = de::lerp(startIt->norm, endIt->norm, inter);
-            }
+            posOut[i]  = de::lerp(start[i].pos,  end[i].pos,  inter);
+            normOut[i] = de::lerp(start[i].norm, end[i].norm, inter);
         }
     }
 }
 
+/**
+ * Returns the vertices interpolated between two frames. The interpolation position
+ * is rounded to the nearest step, and the results are kept until the next render
+ * frame, so that visible instances of a model in the same animation phase are only
+ * interpolated once.
+ */
+static InterpolatedFrame const &interpolatedFrame(float inter, int count,
+    FrameModelFrame const &from, FrameModelFrame const &to)
+{
+    if (interpolationsFrame != R_FrameCount())
+    {
+        // Forget the previous frame's results but keep the storage: clear() would
+        // also free the hash buckets, while erasing does not shrink a reserved hash.
+        interpolations.reserve(INTERPOLATIONS_RESERVED);
+        for (auto i = interpolations.begin(); i != interpolations.end(); )
+        {
+            i = interpolations.erase(i);
+        }
+        interpolationBuffersUsed = 0;
+        interpolationsFrame = R_FrameCount();
+    }
+
+    InterpolationKey key { &from, &to, dint(inter * INTER_STEPS + .5f) };
+    if (key.step == 0 || &from == &to)
+    {
+        key.to   = &from;
+        key.step = 0;
+    }
+
+    auto found = interpolations.constFind(key);
+    if (found != interpolations.constEnd())
+    {
+        return interpolationBuffers.at(found.value());
+    }
+
+    if (interpolationBuffersUsed == interpolationBuffers.size())
+    {
+        interpolationBuffers.append(InterpolatedFrame());
+    }
+    dint const index = interpolationBuffersUsed++;
+    interpolations.insert(key, index);
+
+    // Resizing a reused buffer keeps its capacity.
+    InterpolatedFrame &interp = interpolationBuffers[index];
+    interp.posCoords.resize(count);
+    interp.normCoords.resize(count);
+    Mod_LerpVertices(float(key.step) / INTER_STEPS, count, from, *key.to,
+                     interp.posCoords.data(), interp.normCoords.data());
+    return interp;
+}
+
 static void Mod_MirrorCoords(dint count, Vector3f *coords, dint axis)
 {
     DENG2_ASSERT(coords);
@@ -511,6 +609,40 @@ static void Mod_MirrorCoords(dint count, Vector3f *coords, dint axis)
     }
 }
 
+/**
+ * Rotation by yaw and pitch angles. Gives the same results as M_RotateVector(), but
+ * the sines and cosines are only calculated once when rotating many vectors.
+ */
+struct VectorRotation
+{
+    dfloat yawCos = 1, yawSin = 0;
+    dfloat pitchCos = 1, pitchSin = 0;
+
+    VectorRotation(dfloat degYaw, dfloat degPitch)
+    {
+        dfloat const radYaw = degYaw / 180 * DD_PI, radPitch = degPitch / 180 * DD_PI;
+        if (radYaw != 0)
+        {
+            yawCos = dfloat(cos(radYaw));
+            yawSin = dfloat(sin(radYaw));
+        }
+        if (radPitch != 0)
+        {
+            pitchCos = dfloat(cos(radPitch));
+            pitchSin = dfloat(sin(radPitch));
+        }
+    }
+
+    inline Vector3f operator () (Vector3f const &vec) const
+    {
+        dfloat const x = vec.x * yawCos + vec.y * yawSin;
+        dfloat const y = vec.x * -yawSin + vec.y * yawCos;
+        return Vector3f(vec.z * -pitchSin + x * pitchCos,
+                        y,
+                        vec.z * pitchCos + x * pitchSin);
+    }
+};
+
 /**
  * Rotate a VectorLight direction vector from world space to model space.
  *
@@ -538,52 +670,63 @@ static Vector3f rotateLightVector(VectorLightData const &vlight, dfloat yaw, dfl
 }
 
 /**
- * Calculate vertex lighting.
+ * Calculate vertex lighting. The affecting lights are collected and transformed to
+ * model space first, and then the vertices are lit in one pass.
  */
 static void Mod_VertexColors(Vector4ub *out, dint count, Vector3f const *normCoords,
     duint lightListIdx, duint maxLights, Vector4f const &ambient, bool invert,
     dfloat rotateYaw, dfloat rotatePitch)
 {
-    Vector4f const saturated(1, 1, 1, 1);
+    QVarLengthArray<modelsimdlight_t, 16> lights;
+    ClientApp::renderSystem().forAllVectorLights(lightListIdx, [&] (VectorLightData const &vlight)
+    {
+        // We must transform the light vector to model space.
+        Vector3f const direction = rotateLightVector(vlight, rotateYaw, rotatePitch, invert);
+        lights.append(modelsimdlight_t {
+                          { direction.x, direction.y, direction.z },
+                          vlight.offset, vlight.lightSide, vlight.darkSide,
+                          { vlight.color.x, vlight.color.y, vlight.color.z },
+                          vlight.affectedByAmbient? 0 : 1 });
+
+        // Time to stop?
+        return (maxLights && duint(lights.size()) == maxLights);
+    });
 
-    for (dint i = 0; i < count; ++i, out++, normCoords++)
+    Vector4f const saturated(1, 1, 1, 1);
+    modelsimdlight_t const *firstLight = lights.constData();
+    dint const numLights = lights.size();
+
+    // The vectorized kernel also lights the vertices not used by the active LOD;
+    // that is cheaper than testing each of them.
+    dint i = ModelSimd_VertexColors(&out->x, normCoords->constPtr(), count,
+                                    firstLight, numLights, ambient.constPtr());
+    for (; i < count; ++i)
     {
         if (activeLod && !activeLod->hasVertex(i))
             continue;
 
-        Vector3f const &normal = *normCoords;
+        Vector3f const &normal = normCoords[i];
 
         // Accumulate contributions from all affecting lights.
-        dint numProcessed = 0;
         Vector3f accum[2];  // Begin with total darkness [color, extra].
-        ClientApp::renderSystem().forAllVectorLights(lightListIdx, [&maxLights, &invert, &rotateYaw
-                                                      , &rotatePitch, &normal
-                                                      , &accum, &numProcessed] (VectorLightData const &vlight)
+        for (dint k = 0; k < numLights; ++k)
         {
-            numProcessed += 1;
-
-            // We must transform the light vector to model space.
-            Vector3f const lightDirection
-                    = rotateLightVector(vlight, rotateYaw, rotatePitch, invert);
+            modelsimdlight_t const &light = firstLight[k];
 
-            dfloat strength = lightDirection.dot(normal)
-                            + vlight.offset;  // Shift a bit towards the light.
+            dfloat strength = Vector3f(light.direction).dot(normal)
+                            + light.offset;  // Shift a bit towards the light.
 
             // Ability to both light and shade.
-            if (strength > 0) strength *= vlight.lightSide;
-            else             strength *= vlight.darkSide;
+            if (strength > 0) strength *= light.lightSide;
+            else             strength *= light.darkSide;
 
-            accum[vlight.affectedByAmbient? 0 : 1]
-                += vlight.color * de::clamp(-1.f, strength, 1.f);
-
-            // Time to stop?
-            return (maxLights && duint(numProcessed) == maxLights);
-        });
+            accum[light.accum] += Vector3f(light.color) * de::clamp(-1.f, strength, 1.f);
+        }
 
         // Check for ambient and convert to ubyte.
         Vector4f color(accum[0].max(ambient) + accum[1], ambient[3]);
 
-        *out = (color.min(saturated) * 255).toVector4ub();
+        out[i] = (color.min(saturated) * 255).toVector4ub();
     }
 }
 
@@ -617,20 +760,22 @@ static void Mod_FixedVertexColors(dint count, Vector4ub *colorCoords, Vector4ub
 static void Mod_ShinyCoords(Vector2f *out, int count, Vector3f const *normCoords,
     float normYaw, float normPitch, float shinyAng, float shinyPnt, float reactSpeed)
 {
-    for (int i = 0; i < count; ++i, out++, normCoords++)
+    // Rotate the normal vectors so that they approximate the
+    // model's orientation compared to the viewer.
+    VectorRotation const rotate((shinyPnt + normYaw) * 360 * reactSpeed,
+                                (shinyAng + normPitch - .5f) * 180 * reactSpeed);
+
+    int i = ModelSimd_ShinyCoords(&out->x, normCoords->constPtr(), count,
+                                  rotate.yawCos, rotate.yawSin,
+                                  rotate.pitchCos, rotate.pitchSin);
+    for (; i < count; ++i)
     {
         if (activeLod && !activeLod->hasVertex(i))
             continue;
 
-        float rotatedNormal[3] = { normCoords->x, normCoords->y, normCoords->z };
-
-        // Rotate the normal vector so that it approximates the
-        // model's orientation compared to the viewer.
-        M_RotateVector(rotatedNormal,
-                       (shinyPnt + normYaw) * 360 * reactSpeed,
-                       (shinyAng + normPitch - .5f) * 180 * reactSpeed);
+        Vector3f const rotatedNormal = rotate(normCoords[i]);
 
-        *out = Vector2f(rotatedNormal[0] + 1, rotatedNormal[2]);
+        out[i] = Vector2f(rotatedNormal.x + 1, rotatedNormal.z);
     }
 }
 
@@ -852,13 +997,20 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
     }
 
     // Interpolate vertices and normals.
-    Mod_LerpVertices(inter, numVerts, *frame, *nextFrame,
-                     modelPosCoords, modelNormCoords);
+    InterpolatedFrame const &interp = interpolatedFrame(inter, numVerts, *frame, *nextFrame);
+    Vector3f const *posCoords  = interp.posCoords.constData();
+    Vector3f const *normCoords = interp.normCoords.constData();
 
     if (zSign < 0)
     {
+        // The interpolation is shared with other instances; mirror a copy of it.
+        std::memcpy(modelPosCoords,  posCoords,  sizeof(*posCoords)  * numVerts);
+        std::memcpy(modelNormCoords, normCoords, sizeof(*normCoords) * numVerts);
         Mod_MirrorCoords(numVerts, modelPosCoords, 2);
         Mod_MirrorCoords(numVerts, modelNormCoords, 1);
+
+        posCoords  = modelPosCoords;
+        normCoords = modelNormCoords;
     }
 
     // Coordinates to the center of the model (game coords).
@@ -886,7 +1038,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         ambient = Vector4f(spr.light.ambientColor, alpha);
 
         Mod_VertexColors(modelColorCoords, numVerts,
-                         modelNormCoords, spr.light.vLightListIdx, modelLight + 1,
+                         normCoords, spr.light.vLightListIdx, modelLight + 1,
                          ambient, (mf->scale[VY] < 0), -spr.pose.yaw, -spr.pose.pitch);
     }
 
@@ -949,7 +1101,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         }
 
         Mod_ShinyCoords(modelTexCoords, numVerts,
-                        modelNormCoords, normYaw, normPitch, shinyAng, shinyPnt,
+                        normCoords, normYaw, normPitch, shinyAng, shinyPnt,
                         mf->def.sub(number).getf("shinyReact"));
 
         // Shiny color.
@@ -1013,7 +1165,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
             GL_BindTexture(renderTextures? skinTexture : 0);
 
             drawPrimitives(RC_COMMAND_COORDS, primitives,
-                           modelPosCoords, modelColorCoords);
+                           posCoords, modelColorCoords);
         }
 
         if (shininess > 0)
@@ -1042,7 +1194,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
             GL_BindTexture(renderTextures? skinTexture : 0);
 
             drawPrimitives(RC_BOTH_COORDS, primitives,
-                           modelPosCoords, modelColorCoords, modelTexCoords);
+                           posCoords, modelColorCoords, modelTexCoords);
 
             selectTexUnits(1);
             DGL_ModulateTexture(1);
@@ -1069,7 +1221,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         GL_BindTexture(renderTextures? skinTexture : 0);
 
         drawPrimitives(RC_BOTH_COORDS, primitives,
-                       modelPosCoords, modelColorCoords, modelTexCoords);
+                       posCoords, modelColorCoords, modelTexCoords);
 
         selectTexUnits(1);
         DGL_ModulateTexture(1);
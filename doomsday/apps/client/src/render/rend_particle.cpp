@@ -53,6 +53,7 @@
 #include <de/GLInfo>
 #include <de/ImageFile>
 #include <cstdlib>
+#include <cstring>
 
 using namespace de;
 using namespace world;
@@ -72,6 +73,7 @@ struct OrderedParticle
     dfloat distance;
 };
 static OrderedParticle *order;
+static OrderedParticle *orderTemp;  ///< Work buffer for sorting.
 static size_t orderSize;
 
 static size_t numParts;
@@ -248,16 +250,60 @@ void Rend_ParticleReleaseExtraTextures()
 }
 
 /**
- * Sorts in descending order.
+ * Distances are positive, so the bits of the floating-point values compare like
+ * unsigned integers. The bits are inverted to sort in descending order.
  */
-static dint comparePOrder(void const *a, void const *b)
+static inline duint32 orderKey(OrderedParticle const &pt)
 {
-    auto const &ptA = *(OrderedParticle const *) a;
-    auto const &ptB = *(OrderedParticle const *) b;
+    duint32 bits;
+    std::memcpy(&bits, &pt.distance, sizeof(bits));
+    return ~bits;
+}
+
+/**
+ * Sorts the order buffer in descending order of distance. This is a radix sort that
+ * processes the keys one byte at a time, using the work buffer for the intermediate
+ * results.
+ */
+static void sortOrderBuffer()
+{
+    size_t counts[4][256];
+    de::zap(counts);
+    for(size_t i = 0; i < numParts; ++i)
+    {
+        duint32 const key = orderKey(order[i]);
+        for(dint pass = 0; pass < 4; ++pass)
+        {
+            counts[pass][(key >> (8 * pass)) & 0xff]++;
+        }
+    }
+
+    OrderedParticle *src = order;
+    OrderedParticle *dst = orderTemp;
+    for(dint pass = 0; pass < 4; ++pass)
+    {
+        dint const shift = 8 * pass;
+
+        // Nothing to do if all the keys have the same byte here.
+        if(counts[pass][(orderKey(src[0]) >> shift) & 0xff] == numParts) continue;
 
-    if(ptA.distance > ptB.distance) return -1;
-    if(ptA.distance < ptB.distance) return 1;
-    return 0;  // Highly unlikely (but possible).
+        size_t offsets[256];
+        size_t total = 0;
+        for(dint i = 0; i < 256; ++i)
+        {
+            offsets[i] = total;
+            total += counts[pass][i];
+        }
+        for(size_t i = 0; i < numParts; ++i)
+        {
+            dst[offsets[(orderKey(src[i]) >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if(src != order)
+    {
+        std::memcpy(order, src, sizeof(OrderedParticle) * numParts);
+    }
 }
 
 /**
@@ -282,23 +328,25 @@ static void expandOrderBuffer(size_t max)
     if(orderSize > currentSize)
     {
         order = (OrderedParticle *) Z_Realloc(order, sizeof(OrderedParticle) * orderSize, PU_APPSTATIC);
+        orderTemp = (OrderedParticle *) Z_Realloc(orderTemp, sizeof(OrderedParticle) * orderSize, PU_APPSTATIC);
     }
 }
 
 /**
  * Determines whether the given particle is potentially visible for the current viewer.
  */
-static bool particlePVisible(ParticleInfo const &pinfo)
+static bool particlePVisible(ParticleStore const &particles, dint index)
 {
     // Never if it has already expired.
-    if(pinfo.stage < 0) return false;
+    if(particles.stage[index] < 0) return false;
 
     // Never if the origin lies outside the map.
-    if(!pinfo.bspLeaf || !pinfo.bspLeaf->hasSubspace())
+    world::BspLeaf const *bspLeaf = particles.bspLeaf[index];
+    if(!bspLeaf || !bspLeaf->hasSubspace())
         return false;
 
     // Potentially, if the subspace at the origin is visible.
-    return R_ViewerSubspaceIsVisible(pinfo.bspLeaf->subspace());
+    return R_ViewerSubspaceIsVisible(bspLeaf->subspace());
 }
 
 /**
@@ -332,14 +380,15 @@ static dint listVisibleParticles(world::Map &map)
     {
         if(!R_ViewerGeneratorIsVisible(gen)) return LoopContinue;  // Skip.
 
+        ParticleStore const &particles = gen.particles();
         for(dint i = 0; i < gen.count; ++i)
         {
-            ParticleInfo const &pinfo = gen.particleInfo()[i];
-
-            if(!particlePVisible(pinfo)) continue;  // Skip.
+            if(!particlePVisible(particles, i)) continue;  // Skip.
 
             // Skip particles too far from, or near to, the viewer.
-            dfloat const dist = de::max(pointDist(pinfo.origin), 1.f);
+            fixed_t const origin[3] = { particles.origin[0][i], particles.origin[1][i],
+                                        particles.origin[2][i] };
+            dfloat const dist = de::max(pointDist(origin), 1.f);
             if(gen.def->maxDist != 0 && dist > gen.def->maxDist) continue;
             if(dist < dfloat( ::particleNearLimit )) continue;
 
@@ -351,7 +400,7 @@ static dint listVisibleParticles(world::Map &map)
 
             // Determine what type of particle this is, as this will affect how
             // we go order our render passes and manipulate the render state.
-            dint const psType = gen.stages[pinfo.stage].type;
+            dint const psType = gen.stages[particles.stage[i]].type;
             if(psType == PTC_POINT)
             {
                 ::hasPoints = true;
@@ -394,8 +443,8 @@ static dint listVisibleParticles(world::Map &map)
     // This is the real number of possibly visible particles.
     ::numParts = numVisibleParts;
 
-    // Sort the order list back->front. A quicksort is fast enough.
-    qsort(::order, ::numParts, sizeof(OrderedParticle), comparePOrder);
+    // Sort the order list back->front.
+    sortOrderBuffer();
 
     return true;
 }
@@ -575,7 +624,7 @@ static void drawParticles(dint rtype, bool withBlend)
     {
         OrderedParticle const *slot = &order[i];
         Generator const *gen        = slot->generator;
-        ParticleInfo const &pinfo   = gen->particleInfo()[slot->particleId];
+        ParticleInfo const pinfo     = gen->particleInfo(slot->particleId);
 
         GeneratorParticleStage const *st = &gen->stages[pinfo.stage];
         ded_ptcstage_t const *stDef      = &gen->def->stages[pinfo.stage];
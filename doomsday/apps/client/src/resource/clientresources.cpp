@@ -76,6 +76,7 @@
 #include "gl/gl_texmanager.h"
 #include "gl/svg.h"
 #include "resource/clienttexture.h"
+#include "resource/preparedimagebank.h"
 #include "render/rend_model.h"
 #include "render/rend_particle.h"  // Rend_ParticleReleaseSystemTextures
 #include "render/rendersystem.h"
@@ -148,6 +149,10 @@ DENG2_PIMPL(ClientResources)
     {
         virtual ~CacheTask() {}
         virtual void run() = 0;
+
+        /// Texture variants the task needs. These are prepared beforehand in one
+        /// batch for all the queued tasks.
+        virtual void collectTextureVariants(QList<TextureVariant *> &) const {}
     };
 
     /**
@@ -169,6 +174,11 @@ DENG2_PIMPL(ClientResources)
             // Cache all dependent assets and upload GL textures if necessary.
             material->getAnimator(*spec).cacheAssets();
         }
+
+        void collectTextureVariants(QList<TextureVariant *> &variants) const
+        {
+            variants << material->getAnimator(*spec).assetTextureVariants();
+        }
     };
 
     /// A FIFO queue of material variant caching tasks.
@@ -177,6 +187,8 @@ DENG2_PIMPL(ClientResources)
     typedef QList<CacheTask *> CacheQueue;
     CacheQueue cacheQueue;
 
+    std::unique_ptr<PreparedImageBank> preparedImages; ///< Created when first needed.
+
     Impl(Public *i)
         : Base(i)
         , fontManifestCount        (0)
@@ -495,11 +507,25 @@ DENG2_PIMPL(ClientResources)
 
     void processCacheQueue()
     {
+        // Processing the texture images of all the tasks together lets them be
+        // worked on concurrently (in batches of limited size).
+        QList<TextureVariant *> variants;
+        for (CacheTask const *task : cacheQueue)
+        {
+            task->collectTextureVariants(variants);
+        }
+        TextureVariant::prepareAll(variants);
+
         while (!cacheQueue.isEmpty())
         {
             QScopedPointer<CacheTask> task(cacheQueue.takeFirst());
             task->run();
         }
+
+        if (preparedImages)
+        {
+            preparedImages->purge();
+        }
     }
 
     void queueCacheTasksForMaterial(ClientMaterial &material,
@@ -1903,6 +1929,15 @@ void ClientResources::processCacheQueue()
     d->processCacheQueue();
 }
 
+PreparedImageBank &ClientResources::preparedImageBank()
+{
+    if (!d->preparedImages)
+    {
+        d->preparedImages.reset(new PreparedImageBank);
+    }
+    return *d->preparedImages;
+}
+
 void ClientResources::cache(ClientMaterial &material, MaterialVariantSpec const &spec,
                             bool cacheGroups)
 {
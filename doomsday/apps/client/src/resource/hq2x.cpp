@@ -27,6 +27,7 @@
 #include "dd_types.h"
 #include "dd_share.h"
 #include "resource/image.h"
+#include "gl/gl_texsimd.h"
 
 /*
  * RGB color space.
@@ -101,6 +102,14 @@
 #define trU                 (7)
 #define trV                 (6)
 
+/*
+ * Pixels are compared using keys: the YUV888 of the color, plus an alpha byte that
+ * is 0xff for all non-transparent pixels. Two pixels are distinct if any byte of
+ * their keys differs by more than the corresponding byte of the thresholds.
+ */
+#define ABGR8888toKEY(v)    (ABGR8888toYUV888(v) | (ABGR8888_COMP(3, v) != 0? (uint32_t)AYUV8888_Amask : 0))
+#define KEY_THRESHOLDS      AYUV8888_PACK(trY, trU, trV, 0)
+
 #define PIXEL00_0         Transl(pOut,       w[5]);
 #define PIXEL00_10       Interp1(pOut,       w[5], w[1]);
 #define PIXEL00_11       Interp1(pOut,       w[5], w[4]);
@@ -151,7 +160,6 @@
 #define PIXEL11_100     Interp10(pOut+BpL+4, w[5], w[6], w[8]);
 
 static uint32_t lutBGR888toYUV888[32*64*32];
-static uint32_t YUV1, YUV2;
 
 void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
     uint32_t f2, uint32_t f3)
@@ -188,14 +196,32 @@ void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
     *((uint32_t*)pc) = ABGR8888_PACK(out[3], out[2], out[1], out[0]);
 }
 
-static __inline int Diff(uint32_t c1, uint32_t c2)
+static __inline int Diff(uint32_t k1, uint32_t k2)
 {
-    YUV1 = ABGR8888toYUV888(c1);
-    YUV2 = ABGR8888toYUV888(c2);
-    return ( ((ABGR8888_COMP(3, c1) != 0) != ((ABGR8888_COMP(3, c2) != 0))) ||
-             (abs(int(YUV1 & YUV888_Ymask) - int(YUV2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
-             (abs(int(YUV1 & YUV888_Umask) - int(YUV2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
-             (abs(int(YUV1 & YUV888_Vmask) - int(YUV2 & YUV888_Vmask)) > ((trV & (int)0xFF)) ));
+    return ( ((k1 ^ k2) & AYUV8888_Amask) ||
+             (abs(int(k1 & YUV888_Ymask) - int(k2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
+             (abs(int(k1 & YUV888_Umask) - int(k2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
+             (abs(int(k1 & YUV888_Vmask) - int(k2 & YUV888_Vmask)) > ((trV & (int)0xFF)) ));
+}
+
+/**
+ * Determines the pattern of a pixel, i.e., which of its neighbors are distinct
+ * from it. @a keys points to the upper left neighbor in a padded key image.
+ */
+static int Pattern(uint32_t const *keys, int stride)
+{
+    uint32_t const center = keys[stride + 1];
+    uint32_t const neighbors[8] = {
+        keys[0],          keys[1],              keys[2],
+        keys[stride],                           keys[stride + 2],
+        keys[2 * stride], keys[2 * stride + 1], keys[2 * stride + 2]
+    };
+    int pattern = 0;
+    for(int n = 0; n < 8; ++n)
+    {
+        if(Diff(center, neighbors[n])) pattern |= 1 << n;
+    }
+    return pattern;
 }
 
 static __inline void Transl(uint8_t* pc, uint32_t c)
@@ -269,9 +295,10 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
     {
     dd_bool wrapH = (flags & ICF_UPSCALE_SAMPLE_WRAPH) != 0;
     dd_bool wrapV = (flags & ICF_UPSCALE_SAMPLE_WRAPV) != 0;
-    int pattern, flag, BpL, xA, xB, yA, yB;
-    uint8_t* pOut, *dst;
-    uint32_t w[10];
+    int pattern, BpL, padWidth;
+    uint8_t* pOut, *dst, *patterns;
+    uint32_t* colors, *keys;
+    uint32_t w[10], k[10];
 
     if(width <= 0 || height <= 0)
         return 0;
@@ -288,86 +315,65 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
         App_Error("GL_SmartFilterHQ2x: Failed on allocation of %lu bytes for "
                   "output buffer.", (unsigned long) (BPP * 2 * width * height * 2));
 
+    // The colors and keys of the pixels are copied into images that are padded
+    // with the neighbors beyond the edges (wrapped or clamped), so that the
+    // neighborhood of every pixel can be read without special cases.
+    padWidth = width + 2;
+    colors   = (uint32_t *) M_Malloc(sizeof(*colors) * padWidth * (height + 2));
+    keys     = (uint32_t *) M_Malloc(sizeof(*keys)   * padWidth * (height + 2));
+    patterns = (uint8_t *)  M_Malloc(width);
+    { int y;
+    for(y = 0; y < height + 2; ++y)
+    {
+        int const srcY = (y == 0?          (wrapV? height-1 : 0) :
+                          y == height + 1? (wrapV? 0 : height-1) : y-1);
+        { int x;
+        for(x = 0; x < width + 2; ++x)
+        {
+            int const srcX = (x == 0?         (wrapH? width-1 : 0) :
+                              x == width + 1? (wrapH? 0 : width-1) : x-1);
+            uint32_t const c = DD_ULONG( *( (uint32_t*)(src + OFFSET(srcX, srcY)) ) );
+            colors[y * padWidth + x] = c;
+            keys  [y * padWidth + x] = ABGR8888toKEY(c);
+        }}
+    }}
+
     pOut = dst;
     BpL = BPP * 2 * width; // (Out) Bytes per Line.
     { int y;
     for(y = 0; y < height; ++y)
     {
+        // The neighborhoods begin on the padded row above.
+        uint32_t const *cRow = colors + y * padWidth;
+        uint32_t const *kRow = keys   + y * padWidth;
+
         { int x;
-        for(x = 0; x < width; ++x)
+        for(x = TexSimd_Hq2xPatterns(patterns, kRow, padWidth, width, KEY_THRESHOLDS);
+            x < width; ++x)
         {
-            w[5] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x, y)) ) );
-
-            // Horizontal neighbors.
-            if(wrapH)
-            {
-                w[4] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x == 0? width-1 : x-1, y)) ) );
-                w[6] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x == width-1? 0 : x+1, y)) ) );
-            }
-            else
-            {
-                if(x != 0)
-                    w[4] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x-1, y)) ) );
-                else
-                    w[4] = w[5];
-
-                if(x != width-1)
-                    w[6] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x+1, y)) ) );
-                else
-                    w[6] = w[5];
-            }
-
-            // Vertical neighbors.
-            if(wrapV)
-            {
-                w[2] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x, y == 0? height-1 : y-1)) ) );
-                w[8] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x, y == height-1? 0 : y+1)) ) );
-            }
-            else
-            {
-                if(y != 0)
-                    w[2] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x, y-1)) ) );
-                else
-                    w[2] = w[5];
-
-                if(y != height-1)
-                    w[8] = DD_ULONG( *( (uint32_t*)(src + OFFSET(x, y+1)) ) );
-                else
-                    w[8] = w[5];
-            }
-
-            // Corners.
-            xA =        x == 0? ( wrapH?  width-1 : 0) : x-1;
-            xB =  x == width-1? (!wrapH?  width-1 : 0) : x+1;
-            yA =        y == 0? ( wrapV? height-1 : 0) : y-1;
-            yB = y == height-1? (!wrapV? height-1 : 0) : y+1;
-
-            w[1] = DD_ULONG( *( (uint32_t*)(src + OFFSET(xA, yA)) ) );
-            w[7] = DD_ULONG( *( (uint32_t*)(src + OFFSET(xA, yB)) ) );
-            w[3] = DD_ULONG( *( (uint32_t*)(src + OFFSET(xB, yA)) ) );
-            w[9] = DD_ULONG( *( (uint32_t*)(src + OFFSET(xB, yB)) ) );
+            patterns[x] = uint8_t(Pattern(kRow + x, padWidth));
+        }}
 
-            pattern = 0;
-            flag = 1;
-            YUV1 = ABGR8888toYUV888(w[5]);
+        { int x;
+        for(x = 0; x < width; ++x, ++cRow, ++kRow)
+        {
+            w[1] = cRow[0];
+            w[2] = cRow[1];
+            w[3] = cRow[2];
+            w[4] = cRow[padWidth];
+            w[5] = cRow[padWidth + 1];
+            w[6] = cRow[padWidth + 2];
+            w[7] = cRow[2 * padWidth];
+            w[8] = cRow[2 * padWidth + 1];
+            w[9] = cRow[2 * padWidth + 2];
 
-            { int k;
-            for(k = 1; k <= 9; ++k)
-            {
-                if(k == 5)
-                    continue;
+            // Only the edge neighbors are compared with each other.
+            k[2] = kRow[1];
+            k[4] = kRow[padWidth];
+            k[6] = kRow[padWidth + 2];
+            k[8] = kRow[2 * padWidth + 1];
 
-                if(w[k] != w[5])
-                {
-                    YUV2 = ABGR8888toYUV888(w[k]);
-                    if(((ABGR8888_COMP(3, w[5]) != 0) != (ABGR8888_COMP(3, w[k]) != 0)) ||
-                       (abs(int(YUV1 & YUV888_Ymask) - int(YUV2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
-                       (abs(int(YUV1 & YUV888_Umask) - int(YUV2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
-                       (abs(int(YUV1 & YUV888_Vmask) - int(YUV2 & YUV888_Vmask)) > ((trV & (int)0xFF) )) )
-                        pattern |= flag;
-                }
-                flag <<= 1;
-            }}
+            pattern = patterns[x];
 
             switch(pattern)
             {
@@ -463,7 +469,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 18:
             case 50: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
@@ -473,7 +479,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 80:
             case 81: {
-                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -483,7 +489,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 72:
             case 76: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
@@ -493,7 +499,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 10:
             case 138: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
@@ -529,7 +535,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 22:
             case 54: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -539,7 +545,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 208:
             case 209: {
-                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -549,7 +555,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 104:
             case 108: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -559,7 +565,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 11:
             case 139: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
@@ -569,7 +575,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 19:
             case 51: {
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL00_11 PIXEL01_10}
                     else {
@@ -578,7 +584,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 146:
             case 178: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10 PIXEL11_12}
                     else {
@@ -587,7 +593,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 84:
             case 85: {
-                    PIXEL00_20 if(Diff(w[6], w[8]))
+                    PIXEL00_20 if(Diff(k[6], k[8]))
                     {
                     PIXEL01_11 PIXEL11_10}
                     else {
@@ -596,7 +602,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 112:
             case 113: {
-                    PIXEL00_20 PIXEL01_22 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 if(Diff(k[6], k[8]))
                     {
                     PIXEL10_12 PIXEL11_10}
                     else {
@@ -605,7 +611,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 200:
             case 204: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10 PIXEL11_11}
                     else {
@@ -614,7 +620,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 73:
             case 77: {
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL00_12 PIXEL10_10}
                     else {
@@ -623,7 +629,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 42:
             case 170: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10 PIXEL10_11}
                     else {
@@ -632,7 +638,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 14:
             case 142: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10 PIXEL01_12}
                     else {
@@ -665,13 +671,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 26:
             case 31: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -681,13 +687,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 82:
             case 214: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -697,13 +703,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 88:
             case 248: {
-                    PIXEL00_21 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_22 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -713,13 +719,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 74:
             case 107: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -728,7 +734,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 27: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
@@ -737,7 +743,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_10 PIXEL10_22 PIXEL11_21 break;
               }
             case 86: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -746,7 +752,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_21 PIXEL11_10 break;
               }
             case 216: {
-                    PIXEL00_21 PIXEL01_22 PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL00_21 PIXEL01_22 PIXEL10_10 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -755,7 +761,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 106: {
-                    PIXEL00_10 PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_21 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -764,7 +770,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 30: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -773,7 +779,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_21 break;
               }
             case 210: {
-                    PIXEL00_22 PIXEL01_10 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_22 PIXEL01_10 PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -782,7 +788,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 120: {
-                    PIXEL00_21 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_22 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -791,7 +797,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 75: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
@@ -836,13 +842,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_12 PIXEL01_22 PIXEL10_22 PIXEL11_12 break;
               }
             case 58: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
@@ -851,13 +857,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 83: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -866,13 +872,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 92: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -881,13 +887,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 202: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
@@ -896,13 +902,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 78: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
@@ -911,13 +917,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 154: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
@@ -926,13 +932,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_12 break;
               }
             case 114: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -941,13 +947,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 89: {
-                    PIXEL00_12 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_22 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -956,25 +962,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 90: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -984,7 +990,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 55:
             case 23: {
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL00_11 PIXEL01_0}
                     else {
@@ -993,7 +999,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 182:
             case 150: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0 PIXEL11_12}
                     else {
@@ -1002,7 +1008,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 213:
             case 212: {
-                    PIXEL00_20 if(Diff(w[6], w[8]))
+                    PIXEL00_20 if(Diff(k[6], k[8]))
                     {
                     PIXEL01_11 PIXEL11_0}
                     else {
@@ -1011,7 +1017,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 241:
             case 240: {
-                    PIXEL00_20 PIXEL01_22 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 if(Diff(k[6], k[8]))
                     {
                     PIXEL10_12 PIXEL11_0}
                     else {
@@ -1020,7 +1026,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 236:
             case 232: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0 PIXEL11_11}
                     else {
@@ -1029,7 +1035,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 109:
             case 105: {
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL00_12 PIXEL10_0}
                     else {
@@ -1038,7 +1044,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 171:
             case 43: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0 PIXEL10_11}
                     else {
@@ -1047,7 +1053,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 143:
             case 15: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0 PIXEL01_12}
                     else {
@@ -1055,7 +1061,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_20 break;
               }
             case 124: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1064,7 +1070,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 203: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
@@ -1073,7 +1079,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_21 PIXEL10_10 PIXEL11_11 break;
               }
             case 62: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1082,7 +1088,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 211: {
-                    PIXEL00_11 PIXEL01_10 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_11 PIXEL01_10 PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1091,7 +1097,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 118: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1100,7 +1106,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_12 PIXEL11_10 break;
               }
             case 217: {
-                    PIXEL00_12 PIXEL01_22 PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL00_12 PIXEL01_22 PIXEL10_10 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1109,7 +1115,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 110: {
-                    PIXEL00_10 PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1118,7 +1124,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 155: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
@@ -1151,13 +1157,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_11 PIXEL01_12 PIXEL10_21 PIXEL11_11 break;
               }
             case 220: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1166,13 +1172,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 158: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1181,13 +1187,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_12 break;
               }
             case 234: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1196,13 +1202,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 242: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1211,13 +1217,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 59: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
@@ -1226,13 +1232,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 121: {
-                    PIXEL00_12 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_22 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1241,13 +1247,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 87: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1256,13 +1262,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 79: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
@@ -1271,25 +1277,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 122: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1298,25 +1304,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 94: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1325,25 +1331,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 218: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1352,25 +1358,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 91: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1391,13 +1397,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_12 break;
               }
             case 186: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
@@ -1406,13 +1412,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_12 break;
               }
             case 115: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1421,13 +1427,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 93: {
-                    PIXEL00_12 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_11 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1436,13 +1442,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 206: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
@@ -1452,7 +1458,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 205:
             case 201: {
-                    PIXEL00_12 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_20 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_10}
                     else
@@ -1462,7 +1468,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 174:
             case 46: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_10}
                     else
@@ -1472,7 +1478,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 179:
             case 147: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_10}
                     else
@@ -1482,7 +1488,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 117:
             case 116: {
-                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1497,13 +1503,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_11 PIXEL01_12 PIXEL10_12 PIXEL11_11 break;
               }
             case 126: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1512,13 +1518,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 219: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_10 PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL01_10 PIXEL10_10 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1527,7 +1533,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 125: {
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL00_12 PIXEL10_0}
                     else {
@@ -1535,7 +1541,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_11 PIXEL11_10 break;
               }
             case 221: {
-                    PIXEL00_12 if(Diff(w[6], w[8]))
+                    PIXEL00_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL01_11 PIXEL11_0}
                     else {
@@ -1543,7 +1549,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_10 break;
               }
             case 207: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0 PIXEL01_12}
                     else {
@@ -1551,7 +1557,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_10 PIXEL11_11 break;
               }
             case 238: {
-                    PIXEL00_10 PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0 PIXEL11_11}
                     else {
@@ -1559,7 +1565,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 190: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0 PIXEL11_12}
                     else {
@@ -1567,7 +1573,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 break;
               }
             case 187: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0 PIXEL10_11}
                     else {
@@ -1575,7 +1581,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_10 PIXEL11_12 break;
               }
             case 243: {
-                    PIXEL00_11 PIXEL01_10 if(Diff(w[6], w[8]))
+                    PIXEL00_11 PIXEL01_10 if(Diff(k[6], k[8]))
                     {
                     PIXEL10_12 PIXEL11_0}
                     else {
@@ -1583,7 +1589,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 119: {
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL00_11 PIXEL01_0}
                     else {
@@ -1592,7 +1598,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 237:
             case 233: {
-                    PIXEL00_12 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_20 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1602,7 +1608,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 175:
             case 47: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
@@ -1612,7 +1618,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 183:
             case 151: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1622,7 +1628,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 245:
             case 244: {
-                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1631,13 +1637,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 250: {
-                    PIXEL00_10 PIXEL01_10 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_10 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1646,13 +1652,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 123: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_10 if(Diff(w[8], w[4]))
+                    PIXEL01_10 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1661,13 +1667,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 95: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1676,13 +1682,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_10 PIXEL11_10 break;
               }
             case 222: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL10_10 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1691,13 +1697,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 252: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1706,13 +1712,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 249: {
-                    PIXEL00_12 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_22 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1721,13 +1727,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 235: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1736,13 +1742,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 111: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1751,13 +1757,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 63: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1766,13 +1772,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 159: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1781,13 +1787,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_12 break;
               }
             case 215: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1796,13 +1802,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 246: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1811,19 +1817,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 254: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1832,13 +1838,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 253: {
-                    PIXEL00_12 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_11 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1847,19 +1853,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 251: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_10 if(Diff(w[8], w[4]))
+                    PIXEL01_10 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1868,13 +1874,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 239: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1883,19 +1889,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 127: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1904,13 +1910,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 191: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1919,19 +1925,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_12 break;
               }
             case 223: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL10_10 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1940,13 +1946,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 247: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1955,25 +1961,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 255: {
-                    if(Diff(w[4], w[2]))
+                    if(Diff(k[4], k[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(Diff(k[2], k[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    if(Diff(w[8], w[4]))
+                    if(Diff(k[8], k[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(Diff(k[6], k[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1990,6 +1996,9 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
         pOut += BpL;
     }}
 
+    M_Free(patterns);
+    M_Free(keys);
+    M_Free(colors);
     return dst;
     }
 
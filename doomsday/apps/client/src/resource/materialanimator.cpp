@@ -729,8 +729,14 @@ void MaterialAnimator::prepare(bool fullUpdate)
 
 void MaterialAnimator::cacheAssets()
 {
+    TextureVariant::prepareAll(assetTextureVariants());
     prepare(true);
-    if (material().isSkyMasked() && !::devRendSkyMode) return;
+}
+
+QList<TextureVariant *> MaterialAnimator::assetTextureVariants() const
+{
+    QList<TextureVariant *> variants;
+    if (material().isSkyMasked() && !::devRendSkyMode) return variants;
 
     for (int i = 0; i < material().layerCount(); ++i)
     {
@@ -746,24 +752,25 @@ void MaterialAnimator::cacheAssets()
                     {
                         auto const &detailStage = stage.as<world::DetailTextureMaterialLayer::AnimationStage>();
                         float const contrast = de::clamp(0.f, detailStage.strength, 1.f) * detailFactor /*Global strength multiplier*/;
-                        tex->prepareVariant(resSys().detailTextureSpec(contrast));
+                        variants << tex->chooseVariant(ClientTexture::MatchSpec, resSys().detailTextureSpec(contrast), true);
                     }
                     else if (is<world::ShineTextureMaterialLayer>(layer))
                     {
-                        tex->prepareVariant(Rend_MapSurfaceShinyTextureSpec());
+                        variants << tex->chooseVariant(ClientTexture::MatchSpec, Rend_MapSurfaceShinyTextureSpec(), true);
                         if (ClientTexture *maskTex = findTextureForAnimationStage(stage, MaskTextureProperty))
                         {
-                            maskTex->prepareVariant(Rend_MapSurfaceShinyMaskTextureSpec());
+                            variants << maskTex->chooseVariant(ClientTexture::MatchSpec, Rend_MapSurfaceShinyMaskTextureSpec(), true);
                         }
                     }
                     else
                     {
-                        tex->prepareVariant(*variantSpec().primarySpec);
+                        variants << tex->chooseVariant(ClientTexture::MatchSpec, *variantSpec().primarySpec, true);
                     }
                 }
             }
         }
     }
+    return variants;
 }
 
 bool MaterialAnimator::isOpaque() const
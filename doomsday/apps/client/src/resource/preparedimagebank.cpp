@@ -0,0 +1,270 @@
+/** @file preparedimagebank.cpp  Persistent cache of prepared texture images.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+#include "resource/preparedimagebank.h"
+#include "resource/texturevariantspec.h"
+
+#include "dd_main.h" // App_Resources()
+#include "render/rend_main.h" // fillOutlines
+
+#include <doomsday/resource/colorpalettes.h>
+#include <de/ByteRefArray>
+#include <de/FS>
+#include <de/Folder>
+#include <de/Reader>
+#include <de/Writer>
+#include <de/memory.h>
+#include <cstring>
+
+using namespace de;
+
+/// Changing the way images are prepared invalidates the cached images.
+/// - 2: Images filtered concurrently with hq2x before it was reentrant may be corrupt.
+static duint32 const PREPARATION_VERSION = 2;
+
+/// Maximum size of the prepared images kept in hot storage.
+static dint64 const MAX_HOT_STORAGE_SIZE = 512 * 1024 * 1024;
+
+DENG2_PIMPL(PreparedImageBank), public Lockable
+{
+    struct Source : public ISource {};
+
+    struct Data : public IData, public ISerializable
+    {
+        bool isEmpty = true;
+        bool isChanged = false;
+        Vector2ui size;
+        dint32 pixelSize = 0;
+        dint32 flags = 0;
+        bool paletted = false;
+        duint32 format = 0;
+        Vector3f lumaFactors;
+        Block pixels;
+
+        bool shouldBeSerialized() const override {
+            return isChanged;
+        }
+        ISerializable *asSerializable() override {
+            return this;
+        }
+        duint sizeInMemory() const override {
+            return duint(pixels.size());
+        }
+
+        void operator >> (Writer &to) const override
+        {
+            to << size.x << size.y << pixelSize << flags << duint8(paletted ? 1 : 0)
+               << format << lumaFactors.x << lumaFactors.y << lumaFactors.z << pixels;
+        }
+
+        void operator << (Reader &from) override
+        {
+            duint8 isPaletted;
+            from >> size.x >> size.y >> pixelSize >> flags >> isPaletted
+                 >> format >> lumaFactors.x >> lumaFactors.y >> lumaFactors.z >> pixels;
+            paletted = (isPaletted != 0);
+            isEmpty = pixels.isEmpty();
+        }
+    };
+
+    Impl(Public *i) : Base(i) {}
+
+    static DotPath pathFromId(Block const &id)
+    {
+        DENG2_ASSERT(!id.isEmpty());
+        String const hex = id.asHexadecimalText();
+        return String("%1.%2").arg(hex.last()).arg(hex);
+    }
+
+    /**
+     * Adds the images that were cached in previous sessions, so that they are
+     * accounted for when purging the hot storage.
+     */
+    void addCachedImages()
+    {
+        Folder const *cacheFolder = FS::tryLocate<Folder const>(self().hotStorageCacheLocation().toString());
+        if (!cacheFolder) return;
+
+        for (Folder const *subfolder : cacheFolder->subfolders())
+        {
+            subfolder->forContents([this, subfolder] (String name, File &)
+            {
+                DotPath const path(subfolder->name() + "." + name);
+                if (!self().has(path))
+                {
+                    self().Bank::add(path, new Source);
+                }
+                return LoopContinue;
+            });
+        }
+    }
+};
+
+PreparedImageBank::PreparedImageBank()
+    : Bank("PreparedImageBank", SingleThread | EnableHotStorage, "/home/cache/textures")
+    , d(new Impl(this))
+{
+    setHotStorageSize(MAX_HOT_STORAGE_SIZE);
+    d->addCachedImages();
+}
+
+PreparedImageBank::~PreparedImageBank()
+{
+    // Images are moved to hot storage as soon as they are added or used.
+    Bank::purge();
+}
+
+Block PreparedImageBank::composeId(image_t const &source, TextureVariantSpec const &spec) // static
+{
+    // Only filtering is costly enough to be worth caching.
+    if (!source.pixels) return Block();
+    if (spec.type == TST_GENERAL && !(spec.variant.flags & TSF_UPSCALE_AND_SHARPEN))
+    {
+        return Block();
+    }
+
+    Block data;
+    Writer writer(data);
+    writer << PREPARATION_VERSION << duint32(spec.type);
+    if (spec.type == TST_GENERAL)
+    {
+        writer << duint32(spec.variant.flags & ~TSF_INTERNAL_MASK)
+               << duint8(spec.variant.toAlpha ? 1 : 0)
+               << duint8(fillOutlines ? 1 : 0);
+    }
+    writer << source.size.x << source.size.y << dint32(source.pixelSize)
+           << dint32(source.flags);
+
+    if (source.paletteId)
+    {
+        // The preparation may convert the pixels via the palette colors.
+        res::ColorPalette const &palette = App_Resources().colorPalettes().colorPalette(source.paletteId);
+        writer << dint32(palette.colorCount());
+        for (int i = 0; i < palette.colorCount(); ++i)
+        {
+            Vector3ub const color = palette.color(i);
+            writer << color.x << color.y << color.z;
+        }
+    }
+
+    dsize const pixelBytes = dsize(source.size.x) * source.size.y * source.pixelSize;
+    writer.writeBytes(ByteRefArray(source.pixels, pixelBytes));
+    return data.md5Hash();
+}
+
+bool PreparedImageBank::find(Block const &id, image_t &image, dgltexformat_t &format,
+                             Vector3f &lumaFactors)
+{
+    if (id.isEmpty()) return false;
+
+    DENG2_GUARD(d);
+    LOG_AS("PreparedImageBank");
+
+    DotPath const path = Impl::pathFromId(id);
+    if (!has(path))
+    {
+        Bank::add(path, new Impl::Source);
+    }
+
+    try
+    {
+        auto const &cached = data(path).as<Impl::Data>();
+        if (cached.isEmpty) return false;
+
+        Image_ClearPixelData(image);
+        image.size      = cached.size;
+        image.pixelSize = cached.pixelSize;
+        image.flags     = cached.flags;
+        if (!cached.paletted) image.paletteId = 0;
+        image.pixels    = (uint8_t *) M_Malloc(cached.pixels.size());
+        std::memcpy(image.pixels, cached.pixels.data(), cached.pixels.size());
+
+        format      = dgltexformat_t(cached.format);
+        lumaFactors = cached.lumaFactors;
+    }
+    catch (Error const &er)
+    {
+        LOG_RES_WARNING("Failed to read a prepared image: %s") << er.asText();
+        return false;
+    }
+
+    // The pixel data is no longer needed in memory.
+    unload(path, InHotStorage, ImmediatelyInCurrentThread);
+    return true;
+}
+
+void PreparedImageBank::add(Block const &id, image_t const &image, dgltexformat_t format,
+                            Vector3f const &lumaFactors)
+{
+    if (id.isEmpty() || !image.pixels) return;
+
+    DENG2_GUARD(d);
+    LOG_AS("PreparedImageBank");
+
+    DotPath const path = Impl::pathFromId(id);
+    if (!has(path))
+    {
+        Bank::add(path, new Impl::Source);
+    }
+
+    try
+    {
+        auto &entry = data(path).as<Impl::Data>();
+        entry.size        = image.size;
+        entry.pixelSize   = image.pixelSize;
+        entry.flags       = image.flags;
+        entry.paletted    = (image.paletteId != 0);
+        entry.format      = duint32(format);
+        entry.lumaFactors = lumaFactors;
+        entry.pixels      = Block(image.pixels, dsize(image.size.x) * image.size.y * image.pixelSize);
+        entry.isEmpty     = false;
+        entry.isChanged   = true;
+
+        unload(path, InHotStorage, ImmediatelyInCurrentThread);
+    }
+    catch (Error const &er)
+    {
+        LOG_RES_WARNING("Failed to cache a prepared image: %s") << er.asText();
+    }
+}
+
+void PreparedImageBank::purge()
+{
+    DENG2_GUARD(d);
+    Bank::purge();
+}
+
+void PreparedImageBank::clear()
+{
+    DENG2_GUARD(d);
+    Bank::clear();
+    clearHotStorage();
+}
+
+Bank::IData *PreparedImageBank::loadFromSource(ISource &)
+{
+    // Prepared images can only be deserialized from hot storage or added.
+    return newData();
+}
+
+Bank::IData *PreparedImageBank::newData()
+{
+    return new Impl::Data;
+}
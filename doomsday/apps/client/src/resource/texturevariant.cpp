@@ -28,13 +28,17 @@
 #include "gl/texturecontent.h"
 
 #include "resource/image.h" // GL_LoadSourceImage
+#include "resource/preparedimagebank.h"
 
 #include "render/rend_main.h" // misc global vars awaiting new home
 
 #include <doomsday/resource/colorpalettes.h>
 #include <doomsday/res/Texture>
 #include <de/LogBuffer>
+#include <de/TaskScheduler>
 #include <de/mathutil.h> // M_CeilPow
+#include <QSet>
+#include <vector>
 
 using namespace de;
 
@@ -263,6 +267,9 @@ String TextureVariantSpec::asText() const
     return text;
 }
 
+static void performImageAnalyses(image_t const &image,
+    texturevariantusagecontext_t context, ClientTexture &tex, bool forceUpdate);
+
 DENG2_PIMPL(ClientTexture::Variant)
 {
     ClientTexture &texture; /// The base for which "this" is a context derivative.
@@ -294,6 +301,100 @@ DENG2_PIMPL(ClientTexture::Variant)
         // Release any GL texture we may have prepared.
         self().release();
     }
+
+    /**
+     * Loads the source image and performs any analyses of its pixel data. If
+     * the variant has no GL texture yet, a new name is reserved for it.
+     *
+     * @return  @c true if a source image was loaded.
+     */
+    bool loadSourceImage(image_t &image)
+    {
+        res::Source source = GL_LoadSourceImage(image, texture, spec);
+        if(source == res::None)
+            return false;
+
+        // Do we need to perform any image pixel data analyses?
+        if(spec.type == TST_GENERAL)
+        {
+            performImageAnalyses(image, spec.variant.context, texture,
+                                 true /*force update*/);
+        }
+
+        // Are we preparing a new GL texture?
+        if(glTexName == 0)
+        {
+            // Acquire a new GL texture name.
+            glTexName = GL_GetReservedTextureName();
+
+            // Record the source of the image.
+            texSource = source;
+        }
+        return true;
+    }
+
+    /**
+     * Submits the prepared image for uploading (possibly deferred) and releases
+     * the image pixel data.
+     *
+     * @param image        Image prepared with GL_PrepareTextureImage().
+     * @param format       DGL texture format of the prepared image.
+     * @param lumaFactors  Luminance equalization factors of the prepared image.
+     */
+    void upload(image_t &image, dgltexformat_t format, Vector3f const &lumaFactors)
+    {
+        texturecontent_t c;
+        GL_ConfigureTextureContent(c, glTexName, image, format, lumaFactors, spec,
+                                   texture.manifest());
+
+        /**
+         * Calculate GL texture coordinates based on the image dimensions. The
+         * coordinates are calculated as width / CeilPow2(width), or 1 if larger
+         * than the maximum texture size.
+         *
+         * @todo fixme: Image dimensions may not be the same as the uploaded
+         * texture - defer this logic until all processing has been completed.
+         */
+        if ((c.flags & TXCF_UPLOAD_ARG_NOSTRETCH) &&
+            (c.flags & TXCF_MIPMAP))
+        {
+            s = image.size.x / float( de::ceilPow2(image.size.x) );
+            t = image.size.y / float( de::ceilPow2(image.size.y) );
+        }
+        else
+        {
+            s = 1;
+            t = 1;
+        }
+
+        if(image.flags & IMGF_IS_MASKED)
+        {
+            flags |= TextureVariant::Masked;
+        }
+
+        // Submit the content for uploading (possibly deferred).
+        gl::UploadMethod uploadMethod = GL_ChooseUploadMethod(&c);
+        GL_UploadTextureContent(c, uploadMethod);
+
+        LOGDEV_RES_XVERBOSE("Prepared \"%s\" variant (glName:%u)%s",
+                            texture.manifest().composeUri() << uint(glTexName) <<
+                            (uploadMethod == gl::Immediate? " while not busy!" : ""));
+        LOGDEV_RES_XVERBOSE("  Content: %s", Image_Description(image));
+        LOGDEV_RES_XVERBOSE("  Specification %p: %s", &spec << spec.asText());
+
+        // Are we setting the logical dimensions to the pixel dimensions
+        // of the source image?
+        if(texture.width() == 0 && texture.height() == 0)
+        {
+            LOG_RES_XVERBOSE("World dimensions for \"%s\" taken from image pixels %s",
+                             texture.manifest().composeUri() << image.size.asText());
+
+            texture.setDimensions(image.size);
+        }
+
+        // We're done with the image data.
+        Image_ClearPixelData(image);
+    }
 };
 
 ClientTexture::Variant::Variant(ClientTexture &generalCase, TextureVariantSpec const &spec)
@@ -514,80 +615,127 @@ uint ClientTexture::Variant::prepare()
 
     // Load the source image data.
     image_t image;
-    res::Source source = GL_LoadSourceImage(image, d->texture, d->spec);
-    if(source == res::None)
+    if(!d->loadSourceImage(image))
         return 0;
 
-    // Do we need to perform any image pixel data analyses?
-    if(d->spec.type == TST_GENERAL)
+    // Prepare the image for uploading, unless it has been prepared before.
+    PreparedImageBank &bank = App_Resources().preparedImageBank();
+    Block const preparedId = PreparedImageBank::composeId(image, d->spec);
+    dgltexformat_t format;
+    Vector3f lumaFactors;
+    if(!bank.find(preparedId, image, format, lumaFactors))
     {
-        performImageAnalyses(image, d->spec.variant.context, d->texture,
-                             true /*force update*/);
+        format = GL_PrepareTextureImage(image, d->spec, lumaFactors);
+        bank.add(preparedId, image, format, lumaFactors);
     }
 
-    // Are we preparing a new GL texture?
-    if(d->glTexName == 0)
-    {
-        // Acquire a new GL texture name.
-        d->glTexName = GL_GetReservedTextureName();
+    d->upload(image, format, lumaFactors);
+    return d->glTexName;
+}
 
-        // Record the source of the image.
-        d->texSource = source;
-    }
+void ClientTexture::Variant::prepareAll(QList<Variant *> const &variants)
+{
+    LOG_AS("TextureVariant::prepareAll");
 
-    // Prepare texture content for uploading.
-    texturecontent_t c;
-    GL_PrepareTextureContent(c, d->glTexName, image, d->spec, d->texture.manifest());
+    // Maximum number of images held in memory at the same time. Each batch is
+    // uploaded before the source images of the next one are loaded.
+    static dsize const MAX_BATCH_SIZE = 32;
 
-    /**
-     * Calculate GL texture coordinates based on the image dimensions. The
-     * coordinates are calculated as width / CeilPow2(width), or 1 if larger
-     * than the maximum texture size.
-     *
-     * @todo fixme: Image dimensions may not be the same as the uploaded
-     * texture - defer this logic until all processing has been completed.
-     */
-    if ((c.flags & TXCF_UPLOAD_ARG_NOSTRETCH) &&
-        (c.flags & TXCF_MIPMAP))
+    struct Preparation
     {
-        d->s = image.size.x / float( de::ceilPow2(image.size.x) );
-        d->t = image.size.y / float( de::ceilPow2(image.size.y) );
-    }
-    else
-    {
-        d->s = 1;
-        d->t = 1;
-    }
+        Variant *variant;
+        image_t image;
+        Block preparedId;
+        bool reused;
+        dgltexformat_t format;
+        Vector3f lumaFactors;
+    };
+    std::vector<Preparation> preps;
+    preps.reserve(de::min(dsize(variants.size()), MAX_BATCH_SIZE));
 
-    if(image.flags & IMGF_IS_MASKED)
+    // Releases the pixel data still held by the batch if preparing it throws.
+    // Uploaded images have already been released.
+    struct BatchGuard
     {
-        d->flags |= TextureVariant::Masked;
-    }
+        std::vector<Preparation> &preps;
+        ~BatchGuard()
+        {
+            for(Preparation &prep : preps)
+            {
+                Image_ClearPixelData(prep.image);
+            }
+        }
+    } const batchGuard { preps };
 
-    // Submit the content for uploading (possibly deferred).
-    gl::UploadMethod uploadMethod = GL_ChooseUploadMethod(&c);
-    GL_UploadTextureContent(c, uploadMethod);
+    PreparedImageBank &bank = App_Resources().preparedImageBank();
 
-    LOGDEV_RES_XVERBOSE("Prepared \"%s\" variant (glName:%u)%s",
-                        d->texture.manifest().composeUri() << uint(d->glTexName) <<
-                        (uploadMethod == gl::Immediate? " while not busy!" : ""));
-    LOGDEV_RES_XVERBOSE("  Content: %s", Image_Description(image));
-    LOGDEV_RES_XVERBOSE("  Specification %p: %s", &d->spec << d->spec.asText());
+    QSet<Variant *> seen;
+    QSet<colorpaletteid_t> palettes;
+    int numPrepared = 0;
 
-    // Are we setting the logical dimensions to the pixel dimensions
-    // of the source image?
-    if(d->texture.width() == 0 && d->texture.height() == 0)
+    for(auto next = variants.begin(); next != variants.end(); )
     {
-        LOG_RES_XVERBOSE("World dimensions for \"%s\" taken from image pixels %s",
-                         d->texture.manifest().composeUri() << image.size.asText());
+        // The source images are loaded and analyzed one at a time, because neither
+        // the file system nor the analysis data of the textures is thread-safe.
+        preps.clear();
+        for(; next != variants.end() && preps.size() < MAX_BATCH_SIZE; ++next)
+        {
+            Variant *variant = *next;
+            if(!variant || variant->isPrepared() || seen.contains(variant))
+                continue;
+            seen.insert(variant);
+
+            preps.push_back(Preparation());
+            Preparation &prep = preps.back();
+            prep.variant = variant;
+            if(!variant->d->loadSourceImage(prep.image))
+            {
+                preps.pop_back();
+                continue;
+            }
 
-        d->texture.setDimensions(image.size);
-    }
+            prep.preparedId = PreparedImageBank::composeId(prep.image, variant->d->spec);
+            prep.reused = bank.find(prep.preparedId, prep.image, prep.format, prep.lumaFactors);
 
-    // We're done with the image data.
-    Image_ClearPixelData(image);
+            if(!prep.reused && prep.image.paletteId && !palettes.contains(prep.image.paletteId))
+            {
+                // The nearest color table of a palette is built on first use. Make
+                // sure it won't be built during the concurrent processing.
+                App_Resources().colorPalettes().colorPalette(prep.image.paletteId)
+                        .nearestIndex(Vector3ub());
+                palettes.insert(prep.image.paletteId);
+            }
+        }
+        if(preps.empty()) continue;
 
-    return d->glTexName;
+        // Converting and filtering the pixel data is independent for each image.
+        parallelFor(dsize(preps.size()), [&preps] (dsize start, dsize end)
+        {
+            for(dsize i = start; i < end; ++i)
+            {
+                Preparation &prep = preps[i];
+                if(prep.reused) continue;
+
+                prep.format = GL_PrepareTextureImage(prep.image, prep.variant->d->spec,
+                                                     prep.lumaFactors);
+            }
+        }, 1);
+
+        for(Preparation &prep : preps)
+        {
+            if(!prep.reused)
+            {
+                bank.add(prep.preparedId, prep.image, prep.format, prep.lumaFactors);
+            }
+            prep.variant->d->upload(prep.image, prep.format, prep.lumaFactors);
+        }
+        numPrepared += int(preps.size());
+    }
+
+    if(numPrepared)
+    {
+        LOGDEV_RES_VERBOSE("Prepared %i texture variants") << numPrepared;
+    }
 }
 
 void ClientTexture::Variant::release()
@@ -22,6 +22,7 @@
 
 #include <map>
 #include <utility>
+#include <QCryptographicHash>
 #include <QMap>
 #include <QtAlgorithms>
 #include <de/memoryzone.h>
@@ -29,15 +30,19 @@
 #include <de/Binder>
 #include <de/Context>
 #include <de/Error>
+#include <de/FileSystem>
 #include <de/Log>
+#include <de/Reader>
 #include <de/Scheduler>
 #include <de/ScriptSystem>
 #include <de/Time>
+#include <de/Writer>
 #include <doomsday/doomsdayapp.h>
 #include <doomsday/console/cmd.h>
 #include <doomsday/console/exec.h>
 #include <doomsday/console/var.h>
 #include <doomsday/defs/mapinfo.h>
+#include <doomsday/filesys/fs_main.h>
 #include <doomsday/resource/mapmanifests.h>
 #include <doomsday/world/MaterialManifest>
 #include <doomsday/world/Materials>
@@ -66,6 +71,7 @@
 #include "api_mapedit.h"
 #include "world/p_players.h"
 #include "world/p_ticker.h"
+#include "world/reject.h"
 #include "world/sky.h"
 #include "world/thinkers.h"
 #include "world/bindings_world.h"
@@ -279,10 +285,13 @@ dint const MapConversionReporter::maxWarningsPerType = 10;
 dd_bool ddMapSetup;
 
 // Should we be caching successfully loaded maps?
-//static byte mapCache = true; // cvar
+static byte mapCache = true; // cvar
 
 static char const *mapCacheDir = "mapcache/";
 
+/// Version of the map cache file format. Increment when the format changes.
+static duint32 const MAP_CACHE_VERSION = 3;
+
 /// Determine the identity key for maps loaded from the specified @a sourcePath.
 static String cacheIdForMap(String const &sourcePath)
 {
@@ -358,16 +367,57 @@ DENG2_PIMPL(ClientServerWorld)
                + '-' + cacheIdForMap(sourcePath);
     }
 
+    /**
+     * Data cached from a previous conversion of a map.
+     */
+    struct CachedMapData
+    {
+        Map::BspBuildChoices bspChoices;
+        world::Reject reject;
+        Block loadedFilesHash; ///< Resources present when the conversion was recorded.
+        Block conversion;      ///< Recorded runtime map editing calls (see MPE_Replay()).
+    };
+
+    /**
+     * Begin building a new map with the runtime map editing interface.
+     */
+    static Map *beginMap(res::MapManifest const &mapManifest, MapConversionReporter *reporter,
+                         Map::BspBuildChoices const &bspChoices)
+    {
+        MPE_Begin(nullptr/*dummy*/);
+
+        Map *newMap = MPE_Map();
+
+        // Associate the map with its corresponding manifest.
+        newMap->setManifest(&const_cast<res::MapManifest &>(mapManifest));
+
+        // Reuse cached partitions when building the BSP.
+        newMap->setBspBuildChoices(bspChoices);
+
+        if (reporter)
+        {
+            // Instruct the reporter to begin observing the conversion.
+            reporter->setMap(newMap);
+        }
+        return newMap;
+    }
+
     /**
      * Attempt JIT conversion of the map data with the help of a plugin. Note that
      * the map is left in an editable state in case the caller wishes to perform
      * any further changes.
      *
-     * @param reporter  Reporter which will observe the conversion process.
+     * @param reporter    Reporter which will observe the conversion process.
+     * @param bspChoices  Cached BSP partition choices.
+     * @param recording   If not @c nullptr, the runtime map editing calls made by
+     *                    the converter are recorded here. The recording is left
+     *                    empty if the conversion could not be recorded.
      *
      * @return  The newly converted map (if any).
      */
-    Map *convertMap(res::MapManifest const &mapManifest, MapConversionReporter *reporter = nullptr)
+    Map *convertMap(res::MapManifest const &mapManifest, MapConversionReporter *reporter = nullptr,
+                    Map::BspBuildChoices const &bspChoices = Map::BspBuildChoices(),
+                    Block *recording = nullptr)
     {
         // We require a map converter for this.
         if (!Plug_CheckForHook(HOOK_MAP_CONVERT))
@@ -378,25 +428,21 @@ DENG2_PIMPL(ClientServerWorld)
         if (!mapManifest.sourceFile()) return nullptr;
 
         // Initiate the conversion process.
-        MPE_Begin(nullptr/*dummy*/);
+        beginMap(mapManifest, reporter, bspChoices);
 
-        Map *newMap = MPE_Map();
-
-        // Associate the map with its corresponding manifest.
-        newMap->setManifest(&const_cast<res::MapManifest &>(mapManifest));
-
-        if (reporter)
-        {
-            // Instruct the reporter to begin observing the conversion.
-            reporter->setMap(newMap);
-        }
+        if (recording) MPE_BeginRecording(*recording);
 
         // Ask each converter in turn whether the map format is recognizable
         // and if so to interpret and transfer it to us via the runtime map
         // editing interface.
-        if (!DoomsdayApp::plugins().callAllHooks(HOOK_MAP_CONVERT, 0,
-                                                const_cast<Id1MapRecognizer *>(&mapManifest.recognizer())))
-            return nullptr;
+        bool const converted = DoomsdayApp::plugins().callAllHooks(HOOK_MAP_CONVERT, 0,
+                                    const_cast<Id1MapRecognizer *>(&mapManifest.recognizer()));
+
+        if (recording && !MPE_EndRecording())
+        {
+            recording->clear();
+        }
+        if (!converted) return nullptr;
 
         // A converter signalled success.
 
@@ -407,39 +453,167 @@ DENG2_PIMPL(ClientServerWorld)
         return MPE_TakeMap();
     }
 
-#if 0
     /**
-     * Returns @c true iff data for the map is available in the cache.
+     * Rebuild the map by replaying the runtime map editing calls recorded during
+     * a previous conversion. No converter plugin is needed for this.
+     *
+     * @return  The rebuilt map (still editable), or @c nullptr if the recording
+     * could not be replayed.
+     */
+    Map *replayMapConversion(res::MapManifest const &mapManifest, MapConversionReporter *reporter,
+                             CachedMapData const &cached)
+    {
+        LOG_DEBUG("Replaying cached conversion of \"%s\"...") << mapManifest.composeUri().path();
+
+        beginMap(mapManifest, reporter, cached.bspChoices);
+
+        if (!MPE_Replay(cached.conversion))
+        {
+            if (reporter) reporter->setMap(nullptr);
+            delete MPE_TakeMap();
+            return nullptr;
+        }
+
+        MPE_End();
+        return MPE_TakeMap();
+    }
+
+    /**
+     * Returns the path of the cache file for the map.
      */
-    bool haveCachedMap(res::MapManifest &mapManifest)
+    static String cacheFilePath(res::MapManifest const &mapManifest)
     {
-        // Disabled?
-        if (!mapCache) return false;
-        return DAM_MapIsValid(mapManifest.cachePath, mapManifest.id());
+        return String("/home") / cachePath(mapManifest.sourceFile()->composePath()).toString()
+                               / (mapManifest.gets("id") + ".dmc");
     }
 
     /**
-     * Attempt to load data for the map from the cache.
+     * Calculates a hash of the contents of all the data lumps of the map. Cached data
+     * is only valid for maps whose contents match exactly.
+     */
+    static Block contentHash(res::MapManifest const &mapManifest)
+    {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        for (File1 *lump : mapManifest.recognizer().lumps())
+        {
+            if (!lump || !lump->size()) continue;
+            hash.addData(reinterpret_cast<char const *>(lump->cache()), int(lump->size()));
+            lump->unlock();
+        }
+        // Partitioning depends on the split cost factor, too.
+        dint32 const splitFactor = Con_GetInteger("bsp-factor");
+        hash.addData(reinterpret_cast<char const *>(&splitFactor), sizeof(splitFactor));
+        return hash.result();
+    }
+
+    /**
+     * Calculates a hash identifying the set of loaded resource files. Converters may
+     * look up textures while translating the map data, so a recorded conversion is
+     * only replayed when the same files are loaded.
+     */
+    static Block loadedFilesHash()
+    {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        for (FileHandle *handle : App_FileSystem().loadedFiles())
+        {
+            File1 const &file = handle->file();
+            hash.addData(file.composePath().toUtf8());
+            duint32 const info[2] = { file.size(), file.lastModified() };
+            hash.addData(reinterpret_cast<char const *>(info), sizeof(info));
+        }
+        return hash.result();
+    }
+
+    /**
+     * Attempt to read previously cached data for the map.
      *
-     * @see isCachedDataAvailable()
+     * @param mapManifest  Manifest of the map.
+     * @param hash         Content hash of the map's data lumps.
+     * @param cached       Cached data is written here.
      *
-     * @return  @c true if loading completed successfully.
+     * @return  @c true if valid cached data was found.
      */
-    Map *loadMapFromCache(MapManifest &mapManifest)
+    bool readMapCache(res::MapManifest const &mapManifest, Block const &hash,
+                      CachedMapData &cached)
     {
-        Uri const mapUri = mapManifest.composeUri();
-        Map *map = DAM_MapRead(mapManifest.cachePath);
-        if (!map)
-            /// Failed to load the map specified from the data cache.
-            throw Error("loadMapFromCache", "Failed loading map \"" + mapUri.asText() + "\" from cache");
+        try
+        {
+            if (File const *file = FS::tryLocate<File const>(cacheFilePath(mapManifest)))
+            {
+                Block data;
+                *file >> data;
+
+                Reader reader(data);
+                duint32 version;
+                Block cachedHash;
+                reader.withHeader() >> version;
+                if (version != MAP_CACHE_VERSION) return false;
+                reader >> cachedHash;
+                if (cachedHash != hash) return false; // Outdated.
+
+                cached.bspChoices.clear();
+                reader.readElements(cached.bspChoices);
+                reader >> cached.reject
+                       >> cached.loadedFilesHash
+                       >> cached.conversion;
+                return true;
+            }
+        }
+        catch (Error const &er)
+        {
+            LOGDEV_MAP_WARNING("Failed reading cached data for \"%s\": %s")
+                << mapManifest.composeUri().path() << er.asText();
+        }
+        return false;
+    }
 
-        map->_uri = mapUri;
-        return map;
+    /**
+     * Write the cached data of the (fully built) @a map.
+     */
+    void writeMapCache(Map const &map, Block const &hash, Block const &filesHash,
+                       Block const &conversion)
+    {
+        DENG2_ASSERT(!map.isEditable());
+        DENG2_ASSERT(map.hasManifest());
+
+        try
+        {
+            Block data;
+            Writer writer(data);
+            writer.withHeader() << MAP_CACHE_VERSION << hash;
+            writer.writeElements(map.bspBuildChoices());
+            writer << map.reject() << filesHash << conversion;
+
+            String const path = cacheFilePath(map.manifest());
+            File &file = FS::get().makeFolder(path.fileNamePath()).replaceFile(path.fileName());
+            file << data;
+            file.flush();
+
+            LOG_MAP_VERBOSE("Cached map data written to \"%s\"") << path;
+        }
+        catch (Error const &er)
+        {
+            LOG_MAP_WARNING("Failed caching data for \"%s\": %s")
+                << map.manifest().composeUri().path() << er.asText();
+        }
+    }
+
+    /**
+     * Reads the reject LUT of the map from its REJECT lump, if it has one.
+     */
+    static world::Reject rejectFromLump(res::MapManifest const &mapManifest, dint sectorCount)
+    {
+        File1 *lump = mapManifest.recognizer().lumps().value(Id1MapRecognizer::RejectData);
+        if (!lump || !lump->size()) return world::Reject();
+
+        Block const data(lump->cache(), lump->size());
+        lump->unlock();
+        return world::Reject::fromLump(data, sectorCount);
     }
-#endif
 
     /**
-     * Attempt to load the associated map data.
+     * Attempt to load the associated map data. The map is switched to a playable
+     * state before it is returned.
      *
      * @return  The loaded map if successful. Ownership given to the caller.
      */
@@ -448,20 +622,72 @@ DENG2_PIMPL(ClientServerWorld)
         LOG_AS("ClientServerWorld::loadMap");
 
         /*if (mapManifest.lastLoadAttemptFailed && !forceRetry)
-            return nullptr;
-
-        // Load from cache?
-        if (haveCachedMap(mapManifest))
+            return nullptr;*/
+
+        // Check the cache for data from a previous conversion of this map.
+        Block hash;
+        Block filesHash;
+        CachedMapData cached;
+        bool haveCachedData = false;
+        if (mapCache && mapManifest.sourceFile())
         {
-            return loadMapFromCache(mapManifest);
-        }*/
+            hash      = contentHash(mapManifest);
+            filesHash = loadedFilesHash();
+            haveCachedData = readMapCache(mapManifest, hash, cached);
+        }
 
-        // Try a JIT conversion with the help of a plugin.
-        Map *map = convertMap(mapManifest, reporter);
+        // A recorded conversion can be replayed without the converter plugin.
+        Map *map = nullptr;
+        bool const canReplay = haveCachedData && !cached.conversion.isEmpty() &&
+                               cached.loadedFilesHash == filesHash;
+        if (canReplay)
+        {
+            map = replayMapConversion(mapManifest, reporter, cached);
+        }
+        Block conversion = (map? cached.conversion : Block());
+        if (!map)
+        {
+            // Try a JIT conversion with the help of a plugin.
+            map = convertMap(mapManifest, reporter, cached.bspChoices,
+                             mapCache? &conversion : nullptr);
+        }
         if (!map)
         {
             LOG_WARNING("Failed conversion of \"%s\".") << mapManifest.composeUri().path();
             //mapManifest.lastLoadAttemptFailed = true;
+            return nullptr;
+        }
+
+        // Switch to a playable state. This builds the BSP and the other derived data.
+        if (!map->endEditing())
+        {
+            // Darn. Discard the useless data.
+            if (reporter) reporter->setMap(nullptr);
+            delete map;
+            return nullptr;
+        }
+
+        // The cached reject LUT can be used if the map was partitioned the same way.
+        bool rebuiltReject = false;
+        if (!haveCachedData || map->bspBuildChoices() != cached.bspChoices ||
+            cached.reject.sectorCount() != map->sectorCount())
+        {
+            cached.reject = world::Reject::build(*map);
+            if (cached.reject.isEmpty())
+            {
+                // Too complicated to build; the map's own LUT will have to do.
+                cached.reject = rejectFromLump(mapManifest, map->sectorCount());
+            }
+            rebuiltReject = !cached.reject.isEmpty();
+        }
+        map->setReject(cached.reject);
+
+        // Should we cache this map?
+        if (mapCache && !hash.isEmpty() &&
+            (!haveCachedData || map->bspBuildChoices() != cached.bspChoices || rebuiltReject ||
+             cached.loadedFilesHash != filesHash || cached.conversion != conversion))
+        {
+            writeMapCache(*map, hash, filesHash, conversion);
         }
         return map;
     }
@@ -478,16 +704,6 @@ DENG2_PIMPL(ClientServerWorld)
         // We cannot make an editable map current.
         DENG2_ASSERT(!map->isEditable());
 
-        // Should we cache this map?
-        /*if (mapCache && !haveCachedMap(&map->def()))
-        {
-            // Ensure the destination directory exists.
-            F_MakePath(map->def().cachePath.toUtf8().constData());
-
-            // Cache the map!
-            DAM_MapWrite(map);
-        }*/
-
 #ifdef __CLIENT__
         // Connect the map to world audiences:
         /// @todo The map should instead be notified when it is made current
@@ -747,17 +963,8 @@ DENG2_PIMPL(ClientServerWorld)
         Map *newMap = loadMap(*mapManifest, &reporter);
         if (newMap)
         {
-            // The map may still be in an editable state -- switch to playable.
-            bool const mapIsPlayable = newMap->endEditing();
-
             // Cancel further reports about the map.
             reporter.setMap(nullptr);
-
-            if (!mapIsPlayable)
-            {
-                // Darn. Discard the useless data.
-                delete newMap; newMap = nullptr;
-            }
         }
 
         // This becomes the new current map.
@@ -979,7 +1186,7 @@ void ClientServerWorld::endFrame()
 
 void ClientServerWorld::consoleRegister()  // static
 {
-    //C_VAR_BYTE ("map-cache", &mapCache, 0, 0, 1);
+    C_VAR_BYTE ("map-cache", &mapCache, 0, 0, 1);
 #ifdef __CLIENT__
     //C_VAR_FLOAT("edit-bias-grab-distance", &handDistance, 0, 10, 1000);
 #endif
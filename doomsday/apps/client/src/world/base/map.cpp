@@ -43,6 +43,7 @@
 #include "world/p_object.h"
 #include "world/p_players.h"
 #include "world/polyobjdata.h"
+#include "world/reject.h"
 #include "world/sky.h"
 #include "world/thinkers.h"
 #include "BspLeaf"
@@ -78,8 +79,14 @@
 #include <doomsday/BspNode>
 #include <doomsday/world/Materials>
 
+#include <de/App>
+#include <de/CommandLine>
 #include <de/LogBuffer>
 #include <de/Rectangle>
+#ifdef __CLIENT__
+#  include <de/TaskScheduler>
+#  include <de/fixedpoint.h>
+#endif
 
 #include <de/aabox.h>
 #include <de/charsymbols.h>
@@ -105,6 +112,12 @@ static dint lgMXSample = 1;  ///< 5 samples per block.
 /// removed from the hash. Under normal circumstances, the special
 /// status should be removed fairly quickly.
 #define CLMOBJ_TIMEOUT  4000
+
+/// Number of particles stepped in one batch.
+static dint const PARTICLE_BATCH_SIZE = 256;
+
+/// If there are fewer particles in total, they are stepped in the calling thread.
+static dint const MIN_PARALLEL_PARTICLES = 1024;
 #endif
 
 namespace world {
@@ -282,7 +295,9 @@ DENG2_PIMPL(Map)
     QList<Polyobj *> polyobjs;
 
     Bsp bsp;
+    BspBuildChoices bspChoices;              ///< Partition choices for (re)building the BSP.
     QVector<ConvexSubspace *> subspaces;     ///< All player-traversable subspaces.
+    Reject reject;                           ///< Sector line-of-sight LUT.
     QHash<Id, Subsector *> subsectorsById; ///< Not owned.
 
     //
@@ -603,14 +618,24 @@ DENG2_PIMPL(Map)
             bsp::Partitioner partitioner(bspSplitFactor);
             partitioner.audienceForUnclosedSectorFound += this;
 
+            // Reuse the partition choices of a previous build, if available.
+            partitioner.setReplayChoices(bspChoices);
+
+            // Optionally check that the concurrent build matches a serial one.
+            partitioner.setVerifyParallelBuild(App::commandLine().has("-bspverify"));
+
             // Build a new BSP tree.
             bsp.tree = partitioner.makeBspTree(linesToBuildFor, mesh);
             DENG2_ASSERT(bsp.tree);
 
-            LOG_MAP_VERBOSE("BSP built: %s. With %d Segments and %d Vertexes.")
+            // Remember the choices made so that the tree can be cached.
+            bspChoices = partitioner.choices();
+
+            LOG_MAP_VERBOSE("BSP built: %s. With %d Segments and %d Vertexes%s.")
                     << bsp.tree->summary()
                     << partitioner.segmentCount()
-                    << partitioner.vertexCount();
+                    << partitioner.vertexCount()
+                    << (partitioner.choicesWereReplayed()? " (replayed partitions)" : "");
 
             // Attribute an index to any new vertexes.
             for (dint i = nextVertexOrd; i < mesh.vertexCount(); ++i)
@@ -1483,13 +1508,13 @@ DENG2_PIMPL(Map)
             {
                 if (!gen) continue;
 
-                ParticleInfo const *pInfo = gen->particleInfo();
-                for (dint i = 0; i < gen->count; ++i, pInfo++)
+                ParticleStore const &particles = gen->particles();
+                for (dint i = 0; i < gen->count; ++i)
                 {
-                    if (pInfo->stage < 0 || !pInfo->bspLeaf)
+                    if (particles.stage[i] < 0 || !particles.bspLeaf[i])
                         continue;
 
-                    dint listIndex = pInfo->bspLeaf->sectorPtr()->indexInMap();
+                    dint listIndex = particles.bspLeaf[i]->sectorPtr()->indexInMap();
                     DENG2_ASSERT((unsigned)listIndex < gens.listsSize);
 
                     // Must check that it isn't already there...
@@ -1555,6 +1580,17 @@ BspTree const &Map::bspTree() const
     throw MissingBspTreeError("Map::bspTree", "No BSP tree is available");
 }
 
+Reject const &Map::reject() const
+{
+    return d->reject;
+}
+
+void Map::setReject(Reject const &reject)
+{
+    DENG2_ASSERT(reject.isEmpty() || reject.sectorCount() == sectorCount());
+    d->reject = reject;
+}
+
 #ifdef __CLIENT__
 
 SkyDrawable::Animator &Map::skyAnimator() const
@@ -2898,6 +2934,58 @@ LoopResult Map::forAllGenerators(std::function<LoopResult (Generator &)> func) c
     return LoopContinue;
 }
 
+void Map::moveGeneratorParticles()
+{
+    struct ParticleRange
+    {
+        Generator *gen;
+        dint first;
+        dint end;
+    };
+    QVector<ParticleRange> ranges;
+    dint total = 0;
+    for (Generator *gen : d->getGenerators().activeGens)
+    {
+        if (!gen || !gen->isMovePending()) continue;
+
+        for (dint i = 0; i < gen->count; i += PARTICLE_BATCH_SIZE)
+        {
+            ranges.append(ParticleRange { gen, i, de::min(i + PARTICLE_BATCH_SIZE, gen->count) });
+        }
+        total += gen->count;
+    }
+    if (ranges.isEmpty()) return;
+
+    // Changes to momentum and the Z steps only depend on the particle itself and
+    // the planes, which do not move meanwhile.
+    /// @todo Do not assume generators are from the CURRENT map.
+    fixed_t const grav = FLT2FIX(gravity());
+    auto step = [&ranges, grav] (dsize start, dsize end)
+    {
+        for (dsize i = start; i < end; ++i)
+        {
+            ParticleRange const &range = ranges.at(int(i));
+            range.gen->stepParticles(range.first, range.end, grav);
+        }
+    };
+    if (total >= MIN_PARALLEL_PARTICLES)
+    {
+        parallelFor(dsize(ranges.size()), step, 1);
+    }
+    else
+    {
+        step(0, dsize(ranges.size()));
+    }
+
+    for (Generator *gen : d->getGenerators().activeGens)
+    {
+        if (gen && gen->isMovePending())
+        {
+            gen->moveParticles();
+        }
+    }
+}
+
 LoopResult Map::forAllGeneratorsInSector(Sector const &sector, std::function<LoopResult (Generator &)> func) const
 {
     if (sector.mapPtr() == this)  // Ignore 'alien' sectors.
@@ -4129,6 +4217,20 @@ bool Map::endEditing()
     return true;
 }
 
+Map::BspBuildChoices const &Map::bspBuildChoices() const
+{
+    return d->bspChoices;
+}
+
+void Map::setBspBuildChoices(BspBuildChoices const &choices)
+{
+    if (!d->editingEnabled)
+        /// @throw EditError  Attempted when not editing.
+        throw EditError("Map::setBspBuildChoices", "Editing is not enabled");
+
+    d->bspChoices = choices;
+}
+
 Vertex *Map::createVertex(Vector2d const &origin, dint archiveIndex)
 {
     if (!d->editingEnabled)
@@ -1,13 +1,10 @@
-/** @file reject.h World map sector LOS reject LUT building.
+/** @file reject.cpp  World map sector LOS reject LUT.
  *
  * @authors Copyright © 2007-2013 Daniel Swanson <danij@dengine.net>
  * @authors Copyright © 2000-2007 Andrew Apted <ajapted@gmail.com>
  * @authors Copyright © 1998-2000 Colin Reed <cph@moria.org.uk>
  * @authors Copyright © 1998-2000 Lee Killough <killough@rsn.hp.com>
  *
- * Based on glBSP 2.24 (in turn, based on BSP 2.3).
- * @see http://sourceforge.net/projects/glbsp/
- *
  * @par License
  * GPL: http://www.gnu.org/licenses/gpl.html
  *
@@ -23,92 +20,377 @@
  * 02110-1301 USA</small>
  */
 
-#if 0 // Needs updating.
-#include <cmath>
+#include "world/reject.h"
 
-#include "de_base.h"
-#include "world/map.h"
+#include <de/Log>
+#include <de/Reader>
+#include <de/TaskScheduler>
+#include <de/Time>
+#include <de/Writer>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 
 using namespace de;
 
-void BuildRejectForMap(Map const &map)
+namespace world {
+
+namespace {
+
+/// Points this close to the outside of a clipping line are still considered to
+/// be inside it. Errs on the side of visibility.
+static ddouble const EPSILON = 1.0 / 128;
+
+/// Points this close to a separating line are considered to be on it.
+static ddouble const ON_LINE = 1.0e-6;
+
+/**
+ * Maximum number of portals clipped when tracing the lines of sight from one
+ * sector. If exceeded, everything is assumed to be visible from the sector.
+ */
+static dint const MAX_CLIPS_PER_SECTOR = 0x40000;
+
+/**
+ * Maximum number of portals clipped when building the LUT for a whole map. If
+ * exceeded, the LUT is not built at all.
+ */
+static dint64 const MAX_CLIPS_TOTAL = 0x2000000;
+
+/**
+ * Half-plane in map space. Points on the side the normal points to are inside.
+ */
+struct HalfPlane
 {
-    int *secGroups = M_Malloc(sizeof(int) * map.sectorCount());
-    int group = 0;
+    Vector2d point;
+    Vector2d normal;  ///< Unit length.
 
-    for(uint i = 0; i < map.sectorCount(); ++i)
-    {
-        Sector &sector = map.sectors[i];
-        secGroups[i] = group++;
-        sector.rejNext = sector.rejPrev = &sector;
+    inline ddouble distance(Vector2d const &pos) const {
+        return normal.dot(pos - point);
     }
+};
+
+/**
+ * Returns the half-plane in front of @a portal, on the side of its target region.
+ */
+static HalfPlane frontOf(Reject::Portal const &portal)
+{
+    Vector2d const dir = portal.to - portal.from;
+    ddouble const len = dir.length();
+    return HalfPlane{ portal.from, len > 0? Vector2d(-dir.y, dir.x) / len : Vector2d() };
+}
+
+/**
+ * Clips the segment @a a - @a b to the half-plane.
+ *
+ * @return  @c false if nothing remains of the segment.
+ */
+static bool clipSegment(HalfPlane const &plane, Vector2d &a, Vector2d &b)
+{
+    ddouble const da = plane.distance(a) + EPSILON;
+    ddouble const db = plane.distance(b) + EPSILON;
+    if (da >= 0 && db >= 0) return true;
+    if (da < 0 && db < 0) return false;
 
-    for(uint i = 0; i < map.lineCount(); ++i)
+    Vector2d const cross = a + (b - a) * (da / (da - db));
+    if (da < 0) a = cross;
+    else        b = cross;
+    return true;
+}
+
+/**
+ * Finds the lines that separate the source segment from the window (i.e., the
+ * segments are on opposite sides of the line), bounding the region where the
+ * lines of sight passing through both segments can continue.
+ *
+ * @return  Number of half-planes written to @a planes (at most 4).
+ */
+static dint findSeparators(Vector2d const source[2], Vector2d const window[2], HalfPlane *planes)
+{
+    dint count = 0;
+    for (dint i = 0; i < 2; ++i)
+    for (dint j = 0; j < 2; ++j)
     {
-        Line *line = &map.lines[i];
+        Vector2d const dir = window[j] - source[i];
+        ddouble const len = dir.length();
+        if (len < ON_LINE) continue;
 
-        if(!line->front().hasSector() || !line->back().hasSector())
-            continue;
+        Vector2d const normal = Vector2d(-dir.y, dir.x) / len;
+        ddouble const ds = normal.dot(source[i ^ 1] - source[i]);
+        ddouble const dw = normal.dot(window[j ^ 1] - source[i]);
+        bool const sourceOnLine = std::abs(ds) <= ON_LINE;
+        bool const windowOnLine = std::abs(dw) <= ON_LINE;
 
-        Sector *sec1 = line->front().sectorPtr();
-        Sector *sec2 = line->back().sectorPtr();
+        if (sourceOnLine && windowOnLine) continue;
+        if (!sourceOnLine && !windowOnLine && (ds > 0) == (dw > 0)) continue; // Not separating.
 
-        if(!sec1 || !sec2 || sec1 == sec2)
-            continue;
+        // The lines of sight continue on the window's side.
+        bool const positive = (windowOnLine? ds < 0 : dw > 0);
+        planes[count++] = HalfPlane{ source[i], positive? normal : -normal };
+    }
+    return count;
+}
 
-        // Already in the same group?
-        if(secGroups[sec1->index] == secGroups[sec2->index])
-            continue;
+/**
+ * Traces the lines of sight through the portals between regions.
+ */
+struct Tracer
+{
+    Reject::Portals const &portals;
+    std::vector<std::vector<dint>> byRegion;   ///< Portals on the back side of each region.
 
-        // Swap sectors so that the smallest group is added to the biggest
-        // group. This is based on the assumption that sector numbers in
-        // wads will generally increase over the set of lines, and so
-        // (by swapping) we'll tend to add small groups into larger
-        // groups, thereby minimising the updates to 'rej_group' fields
-        // that is required when merging.
-        Sector *p = 0;
-        if(secGroups[sec1->index] > secGroups[sec2->index])
+    Tracer(dint regionCount, Reject::Portals const &portals)
+        : portals(portals)
+        , byRegion(regionCount)
+    {
+        for (dint i = 0; i < dint(portals.size()); ++i)
         {
-            p = sec1;
-            sec1 = sec2;
-            sec2 = p;
+            DENG2_ASSERT(portals[i].region >= 0 && portals[i].region < regionCount);
+            DENG2_ASSERT(portals[i].target >= 0 && portals[i].target < regionCount);
+            byRegion[portals[i].region].push_back(i);
         }
+    }
 
-        // Update the group numbers in the second group
-        secGroups[sec2->index] = secGroups[sec1->index];
-        for(p = sec2->rejNext; p != sec2; p = p->rejNext)
+    /**
+     * Traces the lines of sight from the sector @a source through the portals,
+     * marking the regions they reach.
+     *
+     * @param source   Region index of the sector.
+     * @param visible  One flag per region.
+     *
+     * @return  Number of portals clipped.
+     */
+    dint trace(dint source, std::vector<bool> &visible) const
+    {
+        struct Window
         {
-            secGroups[p->index] = secGroups[sec1->index];
+            dint portal;            ///< Portal the window is on.
+            Vector2d source[2];     ///< Part of the first portal of the path that can see the window.
+            Vector2d window[2];
+            HalfPlane planes[6];
+            dint planeCount;
+            dsize next;             ///< Next portal to clip against the window.
+        };
+
+        std::vector<Window> stack;
+        std::vector<bool> onPath(portals.size());
+        dint clips = 0;
+
+        visible[source] = true;
+        for (dint first : byRegion[source])
+        {
+            Reject::Portal const &start = portals[first];
+            visible[start.target] = true;
+
+            Window root;
+            root.portal    = first;
+            root.source[0] = root.window[0] = start.from;
+            root.source[1] = root.window[1] = start.to;
+            root.planes[0] = frontOf(start);
+            root.planeCount = 1;
+            root.next      = 0;
+            stack.push_back(root);
+            onPath[first] = true;
+
+            while (!stack.empty())
+            {
+                Window &current = stack.back();
+                auto const &candidates = byRegion[portals[current.portal].target];
+                if (current.next >= candidates.size())
+                {
+                    onPath[current.portal] = false;
+                    stack.pop_back();
+                    continue;
+                }
+
+                dint const index = candidates[current.next++];
+                Reject::Portal const &portal = portals[index];
+                if (onPath[index] || (portal.twin >= 0 && onPath[portal.twin]))
+                    continue;
+
+                if (++clips > MAX_CLIPS_PER_SECTOR)
+                {
+                    // Too complicated; assume everything is visible.
+                    std::fill(visible.begin(), visible.end(), true);
+                    return clips;
+                }
+
+                // Which part of the portal can be seen through the window?
+                Vector2d clipped[2] = { portal.from, portal.to };
+                bool seen = true;
+                for (dint i = 0; i < current.planeCount && seen; ++i)
+                {
+                    seen = clipSegment(current.planes[i], clipped[0], clipped[1]);
+                }
+                if (!seen) continue;
+
+                visible[portal.target] = true;
+
+                // Only the part of the source behind the portal can see through it.
+                HalfPlane const front = frontOf(portal);
+                Window next;
+                next.source[0] = current.source[0];
+                next.source[1] = current.source[1];
+                if (!clipSegment(HalfPlane{ front.point, -front.normal }, next.source[0], next.source[1]))
+                    continue;
+
+                next.portal    = index;
+                next.window[0] = clipped[0];
+                next.window[1] = clipped[1];
+                next.planes[0] = stack.front().planes[0];
+                next.planes[1] = front;
+                next.planeCount = 2 + findSeparators(next.source, next.window, next.planes + 2);
+                next.next      = 0;
+                stack.push_back(next); // Invalidates current.
+                onPath[index] = true;
+            }
         }
+        return clips;
+    }
+};
 
-        // Merge 'em baby...
-        sec1->rejNext->rejPrev = sec2;
-        sec2->rejNext->rejPrev = sec1;
+} // namespace
+
+Reject::Reject()
+    : _sectorCount(0)
+    , _rowSize(0)
+{}
+
+Reject Reject::build(dint count, Portals const &portals) // static
+{
+    LOG_AS("Reject");
 
-        p = sec1->rejNext;
-        sec1->rejNext = sec2->rejNext;
-        sec2->rejNext = p;
+    Reject reject;
+    if (count <= 0 || count > MAX_SECTORS)
+    {
+        return reject;
     }
 
-    size_t rejectSize = (map.sectorCount() * map.sectorCount() + 7) / 8;
-    byte *matrix = Z_Calloc(rejectSize, PU_MAPSTATIC, 0);
+    Time const begunAt;
+    Tracer const tracer(count + 1 /* void */, portals);
 
-    for(int view = 0; view < map.sectorCount(); ++view)
-    for(int target = 0; target < view; ++target)
+    // Rows of the visibility matrix; each row is written by only one task.
+    dint const rowSize = (count + 7) >> 3;
+    Block visible(dsize(rowSize) * count);
+    Byte *visibleRows = visible.data();
+    std::atomic<dint64> totalClips(0);
+    parallelFor(dsize(count), [&tracer, &totalClips, visibleRows, rowSize, count]
+                (dsize start, dsize end)
     {
-        if(secGroups[view] == secGroups[target])
-            continue;
+        std::vector<bool> regions(count + 1);
+        for (dsize from = start; from < end; ++from)
+        {
+            // Give up if the map as a whole is too complicated.
+            if (totalClips > MAX_CLIPS_TOTAL) return;
+
+            std::fill(regions.begin(), regions.end(), false);
+            totalClips += tracer.trace(dint(from), regions);
+
+            Byte *row = visibleRows + from * rowSize;
+            std::memset(row, 0, rowSize);
+            for (dint to = 0; to < count; ++to)
+            {
+                if (regions[to]) row[to >> 3] |= 1 << (to & 7);
+            }
+        }
+    }, 8);
+
+    if (totalClips > MAX_CLIPS_TOTAL)
+    {
+        LOG_MAP_NOTE("Gave up building the reject LUT for %i sectors after %.2f seconds")
+            << count << begunAt.since();
+        return reject;
+    }
+
+    // Lines of sight work both ways; sight lines are rejected only if neither sector
+    // can see the other.
+    reject._sectorCount = count;
+    reject._rowSize     = rowSize;
+    reject._matrix      = Block(dsize(rowSize) * count);
+    Byte const *vis = visible.data();
+    Byte *matrix    = reject._matrix.data();
+    dint rejected   = 0;
+    for (dint from = 0; from < count; ++from)
+    {
+        Byte *row = matrix + from * rowSize;
+        std::memset(row, 0, rowSize);
+        for (dint to = 0; to < count; ++to)
+        {
+            bool const seen = (vis[from * rowSize + (to >> 3)] & (1 << (to & 7))) ||
+                              (vis[to * rowSize + (from >> 3)] & (1 << (from & 7)));
+            if (!seen)
+            {
+                row[to >> 3] |= 1 << (to & 7);
+                rejected++;
+            }
+        }
+    }
+
+    LOGDEV_MAP_VERBOSE("Built reject LUT for %i sectors through %i portals in %.2f seconds "
+                       "(%.1f%% of sector pairs rejected)")
+        << count << dint(portals.size()) << begunAt.since()
+        << 100.0 * rejected / (ddouble(count) * count);
+
+    return reject;
+}
 
-        // For symmetry, do two bits at a time.
-        int p1 = view * map.sectorCount() + target;
-        int p2 = target * map.sectorCount() + view;
+Reject Reject::fromLump(Block const &lump, dint count) // static
+{
+    Reject reject;
+    if (lump.isEmpty() || count <= 0 || count > MAX_SECTORS)
+    {
+        return reject;
+    }
 
-        matrix[p1 >> 3] |= (1 << (p1 & 7));
-        matrix[p2 >> 3] |= (1 << (p2 & 7));
+    // The bits of the lump are not padded at the end of each row.
+    dint const rowSize = (count + 7) >> 3;
+    dint64 const lumpBits = dint64(lump.size()) * 8;
+    reject._sectorCount = count;
+    reject._rowSize     = rowSize;
+    reject._matrix      = Block(dsize(rowSize) * count);
+    Byte const *bits = lump.data();
+    Byte *matrix     = reject._matrix.data();
+    std::memset(matrix, 0, reject._matrix.size());
+    for (dint from = 0; from < count; ++from)
+    {
+        Byte *row = matrix + from * rowSize;
+        for (dint to = 0; to < count; ++to)
+        {
+            dint64 const bit = dint64(from) * count + to;
+            if (bit >= lumpBits) return reject;
+            if (bits[bit >> 3] & (1 << (bit & 7)))
+            {
+                row[to >> 3] |= 1 << (to & 7);
+            }
+        }
     }
+    return reject;
+}
 
-    M_Free(secGroups);
+bool Reject::isEmpty() const
+{
+    return !_sectorCount;
+}
 
-    return matrix;
+dint Reject::sectorCount() const
+{
+    return _sectorCount;
 }
-#endif
+
+void Reject::operator >> (Writer &to) const
+{
+    to << _sectorCount << _matrix;
+}
+
+void Reject::operator << (Reader &from)
+{
+    from >> _sectorCount >> _matrix;
+    _rowSize = (_sectorCount + 7) >> 3;
+
+    if (_sectorCount < 0 || _matrix.size() != dsize(_rowSize) * _sectorCount)
+    {
+        // Invalid data; reject nothing.
+        *this = Reject();
+    }
+}
+
+}  // namespace world
@@ -0,0 +1,194 @@
+/** @file rejectportals.cpp  Sight portals of a world map, for the reject LUT.
+ *
+ * @authors Copyright © 2007-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+#include "world/reject.h"
+
+#include "world/map.h"
+#include "ConvexSubspace"
+#include "Face"
+#include "Line"
+#include "Sector"
+
+#include <QHash>
+#include <QPair>
+
+using namespace de;
+
+namespace world {
+
+namespace {
+
+/**
+ * Collects the portals between the regions of a map. Each sector is a region;
+ * subspaces without a sector and the void outside the map together form one
+ * additional region.
+ */
+struct MapPortals
+{
+    Reject::Portals portals;
+
+    MapPortals(Map const &map)
+    {
+        dint const voidRegion = map.sectorCount();
+
+        auto regionOf = [voidRegion] (ConvexSubspace const &subspace)
+        {
+            return subspace.hasSubsector()? subspace.sector().indexInMap() : voidRegion;
+        };
+
+        // Portals on the same line side leading to the same region are merged.
+        typedef QPair<LineSide const *, dint> SideTarget;
+        QHash<SideTarget, dint> sidePortals;
+        QHash<HEdge const *, dint> hedgePortals;
+
+        map.forAllSubspaces([&] (ConvexSubspace &subspace)
+        {
+            dint const region = regionOf(subspace);
+            Vector2d const center = subspace.poly().center();
+
+            HEdge const *base  = subspace.poly().hedge();
+            HEdge const *hedge = base;
+            do
+            {
+                bool const leadsToVoid = !(hedge->hasTwin() && hedge->twin().hasFace() &&
+                                           hedge->twin().face().hasMapElement());
+                dint const target = (leadsToVoid? voidRegion
+                                                : regionOf(hedge->twin().face().mapElementAs<ConvexSubspace>()));
+
+                LineSide const *side = nullptr;
+                if (hedge->hasMapElement())
+                {
+                    side = &hedge->mapElementAs<LineSideSegment>().lineSide();
+                }
+
+                // Lines of sight are only blocked by one-sided lines (see LineSightTest).
+                bool const passable = !side || !side->hasSections() ||
+                                      (side->hasSector() && !side->considerOneSided());
+
+                if (target != region && passable)
+                {
+                    Reject::Portal portal{ hedge->origin(), hedge->next().origin(), region, target, -1 };
+                    if (isInFront(portal, center))
+                    {
+                        std::swap(portal.from, portal.to);
+                    }
+
+                    if (side && !leadsToVoid)
+                    {
+                        auto found = sidePortals.constFind(SideTarget(side, target));
+                        if (found != sidePortals.constEnd())
+                        {
+                            merge(portals[found.value()], portal);
+                        }
+                        else
+                        {
+                            sidePortals.insert(SideTarget(side, target), add(portal));
+                        }
+                    }
+                    else if (leadsToVoid)
+                    {
+                        // The void can be seen through, too.
+                        dint const out = add(portal);
+                        std::swap(portal.from, portal.to);
+                        std::swap(portal.region, portal.target);
+                        dint const in = add(portal);
+                        portals[out].twin = in;
+                        portals[in].twin  = out;
+                    }
+                    else
+                    {
+                        hedgePortals.insert(hedge, add(portal));
+                    }
+                }
+            } while ((hedge = &hedge->next()) != base);
+            return LoopContinue;
+        });
+
+        // Link the portals to their twins.
+        for (auto i = sidePortals.constBegin(); i != sidePortals.constEnd(); ++i)
+        {
+            Reject::Portal &portal = portals[i.value()];
+            auto found = sidePortals.constFind(SideTarget(&i.key().first->back(), portal.region));
+            if (found != sidePortals.constEnd())
+            {
+                portal.twin = found.value();
+            }
+        }
+        for (auto i = hedgePortals.constBegin(); i != hedgePortals.constEnd(); ++i)
+        {
+            auto found = hedgePortals.constFind(&i.key()->twin());
+            if (found != hedgePortals.constEnd())
+            {
+                portals[i.value()].twin = found.value();
+            }
+        }
+    }
+
+    dint add(Reject::Portal const &portal)
+    {
+        portals.push_back(portal);
+        return dint(portals.size()) - 1;
+    }
+
+    /**
+     * Determines whether @a point is on the side of @a portal that faces the target.
+     */
+    static bool isInFront(Reject::Portal const &portal, Vector2d const &point)
+    {
+        Vector2d const dir = portal.to - portal.from;
+        return Vector2d(-dir.y, dir.x).dot(point - portal.from) > 0;
+    }
+
+    /**
+     * Extends @a portal to also cover the collinear @a other portal.
+     */
+    static void merge(Reject::Portal &portal, Reject::Portal const &other)
+    {
+        Vector2d const dir = portal.to - portal.from;
+        ddouble const len = dir.length();
+        if (len <= 0)
+        {
+            portal.from = other.from;
+            portal.to   = other.to;
+            return;
+        }
+        Vector2d const unit = dir / len;
+        ddouble const a = unit.dot(other.from - portal.from);
+        ddouble const b = unit.dot(other.to   - portal.from);
+        ddouble const start = de::min(0.0, de::min(a, b));
+        ddouble const end   = de::max(len, de::max(a, b));
+        portal.to   = portal.from + unit * end;
+        portal.from = portal.from + unit * start;
+    }
+};
+
+} // namespace
+
+Reject Reject::build(Map const &map) // static
+{
+    dint const count = map.sectorCount();
+    if (count <= 0 || count > MAX_SECTORS)
+    {
+        return Reject();
+    }
+    return build(count, MapPortals(map).portals);
+}
+
+}  // namespace world
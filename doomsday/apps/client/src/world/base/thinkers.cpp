@@ -536,6 +536,10 @@ void Thinker_Run()
         }
         return LoopContinue;
     });
+#ifdef __CLIENT__
+    // The generators only advanced their particles while thinking.
+    App_World().map().moveGeneratorParticles();
+#endif
 }
 
 #undef Thinker_Add
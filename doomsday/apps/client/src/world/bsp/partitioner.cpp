@@ -25,11 +25,15 @@
 #include "world/bsp/partitioner.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <QHash>
 #include <QList>
+#include <QSet>
 #include <QtAlgorithms>
 #include <de/vector1.h>
 #include <de/LogBuffer>
+#include <de/TaskScheduler>
 #include <doomsday/BspNode>
 
 #include "BspLeaf"
@@ -56,6 +60,10 @@ typedef QList<LineSegmentSide *>   LineSegmentSides;
 typedef QList<ConvexSubspaceProxy> SubspaceProxys;
 typedef QHash<Vertex *, EdgeTips>  EdgeTipSetMap;
 
+/// Minimum number of line segments on both sides of a partition for the left subspace
+/// to be partitioned speculatively (see Partitioner::Impl::partitionSpace()).
+static int const MIN_SPECULATIVE_SEGMENTS = 256;
+
 DENG2_PIMPL(Partitioner)
 {
     int splitCostFactor = 7;     ///< Cost of splitting a line segment.
@@ -67,12 +75,24 @@ DENG2_PIMPL(Partitioner)
     int vertexCount  = 0;        ///< Running total of vertexes built.
 
     LineSegments lineSegments;   ///< Line segments in the plane.
+    QHash<LineSegment const *, int> segmentOrdinals;  ///< Index in lineSegments (creation order).
     SubspaceProxys subspaces;    ///< Proxy subspaces in the plane.
     EdgeTipSetMap edgeTipSets;   ///< One set for each vertex.
 
     BspTree *bspRoot = nullptr;  ///< The BSP tree under construction.
     HPlane hplane;               ///< Current space half-plane (partitioner state).
 
+    Choices choices;             ///< Partition choices made during the build.
+    Choices replayChoices;       ///< Previously recorded choices to replay (if any).
+    int replayPos = -1;          ///< Next choice to replay; -1 if not replaying.
+
+    bool parallel = true;        ///< Left subspaces may be partitioned speculatively.
+    bool verifyParallel = false; ///< Verify the build against a serial one.
+    bool isCopy = false;         ///< Partitioning a copy of a subspace (see SubspaceCopy).
+    std::atomic<bool> const *cancelled = nullptr; ///< Set when the result is not needed.
+    Choices speculated;          ///< Validated speculative choices to replay.
+    int speculatedPos = -1;      ///< Next speculative choice; -1 if not replaying.
+
     struct LineSegmentBlockTree
     {
         LineSegmentBlockTreeNode *rootNode;
@@ -101,6 +121,67 @@ DENG2_PIMPL(Partitioner)
         }
     };
 
+    /**
+     * Private copy of the line segments of a subspace, for partitioning the subspace
+     * speculatively in another thread while the originals may still be changed by the
+     * partitioning of the rest of the space (see partitionSpace()).
+     *
+     * The state that partitioning the subspace depends on is recorded when the copy
+     * is made, so that the result can be discarded if any of it changes afterwards.
+     */
+    struct SubspaceCopy
+    {
+        struct SegmentState
+        {
+            LineSegment *lineSeg;
+            Vertex *from;
+            Vertex *to;
+        };
+        typedef QPair<Vertex *, EdgeTips> TipState;
+
+        Mesh mesh;                   ///< Owns the copied (and new) vertexes.
+        Partitioner partitioner;     ///< Partitions the copy.
+        LineSegmentBlockTree tree;   ///< Copy of the subspace block tree.
+        int copiedSegmentCount = 0;  ///< Line segments in the copy before partitioning.
+        int copiedVertexCount  = 0;  ///< Vertexes in the copy before partitioning.
+        QHash<LineSegment const *, LineSegment *> originals; ///< Copy => original.
+        QVector<SegmentState> segmentStates;  ///< Original line segments of the subspace.
+        QList<TipState> tipStates;   ///< Original edge tips at the subspace vertexes.
+        std::atomic<bool> cancelled { false };
+        bool finished = false;
+        TaskGroup task;              ///< Destroyed first (waits for the partitioning).
+
+        SubspaceCopy(int splitCostFactor, AABox const &bounds)
+            : partitioner(splitCostFactor)
+            , tree(bounds)
+        {
+            Impl &copy = *partitioner.d;
+            copy.mesh      = &mesh;
+            copy.isCopy    = true;
+            copy.cancelled = &cancelled;
+        }
+
+        void start()
+        {
+            task.run([this] () { partition(); });
+        }
+
+        void partition()
+        {
+            try
+            {
+                if(BspTree *bspTree = partitioner.d->partitionSpace(tree))
+                {
+                    bspTree->traversePostOrder(clearBspElementWorker);
+                    delete bspTree;
+                }
+                finished = !cancelled;
+            }
+            catch(Error const &)
+            {} // The original subspace will be partitioned as usual.
+        }
+    };
+
     Impl(Public *i) : Base(i) {}
     ~Impl() { clear(); }
 
@@ -126,11 +207,15 @@ DENG2_PIMPL(Partitioner)
         mesh = nullptr;
         qDeleteAll(lineSegments);
         lineSegments.clear();
+        segmentOrdinals.clear();
         subspaces.clear();
         edgeTipSets.clear();
         hplane.clearIntercepts();
 
         segmentCount = vertexCount = 0;
+
+        choices.clear();
+        replayPos = (replayChoices.isEmpty()? -1 : 0);
     }
 
     /**
@@ -151,6 +236,7 @@ DENG2_PIMPL(Partitioner)
         Sector *backSec, LineSide *frontSide, Line *partitionLine = nullptr)
     {
         LineSegment *newSeg = new LineSegment(start, end);
+        segmentOrdinals.insert(newSeg, lineSegments.count());
         lineSegments << newSeg;
 
         LineSegmentSide &front = newSeg->front();
@@ -648,7 +734,8 @@ DENG2_PIMPL(Partitioner)
             // Choose the non-self-referencing sector when we can.
             else if(cur.after() != next.before())
             {
-                if(!cur.lineSegmentIsSelfReferencing() &&
+                if(!isCopy &&
+                   !cur.lineSegmentIsSelfReferencing() &&
                    !next.lineSegmentIsSelfReferencing())
                 {
                     LOG_DEBUG("Sector mismatch #%d %s != #%d %s")
@@ -839,9 +926,301 @@ DENG2_PIMPL(Partitioner)
         return bounds;
     }
 
+    /**
+     * Returns @c true if @a seg is linked in the block tree at or beneath @a node.
+     */
+    static bool isInBlockTree(LineSegmentSide const &seg, LineSegmentBlockTreeNode const &node)
+    {
+        auto const *cur = (LineSegmentBlockTreeNode const *) seg.blockTreeNodePtr();
+        for(; cur; cur = cur->parentPtr())
+        {
+            if(cur == &node) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Look up the next choice from previously recorded partition choices.
+     *
+     * @param recorded      Recorded partition choices.
+     * @param pos           Position of the next choice in @a recorded. Set to -1 if the
+     *                      choice does not match the geometry.
+     * @param candidateSet  Block tree node containing the candidate line segments.
+     * @param chosen        The recorded choice is written here (@c nullptr for a leaf).
+     *
+     * @return  @c true if the recorded choice is valid.
+     */
+    bool nextRecordedChoice(Choices const &recorded, int &pos,
+                            LineSegmentBlockTreeNode &candidateSet, LineSegmentSide *&chosen)
+    {
+        dint32 const choice = (pos < recorded.count()? recorded.at(pos++) : -2 /*exhausted*/);
+        if(choice == -1)
+        {
+            chosen = nullptr;
+            return true;
+        }
+
+        int const ordinal = choice / 2;
+        if(choice >= 0 && ordinal < lineSegments.count())
+        {
+            LineSegmentSide &seg = lineSegments.at(ordinal)->side(choice & 1);
+            if(isInBlockTree(seg, candidateSet))
+            {
+                chosen = &seg;
+                return true;
+            }
+        }
+
+        pos = -1;
+        return false;
+    }
+
+    /**
+     * Attempt to replay the next previously recorded partition choice.
+     *
+     * @param candidateSet  Block tree node containing the candidate line segments.
+     * @param chosen        The replayed choice is written here (@c nullptr for a leaf).
+     *
+     * @return  @c true if a choice was replayed.
+     */
+    bool replayChoice(LineSegmentBlockTreeNode &candidateSet, LineSegmentSide *&chosen)
+    {
+        if(speculatedPos >= 0)
+        {
+            // Speculative choices are validated beforehand, so they always match.
+            return nextRecordedChoice(speculated, speculatedPos, candidateSet, chosen);
+        }
+
+        if(replayPos < 0) return false; // Not replaying.
+
+        if(nextRecordedChoice(replayChoices, replayPos, candidateSet, chosen))
+            return true;
+
+        LOG_MAP_VERBOSE("Recorded partition choices do not match the geometry; "
+                        "evaluating the remaining partitions");
+        return false;
+    }
+
     LineSegmentSide *choosePartition(LineSegmentBlockTreeNode &candidateSet)
     {
-        return PartitionEvaluator(splitCostFactor).choose(candidateSet);
+        LineSegmentSide *chosen = nullptr;
+        if(!replayChoice(candidateSet, chosen))
+        {
+            chosen = PartitionEvaluator(splitCostFactor).choose(candidateSet);
+        }
+
+        // Record the choice so that the same tree can be reproduced later.
+        choices << (chosen? segmentOrdinals.value(&chosen->line()) * 2 + chosen->lineSideId()
+                          : -1);
+        return chosen;
+    }
+
+    bool isCancelled() const
+    {
+        return cancelled && *cancelled;
+    }
+
+    /**
+     * Determines whether the left subspace of a partition should be partitioned
+     * speculatively while the right subspace is being partitioned.
+     */
+    bool shouldSpeculate(LineSegmentBlockTreeNode const &rights,
+                         LineSegmentBlockTreeNode const &lefts) const
+    {
+        return parallel && replayPos < 0 && speculatedPos < 0 && !isCancelled()
+            && rights.userData()->totalCount() >= MIN_SPECULATIVE_SEGMENTS
+            && lefts.userData()->totalCount()  >= MIN_SPECULATIVE_SEGMENTS;
+    }
+
+    /**
+     * Copy the block tree at @a node and the line segments linked in it, preserving
+     * the order of the segments in each block.
+     */
+    template <typename CopySideFunc>
+    static void copyBlockTree(LineSegmentBlockTreeNode const &node,
+                              LineSegmentBlockTreeNode &nodeCopy, CopySideFunc const &copySide)
+    {
+        LineSegmentBlock const &block = *node.userData();
+        LineSegmentBlock &blockCopy   = *nodeCopy.userData();
+
+        blockCopy.copyRefs(block);
+
+        // Linking prepends, so begin with the last segment.
+        for(int i = block.all().count() - 1; i >= 0; --i)
+        {
+            LineSegmentSide *sideCopy = copySide(block.all().at(i));
+            blockCopy.link(*sideCopy);
+            sideCopy->setBlockTreeNode(&nodeCopy);
+        }
+
+        for(int i = 0; i < 2; ++i)
+        {
+            auto const childId = LineSegmentBlockTreeNode::ChildId(i);
+            if(!node.hasChild(childId)) continue;
+
+            LineSegmentBlockTreeNode const &child = *node.childPtr(childId);
+            auto *childCopy = new LineSegmentBlockTreeNode(
+                        new LineSegmentBlock(child.userData()->bounds()), &nodeCopy);
+            nodeCopy.setChild(childId, childCopy);
+
+            copyBlockTree(child, *childCopy, copySide);
+        }
+    }
+
+    /**
+     * Make a private copy of the subspace at @a node: the block tree, the line segments
+     * linked in it and the edge tips at their vertexes (which may refer to line segments
+     * outside the subspace, so those are copied too). The original state that the
+     * partitioning of the subspace depends on is recorded in the copy.
+     */
+    SubspaceCopy *copySubspace(LineSegmentBlockTreeNode const &node)
+    {
+        auto *copy = new SubspaceCopy(splitCostFactor, node.userData()->bounds());
+        Impl &copyImpl = *copy->partitioner.d;
+        copyImpl.parallel = parallel;
+
+        QHash<Vertex *, Vertex *> vertexCopies;
+        QHash<LineSegment *, LineSegment *> segmentCopies;
+        LineSegments copiedSegments; // Originals, in the order copied.
+
+        auto copyVertex = [copy, &vertexCopies] (Vertex &vertex) -> Vertex &
+        {
+            Vertex *&vtxCopy = vertexCopies[&vertex];
+            if(!vtxCopy) vtxCopy = copy->mesh.newVertex(vertex.origin());
+            return *vtxCopy;
+        };
+        auto copySide = [&] (LineSegmentSide *side) -> LineSegmentSide *
+        {
+            LineSegment &lineSeg = side->line();
+            LineSegment *&segCopy = segmentCopies[&lineSeg];
+            if(!segCopy)
+            {
+                segCopy = copyImpl.makeLineSegment(copyVertex(lineSeg.from()),
+                                                   copyVertex(lineSeg.to()),
+                                                   lineSeg.front().sectorPtr(),
+                                                   lineSeg.back().sectorPtr(),
+                                                   lineSeg.front().mapSidePtr(),
+                                                   lineSeg.front().partitionMapLine());
+                copy->originals.insert(segCopy, &lineSeg);
+                copiedSegments << &lineSeg;
+            }
+            return &segCopy->side(side->lineSideId());
+        };
+
+        copyBlockTree(node, copy->tree, copySide);
+
+        int const subspaceSegmentCount = copiedSegments.count();
+        QList<Vertex *> subspaceVertexes; // In the order first encountered.
+        QSet<Vertex *> encountered;
+        for(int i = 0; i < subspaceSegmentCount; ++i)
+        {
+            LineSegment *lineSeg = copiedSegments.at(i);
+            copy->segmentStates << SubspaceCopy::SegmentState{ lineSeg, &lineSeg->from(), &lineSeg->to() };
+            for(Vertex *vertex : { &lineSeg->from(), &lineSeg->to() })
+            {
+                if(!encountered.contains(vertex))
+                {
+                    encountered.insert(vertex);
+                    subspaceVertexes << vertex;
+                }
+            }
+        }
+
+        for(Vertex *vertex : subspaceVertexes)
+        {
+            EdgeTipSetMap::const_iterator found = edgeTipSets.constFind(vertex);
+            EdgeTips const tips = (found != edgeTipSets.constEnd()? found.value() : EdgeTips());
+            copy->tipStates << SubspaceCopy::TipState(vertex, tips);
+            copyImpl.edgeTipSets.insert(&copyVertex(*vertex), tips.copy(copySide));
+        }
+
+        copy->copiedSegmentCount = copyImpl.lineSegments.count();
+        copy->copiedVertexCount  = copy->mesh.vertexCount();
+        return copy;
+    }
+
+    /**
+     * Returns @c true if none of the original state that partitioning the copied
+     * subspace depends on has changed since the copy was made.
+     */
+    bool isUnchanged(SubspaceCopy const &copy) const
+    {
+        for(SubspaceCopy::SegmentState const &state : copy.segmentStates)
+        {
+            if(&state.lineSeg->from() != state.from || &state.lineSeg->to() != state.to)
+                return false; // It has been split.
+        }
+        EdgeTips const noTips;
+        for(SubspaceCopy::TipState const &state : copy.tipStates)
+        {
+            EdgeTipSetMap::const_iterator found = edgeTipSets.constFind(state.first);
+            if(!((found != edgeTipSets.constEnd()? found.value() : noTips) == state.second))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Returns the partition choices made for a copied subspace, with the line segments
+     * of the copy substituted by the originals. The line segments created while
+     * partitioning the copy correspond to those created when partitioning the original
+     * subspace (in the same order), beginning with the ordinal @a firstNewSegment.
+     */
+    Choices originalChoices(SubspaceCopy const &copy, int firstNewSegment) const
+    {
+        Impl const &copyImpl = *copy.partitioner.d;
+
+        Choices result;
+        result.reserve(copyImpl.choices.count());
+        for(dint32 choice : copyImpl.choices)
+        {
+            if(choice >= 0)
+            {
+                int const ordinal = choice / 2;
+                int const originalOrdinal =
+                    (ordinal < copy.copiedSegmentCount?
+                         segmentOrdinals.value(copy.originals.value(copyImpl.lineSegments.at(ordinal)))
+                       : firstNewSegment + ordinal - copy.copiedSegmentCount);
+                choice = originalOrdinal * 2 + (choice & 1);
+            }
+            result << choice;
+        }
+        return result;
+    }
+
+    /**
+     * Check that the partition choices made and the vertexes created during the build
+     * are identical to those of a serial build of the same line segments.
+     */
+    void verifyParallelBuild(SubspaceCopy const &serial, int firstNewSegment,
+                             int firstNewVertex) const
+    {
+        Impl const &serialImpl = *serial.partitioner.d;
+        Mesh::Vertexs const &vertexes       = mesh->vertexs();
+        Mesh::Vertexs const &serialVertexes = serial.mesh.vertexs();
+        int const newVertexCount            = vertexes.count() - firstNewVertex;
+
+        bool identical = serial.finished
+                && originalChoices(serial, firstNewSegment) == choices
+                && lineSegments.count() - firstNewSegment
+                   == serialImpl.lineSegments.count() - serial.copiedSegmentCount
+                && newVertexCount == serialVertexes.count() - serial.copiedVertexCount;
+
+        for(int i = 0; identical && i < newVertexCount; ++i)
+        {
+            Vector2d const &origin       = vertexes.at(firstNewVertex + i)->origin();
+            Vector2d const &serialOrigin = serialVertexes.at(serial.copiedVertexCount + i)->origin();
+            identical = (origin.x == serialOrigin.x && origin.y == serialOrigin.y);
+        }
+
+        if(identical)
+        {
+            LOG_MAP_VERBOSE("Verified that the BSP is identical to a serial build");
+        }
+        else
+        {
+            LOG_MAP_ERROR("The BSP differs from a serial build of the same map");
+        }
     }
 
     /**
@@ -872,8 +1251,9 @@ DENG2_PIMPL(Partitioner)
         BspTree *rightBspTree  = nullptr;
         BspTree *leftBspTree   = nullptr;
 
-        // Pick a line segment to use as the next partition plane.
-        if(LineSegmentSide *partSeg = choosePartition(node))
+        // Pick a line segment to use as the next partition plane (unless the result
+        // is no longer needed, in which case the space is left as is).
+        if(LineSegmentSide *partSeg = (isCancelled()? nullptr : choosePartition(node)))
         {
             // Reconfigure the half-plane for the next round of partitioning.
             hplane.configure(*partSeg);
@@ -912,8 +1292,40 @@ DENG2_PIMPL(Partitioner)
             //AABoxd leftBounds  = segmentBounds(leftTree);
 
             // Recurse on each suspace, first the right space then left.
+            //
+            // Partitioning the right space may split line segments of the left space
+            // (those collinear with the partition have their twin on the other side)
+            // and change the edge tips at vertexes shared by both, so the left space
+            // cannot be partitioned independently. Instead, a copy of the left space
+            // is partitioned in another thread in the meantime. If the right space
+            // did not change anything the copy depends on, the choices made for the
+            // copy are replayed for the left space, which is much quicker than
+            // evaluating the candidates. The segments and vertexes are always created
+            // in the same order, so the result is identical to a serial build.
+            std::unique_ptr<SubspaceCopy> leftCopy;
+            if(shouldSpeculate(rightTree, leftTree))
+            {
+                leftCopy.reset(copySubspace(leftTree));
+                leftCopy->start();
+            }
+
             rightBspTree = partitionSpace(rightTree);
-            leftBspTree  = partitionSpace(leftTree);
+
+            if(leftCopy)
+            {
+                bool const usable = isUnchanged(*leftCopy);
+                leftCopy->cancelled = !usable;
+                leftCopy->task.wait();
+                if(usable && leftCopy->finished)
+                {
+                    speculated    = originalChoices(*leftCopy, lineSegments.count());
+                    speculatedPos = 0;
+                }
+                leftCopy.reset();
+            }
+
+            leftBspTree   = partitionSpace(leftTree);
+            speculatedPos = -1;
 
             // Collapse degenerates upward.
             if(!rightBspTree || !leftBspTree)
@@ -970,6 +1382,16 @@ DENG2_PIMPL(Partitioner)
      */
     void splitOverlappingSegments()
     {
+        // Ordering the segments of a subspace only concerns the subspace itself, so
+        // all the subspaces can be ordered concurrently beforehand.
+        parallelFor(dsize(subspaces.count()), [this] (dsize start, dsize end)
+        {
+            for(dsize i = start; i < end; ++i)
+            {
+                subspaces.at(int(i)).segments();
+            }
+        });
+
         for(ConvexSubspaceProxy const &subspace : subspaces)
         {
             /*
@@ -1026,6 +1448,10 @@ DENG2_PIMPL(Partitioner)
 
     void buildSubspaceGeometries()
     {
+        // The geometries are built serially: the half-edges and faces are allocated
+        // from the shared mesh in subspace order, which determines the indices of the
+        // mesh elements, and a half-edge is twinned with its back side in another
+        // subspace as soon as both have been built. Map line sides are shared too.
         for(ConvexSubspaceProxy const &subspace : subspaces)
         {
             /// @todo Move BSP leaf construction here?
@@ -1105,6 +1531,26 @@ void Partitioner::setSplitCostFactor(int newFactor)
     d->splitCostFactor = newFactor;
 }
 
+void Partitioner::setVerifyParallelBuild(bool enable)
+{
+    d->verifyParallel = enable;
+}
+
+void Partitioner::setReplayChoices(Choices const &choices)
+{
+    d->replayChoices = choices;
+}
+
+Partitioner::Choices const &Partitioner::choices() const
+{
+    return d->choices;
+}
+
+bool Partitioner::choicesWereReplayed() const
+{
+    return d->replayPos >= 0 && d->replayPos == d->replayChoices.count();
+}
+
 static AABox blockmapBounds(AABoxd const &mapBounds)
 {
     AABox mapBoundsi;
@@ -1165,8 +1611,25 @@ BspTree *Partitioner::makeBspTree(QSet<Line *> const &lines, Mesh &mesh)
 
     d->createInitialLineSegments(blockTree);
 
+    // For verification, first partition a copy of the line segments serially.
+    std::unique_ptr<Impl::SubspaceCopy> serialBuild;
+    if(d->verifyParallel)
+    {
+        serialBuild.reset(d->copySubspace(blockTree));
+        serialBuild->partitioner.d->parallel = false;
+        serialBuild->partition();
+    }
+    int const firstNewSegment = d->lineSegments.count();
+    int const firstNewVertex  = mesh.vertexCount();
+
     d->bspRoot = d->partitionSpace(blockTree);
 
+    if(serialBuild)
+    {
+        d->verifyParallelBuild(*serialBuild, firstNewSegment, firstNewVertex);
+        serialBuild.reset();
+    }
+
     // At this point we know that *something* useful was built.
     d->splitOverlappingSegments();
     d->buildSubspaceGeometries();
@@ -23,13 +23,12 @@
 
 #include "world/bsp/partitionevaluator.h"
 
-#include <QList>
+#include <QSet>
+#include <QVector>
 #include <de/Log>
 #include <de/String>
-#include <de/Task>
-#include <de/TaskPool>
+#include <de/TaskScheduler>
 #include "world/bsp/partitioner.h"
-#include "world/clientserverworld.h" // validCount
 
 using namespace de;
 
@@ -173,6 +172,9 @@ namespace internal
 
 using namespace internal;
 
+/// Candidates times line segments below which costing is done in the calling thread.
+static dsize const MIN_PARALLEL_COSTING_WORK = 4096;
+
 DENG2_PIMPL_NOREF(PartitionEvaluator)
 {
     int splitCostFactor = 7;
@@ -181,23 +183,17 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
 
     struct PartitionCandidate
     {
-        LineSegmentSide *line;  ///< Candidate partition line.
-        PartitionCost cost;     ///< Running cost metric total.
+        LineSegmentSide *line = nullptr;  ///< Candidate partition line.
+        PartitionCost cost;               ///< Running cost metric total.
 
+        PartitionCandidate() {}
         PartitionCandidate(LineSegmentSide &partition) : line(&partition)
         {}
     };
-    typedef QList<PartitionCandidate *> Candidates;
+    typedef QVector<PartitionCandidate> Candidates;
     Candidates candidates;
 
-    PartitionCandidate *nextCandidate()
-    {
-        DENG2_ASSERT(costTaskPool.isDone());
-        if(candidates.isEmpty()) return nullptr;
-        return candidates.takeFirst();
-    }
-
-    class CostTask : public Task
+    class CostTask
     {
     public:
         Impl &evaluator;
@@ -378,7 +374,6 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
             }
         }
     };
-    TaskPool costTaskPool;
 
     /**
      * @param line  Partition line to evaluate.
@@ -386,10 +381,26 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
     void beginPartitionCosting(LineSegmentSide *line)
     {
         DENG2_ASSERT(line && line->hasMapSide());
-        // Run a new partition cost task.
-        PartitionCandidate *newCandidate = new PartitionCandidate(*line);
-        candidates << newCandidate;
-        costTaskPool.start(new CostTask(*this, *newCandidate));
+        candidates << PartitionCandidate(*line);
+    }
+
+    /**
+     * Evaluate the costs of all the candidates. The candidates are independent of
+     * each other, so they are costed concurrently when there is enough work to make
+     * it worthwhile (near the leaves of the tree the sets are small).
+     */
+    void evaluateCandidates()
+    {
+        dsize const count = dsize(candidates.size());
+        dsize const work  = count * dsize(rootNode->userData()->totalCount());
+        PartitionCandidate *cands = candidates.data();
+        parallelFor(count, [this, cands] (dsize start, dsize end)
+        {
+            for(dsize i = start; i < end; ++i)
+            {
+                CostTask(*this, cands[i]).runTask();
+            }
+        }, work < MIN_PARALLEL_COSTING_WORK? count : 0);
     }
 };
 
@@ -404,10 +415,10 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
 
     d->rootNode = &node;
 
-    // Increment valid count so we can avoid testing the line segments
-    // produced from a single line more than once per round of partition
-    // selection.
-    validCount++;
+    // Lines whose line segments have already been tested in this round of
+    // partition selection. (Subspaces may be partitioned concurrently, so the
+    // lines themselves cannot be marked.)
+    QSet<Line const *> testedLines;
 
     // Iterative pre-order traversal.
     LineSegmentBlockTreeNode const *cur  = d->rootNode;
@@ -434,11 +445,11 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
                 // Optimization: Only the first line segment produced from a
                 // given line is tested per round of partition costing because
                 // they are all collinear.
-                if(candidate->mapLine().validCount() == validCount)
+                if(testedLines.contains(&candidate->mapLine()))
                     continue; // Skip this.
 
                 // Don't consider further segments of the candidate.
-                candidate->mapLine().setValidCount(validCount);
+                testedLines.insert(&candidate->mapLine());
 
                 // Determine candidate suitability and cost.
                 d->beginPartitionCosting(candidate);
@@ -475,21 +486,22 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
     LineSegmentSide *best = nullptr;
     if(!d->candidates.isEmpty())
     {
-        d->costTaskPool.waitForDone();
+        d->evaluateCandidates();
+
+        // The candidates are compared in the order they were found.
         PartitionCost bestCost;
-        while(Impl::PartitionCandidate *candidate = d->nextCandidate())
+        for(Impl::PartitionCandidate const &candidate : d->candidates)
         {
-            //LOG_DEBUG("%p: %s") << candidate->line << candidate->cost.asText();
+            //LOG_DEBUG("%p: %s") << candidate.line << candidate.cost.asText();
 
-            if(candidate->line && (!best || candidate->cost < bestCost))
+            if(candidate.line && (!best || candidate.cost < bestCost))
             {
                 // We have a new better choice.
-                best     = candidate->line;
-                bestCost = candidate->cost;
+                best     = candidate.line;
+                bestCost = candidate.cost;
             }
-
-            delete candidate;
         }
+        d->candidates.clear();
 
         //LOG_DEBUG("best %p score: %d.%02d")
         //        << best << bestCost.total / 100 << bestCost.total % 100;
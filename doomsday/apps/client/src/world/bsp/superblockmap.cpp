@@ -64,6 +64,12 @@ void LineSegmentBlock::decRef(LineSegmentSide const &seg)
     else                 d->partCount--;
 }
 
+void LineSegmentBlock::copyRefs(LineSegmentBlock const &other)
+{
+    d->mapCount  = other.d->mapCount;
+    d->partCount = other.d->partCount;
+}
+
 LineSegmentSide *LineSegmentBlock::pop()
 {
     if(!d->segments.isEmpty())
@@ -23,6 +23,7 @@
 #include "world/generator.h"
 
 #include "world/clientserverworld.h" // validCount
+#include "world/particlesimd.h"
 #include "world/thinkers.h"
 #include "client/cl_mobj.h"
 #include "BspLeaf"
@@ -98,6 +99,54 @@ static void uncertainPosition(fixed_t *pos, fixed_t low, fixed_t high)
 
 namespace world {
 
+/**
+ * Allocates the arrays of a particle store for @a count particles, in one block.
+ */
+static void allocParticleStore(ParticleStore &store, dint count)
+{
+    dsize const pointerSize = sizeof(void *) * 2;
+    dsize const wordSize    = sizeof(dint) + sizeof(fixed_t) * 11;
+    dsize const shortSize   = sizeof(dshort) + sizeof(dushort) * 2;
+    dsize const byteSize    = sizeof(duint8);
+    auto *block = (duint8 *) Z_Calloc((pointerSize + wordSize + shortSize + byteSize) * count,
+                                      PU_MAP, 0);
+
+    // The arrays are ordered by element size, so that each is aligned.
+    auto nextArray = [&block, count] (dsize elementSize)
+    {
+        void *array = block;
+        block += elementSize * count;
+        return array;
+    };
+    store.bspLeaf    = (BspLeaf **)  nextArray(sizeof(void *));
+    store.contact    = (Line **)     nextArray(sizeof(void *));
+    store.stage      = (dint *)      nextArray(sizeof(dint));
+    for(dint i = 0; i < 3; ++i)
+    {
+        store.origin[i] = (fixed_t *) nextArray(sizeof(fixed_t));
+        store.mov[i]    = (fixed_t *) nextArray(sizeof(fixed_t));
+    }
+    store.gravity    = (fixed_t *)   nextArray(sizeof(fixed_t));
+    store.resistance = (fixed_t *)   nextArray(sizeof(fixed_t));
+    store.stepZ      = (fixed_t *)   nextArray(sizeof(fixed_t));
+    store.floorLimit = (fixed_t *)   nextArray(sizeof(fixed_t));
+    store.ceilLimit  = (fixed_t *)   nextArray(sizeof(fixed_t));
+    store.tics       = (dshort *)    nextArray(sizeof(dshort));
+    store.yaw        = (dushort *)   nextArray(sizeof(dushort));
+    store.pitch      = (dushort *)   nextArray(sizeof(dushort));
+    store.touch      = (duint8 *)    nextArray(sizeof(duint8));
+}
+
+/**
+ * Copies the stage parameters used by the vector kernels to the particle's arrays.
+ */
+static void setParticleStageParams(ParticleStore &store, dint index,
+                                   Generator::ParticleStage const &stage)
+{
+    store.gravity[index]    = stage.gravity;
+    store.resistance[index] = stage.resistance;
+}
+
 Map &Generator::map() const
 {
     return Thinker_Map(thinker);
@@ -133,8 +182,8 @@ Vector3d Generator::origin() const
 
 void Generator::clearParticles()
 {
-    Z_Free(_pinfo);
-    _pinfo = nullptr;
+    Z_Free(_pinfo.bspLeaf); // The first array of the block.
+    zap(_pinfo);
 }
 
 void Generator::configureFromDef(ded_ptcgen_t const *newDef)
@@ -149,7 +198,7 @@ void Generator::configureFromDef(ded_ptcgen_t const *newDef)
 
     def    = newDef;
     _flags = Flags(def->flags);
-    _pinfo = (ParticleInfo *) Z_Calloc(sizeof(ParticleInfo) * count, PU_MAP, 0);
+    allocParticleStore(_pinfo, count);
     stages = (ParticleStage *) Z_Calloc(sizeof(ParticleStage) * def->stages.size(), PU_MAP, 0);
 
     for(dint i = 0; i < def->stages.size(); ++i)
@@ -181,8 +230,7 @@ void Generator::configureFromDef(ded_ptcgen_t const *newDef)
     // Mark unused.
     for(dint i = 0; i < count; ++i)
     {
-        ParticleInfo* pinfo = &_pinfo[i];
-        pinfo->stage = -1;
+        _pinfo.stage[i] = -1;
     }
 }
 
@@ -191,6 +239,11 @@ void Generator::presimulate(dint tics)
     for(; tics > 0; tics--)
     {
         runTick();
+        if(!isMovePending()) break; // Deleted.
+
+        /// @todo Do not assume generator is from the CURRENT map.
+        stepParticles(0, count, FLT2FIX(map().gravity()));
+        moveParticles();
     }
 
     // Reset age so presim doesn't affect it.
@@ -228,7 +281,7 @@ dint Generator::activeParticleCount() const
     dint numActive = 0;
     for(dint i = 0; i < count; ++i)
     {
-        if(_pinfo[i].stage >= 0)
+        if(_pinfo.stage[i] >= 0)
         {
             numActive += 1;
         }
@@ -236,23 +289,40 @@ dint Generator::activeParticleCount() const
     return numActive;
 }
 
-ParticleInfo const *Generator::particleInfo() const
+ParticleInfo Generator::particleInfo(dint index) const
 {
-    return _pinfo;
+    DENG2_ASSERT(index >= 0 && index < count);
+
+    ParticleInfo pinfo;
+    pinfo.stage   = _pinfo.stage[index];
+    pinfo.tics    = _pinfo.tics[index];
+    for(dint i = 0; i < 3; ++i)
+    {
+        pinfo.origin[i] = _pinfo.origin[i][index];
+        pinfo.mov[i]    = _pinfo.mov[i][index];
+    }
+    pinfo.bspLeaf = _pinfo.bspLeaf[index];
+    pinfo.contact = _pinfo.contact[index];
+    pinfo.yaw     = _pinfo.yaw[index];
+    pinfo.pitch   = _pinfo.pitch[index];
+    return pinfo;
 }
 
-static void setParticleAngles(ParticleInfo *pinfo, dint flags)
+ParticleStore const &Generator::particles() const
 {
-    DENG2_ASSERT(pinfo);
+    return _pinfo;
+}
 
+static void setParticleAngles(dushort &yaw, dushort &pitch, dint flags)
+{
     if(flags & Generator::ParticleStage::ZeroYaw)
-        pinfo->yaw = 0;
+        yaw = 0;
     if(flags & Generator::ParticleStage::ZeroPitch)
-        pinfo->pitch = 0;
+        pitch = 0;
     if(flags & Generator::ParticleStage::RandomYaw)
-        pinfo->yaw = RNG_RandFloat() * 65536;
+        yaw = RNG_RandFloat() * 65536;
     if(flags & Generator::ParticleStage::RandomPitch)
-        pinfo->pitch = RNG_RandFloat() * 65536;
+        pitch = RNG_RandFloat() * 65536;
 }
 
 static void particleSound(fixed_t pos[3], ded_embsound_t *sound)
@@ -271,6 +341,12 @@ static void particleSound(fixed_t pos[3], ded_embsound_t *sound)
     S_LocalSoundAtVolumeFrom(sound->id, nullptr, orig, sound->volume);
 }
 
+static void particleSound(ParticleStore const &pinfo, dint index, ded_embsound_t *sound)
+{
+    fixed_t pos[3] = { pinfo.origin[0][index], pinfo.origin[1][index], pinfo.origin[2][index] };
+    particleSound(pos, sound);
+}
+
 dint Generator::newParticle()
 {
 #ifdef __CLIENT__
@@ -293,8 +369,9 @@ dint Generator::newParticle()
 
     dint const newParticleIdx = _spawnCP;
 
-    // Set the particle's data.
-    ParticleInfo *pinfo = &_pinfo[_spawnCP];
+    // Set the particle's data. It is stored when complete.
+    ParticleInfo particle = particleInfo(newParticleIdx);
+    ParticleInfo *pinfo = &particle;
     pinfo->stage = 0;
     if(RNG_RandFloat() < def->altStartVariance)
     {
@@ -467,7 +544,7 @@ dint Generator::newParticle()
 
         if(!subspace)
         {
-            pinfo->stage = -1;
+            _pinfo.stage[newParticleIdx] = -1;
             return -1;
         }
 
@@ -491,7 +568,7 @@ dint Generator::newParticle()
 
         if(tries == 10) // No good place found?
         {
-            pinfo->stage = -1; // Damn.
+            _pinfo.stage[newParticleIdx] = -1; // Damn.
             return -1;
         }
     }
@@ -506,7 +583,7 @@ dint Generator::newParticle()
     }
 
     // Initial angles for the particle.
-    setParticleAngles(pinfo, def->stages[pinfo->stage].flags);
+    setParticleAngles(pinfo->yaw, pinfo->pitch, def->stages[pinfo->stage].flags);
 
     // The other place where this gets updated is after moving over
     // a two-sided line.
@@ -522,11 +599,23 @@ dint Generator::newParticle()
         // A BSP leaf with no geometry is not a suitable place for a particle.
         if(!pinfo->bspLeaf->hasSubspace())
         {
-            pinfo->stage = -1;
+            _pinfo.stage[newParticleIdx] = -1;
             return -1;
         }
     }
 
+    _pinfo.stage[newParticleIdx] = pinfo->stage;
+    _pinfo.tics[newParticleIdx]  = pinfo->tics;
+    for(dint i = 0; i < 3; ++i)
+    {
+        _pinfo.origin[i][newParticleIdx] = pinfo->origin[i];
+        _pinfo.mov[i][newParticleIdx]    = pinfo->mov[i];
+    }
+    _pinfo.bspLeaf[newParticleIdx] = pinfo->bspLeaf;
+    _pinfo.yaw[newParticleIdx]     = pinfo->yaw;
+    _pinfo.pitch[newParticleIdx]   = pinfo->pitch;
+    setParticleStageParams(_pinfo, newParticleIdx, stages[pinfo->stage]);
+
     // Play a stage sound?
     particleSound(pinfo->origin, &def->stages[pinfo->stage].sound);
 
@@ -568,16 +657,16 @@ static dint newGeneratorParticlesWorker(mobj_t *cmo, void *context)
 /**
  * Particle touches something solid. Returns false iff the particle dies.
  */
-static dint touchParticle(ParticleInfo *pinfo, Generator::ParticleStage *stage,
+static dint touchParticle(ParticleStore &pinfo, dint index, Generator::ParticleStage *stage,
     ded_ptcstage_t *stageDef, bool touchWall)
 {
     // Play a hit sound.
-    particleSound(pinfo->origin, &stageDef->hitSound);
+    particleSound(pinfo, index, &stageDef->hitSound);
 
     if(stage->flags.testFlag(Generator::ParticleStage::DieTouch))
     {
         // Particle dies from touch.
-        pinfo->stage = -1;
+        pinfo.stage[index] = -1;
         return false;
     }
 
@@ -586,25 +675,35 @@ static dint touchParticle(ParticleInfo *pinfo, Generator::ParticleStage *stage,
        (!touchWall && stage->flags.testFlag(Generator::ParticleStage::StageFlatTouch)))
     {
         // Particle advances to the next stage.
-        pinfo->tics = 0;
+        pinfo.tics[index] = 0;
     }
 
     // Particle survives the touch.
     return true;
 }
 
-dfloat Generator::particleZ(ParticleInfo const &pinfo) const
+static dfloat particleZ(fixed_t z, BspLeaf const &bspLeaf)
 {
-    auto const &subsec = pinfo.bspLeaf->subspace().subsector().as<world::ClientSubsector>();
-    if(pinfo.origin[2] == DDMAXINT)
+    auto const &subsec = bspLeaf.subspace().subsector().as<world::ClientSubsector>();
+    if(z == DDMAXINT)
     {
         return subsec.visCeiling().heightSmoothed() - 2;
     }
-    if(pinfo.origin[2] == DDMININT)
+    if(z == DDMININT)
     {
         return (subsec.visFloor().heightSmoothed() + 2);
     }
-    return FIX2FLT(pinfo.origin[2]);
+    return FIX2FLT(z);
+}
+
+dfloat Generator::particleZ(ParticleInfo const &pinfo) const
+{
+    return world::particleZ(pinfo.origin[2], *pinfo.bspLeaf);
+}
+
+dfloat Generator::particleZ(dint index) const
+{
+    return world::particleZ(_pinfo.origin[2][index], *_pinfo.bspLeaf[index]);
 }
 
 Vector3f Generator::particleOrigin(ParticleInfo const &pt) const
@@ -617,46 +716,48 @@ Vector3f Generator::particleMomentum(ParticleInfo const &pt) const
     return Vector3f(FIX2FLT(pt.mov[0]), FIX2FLT(pt.mov[1]), FIX2FLT(pt.mov[2]));
 }
 
-void Generator::spinParticle(ParticleInfo &pinfo)
+void Generator::spinParticle(dint index)
 {
     static dint const yawSigns[4]   = { 1,  1, -1, -1 };
     static dint const pitchSigns[4] = { 1, -1,  1, -1 };
 
-    ded_ptcstage_t const *stDef = &def->stages[pinfo.stage];
-    duint const spinIndex        = uint(&pinfo - &_pinfo[id() / 8]) % 4;
+    ded_ptcstage_t const *stDef = &def->stages[_pinfo.stage[index]];
+    duint const spinIndex        = uint(index - id() / 8) % 4;
 
     DENG2_ASSERT(spinIndex < 4);
 
     dint const yawSign   =   yawSigns[spinIndex];
     dint const pitchSign = pitchSigns[spinIndex];
 
+    dushort &yaw   = _pinfo.yaw[index];
+    dushort &pitch = _pinfo.pitch[index];
+
     if(stDef->spin[0] != 0)
     {
-        pinfo.yaw   += 65536 * yawSign   * stDef->spin[0] / (360 * TICSPERSEC);
+        yaw   += 65536 * yawSign   * stDef->spin[0] / (360 * TICSPERSEC);
     }
     if(stDef->spin[1] != 0)
     {
-        pinfo.pitch += 65536 * pitchSign * stDef->spin[1] / (360 * TICSPERSEC);
+        pitch += 65536 * pitchSign * stDef->spin[1] / (360 * TICSPERSEC);
     }
 
-    pinfo.yaw   *= 1 - stDef->spinResistance[0];
-    pinfo.pitch *= 1 - stDef->spinResistance[1];
+    yaw   *= 1 - stDef->spinResistance[0];
+    pitch *= 1 - stDef->spinResistance[1];
 }
 
-void Generator::moveParticle(dint index)
+void Generator::accelerateParticle(dint index)
 {
     DENG2_ASSERT(index >= 0 && index < count);
 
-    ParticleInfo *pinfo   = &_pinfo[index];
-    ParticleStage *st     = &stages[pinfo->stage];
-    ded_ptcstage_t *stDef = &def->stages[pinfo->stage];
+    ParticleStore &pinfo  = _pinfo;
+    ParticleStage *st     = &stages[pinfo.stage[index]];
+    ded_ptcstage_t *stDef = &def->stages[pinfo.stage[index]];
 
     // Particle rotates according to spin speed.
-    spinParticle(*pinfo);
+    spinParticle(index);
 
-    // Changes to momentum.
-    /// @todo Do not assume generator is from the CURRENT map.
-    pinfo->mov[2] -= FixedMul(FLT2FIX(map().gravity()), st->gravity);
+    // Changes to momentum. Gravity is applied with the resistance in stepParticles();
+    // all the forces are added to the momentum, so their order does not matter.
 
     // Vector force.
     if(stDef->vectorForce[0] != 0 || stDef->vectorForce[1] != 0 ||
@@ -664,7 +765,7 @@ void Generator::moveParticle(dint index)
     {
         for(dint i = 0; i < 3; ++i)
         {
-            pinfo->mov[i] += FLT2FIX(stDef->vectorForce[i]);
+            pinfo.mov[i][index] += FLT2FIX(stDef->vectorForce[i]);
         }
     }
 
@@ -678,15 +779,15 @@ void Generator::moveParticle(dint index)
 
         if(source)
         {
-            delta[0] = FIX2FLT(pinfo->origin[0]) - source->origin[0];
-            delta[1] = FIX2FLT(pinfo->origin[1]) - source->origin[1];
-            delta[2] = particleZ(*pinfo) - (source->origin[2] + FIX2FLT(originAtSpawn[2]));
+            delta[0] = FIX2FLT(pinfo.origin[0][index]) - source->origin[0];
+            delta[1] = FIX2FLT(pinfo.origin[1][index]) - source->origin[1];
+            delta[2] = particleZ(index) - (source->origin[2] + FIX2FLT(originAtSpawn[2]));
         }
         else
         {
             for(dint i = 0; i < 3; ++i)
             {
-                delta[i] = FIX2FLT(pinfo->origin[i] - originAtSpawn[i]);
+                delta[i] = FIX2FLT(pinfo.origin[i][index] - originAtSpawn[i]);
             }
         }
 
@@ -709,7 +810,7 @@ void Generator::moveParticle(dint index)
                 // multiply with radial force strength.
                 for(dint i = 0; i < 3; ++i)
                 {
-                    pinfo->mov[i] -= FLT2FIX(
+                    pinfo.mov[i][index] -= FLT2FIX(
                         ((delta[i] / dist) * (dist - def->forceRadius)) * def->force);
                 }
             }
@@ -722,98 +823,112 @@ void Generator::moveParticle(dint index)
 
                 for(dint i = 0; i < 3; ++i)
                 {
-                    pinfo->mov[i] += FLT2FIX(cross[i]) >> 8;
+                    pinfo.mov[i][index] += FLT2FIX(cross[i]) >> 8;
                 }
             }
         }
     }
+}
 
-    if(st->resistance != FRACUNIT)
+/**
+ * The particle is 'soft': half of radius is ignored. The exception is plane flat
+ * particles, which are rendered flat against planes. They are almost entirely soft
+ * when it comes to plane collisions.
+ */
+static fixed_t particleHardRadius(Generator::ParticleStage const &st)
+{
+    if((st.type == PTC_POINT || (st.type >= PTC_TEXTURE && st.type < PTC_TEXTURE + MAX_PTC_TEXTURES)) &&
+       st.flags.testFlag(Generator::ParticleStage::PlaneFlat))
     {
-        for(dint i = 0; i < 3; ++i)
-        {
-            pinfo->mov[i] = FixedMul(pinfo->mov[i], st->resistance);
-        }
+        return FRACUNIT;
     }
+    return st.radius / 2;
+}
 
-    // The particle is 'soft': half of radius is ignored.
-    // The exception is plane flat particles, which are rendered flat
-    // against planes. They are almost entirely soft when it comes to plane
-    // collisions.
-    fixed_t hardRadius = st->radius / 2;
-    if((st->type == PTC_POINT || (st->type >= PTC_TEXTURE && st->type < PTC_TEXTURE + MAX_PTC_TEXTURES)) &&
-       st->flags.testFlag(ParticleStage::PlaneFlat))
-    {
-        hardRadius = FRACUNIT;
-    }
+void Generator::moveParticle(dint index)
+{
+    DENG2_ASSERT(index >= 0 && index < count);
+
+    ParticleStore &pinfo  = _pinfo;
+    ParticleStage *st     = &stages[pinfo.stage[index]];
+    ded_ptcstage_t *stDef = &def->stages[pinfo.stage[index]];
+
+    fixed_t const hardRadius = particleHardRadius(*st);
 
     // Check the new Z position only if not stuck to a plane.
-    fixed_t z = pinfo->origin[2] + pinfo->mov[2];
+    fixed_t z = pinfo.stepZ[index];
     bool zBounce = false, hitFloor = false;
-    if(pinfo->origin[2] != DDMININT && pinfo->origin[2] != DDMAXINT && pinfo->bspLeaf)
+    if(pinfo.origin[2][index] != DDMININT && pinfo.origin[2][index] != DDMAXINT &&
+       pinfo.bspLeaf[index])
     {
-        auto &subsec = pinfo->bspLeaf->subspace().subsector().as<world::ClientSubsector>();
-        if(z > FLT2FIX(subsec.visCeiling().heightSmoothed()) - hardRadius)
+        // Most particles do not touch a plane (see stepParticles()).
+        if(pinfo.touch[index])
         {
-            // The Z is through the roof!
-            if(subsec.visCeiling().surface().hasSkyMaskedMaterial())
+            auto &subsec = pinfo.bspLeaf[index]->subspace().subsector().as<world::ClientSubsector>();
+            if(z > pinfo.ceilLimit[index])
             {
-                // Special case: particle gets lost in the sky.
-                pinfo->stage = -1;
-                return;
-            }
+                // The Z is through the roof!
+                if(subsec.visCeiling().surface().hasSkyMaskedMaterial())
+                {
+                    // Special case: particle gets lost in the sky.
+                    pinfo.stage[index] = -1;
+                    return;
+                }
 
-            if(!touchParticle(pinfo, st, stDef, false))
-                return;
+                if(!touchParticle(pinfo, index, st, stDef, false))
+                    return;
 
-            z = FLT2FIX(subsec.visCeiling().heightSmoothed()) - hardRadius;
-            zBounce = true;
-            hitFloor = false;
-        }
+                z = pinfo.ceilLimit[index];
+                zBounce = true;
+                hitFloor = false;
+            }
 
-        // Also check the floor.
-        if(z < FLT2FIX(subsec.visFloor().heightSmoothed()) + hardRadius)
-        {
-            if(subsec.visFloor().surface().hasSkyMaskedMaterial())
+            // Also check the floor.
+            if(z < pinfo.floorLimit[index])
             {
-                pinfo->stage = -1;
-                return;
-            }
+                if(subsec.visFloor().surface().hasSkyMaskedMaterial())
+                {
+                    pinfo.stage[index] = -1;
+                    return;
+                }
 
-            if(!touchParticle(pinfo, st, stDef, false))
-                return;
+                if(!touchParticle(pinfo, index, st, stDef, false))
+                    return;
 
-            z = FLT2FIX(subsec.visFloor().heightSmoothed()) + hardRadius;
-            zBounce = true;
-            hitFloor = true;
-        }
+                z = pinfo.floorLimit[index];
+                zBounce = true;
+                hitFloor = true;
+            }
 
-        if(zBounce)
-        {
-            pinfo->mov[2] = FixedMul(-pinfo->mov[2], st->bounce);
-            if(!pinfo->mov[2])
+            if(zBounce)
             {
-                // The particle has stopped moving. This means its Z-movement
-                // has ceased because of the collision with a plane. Plane-flat
-                // particles will stick to the plane.
-                if((st->type == PTC_POINT || (st->type >= PTC_TEXTURE && st->type < PTC_TEXTURE + MAX_PTC_TEXTURES)) &&
-                   st->flags.testFlag(ParticleStage::PlaneFlat))
+                fixed_t &movZ = pinfo.mov[2][index];
+                movZ = FixedMul(-movZ, st->bounce);
+                if(!movZ)
                 {
-                    z = hitFloor ? DDMININT : DDMAXINT;
+                    // The particle has stopped moving. This means its Z-movement
+                    // has ceased because of the collision with a plane. Plane-flat
+                    // particles will stick to the plane.
+                    if((st->type == PTC_POINT || (st->type >= PTC_TEXTURE && st->type < PTC_TEXTURE + MAX_PTC_TEXTURES)) &&
+                       st->flags.testFlag(ParticleStage::PlaneFlat))
+                    {
+                        z = hitFloor ? DDMININT : DDMAXINT;
+                    }
                 }
             }
         }
 
         // Move to the new Z coordinate.
-        pinfo->origin[2] = z;
+        pinfo.origin[2][index] = z;
     }
 
     // Now check the XY direction.
     // - Check if the movement crosses any solid lines.
     // - If it does, quit when first one contacted and apply appropriate
     //   bounce (result depends on the angle of the contacted wall).
-    fixed_t x = pinfo->origin[0] + pinfo->mov[0];
-    fixed_t y = pinfo->origin[1] + pinfo->mov[1];
+    fixed_t mov[2] = { pinfo.mov[0][index], pinfo.mov[1][index] };
+    fixed_t x = pinfo.origin[0][index] + mov[0];
+    fixed_t y = pinfo.origin[1][index] + mov[1];
 
     struct checklineworker_params_t
     {
@@ -827,18 +942,18 @@ void Generator::moveParticle(dint index)
 
     // XY movement can be skipped if the particle is not moving on the
     // XY plane.
-    if(!pinfo->mov[0] && !pinfo->mov[1])
+    if(!mov[0] && !mov[1])
     {
         // If the particle is contacting a line, there is a chance that the
         // particle should be killed (if it's moving slowly at max).
-        if(pinfo->contact)
+        if(Line *contact = pinfo.contact[index])
         {
-            Sector *front = pinfo->contact->front().sectorPtr();
-            Sector *back  = pinfo->contact->back().sectorPtr();
+            Sector *front = contact->front().sectorPtr();
+            Sector *back  = contact->back().sectorPtr();
 
-            if(front && back && abs(pinfo->mov[2]) < FRACUNIT / 2)
+            if(front && back && abs(pinfo.mov[2][index]) < FRACUNIT / 2)
             {
-                coord_t const pz = particleZ(*pinfo);
+                coord_t const pz = particleZ(index);
 
                 coord_t fz;
                 if(front->floor().height() > back->floor().height())
@@ -865,7 +980,7 @@ void Generator::moveParticle(dint index)
                 if(pz > fz && pz < cz)
                 {
                     // Kill the particle.
-                    pinfo->stage = -1;
+                    pinfo.stage[index] = -1;
                     return;
                 }
             }
@@ -876,22 +991,22 @@ void Generator::moveParticle(dint index)
     }
 
     // We're moving in XY, so if we don't hit anything there can't be any line contact.
-    pinfo->contact = 0;
+    pinfo.contact[index] = 0;
 
     // Bounding box of the movement line.
     clParm.tmpz = z;
     clParm.tmprad = hardRadius;
-    clParm.tmpx1 = pinfo->origin[0];
+    clParm.tmpx1 = pinfo.origin[0][index];
     clParm.tmpx2 = x;
-    clParm.tmpy1 = pinfo->origin[1];
+    clParm.tmpy1 = pinfo.origin[1][index];
     clParm.tmpy2 = y;
 
     vec2d_t point;
-    V2d_Set(point, FIX2FLT(MIN_OF(x, pinfo->origin[0]) - st->radius),
-                   FIX2FLT(MIN_OF(y, pinfo->origin[1]) - st->radius));
+    V2d_Set(point, FIX2FLT(MIN_OF(x, clParm.tmpx1) - st->radius),
+                   FIX2FLT(MIN_OF(y, clParm.tmpy1) - st->radius));
     V2d_InitBox(clParm.box.arvec2, point);
-    V2d_Set(point, FIX2FLT(MAX_OF(x, pinfo->origin[0]) + st->radius),
-                   FIX2FLT(MAX_OF(y, pinfo->origin[1]) + st->radius));
+    V2d_Set(point, FIX2FLT(MAX_OF(x, clParm.tmpx1) + st->radius),
+                   FIX2FLT(MAX_OF(y, clParm.tmpy1) + st->radius));
     V2d_AddToBox(clParm.box.arvec2, point);
 
     // Iterate the lines in the contacted blocks.
@@ -969,7 +1084,7 @@ void Generator::moveParticle(dint index)
         fixed_t normal[2], dotp;
 
         // Must survive the touch.
-        if(!touchParticle(pinfo, st, stDef, true))
+        if(!touchParticle(pinfo, index, st, stDef, true))
             return;
 
         // There was a hit! Calculate bounce vector.
@@ -986,37 +1101,40 @@ void Generator::moveParticle(dint index)
             goto quit_iteration;
 
         // Calculate as floating point so we don't overflow.
-        dotp = FRACUNIT * (DOT2F(pinfo->mov, normal) / DOT2F(normal, normal));
+        dotp = FRACUNIT * (DOT2F(mov, normal) / DOT2F(normal, normal));
         VECMUL(normal, dotp);
-        VECSUB(normal, pinfo->mov);
-        VECMULADD(pinfo->mov, 2 * FRACUNIT, normal);
-        VECMUL(pinfo->mov, st->bounce);
+        VECSUB(normal, mov);
+        VECMULADD(mov, 2 * FRACUNIT, normal);
+        VECMUL(mov, st->bounce);
+        pinfo.mov[0][index] = mov[0];
+        pinfo.mov[1][index] = mov[1];
 
         // Continue from the old position.
-        x = pinfo->origin[0];
-        y = pinfo->origin[1];
+        x = pinfo.origin[0][index];
+        y = pinfo.origin[1][index];
         clParm.tmcross = false; // Sector can't change if XY doesn't.
 
         // This line is the latest contacted line.
-        pinfo->contact = clParm.ptcHitLine;
+        pinfo.contact[index] = clParm.ptcHitLine;
         goto quit_iteration;
     }
 
   quit_iteration:
     // The move is now OK.
-    pinfo->origin[0] = x;
-    pinfo->origin[1] = y;
+    pinfo.origin[0][index] = x;
+    pinfo.origin[1][index] = y;
 
     // Should we update the sector pointer?
     if(clParm.tmcross)
     {
-        pinfo->bspLeaf = &map().bspLeafAt(Vector2d(FIX2FLT(x), FIX2FLT(y)));
+        BspLeaf *bspLeaf = &map().bspLeafAt(Vector2d(FIX2FLT(x), FIX2FLT(y)));
+        pinfo.bspLeaf[index] = bspLeaf;
 
         // A BSP leaf with no geometry is not a suitable place for a particle.
-        if(!pinfo->bspLeaf->hasSubspace())
+        if(!bspLeaf->hasSubspace())
         {
             // Kill the particle.
-            pinfo->stage = -1;
+            pinfo.stage[index] = -1;
         }
     }
 }
@@ -1091,32 +1209,113 @@ void Generator::runTick()
         }
     }
 
-    // Move particles.
-    ParticleInfo *pinfo = _pinfo;
-    for(dint i = 0; i < count; ++i, pinfo++)
+    // Advance particle stages.
+    for(dint i = 0; i < count; ++i)
     {
-        if(pinfo->stage < 0) continue; // Not in use.
+        dint &stage = _pinfo.stage[i];
+        if(stage < 0) continue; // Not in use.
 
-        if(pinfo->tics-- <= 0)
+        if(_pinfo.tics[i]-- <= 0)
         {
             // Advance to next stage.
-            if(++pinfo->stage == def->stages.size() ||
-               stages[pinfo->stage].type == PTC_NONE)
+            if(++stage == def->stages.size() ||
+               stages[stage].type == PTC_NONE)
             {
                 // Kill the particle.
-                pinfo->stage = -1;
+                stage = -1;
                 continue;
             }
 
-            pinfo->tics = def->stages[pinfo->stage].tics * (1 - def->stages[pinfo->stage].variance * RNG_RandFloat());
+            _pinfo.tics[i] = def->stages[stage].tics * (1 - def->stages[stage].variance * RNG_RandFloat());
+            setParticleStageParams(_pinfo, i, stages[stage]);
 
             // Change in particle angles?
-            setParticleAngles(pinfo, def->stages[pinfo->stage].flags);
+            setParticleAngles(_pinfo.yaw[i], _pinfo.pitch[i], def->stages[stage].flags);
 
             // Play a sound?
-            particleSound(pinfo->origin, &def->stages[pinfo->stage].sound);
+            particleSound(_pinfo, i, &def->stages[stage].sound);
+        }
+    }
+
+    _movePending = true;
+}
+
+bool Generator::isMovePending() const
+{
+    return _movePending;
+}
+
+void Generator::stepParticles(dint first, dint end, fixed_t gravity)
+{
+    DENG2_ASSERT(first >= 0 && end <= count);
+
+    ParticleStore &pinfo = _pinfo;
+    dint const num = end - first;
+
+    for(dint i = first; i < end; ++i)
+    {
+        if(pinfo.stage[i] >= 0) accelerateParticle(i);
+    }
+
+    // Gravity and resistance. The kernel also processes the particles not in use;
+    // their momentum is reset when they are spawned.
+    dint i = first + ParticleSimd_Accelerate(pinfo.mov[0] + first, pinfo.mov[1] + first,
+                                             pinfo.mov[2] + first, pinfo.gravity + first,
+                                             pinfo.resistance + first, num, gravity);
+    for(; i < end; ++i)
+    {
+        if(pinfo.stage[i] < 0) continue; // Not in use.
+
+        pinfo.mov[2][i] -= FixedMul(gravity, pinfo.gravity[i]);
+        if(pinfo.resistance[i] != FRACUNIT)
+        {
+            for(dint k = 0; k < 3; ++k)
+            {
+                pinfo.mov[k][i] = FixedMul(pinfo.mov[k][i], pinfo.resistance[i]);
+            }
+        }
+    }
+
+    // Heights of the planes that free-moving particles can touch. The planes do not
+    // move before moveParticles().
+    for(i = first; i < end; ++i)
+    {
+        fixed_t const z = pinfo.origin[2][i];
+        if(pinfo.stage[i] < 0 || z == DDMININT || z == DDMAXINT || !pinfo.bspLeaf[i])
+        {
+            pinfo.floorLimit[i] = DDMININT;
+            pinfo.ceilLimit[i]  = DDMAXINT;
+            continue;
         }
 
+        auto const &subsec = pinfo.bspLeaf[i]->subspace().subsector().as<world::ClientSubsector>();
+        fixed_t const hardRadius = particleHardRadius(stages[pinfo.stage[i]]);
+        pinfo.floorLimit[i] = FLT2FIX(subsec.visFloor().heightSmoothed()) + hardRadius;
+        pinfo.ceilLimit[i]  = FLT2FIX(subsec.visCeiling().heightSmoothed()) - hardRadius;
+    }
+
+    // Movement along the Z axis, and the plane contacts.
+    i = first + ParticleSimd_StepZ(pinfo.stepZ + first, pinfo.touch + first,
+                                   pinfo.origin[2] + first, pinfo.mov[2] + first,
+                                   pinfo.floorLimit + first, pinfo.ceilLimit + first, num);
+    for(; i < end; ++i)
+    {
+        if(pinfo.stage[i] < 0) continue; // Not in use.
+
+        fixed_t const z = pinfo.origin[2][i] + pinfo.mov[2][i];
+        pinfo.stepZ[i] = z;
+        pinfo.touch[i] = (z > pinfo.ceilLimit[i] || z < pinfo.floorLimit[i]);
+    }
+}
+
+void Generator::moveParticles()
+{
+    _movePending = false;
+
+    for(dint i = 0; i < count; ++i)
+    {
+        if(_pinfo.stage[i] < 0) continue; // Not in use.
+
         // Try to move.
         moveParticle(i);
     }
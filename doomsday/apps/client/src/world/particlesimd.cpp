@@ -0,0 +1,253 @@
+/** @file particlesimd.cpp  Vectorized particle stepping kernels.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "world/particlesimd.h"
+#include "misc/simdlevel.h"
+
+#include <de/libcore.h>
+#include <de/fixedpoint.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define DENG_PARTICLESIMD_X86
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    define PARTICLESIMD_TARGET(isa)
+#  else
+#    define PARTICLESIMD_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+   // Double-precision vectors are only available on AArch64.
+#  define DENG_PARTICLESIMD_NEON
+#  include <arm_neon.h>
+#endif
+
+/*
+ * FixedMul() is (fixed_t) (((double) a * (double) b) / FRACUNIT). The division by
+ * a power of two is exact, so it is done as a multiplication. Conversion to
+ * integer truncates towards zero; out-of-range values become 0x80000000 on x86
+ * and saturate on ARM, as with the scalar conversions.
+ */
+
+#if defined(DENG_PARTICLESIMD_X86) && defined(DENG_NO_FIXED_ASM)
+
+PARTICLESIMD_TARGET("sse2")
+static inline __m128i fixedMulSSE2(__m128i a, __m128i b)
+{
+    __m128d const scale = _mm_set1_pd(1.0 / FRACUNIT);
+    __m128i const aHi = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 2, 3, 2));
+    __m128i const bHi = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 2, 3, 2));
+    __m128d const lo = _mm_mul_pd(_mm_mul_pd(_mm_cvtepi32_pd(a),   _mm_cvtepi32_pd(b)),   scale);
+    __m128d const hi = _mm_mul_pd(_mm_mul_pd(_mm_cvtepi32_pd(aHi), _mm_cvtepi32_pd(bHi)), scale);
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+}
+
+PARTICLESIMD_TARGET("avx2")
+static inline __m256i fixedMulAVX2(__m256i a, __m256i b)
+{
+    __m256d const scale = _mm256_set1_pd(1.0 / FRACUNIT);
+    __m256d const lo = _mm256_mul_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+                                                   _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))),
+                                     scale);
+    __m256d const hi = _mm256_mul_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+                                                   _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))),
+                                     scale);
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(lo)),
+                                   _mm256_cvttpd_epi32(hi), 1);
+}
+
+PARTICLESIMD_TARGET("sse2")
+static int accelerateSSE2(fixed_t *movX, fixed_t *movY, fixed_t *movZ, fixed_t const *gravity,
+                          fixed_t const *resistance, int count, fixed_t mapGravity)
+{
+    __m128i const grav = _mm_set1_epi32(mapGravity);
+    int i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i const res = _mm_loadu_si128((__m128i const *) (resistance + i));
+        __m128i z = _mm_loadu_si128((__m128i const *) (movZ + i));
+        z = _mm_sub_epi32(z, fixedMulSSE2(grav, _mm_loadu_si128((__m128i const *) (gravity + i))));
+        _mm_storeu_si128((__m128i *) (movX + i),
+                         fixedMulSSE2(_mm_loadu_si128((__m128i const *) (movX + i)), res));
+        _mm_storeu_si128((__m128i *) (movY + i),
+                         fixedMulSSE2(_mm_loadu_si128((__m128i const *) (movY + i)), res));
+        _mm_storeu_si128((__m128i *) (movZ + i), fixedMulSSE2(z, res));
+    }
+    return i;
+}
+
+PARTICLESIMD_TARGET("avx2")
+static int accelerateAVX2(fixed_t *movX, fixed_t *movY, fixed_t *movZ, fixed_t const *gravity,
+                          fixed_t const *resistance, int count, fixed_t mapGravity)
+{
+    __m256i const grav = _mm256_set1_epi32(mapGravity);
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i const res = _mm256_loadu_si256((__m256i const *) (resistance + i));
+        __m256i z = _mm256_loadu_si256((__m256i const *) (movZ + i));
+        z = _mm256_sub_epi32(z, fixedMulAVX2(grav, _mm256_loadu_si256((__m256i const *) (gravity + i))));
+        _mm256_storeu_si256((__m256i *) (movX + i),
+                            fixedMulAVX2(_mm256_loadu_si256((__m256i const *) (movX + i)), res));
+        _mm256_storeu_si256((__m256i *) (movY + i),
+                            fixedMulAVX2(_mm256_loadu_si256((__m256i const *) (movY + i)), res));
+        _mm256_storeu_si256((__m256i *) (movZ + i), fixedMulAVX2(z, res));
+    }
+    return i;
+}
+
+#endif // DENG_PARTICLESIMD_X86 && DENG_NO_FIXED_ASM
+
+#ifdef DENG_PARTICLESIMD_X86
+
+PARTICLESIMD_TARGET("sse2")
+static int stepZSSE2(fixed_t *z, uint8_t *touch, fixed_t const *originZ, fixed_t const *movZ,
+                     fixed_t const *floorLimit, fixed_t const *ceilLimit, int count)
+{
+    int i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i const v = _mm_add_epi32(_mm_loadu_si128((__m128i const *) (originZ + i)),
+                                        _mm_loadu_si128((__m128i const *) (movZ + i)));
+        __m128i const hit = _mm_or_si128(
+                _mm_cmpgt_epi32(v, _mm_loadu_si128((__m128i const *) (ceilLimit + i))),
+                _mm_cmplt_epi32(v, _mm_loadu_si128((__m128i const *) (floorLimit + i))));
+        __m128i flags = _mm_packs_epi32(hit, hit);
+        flags = _mm_packs_epi16(flags, flags);
+        _mm_storeu_si128((__m128i *) (z + i), v);
+        int32_t const packed = _mm_cvtsi128_si32(flags);
+        std::memcpy(touch + i, &packed, 4);
+    }
+    return i;
+}
+
+PARTICLESIMD_TARGET("avx2")
+static int stepZAVX2(fixed_t *z, uint8_t *touch, fixed_t const *originZ, fixed_t const *movZ,
+                     fixed_t const *floorLimit, fixed_t const *ceilLimit, int count)
+{
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i const v = _mm256_add_epi32(_mm256_loadu_si256((__m256i const *) (originZ + i)),
+                                           _mm256_loadu_si256((__m256i const *) (movZ + i)));
+        __m256i const hit = _mm256_or_si256(
+                _mm256_cmpgt_epi32(v, _mm256_loadu_si256((__m256i const *) (ceilLimit + i))),
+                _mm256_cmpgt_epi32(_mm256_loadu_si256((__m256i const *) (floorLimit + i)), v));
+        __m128i flags = _mm_packs_epi32(_mm256_castsi256_si128(hit),
+                                        _mm256_extracti128_si256(hit, 1));
+        flags = _mm_packs_epi16(flags, flags);
+        _mm256_storeu_si256((__m256i *) (z + i), v);
+        _mm_storel_epi64((__m128i *) (touch + i), flags);
+    }
+    return i;
+}
+
+#endif // DENG_PARTICLESIMD_X86
+
+#ifdef DENG_PARTICLESIMD_NEON
+
+#ifdef DENG_NO_FIXED_ASM
+static inline int32x4_t fixedMulNEON(int32x4_t a, int32x4_t b)
+{
+    float64x2_t const scale = vdupq_n_f64(1.0 / FRACUNIT);
+    float64x2_t const lo = vmulq_f64(vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(a))),
+                                               vcvtq_f64_s64(vmovl_s32(vget_low_s32(b)))), scale);
+    float64x2_t const hi = vmulq_f64(vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(a))),
+                                               vcvtq_f64_s64(vmovl_s32(vget_high_s32(b)))), scale);
+    return vcombine_s32(vqmovn_s64(vcvtq_s64_f64(lo)), vqmovn_s64(vcvtq_s64_f64(hi)));
+}
+
+static int accelerateNEON(fixed_t *movX, fixed_t *movY, fixed_t *movZ, fixed_t const *gravity,
+                          fixed_t const *resistance, int count, fixed_t mapGravity)
+{
+    int32x4_t const grav = vdupq_n_s32(mapGravity);
+    int i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        int32x4_t const res = vld1q_s32(resistance + i);
+        int32x4_t const z = vsubq_s32(vld1q_s32(movZ + i), fixedMulNEON(grav, vld1q_s32(gravity + i)));
+        vst1q_s32(movX + i, fixedMulNEON(vld1q_s32(movX + i), res));
+        vst1q_s32(movY + i, fixedMulNEON(vld1q_s32(movY + i), res));
+        vst1q_s32(movZ + i, fixedMulNEON(z, res));
+    }
+    return i;
+}
+#endif // DENG_NO_FIXED_ASM
+
+static int stepZNEON(fixed_t *z, uint8_t *touch, fixed_t const *originZ, fixed_t const *movZ,
+                     fixed_t const *floorLimit, fixed_t const *ceilLimit, int count)
+{
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        int32x4_t const v1 = vaddq_s32(vld1q_s32(originZ + i),     vld1q_s32(movZ + i));
+        int32x4_t const v2 = vaddq_s32(vld1q_s32(originZ + i + 4), vld1q_s32(movZ + i + 4));
+        uint32x4_t const hit1 = vorrq_u32(vcgtq_s32(v1, vld1q_s32(ceilLimit + i)),
+                                          vcltq_s32(v1, vld1q_s32(floorLimit + i)));
+        uint32x4_t const hit2 = vorrq_u32(vcgtq_s32(v2, vld1q_s32(ceilLimit + i + 4)),
+                                          vcltq_s32(v2, vld1q_s32(floorLimit + i + 4)));
+        vst1q_s32(z + i,     v1);
+        vst1q_s32(z + i + 4, v2);
+        vst1_u8(touch + i, vmovn_u16(vcombine_u16(vmovn_u32(hit1), vmovn_u32(hit2))));
+    }
+    return i;
+}
+
+#endif // DENG_PARTICLESIMD_NEON
+
+int ParticleSimd_Accelerate(fixed_t *movX, fixed_t *movY, fixed_t *movZ,
+                            fixed_t const *gravity, fixed_t const *resistance,
+                            int count, fixed_t mapGravity)
+{
+#ifdef DENG_NO_FIXED_ASM
+    switch(Simd_Level())
+    {
+# ifdef DENG_PARTICLESIMD_X86
+    case SIMD_AVX2: return accelerateAVX2(movX, movY, movZ, gravity, resistance, count, mapGravity);
+    case SIMD_SSE2: return accelerateSSE2(movX, movY, movZ, gravity, resistance, count, mapGravity);
+# endif
+# ifdef DENG_PARTICLESIMD_NEON
+    case SIMD_NEON: return accelerateNEON(movX, movY, movZ, gravity, resistance, count, mapGravity);
+# endif
+    default: return 0;
+    }
+#else
+    DENG2_UNUSED4(movX, movY, movZ, gravity);
+    DENG2_UNUSED3(resistance, count, mapGravity);
+    return 0;
+#endif
+}
+
+int ParticleSimd_StepZ(fixed_t *z, uint8_t *touch, fixed_t const *originZ,
+                       fixed_t const *movZ, fixed_t const *floorLimit,
+                       fixed_t const *ceilLimit, int count)
+{
+    switch(Simd_Level())
+    {
+#ifdef DENG_PARTICLESIMD_X86
+    case SIMD_AVX2: return stepZAVX2(z, touch, originZ, movZ, floorLimit, ceilLimit, count);
+    case SIMD_SSE2: return stepZSSE2(z, touch, originZ, movZ, floorLimit, ceilLimit, count);
+#endif
+#ifdef DENG_PARTICLESIMD_NEON
+    case SIMD_NEON: return stepZNEON(z, touch, originZ, movZ, floorLimit, ceilLimit, count);
+#endif
+    default: return 0;
+    }
+}
@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <de/libcore.h>
+#include <de/ISerializable>
 #include <de/Record>
 #include <de/String>
 #include <de/Vector>
@@ -41,8 +42,12 @@
  * It is VERY important not to sort the data arrays in any way: the index numbers are
  * important. The game plugins must be recompiled with the new constants if the order of the
  * array items changes.
+ *
+ * The serialized form of the database is a binary snapshot of all the definitions, so that
+ * they can be restored without parsing. Runtime links between definitions are not included.
+ * The format is only meant to be read by the same build that wrote it.
  */
-struct LIBDOOMSDAY_PUBLIC ded_s
+struct LIBDOOMSDAY_PUBLIC ded_s : public de::ISerializable
 {
     de::Record names; ///< Namespace where definition values are stored.
 
@@ -209,6 +214,18 @@ public:
      */
     de::String findEpisode(de::String const &mapId) const;
 
+    // Implements ISerializable.
+    void operator >> (de::Writer &to) const override;
+    void operator << (de::Reader &from) override;
+
+    /**
+     * Returns a checksum of the sizes of the definition structures that are
+     * serialized field by field. If a structure changes (e.g., a field is added),
+     * the checksum changes, so serialized definitions of an older layout can be
+     * recognized as outdated.
+     */
+    static de::duint32 serialLayout();
+
 protected:
     void release();
 
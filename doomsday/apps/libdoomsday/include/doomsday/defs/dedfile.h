@@ -24,10 +24,38 @@
 
 #include "../libdoomsday.h"
 #include "ded.h"
+#include <de/Block>
 #include <de/String>
+#include <functional>
+
+/**
+ * Function that is called with the source text of a definition file that is about to
+ * be parsed.
+ */
+typedef std::function<void (de::String const &path, de::Block const &source)> DEDSourceFunc;
 
 LIBDOOMSDAY_PUBLIC void Def_ReadProcessDED(ded_t *defs, de::String path);
 
+/**
+ * Sets a function to be called for each definition file read with Def_ReadProcessDED(),
+ * including the files included from other files. This can be used for finding out which
+ * files the definitions depend on.
+ *
+ * @param func  Function to call, or @c nullptr to stop.
+ */
+LIBDOOMSDAY_PUBLIC void DED_SetSourceObserver(DEDSourceFunc func);
+
+/**
+ * Reads the source text of a definition file without parsing it. The file is located
+ * the same way as in Def_ReadProcessDED().
+ *
+ * @param path    Path of the definition file.
+ * @param source  The source text is written here.
+ *
+ * @return @c true, if the file was found.
+ */
+LIBDOOMSDAY_PUBLIC bool DED_ReadSource(de::String const &path, de::Block &source);
+
 /**
  * Reads definitions from the given lump.
  */
@@ -108,6 +108,20 @@ public:
      */
     FileHandle &rewind();
 
+    /**
+     * Provides direct, read-only access to the entire contents of the file. Native files
+     * are memory-mapped (on first call) and buffered lumps are returned as is, so no
+     * copies of the data are made. The returned pointer remains valid until the handle
+     * is closed.
+     *
+     * @param length  If not @c nullptr, the length of the accessible data in bytes is
+     *                written here.
+     *
+     * @return  Start of the file contents (@ref baseOffset() already applied); otherwise
+     * @c nullptr if the file cannot be accessed directly (e.g., mapping failed).
+     */
+    uint8_t const *mappedData(size_t *length = nullptr);
+
 public:
     /**
      * Create a new handle on the File @a file.
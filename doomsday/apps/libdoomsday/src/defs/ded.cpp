@@ -22,11 +22,14 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <de/memory.h>
 #include <de/strutil.h>
 #include <de/ArrayValue>
 #include <de/NumberValue>
+#include <de/Reader>
 #include <de/RecordValue>
+#include <de/Writer>
 
 #include "doomsday/defs/decoration.h"
 #include "doomsday/defs/episode.h"
@@ -204,6 +207,628 @@ void ded_s::release()
     finales.clear();
 }
 
+/// Version of the serialized definitions. Increment when the format changes.
+static duint32 const DED_SERIAL_VERSION = 1;
+
+namespace {
+
+template <dsize Size>
+void writeText(Writer &to, char const (&text)[Size])
+{
+    to << Block(text, qstrnlen(text, Size));
+}
+
+template <dsize Size>
+void readText(Reader &from, char (&text)[Size])
+{
+    Block block;
+    from >> block;
+    qstrncpy(text, block.constData(), Size);
+}
+
+void writeString(Writer &to, char const *str)
+{
+    to << duint8(str? 1 : 0);
+    if (str) to << Block(str);
+}
+
+char *readString(Reader &from)
+{
+    duint8 present;
+    from >> present;
+    if (!present) return nullptr;
+
+    Block block;
+    from >> block;
+    return M_StrDup(block.constData());
+}
+
+void writeUri(Writer &to, de::Uri const *uri)
+{
+    to << duint8(uri? 1 : 0);
+    if (uri) to << *uri;
+}
+
+de::Uri *readUri(Reader &from)
+{
+    duint8 present;
+    from >> present;
+    if (!present) return nullptr;
+
+    std::unique_ptr<de::Uri> uri(new de::Uri);
+    from >> *uri;
+    return uri.release();
+}
+
+template <typename Type, dsize Size>
+void writeArray(Writer &to, Type const (&array)[Size])
+{
+    for (Type const &value : array) to << value;
+}
+
+template <typename Type, dsize Size>
+void readArray(Reader &from, Type (&array)[Size])
+{
+    for (Type &value : array) from >> value;
+}
+
+template <typename PODType>
+void writeElements(Writer &to, DEDArray<PODType> const &array);
+
+template <typename PODType>
+void readElements(Reader &from, DEDArray<PODType> &array);
+
+void writeElement(Writer &to, ded_uri_t const &elem)
+{
+    writeUri(to, elem.uri);
+}
+
+void readElement(Reader &from, ded_uri_t &elem)
+{
+    elem.uri = readUri(from);
+}
+
+void writeElement(Writer &to, ded_embsound_t const &snd)
+{
+    writeText(to, snd.name);
+    to << snd.id << snd.volume;
+}
+
+void readElement(Reader &from, ded_embsound_t &snd)
+{
+    readText(from, snd.name);
+    from >> snd.id >> snd.volume;
+}
+
+void writeElement(Writer &to, ded_ptcstage_t const &stage)
+{
+    to << stage.type << stage.tics << stage.variance;
+    writeArray(to, stage.color);
+    to << stage.radius << stage.radiusVariance << stage.flags << stage.bounce
+       << stage.resistance << stage.gravity;
+    writeArray(to, stage.vectorForce);
+    writeArray(to, stage.spin);
+    writeArray(to, stage.spinResistance);
+    to << stage.model;
+    writeText(to, stage.frameName);
+    writeText(to, stage.endFrameName);
+    to << stage.frame << stage.endFrame;
+    writeElement(to, stage.sound);
+    writeElement(to, stage.hitSound);
+}
+
+void readElement(Reader &from, ded_ptcstage_t &stage)
+{
+    from >> stage.type >> stage.tics >> stage.variance;
+    readArray(from, stage.color);
+    from >> stage.radius >> stage.radiusVariance >> stage.flags >> stage.bounce
+         >> stage.resistance >> stage.gravity;
+    readArray(from, stage.vectorForce);
+    readArray(from, stage.spin);
+    readArray(from, stage.spinResistance);
+    from >> stage.model;
+    readText(from, stage.frameName);
+    readText(from, stage.endFrameName);
+    from >> stage.frame >> stage.endFrame;
+    readElement(from, stage.sound);
+    readElement(from, stage.hitSound);
+}
+
+void writeElement(Writer &to, ded_sprid_t const &sprite)
+{
+    writeText(to, sprite.id);
+}
+
+void readElement(Reader &from, ded_sprid_t &sprite)
+{
+    readText(from, sprite.id);
+}
+
+void writeElement(Writer &to, ded_light_t const &light)
+{
+    writeText(to, light.state);
+    writeText(to, light.uniqueMapID);
+    writeArray(to, light.offset);
+    to << light.size;
+    writeArray(to, light.color);
+    writeArray(to, light.lightLevel);
+    to << light.flags;
+    writeUri(to, light.up);
+    writeUri(to, light.down);
+    writeUri(to, light.sides);
+    writeUri(to, light.flare);
+    to << light.haloRadius;
+}
+
+void readElement(Reader &from, ded_light_t &light)
+{
+    readText(from, light.state);
+    readText(from, light.uniqueMapID);
+    readArray(from, light.offset);
+    from >> light.size;
+    readArray(from, light.color);
+    readArray(from, light.lightLevel);
+    from >> light.flags;
+    light.up    = readUri(from);
+    light.down  = readUri(from);
+    light.sides = readUri(from);
+    light.flare = readUri(from);
+    from >> light.haloRadius;
+}
+
+void writeElement(Writer &to, ded_sound_t const &sound)
+{
+    writeText(to, sound.id);
+    writeText(to, sound.name);
+    writeText(to, sound.lumpName);
+    writeUri(to, sound.ext);
+    writeText(to, sound.link);
+    to << sound.linkPitch << sound.linkVolume << sound.priority << sound.channels
+       << sound.group << sound.flags;
+}
+
+void readElement(Reader &from, ded_sound_t &sound)
+{
+    readText(from, sound.id);
+    readText(from, sound.name);
+    readText(from, sound.lumpName);
+    sound.ext = readUri(from);
+    readText(from, sound.link);
+    from >> sound.linkPitch >> sound.linkVolume >> sound.priority >> sound.channels
+         >> sound.group >> sound.flags;
+}
+
+void writeElement(Writer &to, ded_text_t const &text)
+{
+    writeText(to, text.id);
+    writeString(to, text.text);
+}
+
+void readElement(Reader &from, ded_text_t &text)
+{
+    readText(from, text.id);
+    text.text = readString(from);
+}
+
+void writeElement(Writer &to, ded_tenviron_t const &env)
+{
+    writeText(to, env.id);
+    writeElements(to, env.materials);
+}
+
+void readElement(Reader &from, ded_tenviron_t &env)
+{
+    readText(from, env.id);
+    readElements(from, env.materials);
+}
+
+void writeElement(Writer &to, ded_value_t const &value)
+{
+    writeString(to, value.id);
+    writeString(to, value.text);
+}
+
+void readElement(Reader &from, ded_value_t &value)
+{
+    value.id   = readString(from);
+    value.text = readString(from);
+}
+
+void writeElement(Writer &to, ded_detailtexture_t const &detail)
+{
+    writeUri(to, detail.material1);
+    writeUri(to, detail.material2);
+    to << detail.flags << detail.stage.tics << detail.stage.variance;
+    writeUri(to, detail.stage.texture);
+    to << detail.stage.scale << detail.stage.strength << detail.stage.maxDistance;
+}
+
+void readElement(Reader &from, ded_detailtexture_t &detail)
+{
+    detail.material1 = readUri(from);
+    detail.material2 = readUri(from);
+    from >> detail.flags >> detail.stage.tics >> detail.stage.variance;
+    detail.stage.texture = readUri(from);
+    from >> detail.stage.scale >> detail.stage.strength >> detail.stage.maxDistance;
+}
+
+void writeElement(Writer &to, ded_ptcgen_t const &gen)
+{
+    // The generators of a state are linked at runtime (stateNext).
+    writeText(to, gen.state);
+    writeUri(to, gen.material);
+    writeText(to, gen.type);
+    writeText(to, gen.type2);
+    to << gen.typeNum << gen.type2Num;
+    writeText(to, gen.damage);
+    to << gen.damageNum;
+    writeUri(to, gen.map);
+    to << gen.flags << gen.speed << gen.speedVariance;
+    writeArray(to, gen.vector);
+    to << gen.vectorVariance << gen.initVectorVariance;
+    writeArray(to, gen.center);
+    to << gen.subModel << gen.spawnRadius << gen.spawnRadiusMin << gen.maxDist
+       << gen.spawnAge << gen.maxAge << gen.particles << gen.spawnRate
+       << gen.spawnRateVariance << gen.preSim << gen.altStart << gen.altStartVariance
+       << gen.force << gen.forceRadius;
+    writeArray(to, gen.forceAxis);
+    writeArray(to, gen.forceOrigin);
+    writeElements(to, gen.stages);
+}
+
+void readElement(Reader &from, ded_ptcgen_t &gen)
+{
+    readText(from, gen.state);
+    gen.material = readUri(from);
+    readText(from, gen.type);
+    readText(from, gen.type2);
+    from >> gen.typeNum >> gen.type2Num;
+    readText(from, gen.damage);
+    from >> gen.damageNum;
+    gen.map = readUri(from);
+    from >> gen.flags >> gen.speed >> gen.speedVariance;
+    readArray(from, gen.vector);
+    from >> gen.vectorVariance >> gen.initVectorVariance;
+    readArray(from, gen.center);
+    from >> gen.subModel >> gen.spawnRadius >> gen.spawnRadiusMin >> gen.maxDist
+         >> gen.spawnAge >> gen.maxAge >> gen.particles >> gen.spawnRate
+         >> gen.spawnRateVariance >> gen.preSim >> gen.altStart >> gen.altStartVariance
+         >> gen.force >> gen.forceRadius;
+    readArray(from, gen.forceAxis);
+    readArray(from, gen.forceOrigin);
+    readElements(from, gen.stages);
+}
+
+void writeElement(Writer &to, ded_reflection_t const &ref)
+{
+    writeUri(to, ref.material);
+    to << ref.flags << ref.stage.tics << ref.stage.variance;
+    writeUri(to, ref.stage.texture);
+    writeUri(to, ref.stage.maskTexture);
+    to << dint32(ref.stage.blendMode) << ref.stage.shininess;
+    writeArray(to, ref.stage.minColor);
+    to << ref.stage.maskWidth << ref.stage.maskHeight;
+}
+
+void readElement(Reader &from, ded_reflection_t &ref)
+{
+    ref.material = readUri(from);
+    from >> ref.flags >> ref.stage.tics >> ref.stage.variance;
+    ref.stage.texture     = readUri(from);
+    ref.stage.maskTexture = readUri(from);
+    dint32 blendMode;
+    from >> blendMode >> ref.stage.shininess;
+    ref.stage.blendMode = blendmode_t(blendMode);
+    readArray(from, ref.stage.minColor);
+    from >> ref.stage.maskWidth >> ref.stage.maskHeight;
+}
+
+void writeElement(Writer &to, ded_group_member_t const &member)
+{
+    writeUri(to, member.material);
+    to << member.tics << member.randomTics;
+}
+
+void readElement(Reader &from, ded_group_member_t &member)
+{
+    member.material = readUri(from);
+    from >> member.tics >> member.randomTics;
+}
+
+void writeElement(Writer &to, ded_group_t const &group)
+{
+    to << group.flags;
+    writeElements(to, group.members);
+}
+
+void readElement(Reader &from, ded_group_t &group)
+{
+    from >> group.flags;
+    readElements(from, group.members);
+}
+
+void writeElement(Writer &to, ded_linetype_t const &lt)
+{
+    to << lt.id;
+    writeText(to, lt.comment);
+    writeArray(to, lt.flags);
+    to << lt.lineClass << lt.actType << lt.actCount << lt.actTime << lt.actTag;
+    writeArray(to, lt.aparm);
+    writeText(to, lt.aparm9);
+    to << lt.tickerStart << lt.tickerEnd << lt.tickerInterval;
+    writeText(to, lt.actSound);
+    writeText(to, lt.deactSound);
+    to << lt.evChain << lt.actChain << lt.deactChain << lt.actLineType << lt.deactLineType
+       << lt.wallSection;
+    writeUri(to, lt.actMaterial);
+    writeUri(to, lt.deactMaterial);
+    writeText(to, lt.actMsg);
+    writeText(to, lt.deactMsg);
+    to << lt.materialMoveAngle << lt.materialMoveSpeed;
+    writeArray(to, lt.iparm);
+    for (auto const &str : lt.iparmStr) writeText(to, str);
+    writeArray(to, lt.fparm);
+    for (auto const &str : lt.sparm) writeText(to, str);
+}
+
+void readElement(Reader &from, ded_linetype_t &lt)
+{
+    from >> lt.id;
+    readText(from, lt.comment);
+    readArray(from, lt.flags);
+    from >> lt.lineClass >> lt.actType >> lt.actCount >> lt.actTime >> lt.actTag;
+    readArray(from, lt.aparm);
+    readText(from, lt.aparm9);
+    from >> lt.tickerStart >> lt.tickerEnd >> lt.tickerInterval;
+    readText(from, lt.actSound);
+    readText(from, lt.deactSound);
+    from >> lt.evChain >> lt.actChain >> lt.deactChain >> lt.actLineType >> lt.deactLineType
+         >> lt.wallSection;
+    lt.actMaterial   = readUri(from);
+    lt.deactMaterial = readUri(from);
+    readText(from, lt.actMsg);
+    readText(from, lt.deactMsg);
+    from >> lt.materialMoveAngle >> lt.materialMoveSpeed;
+    readArray(from, lt.iparm);
+    for (auto &str : lt.iparmStr) readText(from, str);
+    readArray(from, lt.fparm);
+    for (auto &str : lt.sparm) readText(from, str);
+}
+
+void writeElement(Writer &to, ded_sectortype_t const &st)
+{
+    to << st.id;
+    writeText(to, st.comment);
+    to << st.flags << st.actTag;
+    writeArray(to, st.chain);
+    writeArray(to, st.chainFlags);
+    writeArray(to, st.start);
+    writeArray(to, st.end);
+    for (auto const &interval : st.interval) writeArray(to, interval);
+    writeArray(to, st.count);
+    writeText(to, st.ambientSound);
+    writeArray(to, st.soundInterval);
+    writeArray(to, st.materialMoveAngle);
+    writeArray(to, st.materialMoveSpeed);
+    to << st.windAngle << st.windSpeed << st.verticalWind << st.gravity << st.friction;
+    writeText(to, st.lightFunc);
+    writeArray(to, st.lightInterval);
+    for (auto const &func : st.colFunc) writeText(to, func);
+    for (auto const &interval : st.colInterval) writeArray(to, interval);
+    writeText(to, st.floorFunc);
+    to << st.floorMul << st.floorOff;
+    writeArray(to, st.floorInterval);
+    writeText(to, st.ceilFunc);
+    to << st.ceilMul << st.ceilOff;
+    writeArray(to, st.ceilInterval);
+}
+
+void readElement(Reader &from, ded_sectortype_t &st)
+{
+    from >> st.id;
+    readText(from, st.comment);
+    from >> st.flags >> st.actTag;
+    readArray(from, st.chain);
+    readArray(from, st.chainFlags);
+    readArray(from, st.start);
+    readArray(from, st.end);
+    for (auto &interval : st.interval) readArray(from, interval);
+    readArray(from, st.count);
+    readText(from, st.ambientSound);
+    readArray(from, st.soundInterval);
+    readArray(from, st.materialMoveAngle);
+    readArray(from, st.materialMoveSpeed);
+    from >> st.windAngle >> st.windSpeed >> st.verticalWind >> st.gravity >> st.friction;
+    readText(from, st.lightFunc);
+    readArray(from, st.lightInterval);
+    for (auto &func : st.colFunc) readText(from, func);
+    for (auto &interval : st.colInterval) readArray(from, interval);
+    readText(from, st.floorFunc);
+    from >> st.floorMul >> st.floorOff;
+    readArray(from, st.floorInterval);
+    readText(from, st.ceilFunc);
+    from >> st.ceilMul >> st.ceilOff;
+    readArray(from, st.ceilInterval);
+}
+
+void writeElement(Writer &to, ded_compositefont_mappedcharacter_t const &mapped)
+{
+    to << duint8(mapped.ch);
+    writeUri(to, mapped.path);
+}
+
+void readElement(Reader &from, ded_compositefont_mappedcharacter_t &mapped)
+{
+    duint8 ch;
+    from >> ch;
+    mapped.ch   = ch;
+    mapped.path = readUri(from);
+}
+
+void writeElement(Writer &to, ded_compositefont_t const &font)
+{
+    writeUri(to, font.uri);
+    writeElements(to, font.charMap);
+}
+
+void readElement(Reader &from, ded_compositefont_t &font)
+{
+    font.uri = readUri(from);
+    readElements(from, font.charMap);
+}
+
+template <typename PODType>
+void writeElements(Writer &to, DEDArray<PODType> const &array)
+{
+    to << dint32(array.size());
+    for (int i = 0; i < array.size(); ++i)
+    {
+        writeElement(to, array[i]);
+    }
+}
+
+template <typename PODType>
+void readElements(Reader &from, DEDArray<PODType> &array)
+{
+    dint32 count;
+    from >> count;
+    if (count < 0)
+    {
+        throw ISerializable::DeserializationError("readElements", "Invalid number of elements");
+    }
+    // The new elements are zeroed, so they can be released even if reading fails.
+    PODType *elements = array.append(count);
+    for (int i = 0; i < count; ++i)
+    {
+        readElement(from, elements[i]);
+    }
+}
+
+void writeRegister(Writer &to, DEDRegister const &reg)
+{
+    to << dint32(reg.size());
+    for (int i = 0; i < reg.size(); ++i)
+    {
+        to << reg[i];
+    }
+}
+
+void readRegister(Reader &from, DEDRegister &reg)
+{
+    dint32 count;
+    from >> count;
+    for (int i = 0; i < count; ++i)
+    {
+        // The definitions are deserialized in their original order, so the register
+        // indexes them just like when they were parsed.
+        from >> reg.append();
+    }
+}
+
+} // namespace
+
+void ded_s::operator >> (Writer &to) const
+{
+    to << DED_SERIAL_VERSION << dint32(version) << dint32(modelFlags) << modelScale
+       << modelOffset;
+
+    writeRegister(to, flags);
+    writeRegister(to, episodes);
+    writeRegister(to, things);
+    writeRegister(to, states);
+    writeElements(to, sprites);
+    writeElements(to, lights);
+    writeRegister(to, materials);
+    writeRegister(to, models);
+    writeRegister(to, skies);
+    writeElements(to, sounds);
+    writeRegister(to, musics);
+    writeRegister(to, mapInfos);
+    writeElements(to, text);
+    writeElements(to, textureEnv);
+    writeElements(to, values);
+    writeElements(to, details);
+    writeElements(to, ptcGens);
+    writeRegister(to, finales);
+    writeRegister(to, decorations);
+    writeElements(to, reflections);
+    writeElements(to, groups);
+    writeElements(to, lineTypes);
+    writeElements(to, sectorTypes);
+    writeElements(to, compositeFonts);
+}
+
+duint32 ded_s::serialLayout() // static
+{
+    dsize const sizes[] = {
+        sizeof(ded_uri_t),
+        sizeof(ded_embsound_t),
+        sizeof(ded_ptcstage_t),
+        sizeof(ded_sprid_t),
+        sizeof(ded_light_t),
+        sizeof(ded_sound_t),
+        sizeof(ded_text_t),
+        sizeof(ded_tenviron_t),
+        sizeof(ded_value_t),
+        sizeof(ded_detailtexture_t),
+        sizeof(ded_ptcgen_t),
+        sizeof(ded_reflection_t),
+        sizeof(ded_group_member_t),
+        sizeof(ded_group_t),
+        sizeof(ded_linetype_t),
+        sizeof(ded_sectortype_t),
+        sizeof(ded_compositefont_mappedcharacter_t),
+        sizeof(ded_compositefont_t),
+    };
+
+    // FNV-1a over the sizes.
+    duint32 hash = 2166136261u;
+    for (dsize size : sizes)
+    {
+        hash = (hash ^ duint32(size)) * 16777619u;
+    }
+    return hash ^ DED_SERIAL_VERSION;
+}
+
+void ded_s::operator << (Reader &from)
+{
+    clear();
+
+    duint32 serialVersion;
+    from >> serialVersion;
+    if (serialVersion != DED_SERIAL_VERSION)
+    {
+        throw DeserializationError("ded_s::operator <<", "Unsupported serialization version " +
+                                String::number(serialVersion));
+    }
+    from >> version >> modelFlags >> modelScale >> modelOffset;
+
+    readRegister(from, flags);
+    readRegister(from, episodes);
+    readRegister(from, things);
+    readRegister(from, states);
+    readElements(from, sprites);
+    readElements(from, lights);
+    readRegister(from, materials);
+    readRegister(from, models);
+    readRegister(from, skies);
+    readElements(from, sounds);
+    readRegister(from, musics);
+    readRegister(from, mapInfos);
+    readElements(from, text);
+    readElements(from, textureEnv);
+    readElements(from, values);
+    readElements(from, details);
+    readElements(from, ptcGens);
+    readRegister(from, finales);
+    readRegister(from, decorations);
+    readElements(from, reflections);
+    readElements(from, groups);
+    readElements(from, lineTypes);
+    readElements(from, sectorTypes);
+    readElements(from, compositeFonts);
+}
+
 /*
 int DED_AddMobj(ded_t* ded, char const* idstr)
 {
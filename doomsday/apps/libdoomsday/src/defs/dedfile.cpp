@@ -32,6 +32,7 @@
 using namespace de;
 
 static char dedReadError[512];
+static DEDSourceFunc sourceObserver;
 
 void DED_SetError(String const &message)
 {
@@ -39,6 +40,64 @@ void DED_SetError(String const &message)
     strncpy(dedReadError, msg.toUtf8().constData(), sizeof(dedReadError));
 }
 
+void DED_SetSourceObserver(DEDSourceFunc func)
+{
+    sourceObserver = func;
+}
+
+/**
+ * Reads a file using FS1. Relative paths are relative to the native working directory.
+ *
+ * @param path      Path of the file.
+ * @param contents  Contents of the file are written here.
+ * @param isCustom  If not @c nullptr, the custom status of the file is written here.
+ *
+ * @return @c true, if the file was found.
+ */
+static bool readLegacyFile(String const &path, Block &contents, bool *isCustom = nullptr)
+{
+    try
+    {
+        String fullPath = (NativePath::workPath() / NativePath(path).expand()).withSeparators('/');
+        QScopedPointer<FileHandle> hndl(&App_FileSystem().openFile(fullPath, "rb"));
+
+        hndl->seek(0, SeekEnd);
+        size_t const size = hndl->tell();
+        hndl->rewind();
+
+        File1 &file = hndl->file();
+        if (isCustom)
+        {
+            /// @todo Custom status for contained files is not inherited from the container?
+            *isCustom = (file.isContained()? file.container().hasCustom() : file.hasCustom());
+        }
+
+        contents.resize(size);
+        hndl->read(contents.data(), size);
+        App_FileSystem().releaseFile(file);
+        return true;
+    }
+    catch (FS1::NotFoundError const &)
+    {} // Ignore.
+
+    return false;
+}
+
+bool DED_ReadSource(String const &path, Block &source)
+{
+    // Try FS2 first.
+    try
+    {
+        App::rootFolder().locate<File const>(path) >> source;
+        return true;
+    }
+    catch (...)
+    {
+        // Try FS1 as fallback.
+    }
+    return readLegacyFile(path, source);
+}
+
 void Def_ReadProcessDED(ded_t *defs, String sourcePath)
 {
      LOG_AS("Def_ReadProcessDED");
@@ -50,6 +109,10 @@ void Def_ReadProcessDED(ded_t *defs, String sourcePath)
      {
          Block text;
          App::rootFolder().locate<File const>(sourcePath) >> text;
+         if (sourceObserver)
+         {
+             sourceObserver(sourcePath, text);
+         }
          if (!DED_ReadData(defs, text, sourcePath, true/*consider it custom; there is no way to check...*/))
          {
              App_FatalError("Def_ReadProcessDED: %s\n", dedReadError);
@@ -107,36 +170,21 @@ int DED_ReadLump(ded_t *ded, lumpnum_t lumpNum)
 int DED_Read(ded_t *ded, String path)
 {
     // Attempt to open a definition file on this path.
-    try
+    Block bufferedDef;
+    bool isCustom = false;
+    if (!readLegacyFile(path, bufferedDef, &isCustom))
     {
-        // Relative paths are relative to the native working directory.
-        String fullPath = (NativePath::workPath() / NativePath(path).expand()).withSeparators('/');
-        QScopedPointer<FileHandle> hndl(&App_FileSystem().openFile(fullPath, "rb"));
-
-        // We will buffer a local copy of the file. How large a buffer do we need?
-        hndl->seek(0, SeekEnd);
-        size_t bufferedDefSize = hndl->tell();
-        hndl->rewind();
-        char *bufferedDef = (char *) M_Calloc(bufferedDefSize + 1);
-
-        File1 &file = hndl->file();
-        /// @todo Custom status for contained files is not inherited from the container?
-        bool const isCustom = (file.isContained()? file.container().hasCustom() : file.hasCustom());
-
-        // Copy the file into the local buffer and parse definitions.
-        hndl->read((uint8_t *)bufferedDef, bufferedDefSize);
-        int result = DED_ReadData(ded, bufferedDef, path, isCustom);
-        App_FileSystem().releaseFile(file);
+        DED_SetError("File could not be opened for reading");
+        return false;
+    }
 
-        // Done. Release temporary storage and return the result.
-        M_Free(bufferedDef);
-        return result;
+    if (sourceObserver)
+    {
+        sourceObserver(path, bufferedDef);
     }
-    catch (FS1::NotFoundError const &)
-    {} // Ignore.
 
-    DED_SetError("File could not be opened for reading");
-    return false;
+    // The buffer is null-terminated.
+    return DED_ReadData(ded, bufferedDef.constData(), path, isCustom);
 }
 
 int DED_ReadData(ded_t *ded, char const *buffer, String sourceFile, bool sourceIsCustom)
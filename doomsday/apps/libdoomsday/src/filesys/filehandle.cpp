@@ -32,6 +32,7 @@
 #include <de/memoryblockset.h>
 #include <de/LogBuffer>
 #include <de/NativePath>
+#include <QFile>
 
 namespace de {
 
@@ -58,12 +59,30 @@ DENG2_PIMPL_NOREF(FileHandle)
     uint8_t *data;
     uint8_t *pos;
 
+    /// Memory mapping of the native file (if mapped).
+    QScopedPointer<QFile> mapFile;
+    uint8_t *mapped;
+    size_t mappedSize;
+    bool mapFailed;
+
     Impl() : file(0), list(0), baseOffset(0), hndl(0), size(0), data(0), pos(0)
+           , mapped(0), mappedSize(0), mapFailed(false)
     {
         flags.eof  = false;
         flags.open = false;
         flags.reference = false;
     }
+
+    void unmap()
+    {
+        if (!mapFile.isNull())
+        {
+            if (mapped) mapFile->unmap(mapped);
+            mapFile.reset();
+        }
+        mapped     = 0;
+        mappedSize = 0;
+    }
 };
 
 static void errorIfNotValid(FileHandle const &file, char const * /*callerName*/)
@@ -90,6 +109,7 @@ FileHandle::~FileHandle()
 FileHandle &FileHandle::close()
 {
     if (!d->flags.open) return *this;
+    d->unmap();
     if (d->hndl)
     {
         fclose(d->hndl); d->hndl = 0;
@@ -274,6 +294,52 @@ FileHandle &FileHandle::rewind()
     return *this;
 }
 
+uint8_t const *FileHandle::mappedData(size_t *length)
+{
+    errorIfNotValid(*this, "FileHandle::mappedData");
+    if (length) *length = 0;
+
+    if (d->flags.reference)
+    {
+        return d->file->handle().mappedData(length);
+    }
+
+    if (!d->hndl)
+    {
+        // Buffered data is already in memory.
+        if (length && d->data) *length = d->size;
+        return d->data;
+    }
+
+    if (!d->mapped && !d->mapFailed)
+    {
+        LOG_AS("FileHandle::mappedData");
+
+        // Map the whole native file; the mapping is shared by all lumps in it.
+        d->mapFile.reset(new QFile);
+        if (d->mapFile->open(fileno(d->hndl), QIODevice::ReadOnly, QFileDevice::DontCloseHandle))
+        {
+            qint64 const fileSize = d->mapFile->size();
+            if (fileSize > qint64(d->baseOffset))
+            {
+                d->mapped     = d->mapFile->map(0, fileSize);
+                d->mappedSize = size_t(fileSize);
+            }
+        }
+        if (!d->mapped)
+        {
+            LOGDEV_RES_VERBOSE("Memory mapping is not available, using buffered reads");
+            d->mapFailed = true;
+            d->unmap();
+        }
+    }
+
+    if (!d->mapped) return 0;
+
+    if (length) *length = d->mappedSize - d->baseOffset;
+    return d->mapped + d->baseOffset;
+}
+
 FileHandle *FileHandle::fromFile(File1 &file) // static
 {
     FileHandle *hndl = new FileHandle();
@@ -179,6 +179,21 @@ DENG2_PIMPL_NOREF(Wad)
     QScopedPointer<LumpCache> dataCache;  ///< Data payload cache.
 
     Impl() : entries(PathTree::MultiLeaf) {}
+
+    /**
+     * Returns a pointer to the data of @a lumpFile in the memory-mapped file, or
+     * @c nullptr if the WAD cannot be mapped (or the lump lies outside the file).
+     */
+    static uint8_t const *mappedLump(FileHandle &hndl, LumpFile const &lumpFile)
+    {
+        size_t length;
+        uint8_t const *mapped = hndl.mappedData(&length);
+        if (!mapped) return nullptr;
+
+        FileInfo const &info = lumpFile.info();
+        if (info.baseOffset + info.size > length) return nullptr; // Truncated?
+        return mapped + info.baseOffset;
+    }
 };
 
 Wad::Wad(FileHandle &hndl, String path, FileInfo const &info, File1 *container)
@@ -264,6 +279,12 @@ uint8_t const *Wad::cacheLump(int lumpIndex)
             << (unsigned long) lumpFile.info().size
             << (lumpFile.info().isCompressed()? ", compressed" : ""));
 
+    // Use the lump data in the mapped file directly, if possible.
+    if (uint8_t const *mapped = Impl::mappedLump(*handle_, lumpFile))
+    {
+        return mapped;
+    }
+
     // Time to create the cache?
     if (d->dataCache.isNull())
     {
@@ -335,8 +356,20 @@ size_t Wad::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
         }
     }
 
-    handle_->seek(lumpFile.info().baseOffset + startOffset, SeekSet);
-    size_t readBytes = handle_->read(buffer, length);
+    size_t readBytes;
+    size_t mappedLength;
+    if (uint8_t const *mapped = handle_->mappedData(&mappedLength))
+    {
+        // Copy straight from the mapped file.
+        size_t const from = lumpFile.info().baseOffset + startOffset;
+        readBytes = (from < mappedLength? de::min(length, mappedLength - from) : 0);
+        std::memcpy(buffer, mapped + from, readBytes);
+    }
+    else
+    {
+        handle_->seek(lumpFile.info().baseOffset + startOffset, SeekSet);
+        readBytes = handle_->read(buffer, length);
+    }
 
     /// @todo Do not check the read length here.
     if (readBytes < length)
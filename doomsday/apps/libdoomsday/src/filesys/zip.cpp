@@ -324,6 +324,22 @@ DENG2_PIMPL(Zip)
     Impl(Public *i) : Base(i)
     {}
 
+    /**
+     * Returns a pointer to the (possibly compressed) data of @a lump in the memory-mapped
+     * archive, or @c nullptr if the archive cannot be mapped (or the data lies outside
+     * the file).
+     */
+    uint8_t const *mappedLump(LumpFile const &lump)
+    {
+        size_t length;
+        uint8_t const *mapped = self().handle_->mappedData(&length);
+        if (!mapped) return nullptr;
+
+        FileInfo const &lumpInfo = lump.info();
+        if (lumpInfo.baseOffset + lumpInfo.compressedSize > length) return nullptr; // Truncated?
+        return mapped + lumpInfo.baseOffset;
+    }
+
     /**
      * @param lump      Lump/file to be buffered.
      * @param buffer    Must be large enough to hold the entire uncompressed data lump.
@@ -334,6 +350,24 @@ DENG2_PIMPL(Zip)
         LOG_AS("Zip");
 
         FileInfo const &lumpInfo = lump.info();
+
+        // Access the data directly in the mapped archive, if possible.
+        if (uint8_t const *mapped = mappedLump(lump))
+        {
+            if (lumpInfo.isCompressed())
+            {
+                // Uncompress into the buffer provided by the caller.
+                if (!uncompressRaw(const_cast<uint8_t *>(mapped), lumpInfo.compressedSize,
+                                   buffer, lumpInfo.size))
+                    return 0; // Inflate failed.
+            }
+            else
+            {
+                std::memcpy(buffer, mapped, lumpInfo.size);
+            }
+            return lumpInfo.size;
+        }
+
         self().handle_->seek(lumpInfo.baseOffset, SeekSet);
 
         if (lumpInfo.isCompressed())
@@ -567,6 +601,15 @@ uint8_t const *Zip::cacheLump(int lumpIndex)
                         << (unsigned long) lumpFile.info().size
                         << (lumpFile.info().isCompressed()? ", compressed" : ""));
 
+    // Stored (uncompressed) lumps can be used directly from the mapped archive.
+    if (!lumpFile.info().isCompressed())
+    {
+        if (uint8_t const *mapped = d->mappedLump(lumpFile))
+        {
+            return mapped;
+        }
+    }
+
     // Time to create the cache?
     if (d->dataCache.isNull())
     {
@@ -638,7 +681,14 @@ size_t Zip::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     }
 
     size_t readBytes = 0;
-    if (!startOffset && length == lumpFile.size())
+    uint8_t const *mapped = (lumpFile.isCompressed()? nullptr : d->mappedLump(lumpFile));
+    if (mapped)
+    {
+        // Copy the requested range straight from the mapped archive.
+        readBytes = de::min(size_t(lumpFile.size()) - de::min(size_t(lumpFile.size()), startOffset), length);
+        std::memcpy(buffer, mapped + startOffset, readBytes);
+    }
+    else if (!startOffset && length == lumpFile.size())
     {
         // Read it straight to the caller's data buffer.
         readBytes = d->bufferLump(lumpFile, buffer);
@@ -56,6 +56,14 @@ extern "C" {
  */
 dd_bool P_CheckSight(mobj_t const *beholder, mobj_t const *target);
 
+/**
+ * Forgets the results of the sight checks made so far. P_CheckSight() remembers
+ * its results for repeated checks between mobjs that have not moved, until this
+ * is called at the start of the next tic or by P_ChangeSector() when a door, lift
+ * or other plane moves.
+ */
+void P_ResetSightMemo(void);
+
 /**
  * Determines the world space angle between the points @a from and @a to.
  *
@@ -1114,6 +1114,7 @@ void G_BeginMap()
 
     // Time can now progress in this map.
     mapTime = actualMapTime = 0;
+    P_ResetSightMemo();
 
     // The music may have been paused for the briefing; unpause.
     S_PauseMusic(false);
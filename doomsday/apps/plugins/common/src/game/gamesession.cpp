@@ -23,9 +23,11 @@
 #include <de/App>
 #include <de/CommandLine>
 #include <de/ArrayValue>
+#include <de/Loop>
 #include <de/NumberValue>
 #include <de/RecordValue>
 #include <de/PackageLoader>
+#include <de/TaskScheduler>
 #include <de/Time>
 #include <de/TextValue>
 #include <de/ZipArchive>
@@ -116,9 +118,94 @@ DENG2_PIMPL(GameSession), public GameStateFolder::IMapStateReaderFactory
 
     acs::System acscriptSys;  ///< The One acs::System instance.
 
+    /// Serialized data for files of the package. The files are identified by their
+    /// paths relative to the package, since a file may be replaced before it is written.
+    typedef QList<QPair<String, Block>> FileWrites;
+
+    LoopCallback mainCall;
+    std::function<void ()> afterSaving;  ///< Called when the background write is complete.
+    String savingError;
+    TaskGroup savingTasks;  ///< Writes the .save package to disk in the background.
+
     Impl(Public *i) : Base(i)
     {}
 
+    ~Impl()
+    {
+        // The package must not be left half-written.
+        savingTasks.wait();
+    }
+
+    /**
+     * Writes the changes made to the .save package to disk in a background thread.
+     * The game state has already been serialized, as it must be captured while the
+     * game is not running. Storing the serialized map states in the package files,
+     * compressing the package and writing it out is done in the background, and the
+     * game can continue in the meantime.
+     *
+     * The package must not be accessed before finishSaving() has been called.
+     *
+     * @param saved     Package to write.
+     * @param writes    Serialized data to store in files of the package before writing.
+     *                  If the same file is listed more than once, the last data is kept.
+     * @param finished  Called in the main thread after the package has been written.
+     */
+    void flushInBackground(GameStateFolder &saved, FileWrites const &writes,
+                           std::function<void ()> finished)
+    {
+        finishSaving();
+
+        afterSaving = finished;
+        savingTasks.run([this, &saved, writes] ()
+        {
+            try
+            {
+                for (auto const &write : writes)
+                {
+                    DENG2_GUARD(saved);
+                    saved.locate<File>(write.first) << write.second;
+                }
+                saved.flush();
+            }
+            catch (Error const &er)
+            {
+                savingError = er.asText();
+            }
+            mainCall.enqueue([this] () { finishSaving(); });
+        });
+    }
+
+    /**
+     * Returns the path of a map's state file, relative to the .save package.
+     */
+    static String mapStateFilePath(de::Uri const &mapUri)
+    {
+        return GameStateFolder::stateFilePath(String("maps") / mapUri.path());
+    }
+
+    /**
+     * Waits until the .save package being written in the background is complete.
+     * This must be called before the internal .save package is accessed.
+     */
+    void finishSaving()
+    {
+        savingTasks.wait();
+
+        if (!savingError.isEmpty())
+        {
+            LOG_AS("GameSession");
+            LOG_RES_WARNING("Error writing game session to disk:\n") << savingError;
+            savingError.clear();
+            afterSaving = nullptr;
+        }
+        if (afterSaving)
+        {
+            auto finished = afterSaving;
+            afterSaving = nullptr;
+            finished();
+        }
+    }
+
     inline String userSavePath(String const &fileName)
     {
         DENG_ASSERT(DoomsdayApp::currentGameProfile());
@@ -127,6 +214,8 @@ DENG2_PIMPL(GameSession), public GameStateFolder::IMapStateReaderFactory
 
     void cleanupInternalSave()
     {
+        finishSaving();
+
         // Ensure the internal save folder exists.
         App::fileSystem().makeFolder(internalSavePath.fileNamePath());
 
@@ -230,14 +319,16 @@ DENG2_PIMPL(GameSession), public GameStateFolder::IMapStateReaderFactory
     }
 
     /**
-     * Write the current map state to a file and notify the application about the change
-     * in the game state folder.
+     * Serializes the state of the current map and notifies the application about the
+     * change in the game state folder. This must be done in the main thread, as the map
+     * and its thinkers are read directly.
      *
-     * @param dest            Destination file for the serialized map state.
      * @param saveFolder      Folder containing the save.
      * @param excludePlayers  Should players be excluded from the state?
+     *
+     * @return Serialized map state, to be written to the "maps" folder of @a saveFolder.
      */
-    void serializeCurrentMapState(File &dest, GameStateFolder &saveFolder, bool excludePlayers = false)
+    Block serializeCurrentMapState(GameStateFolder &saveFolder, bool excludePlayers = false)
     {
         Block data;
         SV_OpenFileForWrite(data);
@@ -249,21 +340,26 @@ DENG2_PIMPL(GameSession), public GameStateFolder::IMapStateReaderFactory
         Writer_Delete(writer);
         SV_CloseFile();
 
-        // Write to the file.
-        dest << data;
-
         DoomsdayApp::app().gameSessionWasSaved(self(), saveFolder);
         //self().setThinkerMapping(nullptr);
+        return data;
     }
 
     /**
      * Update/create a new GameStateFolder at the specified @a path from the current
-     * game state.
+     * game state. The package is written to disk in the background.
+     *
+     * @param path      Path of the .save package.
+     * @param metadata  Metadata of the game state.
+     * @param finished  Called in the main thread after the package has been written.
      */
-    GameStateFolder &updateGameStateFolder(String const &path, GameStateMetadata const &metadata)
+    GameStateFolder &updateGameStateFolder(String const &path, GameStateMetadata const &metadata,
+                                           std::function<void ()> finished = nullptr)
     {
         DENG2_ASSERT(self().hasBegun());
 
+        finishSaving();
+
         LOG_AS("GameSession");
         LOG_RES_VERBOSE("Serializing to \"%s\"...") << path;
 
@@ -299,14 +395,18 @@ DENG2_PIMPL(GameSession), public GameStateFolder::IMapStateReaderFactory
 
         //MapStateWriter mapStateWriter;
         //self().setThinkerMapping(&mapStateWriter);
-        serializeCurrentMapState(mapsFolder.replaceFile(self().mapUri().path() + "State"),
-                                 *saved);
-                //<< serializeCurrentMapState(mapStateWriter);
+        FileWrites writes;
+        mapsFolder.replaceFile(self().mapUri().path() + "State");
+        writes << qMakePair(mapStateFilePath(self().mapUri()), serializeCurrentMapState(*saved));
         //DoomsdayApp::app().gameSessionWasSaved(self(), *saved);
         //self().setThinkerMapping(nullptr);
 
-        saved->flush();  // No need to populate; FS2 Files already in sync with source data.
-        saved->cacheMetadata(metadata);  // Avoid immediately reopening the .save package.
+        // No need to populate; FS2 Files already in sync with source data.
+        flushInBackground(*saved, writes, [saved, metadata, finished] ()
+        {
+            saved->cacheMetadata(metadata);  // Avoid immediately reopening the .save package.
+            if (finished) finished();
+        });
 
         return *saved;
     }
@@ -505,6 +605,8 @@ DENG2_PIMPL(GameSession), public GameStateFolder::IMapStateReaderFactory
 
     void loadSaved(String const &savePath)
     {
+        finishSaving();
+
         ::briefDisabled = true;
 
         G_StopDemo();
@@ -1042,6 +1144,10 @@ bool GameSession::progressRestoredOnReload() const
 
 void GameSession::end()
 {
+    // The engine releases the cached archive entries after the game has been shut
+    // down, so the package must not be written to anymore.
+    d->finishSaving();
+
     if (!hasBegun()) return;
 
     // Reset state of relevant subsystems.
@@ -1199,8 +1305,11 @@ void GameSession::leaveMap(de::Uri const &nextMapUri, uint nextMapEntryPoint)
 
     // Are we saving progress?
     GameStateFolder *saved = nullptr;
+    Impl::FileWrites writes;
     if (!d->rules.values.deathmatch) // Never save in deathmatch.
     {
+        d->finishSaving();
+
         saved = &App::rootFolder().locate<GameStateFolder>(internalSavePath);
         auto &mapsFolder = saved->locate<Folder>("maps");
 
@@ -1226,17 +1335,25 @@ void GameSession::leaveMap(de::Uri const &nextMapUri, uint nextMapEntryPoint)
             File &outFile = mapsFolder.replaceFile(mapUri().path() + "State");
             //MapStateWriter mapStateWriter;
             //self().setThinkerMapping(&mapStateWriter);
-            d->serializeCurrentMapState(outFile, *saved, true /*exclude players*/);
+            Block mapState = d->serializeCurrentMapState(*saved, true /*exclude players*/);
             //DoomsdayApp::app().gameSessionWasSaved(*this, *saved);
             //self().setThinkerMapping(nullptr);
 
+            if (nextMapUri.path() == mapUri().path())
+            {
+                // The state is needed right away for revisiting the same map.
+                outFile << mapState;
+            }
+            else
+            {
+                writes << qMakePair(Impl::mapStateFilePath(mapUri()), mapState);
+            }
+
             // We'll flush whole package soon.
         }
 #endif
 
-        // Ensure changes are written to disk right away (otherwise would stay
-        // in memory only).
-        saved->flush();
+        // The changes are written to disk along with the state of the next map.
     }
 
 #if __JHEXEN__
@@ -1310,21 +1427,25 @@ void GameSession::leaveMap(de::Uri const &nextMapUri, uint nextMapEntryPoint)
         auto &mapsFolder = saved->locate<Folder>("maps");
         DENG2_ASSERT(mapsFolder.mode().testFlag(File::Write));
 
-        File &outFile = mapsFolder.replaceFile(mapUri().path() + "State");
+        mapsFolder.replaceFile(mapUri().path() + "State");
         //MapStateWriter mapStateWriter;
         //setThinkerMapping(&mapStateWriter);
-        d->serializeCurrentMapState(outFile, *saved);
+        writes << qMakePair(Impl::mapStateFilePath(mapUri()), d->serializeCurrentMapState(*saved));
         //DoomsdayApp::app().gameSessionWasSaved(*this, *saved);
         //setThinkerMapping(nullptr);
 
-        saved->flush(); // Write all changes to the package.
-        saved->cacheMetadata(metadata); // Avoid immediately reopening the .save package.
+        // Write all changes to the package.
+        d->flushInBackground(*saved, writes, [saved, metadata] ()
+        {
+            saved->cacheMetadata(metadata); // Avoid immediately reopening the .save package.
+        });
     }
 }
 
 String GameSession::userDescription()
 {
     if (!hasBegun()) return "";
+    d->finishSaving();
     return App::rootFolder().locate<GameStateFolder>(internalSavePath)
                                 .metadata().gets("userDescription", "");
 }
@@ -1357,21 +1478,31 @@ void GameSession::save(String const &saveName, String const &userDescription)
         GameStateMetadata metadata = d->metadata();
         metadata.set("userDescription", chooseSaveDescription(savePath, userDescription));
 
-        // Update the existing internal .save package.
-        d->updateGameStateFolder(internalSavePath, metadata);
-
-        // In networked games the server tells the clients to save also.
-        NetSv_SaveGame(metadata.getui("sessionId"));
+        // Update the existing internal .save package. The game continues while the
+        // package is being written to disk.
+        d->updateGameStateFolder(internalSavePath, metadata, [savePath] ()
+        {
+            try
+            {
+                // Copy the internal saved session to the destination slot.
+                AbstractSession::copySaved(savePath, internalSavePath);
 
-        // Copy the internal saved session to the destination slot.
-        AbstractSession::copySaved(savePath, internalSavePath);
+                P_SetMessage(&players[CONSOLEPLAYER], TXT_GAMESAVED);
 
-        P_SetMessage(&players[CONSOLEPLAYER], TXT_GAMESAVED);
+                // Notify the engine that the game was saved.
+                /// @todo After the engine has the primary responsibility of saving the game,
+                /// this notification is unnecessary.
+                Plug_Notify(DD_NOTIFY_GAME_SAVED, nullptr);
+            }
+            catch (Error const &er)
+            {
+                LOG_RES_WARNING("Error saving game session to '%s':\n")
+                        << savePath << er.asText();
+            }
+        });
 
-        // Notify the engine that the game was saved.
-        /// @todo After the engine has the primary responsibility of saving the game,
-        /// this notification is unnecessary.
-        Plug_Notify(DD_NOTIFY_GAME_SAVED, nullptr);
+        // In networked games the server tells the clients to save also.
+        NetSv_SaveGame(metadata.getui("sessionId"));
     }
     catch (Error const &er)
     {
@@ -1391,12 +1522,14 @@ void GameSession::load(String const &saveName)
 
 void GameSession::copySaved(String const &destName, String const &sourceName)
 {
+    d->finishSaving();
     AbstractSession::copySaved(d->userSavePath(destName), d->userSavePath(sourceName));
     LOG_MSG("Copied savegame \"%s\" to \"%s\"") << sourceName << destName;
 }
 
 void GameSession::removeSaved(String const &saveName)
 {
+    d->finishSaving();
     AbstractSession::removeSaved(d->userSavePath(saveName));
 }
 
@@ -24,6 +24,7 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstdint>
 #include <cstring>
 #include "acs/system.h"
 #include "d_net.h"
@@ -116,6 +117,42 @@ static dd_bool checkReject(Sector *sec1, Sector *sec2)
     return true;
 }
 
+/**
+ * Result of a sight check made during the current tic. Monsters looking for
+ * targets repeat the same checks many times over.
+ */
+struct SightMemo
+{
+    int generation;
+    Sector *fromSector;
+    Sector *toSector;
+    coord_t from[3];
+    coord_t to[3];
+    coord_t toHeight;
+    dd_bool result;
+};
+
+#define SIGHT_MEMO_SIZE     2048 // Power of two.
+
+static SightMemo sightMemo[SIGHT_MEMO_SIZE];
+static int sightMemoGeneration = 1;
+
+void P_ResetSightMemo()
+{
+    sightMemoGeneration++;
+}
+
+static SightMemo &sightMemoFor(Sector *fromSector, Sector *toSector, coord_t const from[3],
+    coord_t const to[3])
+{
+    uint hash = uint(uintptr_t(fromSector) >> 4) * 31 + uint(uintptr_t(toSector) >> 4);
+    hash = hash * 31 + uint(int(from[VX])) * 73856093u;
+    hash = hash * 31 + uint(int(from[VY])) * 19349663u;
+    hash = hash * 31 + uint(int(to[VX]))   * 83492791u;
+    hash = hash * 31 + uint(int(to[VY]));
+    return sightMemo[(hash ^ (hash >> 16)) & (SIGHT_MEMO_SIZE - 1)];
+}
+
 dd_bool P_CheckSight(mobj_t const *beholder, mobj_t const *target)
 {
     if(!beholder || !target) return false;
@@ -140,7 +177,27 @@ dd_bool P_CheckSight(mobj_t const *beholder, mobj_t const *target)
         from[VZ] += beholder->height + -(beholder->height / 4);
     }
 
-    return P_CheckLineSight(from, target->origin, 0, target->height, 0);
+    // Has the same check been made during this tic?
+    Sector *fromSector = Mobj_Sector(beholder);
+    Sector *toSector   = Mobj_Sector(target);
+    SightMemo &memo = sightMemoFor(fromSector, toSector, from, target->origin);
+    if(memo.generation == sightMemoGeneration &&
+       memo.fromSector == fromSector && memo.toSector == toSector &&
+       memo.toHeight == target->height &&
+       !std::memcmp(memo.from, from, sizeof(memo.from)) &&
+       !std::memcmp(memo.to, target->origin, sizeof(memo.to)))
+    {
+        return memo.result;
+    }
+
+    memo.generation = sightMemoGeneration;
+    memo.fromSector = fromSector;
+    memo.toSector   = toSector;
+    memo.toHeight   = target->height;
+    std::memcpy(memo.from, from, sizeof(memo.from));
+    std::memcpy(memo.to, target->origin, sizeof(memo.to));
+    memo.result = P_CheckLineSight(from, target->origin, 0, target->height, 0);
+    return memo.result;
 }
 
 angle_t P_AimAtPoint2(coord_t const from[], coord_t const to[], dd_bool shadowed)
@@ -2856,6 +2913,9 @@ dd_bool P_ChangeSector(Sector *sector, int crush)
     parm.crushDamage = crush > 0? 10 : 0;
 #endif
 
+    // The planes of the sector have moved, which may open or block lines of sight.
+    P_ResetSightMemo();
+
     VALIDCOUNT++;
     Sector_TouchingMobjsIterator(sector, PIT_ChangeSector, &parm);
 
@@ -28,6 +28,7 @@
 #include "hu_menu.h"
 #include "hu_msg.h"
 #include "p_actor.h"
+#include "p_map.h"
 #include "p_user.h"
 #include "player.h"
 #include "r_common.h"
@@ -73,6 +74,9 @@ void P_DoTick()
        !Get(DD_PLAYBACK) && mapTime > 1)
         return;
 
+    // Sight check results are only reused during one tic.
+    P_ResetSightMemo();
+
     Thinker_Run();
 
 #if __JDOOM__ || __JDOOM64__ || __JHERETIC__
@@ -19,23 +19,125 @@
 #ifndef IMPORTUDMF_UDMFPARSER_H
 #define IMPORTUDMF_UDMFPARSER_H
 
-#include "udmflex.h"
-#include <de/TokenRange>
+#include <de/Block>
+#include <de/Error>
+#include <de/String>
 #include <QHash>
+#include <QByteArray>
+#include <QVector>
 #include <functional>
 
 /**
  * UMDF parser.
  *
- * Reads input text and makes callbacks for each parsed block. The parsed contents are
- * not kept in memory.
+ * Reads the UTF-8 source text and makes callbacks for each parsed block. The parsed
+ * contents are not kept in memory. The source is read directly as bytes in a single
+ * pass, without converting it to a String or splitting it into tokens first.
+ *
+ * Identifiers (keys and block types) are case insensitive and are interned to
+ * integer ids. The identifiers needed by the importer have predefined ids (see Key);
+ * other identifiers get ids as they are encountered.
  */
 class UDMFParser
 {
 public:
-    typedef QHash<de::String, QVariant> Block;
-    typedef std::function<void (de::String const &, QVariant const &)> AssignmentFunc;
-    typedef std::function<void (de::String const &, Block const &)> BlockFunc;
+    enum Key
+    {
+        // Global assignments.
+        Namespace,
+
+        // Block types.
+        Thing,
+        Vertex,
+        Linedef,
+        Sidedef,
+        Sector,     ///< Also a sidedef property.
+
+        // Block properties.
+        X, Y, Z,
+        Angle,
+        Type,
+        Id,
+        Special,
+        Arg0, Arg1, Arg2, Arg3, Arg4,
+        Ambush,
+        Single,
+        Dm,
+        Coop,
+        Friend,
+        Dormant,
+        Class1, Class2, Class3,
+        Standing,
+        StrifeAlly,
+        Translucent,
+        Invisible,
+        Skill1, Skill2, Skill3, Skill4, Skill5,
+        LightLevel,
+        HeightFloor,
+        HeightCeiling,
+        TextureFloor,
+        TextureCeiling,
+        V1, V2,
+        SideFront,
+        SideBack,
+        Blocking,
+        DontPegTop,
+        DontPegBottom,
+        TwoSided,
+        OffsetX,
+        OffsetY,
+        TextureTop,
+        TextureMiddle,
+        TextureBottom,
+
+        FirstCustomKey
+    };
+
+    /**
+     * Assigned value. Strings point to the source text, so they are valid as long as
+     * the source exists. Strings that contained escape sequences point to their own
+     * unescaped copy instead, which copies of the Value share. A missing value has
+     * the type None, and converts to zero, false, or an empty string.
+     */
+    struct Value
+    {
+        enum Type { None, Boolean, Integer, Double, String };
+
+        Type type = None;
+        de::dint64 integer = 0;     ///< Boolean or Integer.
+        de::ddouble number = 0;     ///< Double.
+        char const *text = nullptr; ///< String (UTF-8, not null-terminated).
+        de::dint textSize = 0;
+        QByteArray unescaped;       ///< Storage of an unescaped String.
+
+        bool toBool() const;
+        de::dint toInt() const;
+        de::ddouble toDouble() const;
+        de::String toString() const;
+    };
+
+    /**
+     * Assignments of a block.
+     */
+    class Block
+    {
+    public:
+        bool contains(de::dint key) const;
+        Value const &operator [] (de::dint key) const;
+        void set(de::dint key, Value const &value);
+        void clear();
+
+    private:
+        struct Assignment
+        {
+            de::dint key;
+            Value value;
+        };
+        QVector<Assignment> _assignments;
+    };
+
+    typedef std::function<void (de::dint key, Value const &)> AssignmentFunc;
+    typedef std::function<void (de::dint type, Block const &)> BlockFunc;
 
     DENG2_ERROR(SyntaxError);
 
@@ -49,26 +151,36 @@ public:
 
     /**
      * Parse UDMF source and make callbacks for global assignments and blocks while
-     * parsing.
+     * parsing. The Block given to the block handler is only valid during the call.
      *
-     * @param input  UDMF source text.
+     * @param input  UDMF source text (UTF-8).
      *
      * @throws SyntaxError  UDMF source text has a syntax error.
      */
-    void parse(de::String const &input);
+    void parse(de::Block const &input);
 
 protected:
-    de::dsize nextFragment();
+    void skipWhite();
+    bool atEnd() const;
+    de::dint parseIdentifier();
     void parseBlock(Block &block);
-    void parseAssignment(Block &block);
+    void parseAssignment(Block &block, de::dint key);
+    Value parseValue();
+    Value parseString();
+    Value parseNumber();
+    void expect(char ch);
+    de::String location() const;
 
 private:
     AssignmentFunc _assignmentHandler;
     BlockFunc _blockHandler;
     Block _globals;
-    UDMFLex _analyzer;
-    de::TokenBuffer _tokens;
-    de::TokenRange _range;
+    Block _block;
+    QHash<QByteArray, de::dint> _keys;
+    QByteArray _unescaped;          ///< Unescaped text of the latest string.
+    char const *_pos = nullptr;
+    char const *_end = nullptr;
+    de::dint _line = 0;
 };
 
 #endif // IMPORTUDMF_UDMFPARSER_H
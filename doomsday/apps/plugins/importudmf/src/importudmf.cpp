@@ -83,9 +83,9 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
                 };
                 ImportState importState;
 
-                parser.setGlobalAssignmentHandler([&importState] (String const &ident, QVariant const &value)
+                parser.setGlobalAssignmentHandler([&importState] (int key, UDMFParser::Value const &value)
                 {
-                    if (ident == UDMFLex::NAMESPACE)
+                    if (key == UDMFParser::Namespace)
                     {
                         LOG_MAP_VERBOSE("UDMF namespace: %s") << value.toString();
                         String const ns = value.toString().toLower();
@@ -100,36 +100,36 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
                     }
                 });
 
-                parser.setBlockHandler([&importState] (String const &type, UDMFParser::Block const &block)
+                parser.setBlockHandler([&importState] (int type, UDMFParser::Block const &block)
                 {
-                    if (type == UDMFLex::THING)
+                    if (type == UDMFParser::Thing)
                     {
                         int const index = importState.thingCount++;
 
                         // Properties common to all games.
-                        gmoSetThingProperty<DDVT_DOUBLE>(index, "X", block["x"].toDouble());
-                        gmoSetThingProperty<DDVT_DOUBLE>(index, "Y", block["y"].toDouble());
-                        gmoSetThingProperty<DDVT_DOUBLE>(index, "Z", block["z"].toDouble());
-                        gmoSetThingProperty<DDVT_ANGLE>(index, "Angle", angle_t(double(block["angle"].toInt()) / 180.0 * ANGLE_180));
-                        gmoSetThingProperty<DDVT_INT>(index, "DoomEdNum", block["type"].toInt());
+                        gmoSetThingProperty<DDVT_DOUBLE>(index, "X", block[UDMFParser::X].toDouble());
+                        gmoSetThingProperty<DDVT_DOUBLE>(index, "Y", block[UDMFParser::Y].toDouble());
+                        gmoSetThingProperty<DDVT_DOUBLE>(index, "Z", block[UDMFParser::Z].toDouble());
+                        gmoSetThingProperty<DDVT_ANGLE>(index, "Angle", angle_t(double(block[UDMFParser::Angle].toInt()) / 180.0 * ANGLE_180));
+                        gmoSetThingProperty<DDVT_INT>(index, "DoomEdNum", block[UDMFParser::Type].toInt());
 
                         // Map spot flags.
                         {
                             gfw_mapspot_flags_t gfwFlags = 0;
 
-                            if (block["ambush"].toBool())      gfwFlags |= GFW_MAPSPOT_DEAF;
-                            if (block["single"].toBool())      gfwFlags |= GFW_MAPSPOT_SINGLE;
-                            if (block["dm"].toBool())          gfwFlags |= GFW_MAPSPOT_DM;
-                            if (block["coop"].toBool())        gfwFlags |= GFW_MAPSPOT_COOP;
-                            if (block["friend"].toBool())      gfwFlags |= GFW_MAPSPOT_MBF_FRIEND;
-                            if (block["dormant"].toBool())     gfwFlags |= GFW_MAPSPOT_DORMANT;
-                            if (block["class1"].toBool())      gfwFlags |= GFW_MAPSPOT_CLASS1;
-                            if (block["class2"].toBool())      gfwFlags |= GFW_MAPSPOT_CLASS2;
-                            if (block["class3"].toBool())      gfwFlags |= GFW_MAPSPOT_CLASS3;
-                            if (block["standing"].toBool())    gfwFlags |= GFW_MAPSPOT_STANDING;
-                            if (block["strifeally"].toBool())  gfwFlags |= GFW_MAPSPOT_STRIFE_ALLY;
-                            if (block["translucent"].toBool()) gfwFlags |= GFW_MAPSPOT_TRANSLUCENT;
-                            if (block["invisible"].toBool())   gfwFlags |= GFW_MAPSPOT_INVISIBLE;
+                            if (block[UDMFParser::Ambush].toBool())      gfwFlags |= GFW_MAPSPOT_DEAF;
+                            if (block[UDMFParser::Single].toBool())      gfwFlags |= GFW_MAPSPOT_SINGLE;
+                            if (block[UDMFParser::Dm].toBool())          gfwFlags |= GFW_MAPSPOT_DM;
+                            if (block[UDMFParser::Coop].toBool())        gfwFlags |= GFW_MAPSPOT_COOP;
+                            if (block[UDMFParser::Friend].toBool())      gfwFlags |= GFW_MAPSPOT_MBF_FRIEND;
+                            if (block[UDMFParser::Dormant].toBool())     gfwFlags |= GFW_MAPSPOT_DORMANT;
+                            if (block[UDMFParser::Class1].toBool())      gfwFlags |= GFW_MAPSPOT_CLASS1;
+                            if (block[UDMFParser::Class2].toBool())      gfwFlags |= GFW_MAPSPOT_CLASS2;
+                            if (block[UDMFParser::Class3].toBool())      gfwFlags |= GFW_MAPSPOT_CLASS3;
+                            if (block[UDMFParser::Standing].toBool())    gfwFlags |= GFW_MAPSPOT_STANDING;
+                            if (block[UDMFParser::StrifeAlly].toBool())  gfwFlags |= GFW_MAPSPOT_STRIFE_ALLY;
+                            if (block[UDMFParser::Translucent].toBool()) gfwFlags |= GFW_MAPSPOT_TRANSLUCENT;
+                            if (block[UDMFParser::Invisible].toBool())   gfwFlags |= GFW_MAPSPOT_INVISIBLE;
 
                             gmoSetThingProperty<DDVT_INT>(index, "Flags",
                                     gfw_MapSpot_TranslateFlagsToInternal(gfwFlags));
@@ -137,13 +137,10 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
 
                         // Skill level bits.
                         {
-                            static String const labels[5] = {
-                                "skill1", "skill2", "skill3", "skill4", "skill5",
-                            };
                             int skillModes = 0;
                             for (int skill = 0; skill < 5; ++skill)
                             {
-                                if (block[labels[skill]].toBool())
+                                if (block[UDMFParser::Skill1 + skill].toBool())
                                     skillModes |= 1 << skill;
                             }
                             gmoSetThingProperty<DDVT_INT>(index, "SkillModes", skillModes);
@@ -151,43 +148,43 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
 
                         if (importState.isHexen || importState.isDoom64)
                         {
-                            gmoSetThingProperty<DDVT_INT>(index, "ID", block["id"].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "ID", block[UDMFParser::Id].toInt());
                         }
                         if (importState.isHexen)
                         {
-                            gmoSetThingProperty<DDVT_INT>(index, "Special", block["special"].toInt());
-                            gmoSetThingProperty<DDVT_INT>(index, "Arg0", block["arg0"].toInt());
-                            gmoSetThingProperty<DDVT_INT>(index, "Arg1", block["arg1"].toInt());
-                            gmoSetThingProperty<DDVT_INT>(index, "Arg2", block["arg2"].toInt());
-                            gmoSetThingProperty<DDVT_INT>(index, "Arg3", block["arg3"].toInt());
-                            gmoSetThingProperty<DDVT_INT>(index, "Arg4", block["arg4"].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "Special", block[UDMFParser::Special].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "Arg0", block[UDMFParser::Arg0].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "Arg1", block[UDMFParser::Arg1].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "Arg2", block[UDMFParser::Arg2].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "Arg3", block[UDMFParser::Arg3].toInt());
+                            gmoSetThingProperty<DDVT_INT>(index, "Arg4", block[UDMFParser::Arg4].toInt());
                         }
                     }
-                    else if (type == UDMFLex::VERTEX)
+                    else if (type == UDMFParser::Vertex)
                     {
                         int const index = importState.vertexCount++;
 
-                        MPE_VertexCreate(block["x"].toDouble(), block["y"].toDouble(), index);
+                        MPE_VertexCreate(block[UDMFParser::X].toDouble(), block[UDMFParser::Y].toDouble(), index);
                     }
-                    else if (type == UDMFLex::LINEDEF)
+                    else if (type == UDMFParser::Linedef)
                     {
                         importState.linedefs.append(block);
                     }
-                    else if (type == UDMFLex::SIDEDEF)
+                    else if (type == UDMFParser::Sidedef)
                     {
                         importState.sidedefs.append(block);
                     }
-                    else if (type == UDMFLex::SECTOR)
+                    else if (type == UDMFParser::Sector)
                     {
                         const int index = importState.sectorCount++;
-                        const int lightlevel = block.contains("lightlevel")? block["lightlevel"].toInt() : 160;
+                        const int lightlevel = block.contains(UDMFParser::LightLevel)? block[UDMFParser::LightLevel].toInt() : 160;
                         const struct de_api_sector_hacks_s hacks{{0, 0}, -1};
 
                         MPE_SectorCreate(float(lightlevel)/255.f, 1.f, 1.f, 1.f, &hacks, index);
 
                         MPE_PlaneCreate(index,
-                                        block["heightfloor"].toDouble(),
-                                        de::Str("Flats:" + block["texturefloor"].toString()),
+                                        block[UDMFParser::HeightFloor].toDouble(),
+                                        de::Str("Flats:" + block[UDMFParser::TextureFloor].toString()),
                                         0.f, 0.f,
                                         1.f, 1.f, 1.f,  // color
                                         1.f,            // opacity
@@ -195,44 +192,44 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
                                         -1);            // index in archive
 
                         MPE_PlaneCreate(index,
-                                        block["heightceiling"].toDouble(),
-                                        de::Str("Flats:" + block["textureceiling"].toString()),
+                                        block[UDMFParser::HeightCeiling].toDouble(),
+                                        de::Str("Flats:" + block[UDMFParser::TextureCeiling].toString()),
                                         0.f, 0.f,
                                         1.f, 1.f, 1.f,  // color
                                         1.f,            // opacity
                                         0, 0, -1.f,     // normal
                                         -1);            // index in archive
 
-                        gmoSetSectorProperty<DDVT_INT>(index, "Type", block["special"].toInt());
-                        gmoSetSectorProperty<DDVT_INT>(index, "Tag",  block["id"].toInt());
+                        gmoSetSectorProperty<DDVT_INT>(index, "Type", block[UDMFParser::Special].toInt());
+                        gmoSetSectorProperty<DDVT_INT>(index, "Tag",  block[UDMFParser::Id].toInt());
                     }
                 });
 
-                parser.parse(String::fromUtf8(bytes));
+                parser.parse(bytes);
 
                 // Now that all the linedefs and sidedefs are read, let's create them.
                 for (int index = 0; index < importState.linedefs.size(); ++index)
                 {
                     UDMFParser::Block const &linedef = importState.linedefs.at(index);
 
-                    int sidefront = linedef["sidefront"].toInt();
-                    int sideback  = linedef.contains("sideback")? linedef["sideback"].toInt() : -1;
+                    int sidefront = linedef[UDMFParser::SideFront].toInt();
+                    int sideback  = linedef.contains(UDMFParser::SideBack)? linedef[UDMFParser::SideBack].toInt() : -1;
 
                     UDMFParser::Block const &front = importState.sidedefs.at(sidefront);
                     UDMFParser::Block const *back  =
                             (sideback >= 0? &importState.sidedefs.at(sideback) : nullptr);
 
-                    int frontSectorIdx = front["sector"].toInt();
-                    int backSectorIdx  = back? (*back)["sector"].toInt() : -1;
+                    int frontSectorIdx = front[UDMFParser::Sector].toInt();
+                    int backSectorIdx  = back? (*back)[UDMFParser::Sector].toInt() : -1;
 
                     // Line flags.
                     int ddLineFlags = 0;
                     short sideFlags = 0;
                     {
-                        bool const blocking      = linedef["blocking"].toBool();
-                        bool const dontpegtop    = linedef["dontpegtop"].toBool();
-                        bool const dontpegbottom = linedef["dontpegbottom"].toBool();
-                        bool const twosided      = linedef["twosided"].toBool();
+                        bool const blocking      = linedef[UDMFParser::Blocking].toBool();
+                        bool const dontpegtop    = linedef[UDMFParser::DontPegTop].toBool();
+                        bool const dontpegbottom = linedef[UDMFParser::DontPegBottom].toBool();
+                        bool const twosided      = linedef[UDMFParser::TwoSided].toBool();
 
                         if (blocking)      ddLineFlags |= DDLF_BLOCKING;
                         if (dontpegtop)    ddLineFlags |= DDLF_DONTPEGTOP;
@@ -244,14 +241,14 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
                         }
                     }
 
-                    MPE_LineCreate(linedef["v1"].toInt(),
-                                   linedef["v2"].toInt(),
+                    MPE_LineCreate(linedef[UDMFParser::V1].toInt(),
+                                   linedef[UDMFParser::V2].toInt(),
                                    frontSectorIdx,
                                    backSectorIdx,
                                    ddLineFlags,
                                    index);
 
-                    auto texName = [] (QVariant tex) -> String {
+                    auto texName = [] (UDMFParser::Value const &tex) -> String {
                         if (tex.toString().isEmpty()) return String();
                         return "Textures:" + tex.toString();
                     };
@@ -259,13 +256,13 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
                     auto addSide = [&texName, sideFlags](
                                        int index, const UDMFParser::Block &side, int sideIndex)
                     {
-                        const int offsetx = side["offsetx"].toInt();
-                        const int offsety = side["offsety"].toInt();
+                        const int offsetx = side[UDMFParser::OffsetX].toInt();
+                        const int offsety = side[UDMFParser::OffsetY].toInt();
                         float     opacity = 1.f;
 
-                        const auto topTex = texName(side["texturetop"]   ).toUtf8();
-                        const auto midTex = texName(side["texturemiddle"]).toUtf8();
-                        const auto botTex = texName(side["texturebottom"]).toUtf8();
+                        const auto topTex = texName(side[UDMFParser::TextureTop]   ).toUtf8();
+                        const auto midTex = texName(side[UDMFParser::TextureMiddle]).toUtf8();
+                        const auto botTex = texName(side[UDMFParser::TextureBottom]).toUtf8();
 
                         struct de_api_side_section_s top = {
                             topTex,
@@ -313,21 +310,21 @@ static int importMapHook(int /*hookType*/, int /*parm*/, void *context)
                         gmoSetLineProperty<DDVT_SHORT>(index, "Flags", flags);
                     }
 
-                    gmoSetLineProperty<DDVT_INT>(index, "Type", linedef["special"].toInt());
+                    gmoSetLineProperty<DDVT_INT>(index, "Type", linedef[UDMFParser::Special].toInt());
 
                     if (!importState.isHexen)
                     {
                         gmoSetLineProperty<DDVT_INT>(index, "Tag",
-                                                     linedef.contains("id")?
-                                                         linedef["id"].toInt() : -1);
+                                                     linedef.contains(UDMFParser::Id)?
+                                                         linedef[UDMFParser::Id].toInt() : -1);
                     }
                     if (importState.isHexen)
                     {
-                        gmoSetLineProperty<DDVT_INT>(index, "Arg0", linedef["arg0"].toInt());
-                        gmoSetLineProperty<DDVT_INT>(index, "Arg1", linedef["arg1"].toInt());
-                        gmoSetLineProperty<DDVT_INT>(index, "Arg2", linedef["arg2"].toInt());
-                        gmoSetLineProperty<DDVT_INT>(index, "Arg3", linedef["arg3"].toInt());
-                        gmoSetLineProperty<DDVT_INT>(index, "Arg4", linedef["arg4"].toInt());
+                        gmoSetLineProperty<DDVT_INT>(index, "Arg0", linedef[UDMFParser::Arg0].toInt());
+                        gmoSetLineProperty<DDVT_INT>(index, "Arg1", linedef[UDMFParser::Arg1].toInt());
+                        gmoSetLineProperty<DDVT_INT>(index, "Arg2", linedef[UDMFParser::Arg2].toInt());
+                        gmoSetLineProperty<DDVT_INT>(index, "Arg3", linedef[UDMFParser::Arg3].toInt());
+                        gmoSetLineProperty<DDVT_INT>(index, "Arg4", linedef[UDMFParser::Arg4].toInt());
                     }
                 }
                 LOG_MAP_WARNING("Loading UDMF maps is an experimental feature");
@@ -20,8 +20,224 @@
 
 using namespace de;
 
+/// Names of the predefined keys, in the order of UDMFParser::Key.
+static char const *const KEY_NAMES[UDMFParser::FirstCustomKey] =
+{
+    "namespace",
+    "thing", "vertex", "linedef", "sidedef", "sector",
+    "x", "y", "z",
+    "angle",
+    "type",
+    "id",
+    "special",
+    "arg0", "arg1", "arg2", "arg3", "arg4",
+    "ambush",
+    "single",
+    "dm",
+    "coop",
+    "friend",
+    "dormant",
+    "class1", "class2", "class3",
+    "standing",
+    "strifeally",
+    "translucent",
+    "invisible",
+    "skill1", "skill2", "skill3", "skill4", "skill5",
+    "lightlevel",
+    "heightfloor",
+    "heightceiling",
+    "texturefloor",
+    "textureceiling",
+    "v1", "v2",
+    "sidefront",
+    "sideback",
+    "blocking",
+    "dontpegtop",
+    "dontpegbottom",
+    "twosided",
+    "offsetx",
+    "offsety",
+    "texturetop",
+    "texturemiddle",
+    "texturebottom",
+};
+
+/// Identifiers longer than this are not expected in UDMF source.
+static dint const MAX_IDENTIFIER = 256;
+
+static inline bool isIdentifierChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Appends the character of an escape sequence to @a output. The escapes are the same
+ * as in Doomsday Script string literals; unknown ones are kept as is.
+ *
+ * @param output  Unescaped text.
+ * @param ch      Character following the backslash. If it starts a hexadecimal
+ *                code, @a ch is moved to the last character of the code.
+ * @param end     End of the string.
+ */
+static void appendEscaped(QByteArray &output, char const *&ch, char const *end)
+{
+    switch (*ch)
+    {
+    case '\\': output.append('\\'); break;
+    case '\'': output.append('\''); break;
+    case '"':  output.append('"');  break;
+    case 'a':  output.append('\a'); break;
+    case 'b':  output.append('\b'); break;
+    case 'f':  output.append('\f'); break;
+    case 'n':  output.append('\n'); break;
+    case 'r':  output.append('\r'); break;
+    case 't':  output.append('\t'); break;
+    case 'v':  output.append('\v'); break;
+
+    case 'x':
+        if (end - ch > 2)
+        {
+            ushort const code = QByteArray(ch + 1, 2).toUShort(nullptr, 16);
+            output.append(QString(QChar(code)).toUtf8());
+            ch += 2;
+            break;
+        }
+        // Fall through.
+
+    default:
+        output.append('\\').append(*ch);
+        break;
+    }
+}
+
+bool UDMFParser::Value::toBool() const
+{
+    switch (type)
+    {
+    case Boolean:
+    case Integer:
+        return integer != 0;
+
+    case Double:
+        return number != 0.0;
+
+    case String:
+        return toString().toLower() != "false" && toString() != "0" && textSize > 0;
+
+    default:
+        return false;
+    }
+}
+
+dint UDMFParser::Value::toInt() const
+{
+    switch (type)
+    {
+    case Boolean:
+    case Integer:
+        return dint(integer);
+
+    case Double:
+        return qRound(number);
+
+    case String:
+        return toString().toInt();
+
+    default:
+        return 0;
+    }
+}
+
+ddouble UDMFParser::Value::toDouble() const
+{
+    switch (type)
+    {
+    case Boolean:
+    case Integer:
+        return ddouble(integer);
+
+    case Double:
+        return number;
+
+    case String:
+        return toString().toDouble();
+
+    default:
+        return 0;
+    }
+}
+
+de::String UDMFParser::Value::toString() const
+{
+    switch (type)
+    {
+    case Boolean:
+        return integer? "true" : "false";
+
+    case Integer:
+        return de::String::number(integer);
+
+    case Double:
+        return de::String::number(number);
+
+    case String:
+        return QString::fromUtf8(text, textSize);
+
+    default:
+        return de::String();
+    }
+}
+
+bool UDMFParser::Block::contains(dint key) const
+{
+    for (Assignment const &asg : _assignments)
+    {
+        if (asg.key == key) return true;
+    }
+    return false;
+}
+
+UDMFParser::Value const &UDMFParser::Block::operator [] (dint key) const
+{
+    static Value const none;
+    for (Assignment const &asg : _assignments)
+    {
+        if (asg.key == key) return asg.value;
+    }
+    return none;
+}
+
+void UDMFParser::Block::set(dint key, Value const &value)
+{
+    for (Assignment &asg : _assignments)
+    {
+        if (asg.key == key)
+        {
+            asg.value = value;
+            return;
+        }
+    }
+    _assignments.append(Assignment{ key, value });
+}
+
+void UDMFParser::Block::clear()
+{
+    // Keeps the allocated memory for the next block.
+    _assignments.resize(0);
+}
+
 UDMFParser::UDMFParser()
-{}
+{
+    for (dint i = 0; i < FirstCustomKey; ++i)
+    {
+        _keys.insert(QByteArray(KEY_NAMES[i]), i);
+    }
+}
 
 void UDMFParser::setGlobalAssignmentHandler(UDMFParser::AssignmentFunc func)
 {
@@ -38,129 +254,333 @@ UDMFParser::Block const &UDMFParser::globals() const
     return _globals;
 }
 
-void UDMFParser::parse(String const &input)
+void UDMFParser::parse(de::Block const &input)
 {
-    // Lexical analyzer for Haw scripts.
-    _analyzer = UDMFLex(input);
+    _pos  = reinterpret_cast<char const *>(input.constData());
+    _end  = _pos + input.size();
+    _line = 1;
 
-    while (nextFragment() > 0)
+    for (skipWhite(); !atEnd(); skipWhite())
     {
-        if (_range.lastToken().equals(UDMFLex::BRACKET_OPEN))
+        // Empty statement?
+        if (*_pos == ';')
         {
-            String const blockType = _range.firstToken().str().toLower();
+            ++_pos;
+            continue;
+        }
 
-            Block block;
-            parseBlock(block);
+        dint const identifier = parseIdentifier();
+        skipWhite();
+        if (!atEnd() && *_pos == '{')
+        {
+            ++_pos;
+            _block.clear();
+            parseBlock(_block);
 
             if (_blockHandler)
             {
-                _blockHandler(blockType, block);
+                _blockHandler(identifier, _block);
             }
         }
         else
         {
-            parseAssignment(_globals);
+            parseAssignment(_globals, identifier);
+
+            if (_assignmentHandler)
+            {
+                _assignmentHandler(identifier, _globals[identifier]);
+            }
         }
     }
 
-    // We're done, free the remaining tokens.
-    _tokens.clear();
+    _pos = _end = nullptr;
 }
 
-dsize UDMFParser::nextFragment()
+void UDMFParser::skipWhite()
 {
-    _analyzer.getExpressionFragment(_tokens);
+    while (_pos < _end)
+    {
+        char const c = *_pos;
+        if (c == '\n')
+        {
+            ++_line;
+            ++_pos;
+        }
+        else if (c == ' ' || c == '\t' || c == '\r')
+        {
+            ++_pos;
+        }
+        else if (c == '/' && _pos + 1 < _end && _pos[1] == '/')
+        {
+            // Comment until the end of the line.
+            while (_pos < _end && *_pos != '\n') ++_pos;
+        }
+        else if (c == '/' && _pos + 1 < _end && _pos[1] == '*')
+        {
+            for (_pos += 2; ; ++_pos)
+            {
+                if (_pos + 1 >= _end)
+                {
+                    throw SyntaxError("UDMFParser::skipWhite", "Unterminated comment at " + location());
+                }
+                if (*_pos == '\n') ++_line;
+                if (_pos[0] == '*' && _pos[1] == '/') break;
+            }
+            _pos += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
 
-    // Begin with the whole thing.
-    _range = TokenRange(_tokens);
+bool UDMFParser::atEnd() const
+{
+    return _pos >= _end;
+}
 
-    return _tokens.size();
+dint UDMFParser::parseIdentifier()
+{
+    char const *start = _pos;
+    if (atEnd() || !(isIdentifierChar(*_pos) && !isDigit(*_pos)))
+    {
+        throw SyntaxError("UDMFParser::parseIdentifier", "Expected an identifier at " + location());
+    }
+    while (_pos < _end && isIdentifierChar(*_pos)) ++_pos;
+
+    dint const len = dint(_pos - start);
+    if (len > MAX_IDENTIFIER)
+    {
+        throw SyntaxError("UDMFParser::parseIdentifier", "Identifier is too long at " + location());
+    }
+
+    // Identifiers are case insensitive. Usually they are already in lower case and
+    // can be looked up without copying.
+    char lower[MAX_IDENTIFIER];
+    bool hasUpper = false;
+    for (dint i = 0; i < len; ++i)
+    {
+        char const c = start[i];
+        hasUpper |= (c >= 'A' && c <= 'Z');
+        lower[i] = (c >= 'A' && c <= 'Z'? c - 'A' + 'a' : c);
+    }
+    QByteArray const name = QByteArray::fromRawData(hasUpper? lower : start, len);
+
+    auto found = _keys.constFind(name);
+    if (found != _keys.constEnd())
+    {
+        return found.value();
+    }
+    // A new identifier; the key needs a copy of the name.
+    dint const key = _keys.size();
+    _keys.insert(QByteArray(name.constData(), name.size()), key);
+    return key;
 }
 
 void UDMFParser::parseBlock(Block &block)
 {
     // Read all the assignments in the block.
-    while (nextFragment() > 0)
+    for (skipWhite(); ; skipWhite())
     {
-        if (_range.firstToken().equals(UDMFLex::BRACKET_CLOSE))
+        if (atEnd())
+        {
+            throw SyntaxError("UDMFParser::parseBlock", "Unterminated block at " + location());
+        }
+        if (*_pos == '}')
+        {
+            ++_pos;
             break;
-
-        parseAssignment(block);
+        }
+        if (*_pos == ';')
+        {
+            ++_pos;
+            continue;
+        }
+        parseAssignment(block, parseIdentifier());
     }
 }
 
-void UDMFParser::parseAssignment(Block &block)
+void UDMFParser::parseAssignment(Block &block, dint key)
 {
-    if (_range.isEmpty())
-        return; // Nothing here?
+    skipWhite();
+    expect('=');
+    skipWhite();
+    Value const value = parseValue();
+    skipWhite();
+    expect(';');
+
+    block.set(key, value);
+}
 
-    if (!_range.lastToken().equals(UDMFLex::SEMICOLON))
+UDMFParser::Value UDMFParser::parseValue()
+{
+    if (atEnd())
     {
-        throw SyntaxError("UDMFParser::parseAssignment",
-                          "Expected expression to end in a semicolon at " +
-                          _range.lastToken().asText());
+        throw SyntaxError("UDMFParser::parseValue", "Expected a value at " + location());
+    }
+    char const c = *_pos;
+    if (c == '"')
+    {
+        return parseString();
+    }
+    if (isDigit(c) || c == '-' || c == '+' || c == '.')
+    {
+        return parseNumber();
     }
-    if (_range.size() == 1)
-        return; // Just a semicolon?
 
-    if (!_range.token(1).equals(UDMFLex::ASSIGN))
+    if (!isIdentifierChar(c))
+    {
+        throw SyntaxError("UDMFParser::parseValue", "Unexpected value at " + location());
+    }
+    char const *start = _pos;
+    while (_pos < _end && isIdentifierChar(*_pos)) ++_pos;
+    dint const len = dint(_pos - start);
+    Value value;
+    if ((len == 4 && !qstrnicmp(start, "true", 4)) ||
+        (len == 5 && !qstrnicmp(start, "false", 5)))
     {
-        throw SyntaxError("UDMFParser::parseAssignment",
-                          "Expected expression to have an assignment operator at " +
-                          _range.token(1).asText());
+        value.type    = Value::Boolean;
+        value.integer = (len == 4);
     }
+    else
+    {
+        // Unquoted identifiers are used as strings.
+        value.type     = Value::String;
+        value.text     = start;
+        value.textSize = len;
+    }
+    return value;
+}
 
-    String const identifier = _range.firstToken().str().toLower();
-    Token const &valueToken = _range.token(2);
+UDMFParser::Value UDMFParser::parseString()
+{
+    DENG2_ASSERT(*_pos == '"');
+
+    // The previous string's storage is still referenced by its Value, if needed.
+    _unescaped.clear();
 
-    // Store the assigned value into a variant.
-    QVariant value;
-    switch (valueToken.type())
+    char const *start = ++_pos;
+    bool escaped = false;
+    for (;; ++_pos)
     {
-    case Token::KEYWORD:
-        if (valueToken.equals(UDMFLex::T_TRUE))
+        if (atEnd())
         {
-            value.setValue(true);
+            throw SyntaxError("UDMFParser::parseString", "Unterminated string at " + location());
         }
-        else if (valueToken.equals(UDMFLex::T_FALSE))
+        if (*_pos == '"') break;
+        if (*_pos == '\n') ++_line;
+        if (*_pos == '\\')
         {
-            value.setValue(false);
+            escaped = true;
+            ++_pos; // The next character is part of the string.
+            if (!atEnd() && *_pos == '\n') ++_line;
         }
-        else
+    }
+
+    Value value;
+    value.type     = Value::String;
+    value.text     = start;
+    value.textSize = dint(_pos - start);
+    ++_pos; // Closing quote.
+
+    if (escaped)
+    {
+        // Only strings with escape sequences need to be copied.
+        char const *end = start + value.textSize;
+        _unescaped.reserve(value.textSize);
+        for (char const *ch = start; ch < end; ++ch)
         {
-            throw SyntaxError("UDMFParser::parseAssignment",
-                              "Unexpected value for assignment at " + valueToken.asText());
+            if (*ch == '\\')
+            {
+                appendEscaped(_unescaped, ++ch, end);
+            }
+            else
+            {
+                _unescaped.append(*ch);
+            }
         }
-        break;
+        value.unescaped = _unescaped;
+        value.text      = value.unescaped.constData();
+        value.textSize  = value.unescaped.size();
+    }
+    return value;
+}
 
-    case Token::LITERAL_NUMBER:
-        if (valueToken.isInteger())
+UDMFParser::Value UDMFParser::parseNumber()
+{
+    char const *start = _pos;
+    bool isFloat = false;
+
+    if (*_pos == '-' || *_pos == '+') ++_pos;
+    if (_pos + 1 < _end && _pos[0] == '0' && (_pos[1] == 'x' || _pos[1] == 'X'))
+    {
+        for (_pos += 2; _pos < _end && isIdentifierChar(*_pos); ++_pos) {}
+    }
+    else
+    {
+        while (_pos < _end && isDigit(*_pos)) ++_pos;
+        if (_pos < _end && *_pos == '.')
         {
-            value.setValue(valueToken.toInteger());
+            isFloat = true;
+            for (++_pos; _pos < _end && isDigit(*_pos); ++_pos) {}
         }
-        else
+        if (_pos < _end && (*_pos == 'e' || *_pos == 'E'))
         {
-            value.setValue(valueToken.toDouble());
+            isFloat = true;
+            ++_pos;
+            if (_pos < _end && (*_pos == '-' || *_pos == '+')) ++_pos;
+            while (_pos < _end && isDigit(*_pos)) ++_pos;
         }
-        break;
-
-    case Token::LITERAL_STRING_QUOTED:
-        value.setValue(QString(valueToken.unescapeStringLiteral()));
-        break;
+    }
 
-    case Token::IDENTIFIER:
-        value.setValue(QString(valueToken.str()));
-        break;
+    dint const len = dint(_pos - start);
+    Value value;
+    bool ok = true;
 
-    default:
-        DENG2_ASSERT(0!="[UMDFParser::parseAssignment] Invalid token type");
-        break;
+    // Plain decimal integers are the most common, so they are converted directly.
+    char const *digits = (*start == '-' || *start == '+'? start + 1 : start);
+    if (!isFloat && digits < _pos && (*digits != '0' || _pos - digits == 1) && _pos - digits <= 18)
+    {
+        dint64 number = 0;
+        for (char const *ch = digits; ch < _pos; ++ch)
+        {
+            number = number * 10 + (*ch - '0');
+        }
+        value.type    = Value::Integer;
+        value.integer = (*start == '-'? -number : number);
     }
+    else if (!isFloat)
+    {
+        // Hexadecimal, octal, or very large.
+        value.type    = Value::Integer;
+        value.integer = QByteArray::fromRawData(start, len).toLongLong(&ok, 0);
+    }
+    else
+    {
+        value.type   = Value::Double;
+        value.number = QByteArray::fromRawData(start, len).toDouble(&ok);
+    }
+    if (!ok)
+    {
+        throw SyntaxError("UDMFParser::parseNumber",
+                          "Invalid number \"" + de::String(QString::fromUtf8(start, len)) +
+                          "\" at " + location());
+    }
+    return value;
+}
 
-    block.insert(identifier, value);
-
-    if (_assignmentHandler && (&block == &_globals))
+void UDMFParser::expect(char ch)
+{
+    if (atEnd() || *_pos != ch)
     {
-        _assignmentHandler(identifier, value);
+        throw SyntaxError("UDMFParser::expect",
+                          de::String("Expected '%1' at %2").arg(QChar(ch)).arg(location()));
     }
+    ++_pos;
+}
+
+de::String UDMFParser::location() const
+{
+    return de::String("line %1").arg(_line);
 }
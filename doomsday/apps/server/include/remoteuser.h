@@ -61,6 +61,28 @@ public:
      */
     bool isJoined() const;
 
+    /**
+     * Determines if messages sent to the user are compressed using the preset
+     * deflate dictionary (see Net_DeflateDictionary()).
+     */
+    bool usesDeflateDictionary() const;
+
+    /**
+     * Sets the preset dictionary for deflating messages sent to the user. The
+     * user must have agreed to use the dictionary.
+     *
+     * @see Socket::setDeflateDictionary()
+     */
+    void setDeflateDictionary(de::Block const &dictionary);
+
+    /**
+     * Sets the preset dictionary available for inflating messages received from
+     * the user.
+     *
+     * @see Socket::setInflateDictionary()
+     */
+    void setInflateDictionary(de::Block const &dictionary);
+
     /**
      * Determines if the remote user is actually connecting from the local host
      * rather than from some remote one.
@@ -76,6 +98,15 @@ public:
     // Implements Transmitter.
     void send(de::IByteArray const &data);
 
+    /**
+     * Sends a message that has been prepared for sending. The same message can be
+     * sent to multiple users while compressing it only once. The message must have
+     * been prepared with the deflate dictionary if the user uses one.
+     *
+     * @param message  Prepared message.
+     */
+    void send(de::Socket::PreparedMessage const &message);
+
 signals:
     void userDestroyed();
 
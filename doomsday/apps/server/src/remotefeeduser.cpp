@@ -22,10 +22,102 @@
 #include <de/FileSystem>
 #include <de/Folder>
 #include <de/Message>
+#include <de/NativePath>
 #include <de/RemoteFeedProtocol>
+#include <de/Time>
+
+#include <QFile>
+#include <memory>
 
 using namespace de;
 
+namespace internal {
+
+/**
+ * Read-only contents of a file being transferred. Native files are memory-mapped;
+ * other files are read into memory once. A source is shared by all concurrent
+ * transfers of the same file, regardless of which user requested it.
+ */
+class TransferSource
+{
+public:
+    TransferSource(File const &file)
+        : _path(file.path())
+        , _modifiedAt(file.status().modifiedAt)
+    {
+        NativePath const nativePath = file.correspondingNativePath();
+        if (!nativePath.isEmpty())
+        {
+            _native.setFileName(nativePath);
+            if (_native.open(QFile::ReadOnly) && _native.size() == qint64(file.status().size))
+            {
+                _size   = dsize(_native.size());
+                _mapped = (_size? _native.map(0, _native.size()) : nullptr);
+            }
+        }
+        if (!_mapped)
+        {
+            _native.close();
+            file >> _data;
+            _size = _data.size();
+        }
+    }
+
+    dsize size() const { return _size; }
+
+    bool isOutdated(File const &file) const
+    {
+        return file.status().modifiedAt != _modifiedAt;
+    }
+
+    /**
+     * Returns a chunk of the contents starting at @a pos.
+     */
+    Block read(dsize pos, dsize count) const
+    {
+        pos   = de::min(pos, _size);
+        count = de::min(count, _size - pos);
+        if (_mapped) return Block(_mapped + pos, count);
+        return _data.mid(pos, count);
+    }
+
+    /**
+     * Returns the shared source for @a file, creating it if no transfers of the
+     * file are currently active.
+     */
+    static std::shared_ptr<TransferSource const> get(File const &file)
+    {
+        static LockableT<QHash<String, std::weak_ptr<TransferSource const>>> active;
+
+        DENG2_GUARD(active);
+        if (auto src = active.value.value(file.path()).lock())
+        {
+            if (!src->isOutdated(file)) return src;
+        }
+        std::shared_ptr<TransferSource const> src(new TransferSource(file));
+        active.value.insert(file.path(), src);
+
+        // Forget expired sources.
+        for (auto i = active.value.begin(); i != active.value.end(); )
+        {
+            if (i.value().expired()) i = active.value.erase(i); else ++i;
+        }
+        return src;
+    }
+
+private:
+    String _path;
+    Time _modifiedAt;
+    QFile _native;
+    uchar const *_mapped = nullptr;
+    Block _data;
+    dsize _size = 0;
+};
+
+} // namespace internal
+
+using namespace internal;
+
 DENG2_PIMPL(RemoteFeedUser)
 {
     using QueryId = RemoteFeedQueryPacket::Id;
@@ -33,11 +125,13 @@ DENG2_PIMPL(RemoteFeedUser)
     struct Transfer
     {
         QueryId queryId;
-        Block data;
+        std::shared_ptr<TransferSource const> source;
         duint64 position = 0;
 
         Transfer(QueryId id = 0) : queryId(id)
         {}
+
+        dsize size() const { return source? source->size() : 0; }
     };
 
     std::unique_ptr<Socket> socket;
@@ -126,12 +220,16 @@ DENG2_PIMPL(RemoteFeedUser)
                 auto &xfer = transfers.value.front();
 
                 response->setId(xfer.queryId);
-                response->setFileSize(xfer.data.size());
+                response->setFileSize(xfer.size());
                 response->setStartOffset(xfer.position);
-                response->setData(xfer.data.mid(xfer.position, blockSize));
+                if (xfer.source)
+                {
+                    // Only the chunk being sent is copied out of the source.
+                    response->setData(xfer.source->read(xfer.position, blockSize));
+                }
 
                 xfer.position += response->data().size();
-                if (xfer.position >= xfer.data.size())
+                if (xfer.position >= xfer.size())
                 {
                     // That was all.
                     transfers.value.pop_front();
@@ -181,15 +279,17 @@ DENG2_PIMPL(RemoteFeedUser)
                 Transfer xfer(query.id());
                 if (auto const *file = FS::tryLocate<File const>(query.path()))
                 {
-                    *file >> xfer.data;
+                    xfer.source   = TransferSource::get(*file);
+                    xfer.position = de::min(query.startOffset(), duint64(xfer.size()));
                 }
                 else
                 {
                     LOG_NET_WARNING("%s not found!") << query.path();
                 }
-                LOG_NET_MSG("New file transfer: %s size:%i")
+                LOG_NET_MSG("New file transfer: %s size:%i offset:%i")
                         << query.path()
-                        << xfer.data.size();
+                        << xfer.size()
+                        << xfer.position;
                 DENG2_GUARD(transfers);
                 transfers.value.push_back(xfer);
                 break; }
@@ -267,6 +267,14 @@ void RemoteUser::send(IByteArray const &data)
     }
 }
 
+void RemoteUser::send(Socket::PreparedMessage const &message)
+{
+    if (d->state != Disconnected && d->socket->isOpen())
+    {
+        d->socket->send(message);
+    }
+}
+
 void RemoteUser::handleIncomingPackets()
 {
     LOG_AS("RemoteUser");
@@ -287,13 +295,9 @@ void RemoteUser::handleIncomingPackets()
             /// be handled immediately.
 
             // Post the data into the queue.
-            netmessage_t *msg = (netmessage_t *) M_Calloc(sizeof(netmessage_t));
-
+            netmessage_t *msg = N_NewMessage(packet->size());
             msg->sender = d->id;
-            msg->data = new byte[packet->size()];
-            memcpy(msg->data, packet->data(), packet->size());
-            msg->size = packet->size();
-            msg->handle = msg->data; // needs delete[]
+            memcpy(msg->data, packet->data(), msg->size);
 
             // The message queue will handle the message from now on.
             N_PostMessage(msg);
@@ -318,3 +322,18 @@ bool RemoteUser::isJoined() const
 {
     return d->state == Joined;
 }
+
+bool RemoteUser::usesDeflateDictionary() const
+{
+    return d->socket && !d->socket->deflateDictionary().isEmpty();
+}
+
+void RemoteUser::setDeflateDictionary(Block const &dictionary)
+{
+    if (d->socket) d->socket->setDeflateDictionary(dictionary);
+}
+
+void RemoteUser::setInflateDictionary(Block const &dictionary)
+{
+    if (d->socket) d->socket->setInflateDictionary(dictionary);
+}
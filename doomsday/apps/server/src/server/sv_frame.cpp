@@ -25,7 +25,10 @@
 #include "server/sv_pool.h"
 #include "world/p_players.h"
 
+#include <de/c_wrapper.h>
 #include <de/LogBuffer>
+#include <de/NativePath>
+#include <QFile>
 #include <cmath>
 
 using namespace de;
@@ -62,6 +65,47 @@ static dint totalFrameCount;
 
 static dint lastTransmitTic;
 
+/// Sent frame packets are written here when the -capturedeltas option is used.
+/// The capture is used for training the network deflate dictionary (see the
+/// netdict tool).
+static QFile *frameCapture;
+static bool frameCaptureChecked;
+
+/**
+ * Appends the frame packet in the network buffer to the capture file, if one has
+ * been specified on the command line. Each packet is preceded by its size as a
+ * 32-bit little-endian integer.
+ */
+static void Sv_CaptureFrame()
+{
+    if (!::frameCaptureChecked)
+    {
+        ::frameCaptureChecked = true;
+        if (CommandLine_CheckWith("-capturedeltas", 1))
+        {
+            NativePath const path = CommandLine_NextAsPath();
+            ::frameCapture = new QFile(path.toString());
+            if (::frameCapture->open(QFile::WriteOnly | QFile::Truncate))
+            {
+                LOG_NET_NOTE("Capturing frame packets to \"%s\"") << path.pretty();
+            }
+            else
+            {
+                LOG_NET_ERROR("Failed to open \"%s\" for capturing frame packets")
+                        << path.pretty();
+                delete ::frameCapture;
+                ::frameCapture = nullptr;
+            }
+        }
+    }
+    if (!::frameCapture) return;
+
+    duint32 const size = duint32(::netBuffer.headerLength + ::netBuffer.length);
+    char const sizeBytes[4] = { char(size), char(size >> 8), char(size >> 16), char(size >> 24) };
+    ::frameCapture->write(sizeBytes, 4);
+    ::frameCapture->write(reinterpret_cast<char const *>(&::netBuffer.msg), size);
+}
+
 /**
  * Send all the relevant information to each client.
  */
@@ -100,6 +144,10 @@ void Sv_TransmitFrame()
     // How many players currently in the game?
     dint const numInGame = Sv_GetNumPlayers();
 
+    // Players who will be sent a frame.
+    dint frameTargets[DDMAXPLAYERS];
+    dint numFrameTargets = 0;
+
     dint pCount = 0;
     for (dint i = 0; i < DDMAXPLAYERS; ++i)
     {
@@ -133,7 +181,7 @@ void Sv_TransmitFrame()
             // decrease back to zero.
             //::clients[i].updateCount--;
 
-            Sv_SendFrame(i);
+            frameTargets[numFrameTargets++] = i;
         }
         else
         {
@@ -141,6 +189,21 @@ void Sv_TransmitFrame()
                              ::lastTransmitTic << i << plr.ready);
         }
     }
+
+    // The priority queues of the clients need to be rebuilt before new frames
+    // can be sent. The pools are rated concurrently.
+    pool_t *pools[DDMAXPLAYERS + 1];
+    for (dint i = 0; i < numFrameTargets; ++i)
+    {
+        pools[i] = Sv_GetPool(frameTargets[i]);
+    }
+    pools[numFrameTargets] = nullptr;
+    Sv_RatePools(pools);
+
+    for (dint i = 0; i < numFrameTargets; ++i)
+    {
+        Sv_SendFrame(frameTargets[i]);
+    }
 }
 
 /**
@@ -160,6 +223,10 @@ void Sv_Shutdown()
     }
 #endif
 
+    delete ::frameCapture;
+    ::frameCapture = nullptr;
+    ::frameCaptureChecked = false;
+
     Sv_ShutdownPools();
 }
 
@@ -776,7 +843,8 @@ byte Sv_GetNewResendID(pool_t *pool)
 
 /**
  * Send a sv_frame packet to the specified player. The amount of data sent
- * depends on the player's bandwidth rating.
+ * depends on the player's bandwidth rating. The player's pool must have been
+ * rated before this is called.
  */
 void Sv_SendFrame(dint plrNum)
 {
@@ -791,10 +859,6 @@ void Sv_SendFrame(dint plrNum)
         return;
     }
 
-    // The priority queue of the client needs to be rebuilt before
-    // a new frame can be sent.
-    Sv_RatePool(pool);
-
     // This will be a new set.
     DENG2_ASSERT(pool);
     pool->setDealer++;
@@ -866,6 +930,8 @@ void Sv_SendFrame(dint plrNum)
 
     Msg_End();
 
+    Sv_CaptureFrame();
+
     Net_SendBuffer(plrNum, 0);
 
     // Once sent, the delta set can be discarded.
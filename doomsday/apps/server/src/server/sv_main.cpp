@@ -525,6 +525,51 @@ void Sv_ExecuteCommand(void)
     M_Free(cmd);
 }
 
+/**
+ * Handles a client's offer to use the preset deflate dictionary. If we have the same
+ * dictionary, the offer is accepted and the following messages to and from the
+ * client may be compressed with the dictionary.
+ */
+static void Sv_HandleDeflateDictionaryOffer(dint plrNum)
+{
+    LOG_AS("Sv_HandleDeflateDictionaryOffer");
+
+    Block hash(16);
+    Reader_Read(::msgReader, hash.data(), hash.size());
+
+    if (plrNum < 1 || plrNum >= DDMAXPLAYERS || !DD_Player(plrNum)->isConnected())
+        return;
+
+    Block const dictionary = Net_DeflateDictionary();
+    if (dictionary.isEmpty() || hash != dictionary.md5Hash())
+    {
+        LOG_NET_VERBOSE("Client %i has a different deflate dictionary") << plrNum;
+        return;
+    }
+
+    try
+    {
+        RemoteUser &user = App_ServerSystem().user(DD_Player(plrNum)->remoteUserId);
+
+        // The client starts using the dictionary after receiving our reply.
+        user.setInflateDictionary(dictionary);
+
+        Msg_Begin(PSV_DEFLATE_DICTIONARY);
+        Writer_Write(::msgWriter, hash.data(), hash.size());
+        Msg_End();
+        Net_SendBuffer(plrNum, 0);
+
+        // Messages sent after the reply are compressed with the dictionary.
+        user.setDeflateDictionary(dictionary);
+
+        LOG_NET_VERBOSE("Using the preset deflate dictionary with client %i") << plrNum;
+    }
+    catch (Error const &er)
+    {
+        LOGDEV_NET_WARNING("Failed to accept the deflate dictionary: %s") << er.asText();
+    }
+}
+
 /**
  * Server's packet handler.
  */
@@ -578,6 +623,10 @@ void Sv_GetPackets(void)
             Net_PingResponse();
             break;
 
+        case PCL_DEFLATE_DICTIONARY:
+            Sv_HandleDeflateDictionaryOffer(netBuffer.player);
+            break;
+
         case PCL_HELLO:
         case PCL_HELLO2:
         case PKT_OK:
@@ -29,6 +29,8 @@
 #include <de/timer.h>
 #include <de/vector1.h>
 #include <de/LogBuffer>
+#include <de/TaskScheduler>
+#include <vector>
 #include "def_main.h"  // Def_SameStateSequence
 
 #include "network/net_main.h"
@@ -42,23 +44,17 @@ using namespace de;
 
 #define DEFAULT_DELTA_BASE_SCORE    ( 10000 )
 
-#define REG_MOBJ_HASH_SIZE          ( 1024 )
-#define REG_MOBJ_HASH_FUNCTION_MASK ( 0x3ff )
+// Mobj IDs are 16-bit (see Thinkers).
+#define REG_MOBJ_ID_COUNT           ( 0x10000 )
+
+// Initial number of mobjs the register has room for.
+#define REG_MOBJ_MIN_CAPACITY       ( 256 )
 
 // Maximum difference in plane height where the absolute height doesn't need to be sent.
 #define PLANE_SKIP_LIMIT            ( 40 )
 
-struct reg_mobj_t
-{
-    reg_mobj_t *next;  ///< In the register hash.
-    reg_mobj_t *prev;  ///< In the register hash.
-    dt_mobj_t mo;      ///< The state of the mobj.
-};
-
-struct mobjhash_t
-{
-    reg_mobj_t *first, *last;
-};
+// Number of world elements compared against the register in one task.
+#define REG_COMPARE_GRAIN_SIZE      ( 256 )
 
 /**
  * One cregister_t holds the state of the entire world.
@@ -68,8 +64,14 @@ struct cregister_t
     dint gametic;       ///< The time the register was last updated.
     dd_bool isInitial;  ///< @c true if *this* register contains a read-only copy of the initial state of the world.
 
-    // The mobjs are stored in a hash for efficiency (ID is the key).
-    mobjhash_t mobjs[REG_MOBJ_HASH_SIZE];
+    // The registered mobjs are stored contiguously, in no particular order.
+    dt_mobj_t *mobjs;
+    dint mobjCount;
+    dint mobjCapacity;
+
+    // Index of each registered mobj in the mobjs array, plus one (ID is the key).
+    // Zero means the mobj is not registered.
+    duint16 *mobjSlots;
 
     dt_player_t ddPlayers[DDMAXPLAYERS];
     dt_sector_t *sectors;
@@ -77,6 +79,35 @@ struct cregister_t
     dt_poly_t *polyObjs;
 };
 
+/**
+ * Storage for a delta of any type.
+ */
+union anydelta_t
+{
+    delta_t delta;
+    mobjdelta_t mobj;
+    playerdelta_t player;
+    sectordelta_t sector;
+    sidedelta_t side;
+    polydelta_t poly;
+    sounddelta_t sound;
+};
+
+/**
+ * Delta produced by comparing the world against the register.
+ */
+struct generateddelta_t
+{
+    anydelta_t delta;
+    dint index;  ///< Index of the compared world element.
+};
+
+/**
+ * Deltas generated during one comparison of the world against the register, in the
+ * order they were generated.
+ */
+typedef std::vector<generateddelta_t> DeltaBatch;
+
 void Sv_RegisterWorld(cregister_t *reg, dd_bool isInitial);
 void Sv_NewDelta(void *deltaPtr, deltatype_t type, duint id);
 dd_bool Sv_IsVoidDelta(void const *delta);
@@ -194,92 +225,74 @@ pool_t *Sv_GetPool(duint consoleNumber)
     return &DD_Player(consoleNumber)->deltaPool();
 }
 
-/**
- * The hash function for the register mobj hash.
- */
-duint Sv_RegisterHashFunction(thid_t id)
-{
-    return (duint) id & REG_MOBJ_HASH_FUNCTION_MASK;
-}
-
 /**
  * Returns a pointer to the register map-object, if it already exists.
  */
-reg_mobj_t *Sv_RegisterFindMobj(cregister_t *reg, thid_t id)
+dt_mobj_t *Sv_RegisterFindMobj(cregister_t *reg, thid_t id)
 {
     DENG2_ASSERT(reg);
 
-    // See if there already is a register-mobj for this id.
-    mobjhash_t const &hash = reg->mobjs[Sv_RegisterHashFunction(id)];
-    for (reg_mobj_t *it = hash.first; it; it = it->next)
+    if (!reg->mobjSlots) return nullptr;
+
+    if (duint16 slot = reg->mobjSlots[id])
     {
-        if (it->mo.thinker.id == id) return it;
+        return &reg->mobjs[slot - 1];
     }
-
     return nullptr;  // Not found.
 }
 
 /**
- * Adds a new reg_mobj_t to the register's mobj hash.
+ * Adds a new map-object to the register. The returned pointer remains valid only
+ * until the next time a map-object is added to or removed from the register.
  */
-reg_mobj_t *Sv_RegisterAddMobj(cregister_t *reg, thid_t id)
+dt_mobj_t *Sv_RegisterAddMobj(cregister_t *reg, thid_t id)
 {
     DENG2_ASSERT(reg);
-    mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(id)];
 
     // Try to find an existing register-mobj.
-    if (reg_mobj_t *newRegMo = Sv_RegisterFindMobj(reg, id))
-        return newRegMo;
+    if (dt_mobj_t *regMo = Sv_RegisterFindMobj(reg, id))
+        return regMo;
 
-    // Allocate the new register-mobj.
-    auto *newRegMo = (reg_mobj_t *) Z_Calloc(sizeof(reg_mobj_t), PU_MAP, 0);
-
-    // Link it to the end of the hash list.
-    if (hash.last)
+    if (!reg->mobjSlots)
     {
-        hash.last->next = newRegMo;
-        newRegMo->prev = hash.last;
+        reg->mobjSlots = (duint16 *) Z_Calloc(sizeof(*reg->mobjSlots) * REG_MOBJ_ID_COUNT, PU_MAP, 0);
     }
-    hash.last = newRegMo;
 
-    if (!hash.first)
+    // Need more room?
+    if (reg->mobjCount == reg->mobjCapacity)
     {
-        hash.first = newRegMo;
+        reg->mobjCapacity = de::max(REG_MOBJ_MIN_CAPACITY, reg->mobjCapacity * 2);
+        reg->mobjs = (dt_mobj_t *) Z_Realloc(reg->mobjs, sizeof(*reg->mobjs) * reg->mobjCapacity, PU_MAP);
     }
 
+    // Append the new register-mobj to the end of the array.
+    dt_mobj_t *newRegMo = &reg->mobjs[reg->mobjCount++];
+    de::zapPtr(newRegMo);
+    newRegMo->thinker.id = id;
+    reg->mobjSlots[id] = duint16(reg->mobjCount);
+
     return newRegMo;
 }
 
 /**
- * Removes a reg_mobj_t from the register's mobj hash.
+ * Removes a map-object from the register. The last map-object in the register is
+ * moved to the place of the removed one.
  */
-void Sv_RegisterRemoveMobj(cregister_t *reg, reg_mobj_t *regMo)
+void Sv_RegisterRemoveMobj(cregister_t *reg, thid_t id)
 {
-    DENG2_ASSERT(regMo);
-    mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(regMo->mo.thinker.id)];
+    DENG2_ASSERT(reg);
 
-    // Update the first and last links.
-    if (hash.last == regMo)
-    {
-        hash.last = regMo->prev;
-    }
-    if (hash.first == regMo)
-    {
-        hash.first = regMo->next;
-    }
+    dt_mobj_t *regMo = Sv_RegisterFindMobj(reg, id);
+    if (!regMo) return;
 
-    // Link out of the list.
-    if (regMo->next)
-    {
-        regMo->next->prev = regMo->prev;
-    }
-    if (regMo->prev)
+    dt_mobj_t const *last = &reg->mobjs[reg->mobjCount - 1];
+    if (regMo != last)
     {
-        regMo->prev->next = regMo->next;
+        memcpy(regMo, last, sizeof(*regMo));
+        reg->mobjSlots[regMo->thinker.id] = reg->mobjSlots[id];
     }
-
-    // Destroy the register-mobj.
-    Z_Free(regMo);
+    reg->mobjSlots[id] = 0;
+    reg->mobjCount--;
 }
 
 /**
@@ -499,11 +512,11 @@ dd_bool Sv_RegisterCompareMobj(cregister_t *reg, mobj_t const *s, mobjdelta_t *d
 {
     dint df;
     dt_mobj_t const *r = ::dummyZeroMobj;
-    reg_mobj_t *regMo  = Sv_RegisterFindMobj(reg, s->thinker.id);
+    dt_mobj_t const *regMo = Sv_RegisterFindMobj(reg, s->thinker.id);
     if (regMo)
     {
         // Use the registered data.
-        r  = &regMo->mo;
+        r  = regMo;
         df = 0;
     }
     else
@@ -1106,13 +1119,12 @@ dd_bool Sv_IsSameDelta(void const *delta1, void const *delta2)
 }
 
 /**
- * Makes a copy of the delta.
+ * @return  Size of the delta in bytes, including the type-specific data.
  */
-void* Sv_CopyDelta(void* deltaPtr)
+size_t Sv_DeltaSize(void const *deltaPtr)
 {
-    void*               newDelta;
-    delta_t*            delta = (delta_t *) deltaPtr;
-    size_t              size =
+    delta_t const *delta = (delta_t const *) deltaPtr;
+    size_t size =
         ( delta->type == DT_MOBJ ?         sizeof(mobjdelta_t)
         : delta->type == DT_PLAYER ?       sizeof(playerdelta_t)
         : delta->type == DT_SECTOR ?       sizeof(sectordelta_t)
@@ -1128,10 +1140,18 @@ void* Sv_CopyDelta(void* deltaPtr)
 
     if (size == 0)
     {
-        App_Error("Sv_CopyDelta: Unknown delta type %i.\n", delta->type);
+        App_Error("Sv_DeltaSize: Unknown delta type %i.\n", delta->type);
     }
+    return size;
+}
 
-    newDelta = Z_Malloc(size, PU_MAP, 0);
+/**
+ * Makes a copy of the delta.
+ */
+void* Sv_CopyDelta(void const *deltaPtr)
+{
+    size_t size = Sv_DeltaSize(deltaPtr);
+    void *newDelta = Z_Malloc(size, PU_MAP, 0);
     memcpy(newDelta, deltaPtr, size);
     return newDelta;
 }
@@ -1826,14 +1846,16 @@ int Sv_ExcludeDelta(pool_t* pool, const void* deltaPtr)
  * Deltas are unique only in the NEW state. There may be multiple UNACKED
  * deltas for the same entity.
  *
- * The contents of the delta must not be modified.
+ * The contents of the delta are not modified, so the same delta can be added to
+ * several pools concurrently.
  */
-void Sv_AddDelta(pool_t* pool, void* deltaPtr)
+void Sv_AddDelta(pool_t* pool, void const *deltaPtr)
 {
     delta_t*            iter, *next = NULL, *existingNew = NULL;
-    delta_t*            delta = (delta_t *) deltaPtr;
+    delta_t const*      delta = (delta_t const *) deltaPtr;
     deltalink_t*        hash = Sv_PoolHash(pool, delta->id);
-    int                 flags, originalFlags;
+    int                 flags;
+    anydelta_t          excluded;
 
     // Sometimes we can exclude a part of the data, if the client has no
     // use for it.
@@ -1845,9 +1867,14 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
         return;
     }
 
-    // Temporarily use the excluded flags.
-    originalFlags = delta->flags;
-    delta->flags = flags;
+    if (flags != delta->flags)
+    {
+        // Use a copy with the excluded flags. The original delta may yet be added
+        // to other pools, which should use the original flags.
+        memcpy(&excluded, delta, Sv_DeltaSize(delta));
+        excluded.delta.flags = flags;
+        delta = &excluded.delta;
+    }
 
     // While subtracting from old deltas, we'll look for a pointer to
     // an existing NEW delta.
@@ -1910,17 +1937,12 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
             hash->first = iter;
         }
     }
-
-    // This delta may yet be added to other pools. They should use the
-    // original flags, not the ones we might've used (hackish: copying the
-    // whole delta is not really an option, though).
-    delta->flags = originalFlags;
 }
 
 /**
  * Add the delta to all the pools in the NULL-terminated array.
  */
-void Sv_AddDeltaToPools(void* deltaPtr, pool_t** targets)
+void Sv_AddDeltaToPools(void const *deltaPtr, pool_t** targets)
 {
     for (; *targets; targets++)
     {
@@ -1961,11 +1983,9 @@ void Sv_PoolMobjRemoved(pool_t* pool, thid_t id)
 void Sv_MobjRemoved(thid_t id)
 {
     uint                i;
-    reg_mobj_t*         mo = Sv_RegisterFindMobj(&worldRegister, id);
-
-    if (mo)
+    if (Sv_RegisterFindMobj(&worldRegister, id))
     {
-        Sv_RegisterRemoveMobj(&worldRegister, mo);
+        Sv_RegisterRemoveMobj(&worldRegister, id);
 
         // We must remove all NEW deltas for this mobj from the pools.
         // One possibility: there are mobj deltas waiting in the pool,
@@ -2050,83 +2070,153 @@ int Sv_GetTargetPools(pool_t** targets, int clientsMask)
 }
 
 /**
- * Null deltas are generated for mobjs that have been destroyed.
- * The register's mobj hash is scanned to see which mobjs no longer exist.
- *
- * When updating, the destroyed mobjs are removed from the register.
+ * Adds the deltas to all the target pools. The pools are independent of each other,
+ * so each pool is updated in a separate task. The deltas are added to each pool in
+ * the order they were generated.
  */
-void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_AddBatchToPools(DeltaBatch const &batch, pool_t **targets)
 {
-    int i;
-    mobjhash_t *hash;
-    reg_mobj_t *obj, *next = 0;
-    mobjdelta_t null;
+    if (batch.empty()) return;
 
-    for (i = 0, hash = reg->mobjs; i < REG_MOBJ_HASH_SIZE; ++i, hash++)
+    dsize numTargets = 0;
+    while (targets[numTargets]) { numTargets++; }
+
+    parallelFor(numTargets, [&batch, targets] (dsize start, dsize end)
     {
-        for (obj = hash->first; obj; obj = next)
+        for (dsize i = start; i < end; ++i)
         {
-            // This reg_mobj_t might be removed.
-            next = obj->next;
-
-            /// @todo Do not assume mobj is from the CURRENT map.
-            if (!worldSys().map().thinkers().isUsedMobjId(obj->mo.thinker.id))
+            for (generateddelta_t const &gen : batch)
             {
-                // This object no longer exists!
-                Sv_NewDelta(&null, DT_MOBJ, obj->mo.thinker.id);
-                null.delta.flags = MDFC_NULL;
+                Sv_AddDelta(targets[i], &gen.delta);
+            }
+        }
+    }, 1);
+}
 
-                // We need all the data for positioning.
-                memcpy(&null.mo, &obj->mo, sizeof(dt_mobj_t));
+/**
+ * Compares world elements against the register. The range of elements is split
+ * into chunks that are compared concurrently. The produced deltas are appended to
+ * @a batch in the order of the elements, regardless of how the range was split.
+ *
+ * @param count    Number of elements.
+ * @param batch    Deltas are appended here.
+ * @param compare  Called with the index of an element and the delta to initialize.
+ *                 Returns @c true if the result is not void. Must not modify anything
+ *                 other than the register data of the element itself.
+ */
+template <typename CompareFunc>
+void Sv_CompareInParallel(dint count, DeltaBatch &batch, CompareFunc compare)
+{
+    if (count <= 0) return;
 
-                Sv_AddDeltaToPools(&null, targets);
+    dsize const grainSize = REG_COMPARE_GRAIN_SIZE;
+    std::vector<DeltaBatch> chunks((dsize(count) + grainSize - 1) / grainSize);
 
-                if (doUpdate)
-                {
-                    // Keep the register up to date.
-                    Sv_RegisterRemoveMobj(reg, obj);
-                }
+    parallelFor(dsize(count), [&chunks, &compare, grainSize] (dsize start, dsize end)
+    {
+        DeltaBatch &chunk = chunks[start / grainSize];
+        generateddelta_t gen;
+        for (dsize i = start; i < end; ++i)
+        {
+            if (compare(dint(i), &gen.delta))
+            {
+                gen.index = dint(i);
+                chunk.push_back(gen);
             }
         }
+    }, grainSize);
+
+    for (DeltaBatch const &chunk : chunks)
+    {
+        batch.insert(batch.end(), chunk.begin(), chunk.end());
+    }
+}
+
+/**
+ * Null deltas are generated for mobjs that have been destroyed.
+ * The registered mobjs are scanned to see which ones no longer exist.
+ *
+ * When updating, the destroyed mobjs are removed from the register.
+ */
+void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, DeltaBatch &batch)
+{
+    dsize const first = batch.size();
+
+    /// @todo Do not assume mobj is from the CURRENT map.
+    auto &thinkers = worldSys().map().thinkers();
+
+    Sv_CompareInParallel(reg->mobjCount, batch, [reg, &thinkers] (dint i, anydelta_t *delta)
+    {
+        dt_mobj_t const &regMo = reg->mobjs[i];
+        if (thinkers.isUsedMobjId(regMo.thinker.id)) return false;
+
+        // This object no longer exists!
+        mobjdelta_t &null = delta->mobj;
+        Sv_NewDelta(&null, DT_MOBJ, regMo.thinker.id);
+        null.delta.flags = MDFC_NULL;
+
+        // We need all the data for positioning.
+        memcpy(&null.mo, &regMo, sizeof(dt_mobj_t));
+        return true;
+    });
+
+    if (doUpdate)
+    {
+        // Keep the register up to date.
+        for (dsize i = first; i < batch.size(); ++i)
+        {
+            Sv_RegisterRemoveMobj(reg, batch[i].delta.delta.id);
+        }
     }
 }
 
 /**
  * Mobj deltas are generated for all mobjs that have changed.
  */
-void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, DeltaBatch &batch)
 {
+    // Collect the mobjs to compare.
+    std::vector<mobj_t const *> mobjs;
     worldSys().map().thinkers().forAll(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
-                                       0x1 /*public*/, [&reg, &doUpdate, &targets] (thinker_t *th)
+                                       0x1 /*public*/, [&mobjs] (thinker_t *th)
     {
-        auto &mob = *reinterpret_cast<mobj_t *>(th);
+        auto const &mob = *reinterpret_cast<mobj_t *>(th);
 
         // Some objects should not be processed.
         if (!Sv_IsMobjIgnored(mob))
         {
-            // Compare to produce a delta.
-            mobjdelta_t delta;
-            if (Sv_RegisterCompareMobj(reg, &mob, &delta))
-            {
-                Sv_AddDeltaToPools(&delta, targets);
-
-                if (doUpdate)
-                {
-                    // This'll add a new register-mobj if it doesn't already exist.
-                    Sv_RegisterMobj(&Sv_RegisterAddMobj(reg, mob.thinker.id)->mo, &mob);
-                }
-            }
+            mobjs.push_back(&mob);
         }
         return LoopContinue;
     });
+
+    dsize const first = batch.size();
+
+    // Compare to produce deltas. The register is not modified during comparison.
+    Sv_CompareInParallel(dint(mobjs.size()), batch, [reg, &mobjs] (dint i, anydelta_t *delta)
+    {
+        return Sv_RegisterCompareMobj(reg, mobjs[i], &delta->mobj);
+    });
+
+    if (doUpdate)
+    {
+        for (dsize i = first; i < batch.size(); ++i)
+        {
+            mobj_t const *mob = mobjs[batch[i].index];
+
+            // This'll add a new register-mobj if it doesn't already exist.
+            Sv_RegisterMobj(Sv_RegisterAddMobj(reg, mob->thinker.id), mob);
+        }
+    }
 }
 
 /**
  * Player deltas are generated for changed player data.
  */
-void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
+void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, DeltaBatch &batch)
 {
-    playerdelta_t player;
+    generateddelta_t gen;
+    playerdelta_t &player = gen.delta.player;
     uint i;
 
     for (i = 0; i < DDMAXPLAYERS; ++i)
@@ -2142,15 +2232,16 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
             // flags).
             if (doUpdate && (player.delta.flags & PDF_MOBJ))
             {
-                reg_mobj_t* registered = Sv_RegisterFindMobj(reg, reg->ddPlayers[i].mobj);
+                dt_mobj_t* registered = Sv_RegisterFindMobj(reg, reg->ddPlayers[i].mobj);
 
                 if (registered)
                 {
-                    Sv_RegisterResetMobj(&registered->mo);
+                    Sv_RegisterResetMobj(registered);
                 }
             }
 
-            Sv_AddDeltaToPools(&player, targets);
+            gen.index = dint(i);
+            batch.push_back(gen);
         }
 
         if (doUpdate)
@@ -2159,9 +2250,9 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
         }
 
         // What about forced deltas?
+#if 0
         if (Sv_IsPoolTargeted(Sv_GetPool(i), targets))
         {
-#if 0
             if (DD_Player(i).flags & DDPF_FIXANGLES)
             {
                 Sv_NewDelta(&player, DT_PLAYER, i);
@@ -2197,25 +2288,21 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
                 // Doing this once is enough.
                 DD_Player(i).flags &= ~(DDPF_FIXORIGIN | DDPF_FIXMOM);
             }
-#endif
         }
+#endif
     }
 }
 
 /**
  * Sector deltas are generated for changed sectors.
  */
-void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, DeltaBatch &batch)
 {
-    sectordelta_t delta;
-
-    for (int i = 0; i < worldSys().map().sectorCount(); ++i)
+    Sv_CompareInParallel(worldSys().map().sectorCount(), batch,
+                         [reg, doUpdate] (dint i, anydelta_t *delta)
     {
-        if (Sv_RegisterCompareSector(reg, i, &delta, doUpdate))
-        {
-            Sv_AddDeltaToPools(&delta, targets);
-        }
-    }
+        return Sv_RegisterCompareSector(reg, i, &delta->sector, doUpdate);
+    });
 }
 
 /**
@@ -2223,7 +2310,7 @@ void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
  * Changes in sides (textures) are so rare that all sides need not be
  * checked on every tic.
  */
-void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, DeltaBatch &batch)
 {
     static uint numShifts = 2, shift = 0;
 
@@ -2248,40 +2335,35 @@ void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
         shift %= numShifts;
     }
 
-    sidedelta_t delta;
-    for (uint i = start; i < end; ++i)
+    Sv_CompareInParallel(dint(end - start), batch,
+                         [reg, doUpdate, start] (dint i, anydelta_t *delta)
     {
-        if (Sv_RegisterCompareSide(reg, i, &delta, doUpdate))
-        {
-            Sv_AddDeltaToPools(&delta, targets);
-        }
-    }
+        return Sv_RegisterCompareSide(reg, start + i, &delta->side, doUpdate);
+    });
 }
 
 /**
  * Poly deltas are generated for changed polyobjs.
  */
-void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, DeltaBatch &batch)
 {
     LOG_AS("Sv_NewPolyDeltas");
 
-    polydelta_t delta;
-
     /// @todo fixme: Do not assume the current map.
-    for (int i = 0; i < worldSys().map().polyobjCount(); ++i)
+    Sv_CompareInParallel(worldSys().map().polyobjCount(), batch,
+                         [reg, doUpdate] (dint i, anydelta_t *delta)
     {
-        if (Sv_RegisterComparePoly(reg, i, &delta))
+        bool const changed = Sv_RegisterComparePoly(reg, i, &delta->poly);
+        if (changed)
         {
             LOGDEV_NET_XVERBOSE_DEBUGONLY("Change in poly %i", i);
-
-            Sv_AddDeltaToPools(&delta, targets);
         }
-
         if (doUpdate)
         {
             Sv_RegisterPoly(&reg->polyObjs[i], i);
         }
-    }
+        return changed;
+    });
 }
 
 void Sv_NewSoundDelta(int soundId, mobj_t const *emitter, Sector *sourceSector,
@@ -2417,23 +2499,29 @@ void Sv_GenerateNewDeltas(cregister_t* reg, int clientNumber, dd_bool doUpdate)
         Sv_UpdateOwnerInfo(*pool);
     }
 
+    // The world is compared against the register first, and the resulting deltas
+    // are then added to the pools.
+    DeltaBatch batch;
+
     // Generate null deltas (removed mobjs).
-    Sv_NewNullDeltas(reg, doUpdate, targets);
+    Sv_NewNullDeltas(reg, doUpdate, batch);
 
     // Generate mobj deltas.
-    Sv_NewMobjDeltas(reg, doUpdate, targets);
+    Sv_NewMobjDeltas(reg, doUpdate, batch);
 
     // Generate player deltas.
-    Sv_NewPlayerDeltas(reg, doUpdate, targets);
+    Sv_NewPlayerDeltas(reg, doUpdate, batch);
 
     // Generate sector deltas.
-    Sv_NewSectorDeltas(reg, doUpdate, targets);
+    Sv_NewSectorDeltas(reg, doUpdate, batch);
 
     // Generate side deltas.
-    Sv_NewSideDeltas(reg, doUpdate, targets);
+    Sv_NewSideDeltas(reg, doUpdate, batch);
 
     // Generate poly deltas.
-    Sv_NewPolyDeltas(reg, doUpdate, targets);
+    Sv_NewPolyDeltas(reg, doUpdate, batch);
+
+    Sv_AddBatchToPools(batch, targets);
 
     if (doUpdate)
     {
@@ -2780,6 +2868,21 @@ void Sv_RatePool(pool_t* pool)
     }
 }
 
+void Sv_RatePools(pool_t **pools)
+{
+    dsize count = 0;
+    while (pools[count]) { count++; }
+
+    // The pools are independent of each other.
+    parallelFor(count, [pools] (dsize start, dsize end)
+    {
+        for (dsize i = start; i < end; ++i)
+        {
+            Sv_RatePool(pools[i]);
+        }
+    }, 1);
+}
+
 /**
  * Do special things that need to be done when the delta has been acked.
  */
@@ -95,6 +95,9 @@ public:
 /**
  * Executes an asynchronous callback in a background thread.
  *
+ * Each callback runs in a dedicated thread, not in the TaskScheduler's workers, so it
+ * may block (e.g., waiting for network or file system operations).
+ *
  * After the background thread finishes, the result from the callback is passed to
  * another callback that is called in the main thread.
  *
@@ -19,8 +19,6 @@
 #ifndef LIBDENG2_TASK_H
 #define LIBDENG2_TASK_H
 
-#include <QRunnable>
-
 #include "../libcore.h"
 #include "../TaskPool"
 
@@ -30,14 +28,21 @@ namespace de {
  * Concurrent task that will be executed asynchronously by a TaskPool. Override
  * runTask() in a derived class.
  *
+ * Tasks are run by the TaskScheduler, which deletes each task after it has
+ * finished running.
+ *
  * @ingroup concurrency
  */
-class DENG2_PUBLIC Task : public QRunnable
+class DENG2_PUBLIC Task
 {
 public:
     Task();
     virtual ~Task() {}
 
+    /**
+     * Runs the task and notifies the pool that the task has finished. Called by
+     * TaskScheduler in a worker thread.
+     */
     void run();
 
     /**
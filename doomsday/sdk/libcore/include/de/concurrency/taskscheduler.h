@@ -0,0 +1,171 @@
+/** @file taskscheduler.h  Work-stealing scheduler for concurrent tasks.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_TASKSCHEDULER_H
+#define LIBDENG2_TASKSCHEDULER_H
+
+#include "../libcore.h"
+#include <functional>
+
+namespace de {
+
+class Task;
+
+/**
+ * Work-stealing scheduler that runs Tasks in a fixed set of background worker
+ * threads. @ingroup concurrency
+ *
+ * Each worker thread has its own deque of tasks. Tasks started by a worker are
+ * pushed to the worker's own deque and the worker runs them newest first. When a
+ * worker runs out of tasks, it steals the oldest tasks from the other workers.
+ * Tasks started from other threads (e.g., the main thread) are placed in a shared
+ * queue that is ordered by priority.
+ *
+ * This way a large number of small tasks, including tasks that start more tasks,
+ * can be run without all the threads contending over a single lock.
+ *
+ * The application has one shared scheduler (TaskScheduler::get()). TaskPool,
+ * TaskGroup and parallelFor() run their work using it. async() is not run by the
+ * scheduler: its callbacks may block for long periods, so each one gets a
+ * dedicated thread.
+ */
+class DENG2_PUBLIC TaskScheduler
+{
+public:
+    enum Priority
+    {
+        LowPriority    = 0,
+        MediumPriority = 1,
+        HighPriority   = 2
+    };
+
+public:
+    /**
+     * Starts the worker threads.
+     *
+     * @param workerCount  Number of worker threads. If zero, one worker is started
+     *                     for each logical CPU core.
+     */
+    TaskScheduler(int workerCount = 0);
+
+    /**
+     * Runs all the remaining queued tasks and stops the worker threads.
+     */
+    ~TaskScheduler();
+
+    int workerCount() const;
+
+    /**
+     * Queues a task for running. Ownership of the task is given to the scheduler;
+     * the task is deleted after it has finished running.
+     *
+     * @param task      Task to run.
+     * @param priority  Priority of the task. Only affects the order in which tasks
+     *                  started outside the worker threads are run.
+     */
+    void start(Task *task, Priority priority = LowPriority);
+
+    /**
+     * Runs one queued task in the calling thread, if there is one available that
+     * is accepted by @a accept. A worker thread that waits for a set of tasks to
+     * finish should use this to help run those specific tasks. Running unrelated
+     * tasks while waiting could re-enter code that is not prepared for it.
+     *
+     * @param accept  Determines which tasks may be run.
+     *
+     * @return @c true, if a task was run.
+     */
+    bool runPendingTask(std::function<bool (Task const &)> const &accept);
+
+    /**
+     * Determines if the calling thread is one of the scheduler's workers.
+     */
+    bool isWorkerThread() const;
+
+    /**
+     * Returns the application's shared scheduler.
+     */
+    static TaskScheduler &get();
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+/**
+ * Group of concurrent tasks that can be waited on together. @ingroup concurrency
+ *
+ * Unlike TaskPool, TaskGroup is a lightweight object meant to be used locally,
+ * for instance to split a single operation into a few concurrent parts. If the
+ * group is waited on in a worker thread, the waiting thread runs the queued tasks
+ * of the same group in the meantime.
+ */
+class DENG2_PUBLIC TaskGroup
+{
+public:
+    typedef std::function<void ()> Work;
+
+public:
+    TaskGroup(TaskScheduler &scheduler = TaskScheduler::get());
+
+    /**
+     * Waits until all the tasks of the group have finished.
+     */
+    ~TaskGroup();
+
+    /**
+     * Starts a new task in the group.
+     *
+     * @param work      Function to call in a worker thread.
+     * @param priority  Priority of the task.
+     */
+    void run(Work work, TaskScheduler::Priority priority = TaskScheduler::MediumPriority);
+
+    /**
+     * Blocks until all the started tasks have finished.
+     */
+    void wait();
+
+    bool isDone() const;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+/**
+ * Calls a function for all the indices in the range [0, @a count), splitting the
+ * range into chunks that are processed concurrently by the worker threads.
+ * The calling thread processes chunks as well and the function returns when all
+ * of the range has been processed.
+ *
+ * If @a func throws an exception, the remaining chunks are still processed and the
+ * first exception is rethrown in the calling thread.
+ *
+ * @param count      Number of indices.
+ * @param func       Called with the (start, end) of each chunk. The end is exclusive.
+ * @param grainSize  Maximum number of indices per chunk. If zero, an appropriate
+ *                   size is chosen based on the number of worker threads.
+ *
+ * @ingroup concurrency
+ */
+DENG2_PUBLIC void parallelFor(dsize count,
+                              std::function<void (dsize start, dsize end)> const &func,
+                              dsize grainSize = 0);
+
+} // namespace de
+
+#endif // LIBDENG2_TASKSCHEDULER_H
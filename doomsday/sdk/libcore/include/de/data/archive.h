@@ -28,6 +28,7 @@
 #include "../File"
 #include "../PathTree"
 
+#include <QList>
 #include <set>
 
 namespace de {
@@ -215,6 +216,24 @@ public:
      */
     void uncacheBlock(Path const &path) const;
 
+    /**
+     * Deserializes the contents of several entries in advance, so that accessing
+     * them later with entryBlock() does not require any reading or decompression.
+     * The entries are deserialized concurrently using the task scheduler. This
+     * call returns after all of them are ready. The cached entries of the archive
+     * cannot be accessed by other threads in the meantime.
+     *
+     * The archive must have a source for prefetching to be possible. Entries that
+     * are already cached, and entries that do not exist, are ignored.
+     *
+     * @param paths   Paths of the entries to prefetch.
+     * @param budget  Maximum total size of the prefetched contents, in bytes.
+     *                Entries that would exceed the budget are skipped.
+     *
+     * @return Total size of the prefetched contents, in bytes.
+     */
+    dsize prefetch(QList<Path> const &paths, dsize budget);
+
     /**
      * Adds an entry to the archive. The entry will not be committed to the
      * source, but instead remains as-is in memory.
@@ -383,7 +383,15 @@ public:
     void clearFromCache(DotPath const &path);
 
     /**
-     * Moves excess items on each cache level to lower level(s).
+     * Moves excess items on each cache level to lower level(s), so that the levels
+     * do not exceed their maximum sizes (see setMemoryCacheSize() and
+     * setHotStorageSize()). The least recently used items are moved first. Items
+     * purged from the hot storage are moved to cold storage and their serialized
+     * copies are deleted.
+     *
+     * If the hot storage has a maximum size, the access times of the items remaining
+     * in it are saved, so that items restored from hot storage in a later session
+     * keep their place in the usage order.
      */
     void purge();
 
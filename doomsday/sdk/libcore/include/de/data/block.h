@@ -106,6 +106,28 @@ public:
 
     Block compressed(int level = -1) const;
     Block decompressed() const;
+
+    /**
+     * Compresses the block using a preset deflate dictionary. The result has the same
+     * layout as compressed(), but the data can only be decompressed when the same
+     * dictionary is available.
+     *
+     * @param level       Compression level (0-9, or -1 for the default).
+     * @param dictionary  Preset dictionary. If empty, no dictionary is used.
+     *
+     * @return Compressed data, or an empty block if compression failed.
+     */
+    Block compressed(int level, Block const &dictionary) const;
+
+    /**
+     * Decompresses a block produced by compressed(). If the data was compressed with
+     * a preset dictionary, the same @a dictionary must be provided.
+     *
+     * @param dictionary  Preset dictionary.
+     *
+     * @return Decompressed data, or an empty block if decompression failed.
+     */
+    Block decompressed(Block const &dictionary) const;
     Block md5Hash() const;
     String asHexadecimalText() const;
 
@@ -525,6 +525,19 @@ public:
      */
     Members const &members() const;
 
+    /**
+     * Returns an identifier that is unique among all the records created during
+     * the lifetime of the application.
+     */
+    duint32 uniqueId() const;
+
+    /**
+     * Returns the membership version of the record. The version changes every time
+     * members are added to or removed from the record, so it can be used to check
+     * whether information cached about the members is still valid.
+     */
+    duint32 membershipVersion() const;
+
     LoopResult forMembers(std::function<LoopResult (String const &, Variable &)> func);
 
     LoopResult forMembers(std::function<LoopResult (String const &, Variable const &)> func) const;
@@ -106,6 +106,14 @@ public:
 
     void unloadAll();
 
+    /**
+     * Enables or disables decompressing the contents of packages in advance when
+     * they are loaded. Prefetching is disabled by default.
+     *
+     * @param enabled  @c true to prefetch the contents of packages loaded from now on.
+     */
+    void setPrefetchEnabled(bool enabled);
+
     bool isLoaded(String const &packageId) const;
 
     bool isLoaded(File const &file) const;
@@ -63,6 +63,7 @@ struct DENG2_PUBLIC Query
     QueryId id;
     String path;
     StringList packageIds;
+    duint64 startOffset = 0; ///< Where to begin a file contents transfer.
 
     // Callbacks:
     Request<FileMetadata> fileMetadata;
@@ -74,7 +75,7 @@ struct DENG2_PUBLIC Query
 
 public:
     Query(Request<FileMetadata> req, String path);
-    Query(Request<FileContents> req, String path);
+    Query(Request<FileContents> req, String path, duint64 startOffset = 0);
     bool isValid() const;
     void cancel();
 };
@@ -40,8 +40,15 @@ public:
     void setQuery(Query query);
     void setPath(String const &path);
 
+    /**
+     * Sets the offset where a FileContents transfer begins. Used for resuming
+     * an interrupted transfer.
+     */
+    void setStartOffset(duint64 offset);
+
     Query query() const;
     String path() const;
+    duint64 startOffset() const;
 
     // Implements ISerializable.
     void operator >> (Writer &to) const;
@@ -52,6 +59,7 @@ public:
 private:
     Query _query;
     String _path;
+    duint64 _startOffset;
 };
 
 /**
@@ -81,9 +81,20 @@ public:
                                         String folderPath,
                                         FileMetadata metadataReceived);
 
+    /**
+     * Requests the contents of a remote file.
+     *
+     * @param repository        Repository address.
+     * @param filePath          Path of the file in the repository.
+     * @param contentsReceived  Called as chunks of the file are received.
+     * @param startOffset       Offset where to begin the transfer. Used for resuming
+     *                          an interrupted download. Not all links support this;
+     *                          the offsets of the received chunks are authoritative.
+     */
     Request<FileContents> fetchFileContents(String const &repository,
                                             String filePath,
-                                            FileContents contentsReceived);
+                                            FileContents contentsReceived,
+                                            duint64 startOffset = 0);
 
     QNetworkAccessManager &network();
 
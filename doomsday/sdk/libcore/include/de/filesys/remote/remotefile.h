@@ -61,6 +61,13 @@ public:
 
     void deleteCache();
 
+    /**
+     * Cancels all downloads in progress. The data received so far is kept in the
+     * cache so the downloads can be resumed later. This must be called while the
+     * file system is still available, e.g., when the application is shutting down.
+     */
+    static void cancelAllDownloads();
+
     // File streaming.
     IIStream const &operator >> (IByteArray &bytes) const override;
 
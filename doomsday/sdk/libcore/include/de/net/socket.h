@@ -23,12 +23,14 @@
 #include "../libcore.h"
 #include "../IByteArray"
 #include "../Address"
+#include "../Block"
 #include "../Transmitter"
 
 #include <QTcpSocket>
 #include <QHostInfo>
 #include <QList>
 #include <QFlags>
+#include <memory>
 
 /// Largest message sendable using the protocol.
 #define DENG2_SOCKET_MAX_PAYLOAD_SIZE (1 << 22) // 4 MB
@@ -43,8 +45,12 @@ class Message;
  * ListenSocket constructs Socket instances for incoming connections.
  *
  * Note that Socket instances must always be used in the same thread as ListenSocket.
- * Socket uses a background thread for compressing large messages before sending. This
- * means they may be sent out-of-order with regards to all other messages.
+ * Socket uses a background thread for compressing large messages before sending. The
+ * messages are nevertheless written in the order they were sent, unless the socket
+ * allows reordering (see setRetainOrder()).
+ *
+ * A message that is sent to several recipients should be sent as a PreparedMessage, so
+ * that it only needs to be compressed once.
  *
  * @ingroup net
  */
@@ -75,6 +81,45 @@ public:
     };
     Q_DECLARE_FLAGS(HeaderFlags, HeaderFlag)
 
+    /**
+     * Message that has been encoded for sending. The payload is compressed only once,
+     * after which the message can be sent via any number of sockets. Copies of a
+     * prepared message share the same encoded data.
+     *
+     * Large messages are compressed in a background thread. Sockets keep the message
+     * queued until it is ready to be written.
+     */
+    class DENG2_PUBLIC PreparedMessage
+    {
+    public:
+        /**
+         * Starts encoding a message. Small messages are encoded immediately.
+         *
+         * @param packet             Message payload.
+         * @param deflateDictionary  Preset deflate dictionary. The message can only be
+         *                           sent to peers that can inflate with the same
+         *                           dictionary (see Socket::setInflateDictionary()).
+         */
+        explicit PreparedMessage(IByteArray const &packet,
+                                 Block const &deflateDictionary = Block());
+
+        /**
+         * Determines if the message has been encoded and can be written to a socket.
+         */
+        bool isReady() const;
+
+        /**
+         * Blocks until the message has been encoded.
+         */
+        void wait() const;
+
+    private:
+        struct Impl;
+        std::shared_ptr<Impl> d;
+
+        friend class Socket;
+    };
+
 public:
     Socket();
 
@@ -129,15 +174,37 @@ public:
      * Specifies whether all sent messages need to be written out in the order they have
      * been sent. The default is to retain order.
      *
-     * If the messaging protocol in use does not require messages to be ordered, setting
-     * this to @c false allows Socket to compress large messages in a background thread
-     * and send them when ready, instead of blocking.
+     * Large messages are always compressed in a background thread. If the messaging
+     * protocol in use does not require messages to be ordered, setting this to @c false
+     * allows Socket to write later messages while earlier ones are still being
+     * compressed.
      *
      * @param retainOrder  @c true to keep send order, @c false to allow order to be
      *                     unpredictable.
      */
     void setRetainOrder(bool retainOrder);
 
+    /**
+     * Sets the preset dictionary used when deflating sent messages. The peer must
+     * be able to inflate them, so the dictionary should only be set after the peer
+     * has confirmed that it has the same dictionary.
+     *
+     * @param dictionary  Preset deflate dictionary. Empty to not use a dictionary.
+     */
+    void setDeflateDictionary(Block const &dictionary);
+
+    Block deflateDictionary() const;
+
+    /**
+     * Sets the preset dictionary available for inflating received messages. A
+     * received message only uses the dictionary if it was deflated with it, so this
+     * can be set before the peer starts using the dictionary. Received messages that
+     * were deflated without a dictionary can still be read.
+     *
+     * @param dictionary  Preset deflate dictionary. Empty to not use a dictionary.
+     */
+    void setInflateDictionary(Block const &dictionary);
+
     // Implements Transmitter.
     /**
      * Sends the given data over the socket.  Copies the data into
@@ -159,6 +226,14 @@ public:
      */
     Socket &operator << (IByteArray const &data);
 
+    /**
+     * Sends a message that has been prepared for sending. If the message is still
+     * being encoded, it is written when ready.
+     *
+     * @param message  Prepared message.
+     */
+    void send(PreparedMessage const &message);
+
     /**
      * Returns the next received message. If nothing has been received,
      * returns @c NULL.
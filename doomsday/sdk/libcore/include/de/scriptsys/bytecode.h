@@ -0,0 +1,164 @@
+/** @file bytecode.h  Compiled form of an expression.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_BYTECODE_H
+#define LIBDENG2_BYTECODE_H
+
+#include "../libcore.h"
+#include "operator.h"
+
+#include <vector>
+
+namespace de {
+
+class Expression;
+class Value;
+
+/**
+ * Flat sequence of instructions that evaluates an expression tree. @ingroup script
+ *
+ * An expression is compiled once (see Expression::bytecode()) and the Evaluator then
+ * runs the instructions in order, using its result stack as the value stack. The
+ * instructions are in postfix order: the operands of an expression are evaluated
+ * before the expression itself. Operators and the construction of arrays and
+ * dictionaries are carried out by the Evaluator; only name lookups and built-in
+ * functions call back to their expression node.
+ *
+ * Constant values are kept in a constant pool and are not owned by the bytecode;
+ * they belong to the compiled ConstantExpressions.
+ */
+class DENG2_PUBLIC Bytecode
+{
+public:
+    enum OpCode
+    {
+        /// Pushes a copy of constant number @em arg onto the result stack.
+        PushConstant,
+
+        /// Calls the evaluate() method of the node. The node pops its operands from
+        /// the result stack and the returned value is pushed onto the stack. Used for
+        /// name lookups and built-in functions.
+        Evaluate,
+
+        /// Evaluates the node and all its operands using Expression::push(). Used for
+        /// expressions that cannot be compiled.
+        EvaluateTree,
+
+        /// Pops the operand and applies the unary operator @em arg to it.
+        UnaryOperator,
+
+        /// Pops the right and left operands and applies the binary operator @em arg
+        /// to them.
+        BinaryOperator,
+
+        /// Pops @em arg results and pushes an array of them.
+        MakeArray,
+
+        /// Pops @em arg key/value pairs and pushes a dictionary of them.
+        MakeDictionary,
+
+        /// Pops a result whose member scope is used by the next Scoped instruction
+        /// (left side of the member operator).
+        SetScope,
+
+        /// Discards the scope that was set by SetScope.
+        DropScope,
+
+        /// Pops a result. If it is false, pushes False and jumps to instruction @em arg.
+        And,
+
+        /// Pops a result. If it is true, pushes True and jumps to instruction @em arg.
+        Or,
+
+        /// Pops a result and pushes a boolean that tells whether it is true.
+        ToBoolean
+    };
+
+    enum InstructionFlag
+    {
+        /// The instruction is evaluated in the scope set by the preceding SetScope,
+        /// and the scope is attached to the pushed result.
+        Scoped = 0x1,
+
+        /// The INDEX operator evaluates to a reference.
+        ByReference = 0x2
+    };
+
+    struct Instruction
+    {
+        duint8 op;
+        duint8 flags;
+        duint32 arg;
+        Expression const *node;
+    };
+
+    typedef std::vector<Instruction> Instructions;
+
+public:
+    Bytecode();
+
+    /**
+     * Appends a new instruction.
+     *
+     * @param op      Operation.
+     * @param node    Expression that the instruction belongs to.
+     * @param scoped  Evaluate the instruction in the scope defined by SetScope.
+     * @param arg     Argument of the operation.
+     *
+     * @return Index of the instruction.
+     */
+    dsize add(OpCode op, Expression const *node, bool scoped = false, duint32 arg = 0);
+
+    /**
+     * Appends a PushConstant instruction. The value is added to the constant pool.
+     *
+     * @param value   Constant value. Must exist as long as the bytecode does.
+     * @param node    Expression that the instruction belongs to.
+     * @param scoped  Evaluate the instruction in the scope defined by SetScope.
+     */
+    void addConstant(Value const &value, Expression const *node, bool scoped = false);
+
+    /**
+     * Appends an UnaryOperator or BinaryOperator instruction.
+     *
+     * @param op           Operator.
+     * @param node         Expression that the instruction belongs to.
+     * @param unary        The operator is unary.
+     * @param byReference  The INDEX operator evaluates to a reference.
+     */
+    void addOperator(Operator op, Expression const *node, bool unary, bool byReference = false);
+
+    /**
+     * Makes a jump instruction point to the next instruction to be added.
+     *
+     * @param jump  Index of the jump instruction.
+     */
+    void setJumpTargetHere(dsize jump);
+
+    Instructions const &instructions() const;
+
+    Value const &constant(duint32 index) const;
+
+private:
+    Instructions _instructions;
+    std::vector<Value const *> _constants;
+};
+
+} // namespace de
+
+#endif // LIBDENG2_BYTECODE_H
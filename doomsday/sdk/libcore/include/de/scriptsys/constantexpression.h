@@ -48,6 +48,8 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    void compile(Bytecode &code, bool scoped = false) const;
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
@@ -37,6 +37,9 @@ class Record;
 /**
  * Stack for evaluating expressions.
  *
+ * Expressions are evaluated by running their compiled Bytecode. The result stack
+ * serves as the value stack of the bytecode instructions.
+ *
  * @ingroup script
  */
 class DENG2_PUBLIC Evaluator
@@ -105,6 +108,19 @@ public:
      */
     void namespaces(Namespaces &spaces) const;
 
+    /**
+     * Returns the namespaces currently visible (see namespaces()). During an
+     * evaluation the list remains valid until the evaluation ends.
+     */
+    Namespaces const &namespaces() const;
+
+    /**
+     * Returns the namespaces of the process's call stack, ignoring the namespace
+     * scope of the current expression. During an evaluation the list remains valid
+     * until the evaluation ends.
+     */
+    Namespaces const &processNamespaces() const;
+
     /**
      * Returns the current local namespace (topmost namespace from namespaces()).
      */
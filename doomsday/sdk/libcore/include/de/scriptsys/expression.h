@@ -23,9 +23,11 @@
 #include "../ISerializable"
 
 #include <QFlags>
+#include <atomic>
 
 namespace de {
 
+class Bytecode;
 class Evaluator;
 class Value;
 class Record;
@@ -97,6 +99,22 @@ public:
 
     virtual Value *evaluate(Evaluator &evaluator) const = 0;
 
+    /**
+     * Compiles the expression and its operands into bytecode. The default
+     * implementation falls back to evaluating the expression tree with push().
+     *
+     * @param code    Bytecode where instructions are appended.
+     * @param scoped  The expression is evaluated in the scope defined by the left
+     *                side of a member operator (see Bytecode::SetScope).
+     */
+    virtual void compile(Bytecode &code, bool scoped = false) const;
+
+    /**
+     * Returns the compiled bytecode of the expression. The expression is compiled
+     * when this is called for the first time.
+     */
+    Bytecode const &bytecode() const;
+
     /**
      * Returns the flags of the expression.
      */
@@ -144,6 +162,7 @@ protected:
 
 private:
     Flags _flags;
+    mutable std::atomic<Bytecode *> _bytecode;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Expression::Flags)
@@ -80,6 +80,8 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    void compile(Bytecode &code, bool scoped = false) const;
+
     /**
      * Verifies that @a value can be used as the l-value of an operator that
      * does assignment.
@@ -88,13 +90,32 @@ public:
      */
     static void verifyAssignable(Value *value);
 
+    /**
+     * Applies an operator to the values of its operands. This is used for all the
+     * operators except MEMBER, AND and OR, whose right operand is evaluated
+     * depending on the result of the left operand.
+     *
+     * @param evaluator    Evaluator.
+     * @param op           Operator.
+     * @param leftValue    Left operand, or @c nullptr if the operator is unary.
+     *                     Ownership taken.
+     * @param rightValue   Right operand. Ownership taken.
+     * @param leftScope    Scope of the left operand (used by CALL). Ownership taken.
+     * @param byReference  INDEX evaluates to a reference.
+     *
+     * @return Result of the operation. @c nullptr if the result is given by the
+     * called function.
+     */
+    static Value *apply(Evaluator &evaluator, Operator op, Value *leftValue,
+                        Value *rightValue, Value *leftScope, bool byReference);
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
 
 private:
     /// Performs the slice operation (Python semantics).
-    Value *performSlice(Value &leftValue, Value &rightValue) const;
+    static Value *performSlice(Value &leftValue, Value &rightValue);
 
     /// Used to create return values of boolean operations.
     static Value *newBooleanValue(bool isTrue);
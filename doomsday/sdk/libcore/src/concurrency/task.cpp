@@ -40,7 +40,7 @@ void Task::run()
     // Cleanup.
     if (_pool) _pool->taskFinishedRunning(*this);
     
-    // The thread's log is not disposed because task threads are pooled (by TaskPool)
+    // The thread's log is not disposed because task threads are pooled (by TaskScheduler)
     // and the log object will be reused in future tasks.
 }
 
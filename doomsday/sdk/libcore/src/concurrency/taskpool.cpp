@@ -18,13 +18,13 @@
 
 #include "de/TaskPool"
 #include "de/Task"
+#include "de/TaskScheduler"
 #include "de/Guard"
 
-#include <QThreadPool>
-#include <QSet>
 #include <de/Lockable>
 #include <de/Loop>
 #include <de/Waitable>
+#include <atomic>
 
 namespace de {
 
@@ -45,8 +45,9 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
     /// Private instance will be deleted when pool is empty.
     bool deleteWhenDone = false;
 
-    /// Set of running tasks.
-    QSet<Task *> tasks;
+    /// Number of started tasks that have not yet finished. The pool is only locked
+    /// when the last task finishes.
+    std::atomic<int> taskCount { 0 };
 
     Impl(Public *i) : Base(i)
     {
@@ -58,73 +59,101 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
     {
         // The pool is always empty at this point because the destructor is not
         // called until all the tasks have been finished and removed.
-        DENG2_ASSERT(tasks.isEmpty());
+        DENG2_ASSERT(taskCount == 0);
     }
 
     void add(Task *t)
     {
-        DENG2_GUARD(this);
         t->_pool = this;
-        if (tasks.isEmpty())
+        if (taskCount++ == 0)
         {
             wait(); // Semaphore now unavailable.
         }
-        tasks.insert(t);
     }
 
-    /// Returns @c true, if the pool became empty as result of the remove.
-    bool remove(Task *t)
+    /**
+     * Removes a finished task without locking, unless it is the last one.
+     *
+     * @return @c true, if the task was removed. @c false, if the pool may become
+     * empty and the caller must lock the pool and remove the task itself.
+     */
+    bool removeIfNotLast()
     {
-        DENG2_GUARD(this);
-        tasks.remove(t);
-        if (tasks.isEmpty())
+        for (int count = taskCount; count > 1; )
         {
-            post();
-            return true;
+            if (taskCount.compare_exchange_weak(count, count - 1)) return true;
         }
         return false;
     }
 
     void waitForEmpty() const
     {
-        wait();
+        auto &scheduler = TaskScheduler::get();
+        if (scheduler.isWorkerThread())
+        {
+            // Blocking a worker thread could prevent the remaining tasks from
+            // running, so help run the pool's own queued tasks while waiting.
+            auto const isOwnTask = [this] (Task const &task)
+            {
+                return task._pool == this;
+            };
+            while (!isEmpty())
+            {
+                if (!scheduler.runPendingTask(isOwnTask) && tryWait(.001))
+                {
+                    post();
+                    break;
+                }
+            }
+        }
+        else
+        {
+            wait();
+            post(); // When empty, the semaphore is available.
+        }
+        // The task that emptied the pool may still be notifying the audience.
         DENG2_GUARD(this);
-        DENG2_ASSERT(tasks.isEmpty());
-        post(); // When empty, the semaphore is available.
     }
 
     bool isEmpty() const
     {
-        DENG2_GUARD(this);
-        return tasks.isEmpty();
+        return taskCount == 0;
     }
 
-    void taskFinishedRunning(Task &task)
+    void taskFinishedRunning(Task &)
     {
+        // Other tasks are still running?
+        if (removeIfNotLast()) return;
+
         lock();
-        if (remove(&task))
+        if (--taskCount > 0)
         {
-            if (deleteWhenDone)
-            {
-                // All done, clean up!
-                unlock();
+            // A new task was started meanwhile.
+            unlock();
+            return;
+        }
+        post(); // Pool is now empty.
 
-                // NOTE: Guard isn't used because the object doesn't exist past this point.
-                delete this;
-                return;
+        if (deleteWhenDone)
+        {
+            // All done, clean up!
+            unlock();
+
+            // NOTE: Guard isn't used because the object doesn't exist past this point.
+            delete this;
+            return;
+        }
+        else if (isEmpty()) // A new task may have been started already.
+        {
+            try
+            {
+                emit self().allTasksDone();
+                DENG2_FOR_AUDIENCE(Done, i) i->taskPoolDone(self());
             }
-            else
+            catch (Error const &er)
             {
-                try
-                {
-                    emit self().allTasksDone();
-                    DENG2_FOR_AUDIENCE(Done, i) i->taskPoolDone(self());
-                }
-                catch (Error const &er)
-                {
-                    unlock();
-                    throw er;
-                }
+                unlock();
+                throw er;
             }
         }
         unlock();
@@ -152,7 +181,7 @@ TaskPool::~TaskPool()
 void TaskPool::start(Task *task, Priority priority)
 {
     d->add(task);
-    QThreadPool::globalInstance()->start(task, int(priority));
+    TaskScheduler::get().start(task, TaskScheduler::Priority(priority));
 }
 
 void TaskPool::start(TaskFunction taskFunction, Priority priority)
@@ -0,0 +1,508 @@
+/** @file taskscheduler.cpp  Work-stealing scheduler for concurrent tasks.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/TaskScheduler"
+#include "de/Task"
+#include "de/math.h"
+
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace de {
+
+DENG2_PIMPL_NOREF(TaskScheduler)
+{
+    /**
+     * Worker thread with its own deque of tasks. The worker itself pushes and pops
+     * at the back of the deque, while other threads steal from the front.
+     */
+    struct Worker : public QThread
+    {
+        Impl &scheduler;
+        int index;
+        std::mutex mutex;
+        std::deque<Task *> tasks;
+
+        Worker(Impl &scheduler, int index) : scheduler(scheduler), index(index) {}
+
+        void run() override
+        {
+            scheduler.workerLoop(*this);
+        }
+    };
+
+    std::vector<Worker *> workers;
+
+    /// Tasks started outside the worker threads, one queue per priority.
+    std::mutex sharedMutex;
+    std::deque<Task *> sharedTasks[3];
+    std::atomic<int> sharedCount { 0 };
+
+    std::atomic<int>      queuedCount   { 0 }; ///< Tasks waiting in all of the queues.
+    std::atomic<int>      sleepingCount { 0 }; ///< Workers waiting for new tasks.
+    std::atomic<unsigned> nextVictim    { 0 };
+    std::atomic<bool>     stopping      { false };
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    Impl(int workerCount)
+    {
+        if (workerCount <= 0)
+        {
+            workerCount = de::max(1, QThread::idealThreadCount());
+        }
+        for (int i = 0; i < workerCount; ++i)
+        {
+            workers.push_back(new Worker(*this, i));
+        }
+        for (Worker *worker : workers)
+        {
+            worker->start();
+        }
+    }
+
+    ~Impl()
+    {
+        stopping = true;
+        {
+            std::lock_guard<std::mutex> g(sleepMutex);
+            wakeUp.notify_all();
+        }
+        for (Worker *worker : workers)
+        {
+            worker->wait();
+            delete worker;
+        }
+    }
+
+    Worker *currentWorker() const
+    {
+        auto *worker = dynamic_cast<Worker *>(QThread::currentThread());
+        if (worker && &worker->scheduler == this)
+        {
+            return worker;
+        }
+        return nullptr;
+    }
+
+    void push(Task *task, Priority priority)
+    {
+        if (Worker *worker = currentWorker())
+        {
+            std::lock_guard<std::mutex> g(worker->mutex);
+            worker->tasks.push_back(task);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> g(sharedMutex);
+            sharedTasks[priority].push_back(task);
+            sharedCount++;
+        }
+        queuedCount++;
+
+        // If a worker is asleep, wake one up. The worker checks queuedCount after
+        // announcing that it is about to sleep, so the notification cannot be lost.
+        if (sleepingCount > 0)
+        {
+            std::lock_guard<std::mutex> g(sleepMutex);
+            wakeUp.notify_one();
+        }
+    }
+
+    Task *takeShared()
+    {
+        if (sharedCount <= 0) return nullptr;
+
+        std::lock_guard<std::mutex> g(sharedMutex);
+        for (int p = HighPriority; p >= LowPriority; --p)
+        {
+            auto &queue = sharedTasks[p];
+            if (!queue.empty())
+            {
+                Task *task = queue.front();
+                queue.pop_front();
+                sharedCount--;
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    Task *steal(Worker const *thief)
+    {
+        unsigned const count = unsigned(workers.size());
+        unsigned const start = (thief? unsigned(thief->index) + 1 : nextVictim++);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            Worker *victim = workers[(start + i) % count];
+            if (victim == thief) continue;
+
+            std::lock_guard<std::mutex> g(victim->mutex);
+            if (!victim->tasks.empty())
+            {
+                Task *task = victim->tasks.front();
+                victim->tasks.pop_front();
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Finds the next task to run: first from the calling worker's own deque, then
+     * from the shared queue, and finally from the other workers' deques.
+     *
+     * @param worker  Calling worker, or @c nullptr if called from another thread.
+     */
+    Task *take(Worker *worker)
+    {
+        if (queuedCount <= 0) return nullptr;
+
+        Task *task = nullptr;
+        if (worker)
+        {
+            std::lock_guard<std::mutex> g(worker->mutex);
+            if (!worker->tasks.empty())
+            {
+                task = worker->tasks.back();
+                worker->tasks.pop_back();
+            }
+        }
+        if (!task) task = takeShared();
+        if (!task) task = steal(worker);
+        if (task) queuedCount--;
+        return task;
+    }
+
+    /**
+     * Finds a queued task that is accepted by @a accept and removes it from its
+     * queue. The calling worker's own deque is searched first.
+     */
+    Task *takeAccepted(Worker *worker, std::function<bool (Task const &)> const &accept)
+    {
+        if (queuedCount <= 0) return nullptr;
+
+        auto const extract = [&accept] (std::deque<Task *> &queue) -> Task *
+        {
+            for (auto i = queue.begin(); i != queue.end(); ++i)
+            {
+                if (accept(**i))
+                {
+                    Task *task = *i;
+                    queue.erase(i);
+                    return task;
+                }
+            }
+            return nullptr;
+        };
+
+        Task *task = nullptr;
+        if (worker)
+        {
+            std::lock_guard<std::mutex> g(worker->mutex);
+            task = extract(worker->tasks);
+        }
+        if (!task && sharedCount > 0)
+        {
+            std::lock_guard<std::mutex> g(sharedMutex);
+            for (int p = HighPriority; p >= LowPriority && !task; --p)
+            {
+                if ((task = extract(sharedTasks[p])) != nullptr) sharedCount--;
+            }
+        }
+        for (unsigned i = 0; !task && i < workers.size(); ++i)
+        {
+            if (workers[i] == worker) continue;
+            std::lock_guard<std::mutex> g(workers[i]->mutex);
+            task = extract(workers[i]->tasks);
+        }
+        if (task) queuedCount--;
+        return task;
+    }
+
+    static void run(Task *task)
+    {
+        task->run();
+        delete task;
+    }
+
+    void workerLoop(Worker &worker)
+    {
+        for (;;)
+        {
+            if (Task *task = take(&worker))
+            {
+                run(task);
+                continue;
+            }
+            if (stopping && queuedCount <= 0)
+            {
+                break;
+            }
+            sleepingCount++;
+            {
+                std::unique_lock<std::mutex> lk(sleepMutex);
+                wakeUp.wait(lk, [this] () { return queuedCount > 0 || stopping; });
+            }
+            sleepingCount--;
+        }
+    }
+};
+
+TaskScheduler::TaskScheduler(int workerCount)
+    : d(new Impl(workerCount))
+{}
+
+TaskScheduler::~TaskScheduler()
+{}
+
+int TaskScheduler::workerCount() const
+{
+    return int(d->workers.size());
+}
+
+void TaskScheduler::start(Task *task, Priority priority)
+{
+    DENG2_ASSERT(task);
+    d->push(task, priority);
+}
+
+bool TaskScheduler::runPendingTask(std::function<bool (Task const &)> const &accept)
+{
+    if (Task *task = d->takeAccepted(d->currentWorker(), accept))
+    {
+        Impl::run(task);
+        return true;
+    }
+    return false;
+}
+
+bool TaskScheduler::isWorkerThread() const
+{
+    return d->currentWorker() != nullptr;
+}
+
+TaskScheduler &TaskScheduler::get()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+//---------------------------------------------------------------------------------------
+
+DENG2_PIMPL_NOREF(TaskGroup)
+{
+    /// Runs one function of the group and notifies the group when done.
+    class GroupTask : public Task
+    {
+    public:
+        GroupTask(Impl &group, Work work) : _group(group), _work(std::move(work)) {}
+        ~GroupTask() { _group.taskFinished(); }
+        void runTask() override { _work(); }
+        bool belongsTo(Impl const &group) const { return &_group == &group; }
+
+    private:
+        Impl &_group;
+        Work _work;
+    };
+
+    TaskScheduler &scheduler;
+    std::atomic<int> pendingCount { 0 };
+    std::mutex mutex;
+    std::condition_variable allDone;
+
+    Impl(TaskScheduler &scheduler) : scheduler(scheduler) {}
+
+    void taskFinished()
+    {
+        // The count is decremented while locked so that a waiting thread cannot
+        // destroy the group before the notification has been sent.
+        std::lock_guard<std::mutex> g(mutex);
+        if (--pendingCount == 0)
+        {
+            allDone.notify_all();
+        }
+    }
+
+    void wait()
+    {
+        // A waiting worker runs the queued tasks of this group, otherwise they might
+        // never get a chance to run if all the workers are waiting. Other tasks are
+        // left alone so that unrelated code does not get run in the middle of this.
+        bool const helping = scheduler.isWorkerThread();
+        auto const isOwnTask = [this] (Task const &task)
+        {
+            auto const *groupTask = dynamic_cast<GroupTask const *>(&task);
+            return groupTask && groupTask->belongsTo(*this);
+        };
+        while (pendingCount > 0)
+        {
+            if (helping && scheduler.runPendingTask(isOwnTask)) continue;
+
+            std::unique_lock<std::mutex> lk(mutex);
+            auto const done = [this] () { return pendingCount == 0; };
+            if (helping)
+            {
+                allDone.wait_for(lk, std::chrono::milliseconds(1), done);
+            }
+            else
+            {
+                allDone.wait(lk, done);
+            }
+        }
+        // Make sure the last finished task is no longer using the mutex.
+        std::lock_guard<std::mutex> g(mutex);
+    }
+};
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler)
+    : d(new Impl(scheduler))
+{}
+
+TaskGroup::~TaskGroup()
+{
+    d->wait();
+}
+
+void TaskGroup::run(Work work, TaskScheduler::Priority priority)
+{
+    d->pendingCount++;
+    d->scheduler.start(new Impl::GroupTask(*d, std::move(work)), priority);
+}
+
+void TaskGroup::wait()
+{
+    d->wait();
+}
+
+bool TaskGroup::isDone() const
+{
+    return d->pendingCount == 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+namespace internal {
+
+/**
+ * State of a parallelFor() shared by the calling thread and the helper tasks.
+ * Helpers that start late may outlive the call, so the state is reference counted.
+ */
+struct ParallelForState
+{
+    std::function<void (dsize, dsize)> func;
+    dsize count;
+    dsize grainSize;
+    dsize chunkCount;
+    std::atomic<dsize> nextChunk { 0 };
+    std::atomic<dsize> doneChunks { 0 };
+    std::mutex mutex;
+    std::condition_variable allDone;
+    std::exception_ptr error;
+
+    ParallelForState(std::function<void (dsize, dsize)> const &func, dsize count, dsize grainSize)
+        : func(func)
+        , count(count)
+        , grainSize(grainSize)
+        , chunkCount((count + grainSize - 1) / grainSize)
+    {}
+
+    /// Processes chunks until there are none left.
+    void work()
+    {
+        for (dsize chunk; (chunk = nextChunk++) < chunkCount; )
+        {
+            try
+            {
+                func(chunk * grainSize, de::min(count, (chunk + 1) * grainSize));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> g(mutex);
+                if (!error) error = std::current_exception();
+            }
+            if (++doneChunks == chunkCount)
+            {
+                std::lock_guard<std::mutex> g(mutex);
+                allDone.notify_all();
+            }
+        }
+    }
+
+    void waitForAllChunks()
+    {
+        std::unique_lock<std::mutex> lk(mutex);
+        allDone.wait(lk, [this] () { return doneChunks == chunkCount; });
+    }
+};
+
+class ParallelForTask : public Task
+{
+public:
+    ParallelForTask(std::shared_ptr<ParallelForState> state) : _state(std::move(state)) {}
+    void runTask() override { _state->work(); }
+
+private:
+    std::shared_ptr<ParallelForState> _state;
+};
+
+} // namespace internal
+
+void parallelFor(dsize count, std::function<void (dsize, dsize)> const &func, dsize grainSize)
+{
+    if (!count) return;
+
+    auto &scheduler = TaskScheduler::get();
+    if (!grainSize)
+    {
+        // A few chunks per worker evens out the load if some chunks are slower.
+        grainSize = de::max(dsize(1), count / dsize(scheduler.workerCount() * 4));
+    }
+    if (grainSize >= count)
+    {
+        func(0, count);
+        return;
+    }
+
+    auto state = std::make_shared<internal::ParallelForState>(func, count, grainSize);
+
+    // The calling thread works on the range as well, so one helper fewer is needed.
+    dsize const helpers = de::min(state->chunkCount - 1, dsize(scheduler.workerCount()));
+    for (dsize i = 0; i < helpers; ++i)
+    {
+        scheduler.start(new internal::ParallelForTask(state), TaskScheduler::HighPriority);
+    }
+    state->work();
+
+    // Chunks may still be in progress in other threads.
+    state->waitForAllChunks();
+
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace de
@@ -44,6 +44,7 @@
 #include "de/PackageLoader"
 #include "de/Record"
 #include "de/RemoteFeedRelay"
+#include "de/RemoteFile"
 #include "de/ScriptSystem"
 #include "de/StaticLibraryFeed"
 #include "de/TextValue"
@@ -200,6 +201,9 @@ DENG2_PIMPL(App)
 
     ~Impl()
     {
+        // Keep the data of interrupted downloads while the file system is available.
+        RemoteFile::cancelAllDownloads();
+
         metaBank.reset();
 
         if (errorSink)
@@ -17,10 +17,14 @@
  */
 
 #include "de/Archive"
+#include "de/Guard"
+#include "de/TaskScheduler"
+
+#include <vector>
 
 namespace de {
 
-DENG2_PIMPL(Archive)
+DENG2_PIMPL(Archive), public Lockable
 {
     /// Source data provided at construction.
     IByteArray const *source;
@@ -85,6 +89,7 @@ void Archive::cache(CacheOperation operation)
         // Nothing to read from.
         return;
     }
+    DENG2_GUARD(d);
     PathTreeIterator<PathTree> iter(d->index->leafNodes());
     while (iter.hasNext())
     {
@@ -172,6 +177,7 @@ File::Status Archive::entryStatus(Path const &path) const
 Block const &Archive::entryBlock(Path const &path) const
 {
     DENG2_ASSERT(d->index != 0);
+    DENG2_GUARD(d);
 
     // The entry contents will be cached in memory.
     if (Entry *entry = static_cast<Entry *>(d->index->tryFind(path, PathTree::MatchFull | PathTree::NoBranch)))
@@ -195,6 +201,8 @@ Block const &Archive::entryBlock(Path const &path) const
 
 Block &Archive::entryBlock(Path const &path)
 {
+    DENG2_GUARD(d);
+
     if (!hasEntry(path))
     {
         add(path, Block());
@@ -216,6 +224,8 @@ void Archive::uncacheBlock(Path const &path) const
 {
     if (!d->source) return; // Wouldn't be able to re-cache the data.
 
+    DENG2_GUARD(d);
+
     if (Entry *entry = static_cast<Entry *>(d->index->tryFind(path, PathTree::MatchFull | PathTree::NoBranch)))
     {
         if (!entry->data && !entry->dataInArchive) return;
@@ -237,6 +247,77 @@ void Archive::uncacheBlock(Path const &path) const
     }
 }
 
+dsize Archive::prefetch(QList<Path> const &paths, dsize budget)
+{
+    if (!d->source) return 0; // Nothing to read from.
+
+    // The entries must not be accessed or uncached elsewhere while the prefetched
+    // contents are being prepared.
+    DENG2_GUARD(d);
+
+    struct Prefetched
+    {
+        Entry *entry;
+        Path path;
+        bool serializedReadHere;
+        std::unique_ptr<Block> data;
+    };
+    std::vector<Prefetched> work;
+
+    // The serialized data is read from the source beforehand, because the source
+    // is not meant to be accessed concurrently.
+    dsize total = 0;
+    for (Path const &path : paths)
+    {
+        Entry *entry = static_cast<Entry *>(d->index->tryFind(path, PathTree::MatchFull | PathTree::NoBranch));
+        if (!entry || entry->data || !entry->size) continue;
+        if (total + entry->size > budget) continue;
+
+        total += entry->size;
+        bool const readHere = !entry->dataInArchive;
+        if (readHere)
+        {
+            entry->dataInArchive.reset(new Block(*d->source, entry->offset, entry->sizeInArchive));
+        }
+        work.push_back(Prefetched { entry, path, readHere, nullptr });
+    }
+
+    parallelFor(work.size(), [this, &work] (dsize start, dsize end)
+    {
+        for (dsize i = start; i < end; ++i)
+        {
+            Prefetched &pre = work[i];
+            try
+            {
+                std::unique_ptr<Block> data(new Block);
+                readFromSource(*pre.entry, pre.path, *data);
+                pre.data.reset(data.release());
+            }
+            catch (Error const &)
+            {
+                // The entry will be read again when it is needed, and the error
+                // is reported then.
+            }
+        }
+    }, 1);
+
+    dsize prefetched = 0;
+    for (Prefetched &pre : work)
+    {
+        if (pre.data)
+        {
+            prefetched += pre.data->size();
+            pre.entry->data.reset(pre.data.release());
+        }
+        if (pre.serializedReadHere)
+        {
+            // Release the serialized copy if the entry was not compressed.
+            pre.entry->dataInArchive.reset();
+        }
+    }
+    return prefetched;
+}
+
 void Archive::add(Path const &path, IByteArray const &data)
 {
     if (path.isEmpty())
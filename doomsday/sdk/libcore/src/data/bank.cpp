@@ -31,10 +31,17 @@
 #include "de/math.h"
 
 #include <QThread>
+#include <QHash>
 #include <QList>
+#include <algorithm>
 
 namespace de {
 
+/// Name of the file in the hot storage folder where the access times of the items
+/// are kept between sessions. Item paths are dot-separated, so the serialized items
+/// never have a dot in their file name.
+static String const ACCESS_INDEX_NAME = "access.index";
+
 namespace internal {
 
 /**
@@ -546,6 +553,7 @@ DENG2_PIMPL(Bank)
     TaskPool jobs;
     NotifyQueue notifications;
     LoopCallback mainCall;
+    QHash<String, Time> accessIndex; ///< Access times of hot items in earlier sessions.
 
     Impl(Public *i, char const *name, Flags const &flg)
         : Base(i)
@@ -638,6 +646,81 @@ DENG2_PIMPL(Bank)
             // Make sure that the cache folder is immediately populated so that the
             // cached data available for future operations.
             FS::get().makeFolder(location);
+
+            readAccessIndex();
+        }
+    }
+
+    /**
+     * Reads the access times of the items in hot storage, as saved by
+     * writeAccessIndex() in an earlier session.
+     */
+    void readAccessIndex()
+    {
+        accessIndex.clear();
+        try
+        {
+            if (File const *file = FS::tryLocate<File const>(serialCache->path() / ACCESS_INDEX_NAME))
+            {
+                Reader reader(*file);
+                reader.withHeader();
+                duint32 count;
+                reader >> count;
+                while (count-- > 0)
+                {
+                    String path;
+                    Time accessedAt;
+                    reader >> path >> accessedAt;
+                    accessIndex.insert(path, accessedAt);
+                }
+            }
+        }
+        catch (Error const &er)
+        {
+            LOG_WARNING("Failed to read the access times of hot storage:\n") << er.asText();
+            accessIndex.clear();
+        }
+    }
+
+    /**
+     * Saves the access times of the items in hot storage, so that the least recently
+     * used items can be purged in later sessions as well.
+     */
+    void writeAccessIndex()
+    {
+        DENG2_ASSERT(serialCache);
+
+        QList<Data *> hotItems;
+        {
+            DENG2_GUARD(*serialCache);
+            hotItems = serialCache->items().toList();
+        }
+        QList<QPair<String, Time>> entries;
+        for (Data *item : hotItems)
+        {
+            DENG2_GUARD(item);
+            if (item->cache != serialCache.get() || !item->accessedAt.isValid()) continue;
+
+            // Stored as date and time, because high-performance time is relative
+            // to the start of the session.
+            Time accessedAt(item->accessedAt);
+            entries << qMakePair(item->path(sepChar).toString(), Time(accessedAt.asDateTime()));
+        }
+        try
+        {
+            Block index;
+            Writer writer(index);
+            writer.withHeader() << duint32(entries.size());
+            for (auto const &entry : entries)
+            {
+                writer << entry.first << entry.second;
+            }
+            FS::get().makeFolder(serialCache->path())
+                    .replaceFile(ACCESS_INDEX_NAME) << index;
+        }
+        catch (Error const &er)
+        {
+            LOG_WARNING("Failed to save the access times of hot storage:\n") << er.asText();
         }
     }
 
@@ -663,6 +746,15 @@ DENG2_PIMPL(Bank)
 
                     item.serial.reset(src);
                     best = serialCache.get();
+
+                    // Restore the access time from an earlier session. It is made
+                    // relative to the current session's high-performance time.
+                    auto found = accessIndex.constFind(item.path(sepChar).toString());
+                    if (found != accessIndex.constEnd() && found.value().isValid())
+                    {
+                        item.accessedAt = Time(Time::currentHighPerformanceTime().highPerformanceTime()
+                                               - found.value().since());
+                    }
                 }
             }
         }
@@ -686,6 +778,79 @@ DENG2_PIMPL(Bank)
         }
     }
 
+    /**
+     * Moves the least recently used items of a cache to a lower cache level until
+     * the cache no longer exceeds its maximum size. Items purged from the hot
+     * storage have their serialized copies deleted.
+     */
+    void purge(DataCache &cache)
+    {
+        if (cache.maxBytes() == Unlimited) return;
+
+        struct Usage
+        {
+            Data *item;
+            Time accessedAt;
+            dint64 size;
+        };
+        std::vector<Usage> usage;
+        dint64 excess = 0;
+        QList<Data *> items;
+        {
+            DENG2_GUARD(cache);
+            excess = cache.byteCount() - cache.maxBytes();
+            if (excess <= 0) return;
+            items = cache.items().toList();
+        }
+        for (Data *item : items)
+        {
+            DENG2_GUARD(item);
+            if (item->cache != &cache) continue;
+
+            dint64 const size = (&cache == &memoryCache? (item->data? item->data->sizeInMemory() : 0)
+                                                       : (item->serial? item->serial->size() : 0));
+            usage.push_back(Usage{ item, item->accessedAt, size });
+        }
+
+        // Items that have not been accessed are the first to go.
+        std::sort(usage.begin(), usage.end(), [] (Usage const &a, Usage const &b) {
+            if (!a.accessedAt.isValid()) return b.accessedAt.isValid();
+            if (!b.accessedAt.isValid()) return false;
+            return a.accessedAt < b.accessedAt;
+        });
+
+        for (Usage const &used : usage)
+        {
+            if (excess <= 0) break;
+            excess -= used.size;
+
+            if (&cache == &memoryCache)
+            {
+                unload(used.item->path(sepChar), serialCache? InHotStorage : InColdStorage,
+                       AfterQueued);
+            }
+            else
+            {
+                destroySerialized(*used.item);
+            }
+        }
+    }
+
+    void destroySerialized(Data &item)
+    {
+        DENG2_GUARD(item);
+
+        if (item.cache != serialCache.get() || !item.serial) return;
+
+        Folder *folder = item.serial->parent();
+        String const name = item.serial->name();
+        item.changeCache(sourceCache);
+        if (folder)
+        {
+            folder->tryDestroyFile(name);
+        }
+    }
+
     void notify(Notification const &notif)
     {
         notifications.put(new Notification(notif));
@@ -980,10 +1145,17 @@ void Bank::clearFromCache(DotPath const &path)
 
 void Bank::purge()
 {
-    /**
-     * @todo Implement cache purging (and different purging strategies?).
-     * Purge criteria can be age and cache level maximum limits.
-     */
+    LOG_AS(d->nameForLog);
+
+    d->purge(d->memoryCache);
+    if (d->serialCache)
+    {
+        d->purge(*d->serialCache);
+        if (d->serialCache->maxBytes() != Unlimited)
+        {
+            d->writeAccessIndex();
+        }
+    }
 }
 
 Bank::IData *Bank::newData()
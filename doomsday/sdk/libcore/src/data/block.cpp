@@ -22,6 +22,7 @@
 
 #include <QCryptographicHash>
 #include <cstring>
+#include <zlib.h>
 
 namespace de {
 
@@ -203,6 +204,87 @@ Block Block::decompressed() const
     return qUncompress(*this);
 }
 
+Block Block::compressed(int level, Block const &dictionary) const
+{
+    if (dictionary.isEmpty()) return compressed(level);
+
+    z_stream stream = {};
+    if (deflateInit(&stream, level) != Z_OK)
+    {
+        return Block();
+    }
+    deflateSetDictionary(&stream, dictionary.data(), uInt(dictionary.size()));
+
+    // Like qCompress(), the data begins with the uncompressed size (big-endian).
+    Block result(4 + deflateBound(&stream, uLong(size())));
+    Byte *out = result.data();
+    out[0] = Byte(size() >> 24);
+    out[1] = Byte(size() >> 16);
+    out[2] = Byte(size() >> 8);
+    out[3] = Byte(size());
+
+    stream.next_in   = const_cast<Byte *>(data());
+    stream.avail_in  = uInt(size());
+    stream.next_out  = out + 4;
+    stream.avail_out = uInt(result.size() - 4);
+
+    int const res = deflate(&stream, Z_FINISH);
+    result.resize(4 + stream.total_out);
+    deflateEnd(&stream);
+
+    if (res != Z_STREAM_END) return Block();
+    return result;
+}
+
+Block Block::decompressed(Block const &dictionary) const
+{
+    if (size() < 4) return Block();
+
+    Byte const *in = data();
+    dsize const expectedSize = (dsize(in[0]) << 24) | (dsize(in[1]) << 16) |
+                               (dsize(in[2]) << 8)  |  dsize(in[3]);
+
+    // Deflate cannot reach a ratio better than about 1:1032, so anything larger
+    // must be corrupt.
+    if (expectedSize > 1032 * size() + 64)
+    {
+        return Block();
+    }
+
+    Block result(expectedSize);
+    Byte empty = 0;
+
+    z_stream stream = {};
+    stream.next_in   = const_cast<Byte *>(in + 4);
+    stream.avail_in  = uInt(size() - 4);
+    stream.next_out  = (expectedSize? result.data() : &empty);
+    stream.avail_out = uInt(expectedSize);
+
+    if (inflateInit(&stream) != Z_OK)
+    {
+        return Block();
+    }
+    int res = inflate(&stream, Z_FINISH);
+    if (res == Z_NEED_DICT)
+    {
+        // inflateSetDictionary() checks that this is the dictionary that was used.
+        if (dictionary.isEmpty() ||
+            inflateSetDictionary(&stream, dictionary.data(), uInt(dictionary.size())) != Z_OK)
+        {
+            inflateEnd(&stream);
+            return Block();
+        }
+        res = inflate(&stream, Z_FINISH);
+    }
+    inflateEnd(&stream);
+
+    if (res != Z_STREAM_END || stream.total_out != expectedSize)
+    {
+        return Block();
+    }
+    return result;
+}
+
 Block Block::md5Hash() const
 {
     QCryptographicHash hash(QCryptographicHash::Md5);
@@ -25,7 +25,11 @@
 #include "de/data/huffman.h"
 #include "de/App"
 #include "de/Log"
-#include "de/ByteRefArray"
+#include "de/math.h"
+
+// Number of bits decoded with one table lookup.
+#define DECODE_TABLE_BITS   11
+#define DECODE_TABLE_SIZE   (1 << DECODE_TABLE_BITS)
 
 // Heap relations.
 #define HEAP_PARENT(i)  (((i) + 1)/2 - 1)
@@ -123,9 +127,13 @@ struct HuffCode {
     duint length;
 };
 
-struct HuffBuffer {
-    dbyte *data;
-    dsize size;
+/**
+ * Entry in the decoding table. The table is indexed with the next DECODE_TABLE_BITS
+ * bits of the coded data.
+ */
+struct HuffDecodeEntry {
+    HuffNode const *node;     // Leaf, or the subtree where longer codes continue.
+    duint length;             // Number of bits consumed.
 };
 
 struct Huffman
@@ -136,12 +144,18 @@ struct Huffman
     // The lookup table for encoding.
     HuffCode huffCodes[256];
 
+    // The lookup table for decoding.
+    HuffDecodeEntry decodeTable[DECODE_TABLE_SIZE];
+
+    duint minCodeLength;
+
     /**
      * Builds the Huffman tree and initializes the code lookup.
      */
-    Huffman() : huffRoot(0)
+    Huffman() : huffRoot(0), minCodeLength(32)
     {
         zap(huffCodes);
+        zap(decodeTable);
 
         HuffQueue queue;
         HuffNode *node;
@@ -174,6 +188,13 @@ struct Huffman
         // Fill in the code lookup table.
         Huff_BuildLookup(huffRoot, 0, 0);
 
+        for (i = 0; i < 256; ++i)
+        {
+            minCodeLength = de::min(minCodeLength, huffCodes[i].length);
+        }
+
+        Huff_BuildDecodeTable();
+
 #if 0
         if (qApp->arguments().contains("-huffcodes"))
         {
@@ -327,19 +348,24 @@ struct Huffman
     }
 
     /**
-     * Checks if the encoding/decoding buffer can hold the given number of
-     * bytes. If not, reallocates the buffer.
+     * Builds the decoding table by following each possible sequence of
+     * DECODE_TABLE_BITS bits from the root of the tree.
      */
-    static void Huff_ResizeBuffer(HuffBuffer *buffer, dsize neededSize)
+    void Huff_BuildDecodeTable()
     {
-        while (neededSize > buffer->size)
+        for (duint index = 0; index < DECODE_TABLE_SIZE; ++index)
         {
-            if (!buffer->size)
-                buffer->size = qMax(dsize(1024), neededSize);
-            else
-                buffer->size *= 2;
+            HuffNode const *node = huffRoot;
+            duint length = 0;
+            while (length < DECODE_TABLE_BITS && (node->left || node->right))
+            {
+                node = (index & (1 << length)? node->right : node->left);
+                DENG2_ASSERT(node);
+                ++length;
+            }
+            decodeTable[index].node   = node;
+            decodeTable[index].length = length;
         }
-        buffer->data = reinterpret_cast<dbyte *>(realloc(buffer->data, buffer->size));
     }
 
     /**
@@ -355,146 +381,126 @@ struct Huffman
         }
     }
 
-    /**
-     * Free the buffer.
-     */
-    void Huff_DestroyBuffer(HuffBuffer *buffer)
-    {
-        free(buffer->data);
-        zapPtr(buffer);
-    }
-
-    dbyte *encode(dbyte const *data, dsize size, dsize *encodedSize) const
+    Block encode(dbyte const *data, dsize size) const
     {
-        HuffBuffer huffEnc;
-        dsize i;
-        duint code;
-        int remaining, fits;
-        dbyte *out, bit;
-
-        zap(huffEnc);
-
-        // The encoded message is never twice the original size
-        // (longest codes are currently 11 bits).
-        Huff_ResizeBuffer(&huffEnc, 2 * size);
-
-        // First three bits of the encoded data contain the number of bits (-1)
-        // in the last dbyte of the encoded data. It's written when we have
+        // The first three bits of the encoded data contain the number of bits (-1)
+        // in the last byte of the encoded data. They are written when we have
         // finished the encoding.
-        bit = 3;
+        dsize const totalBits = 3 + Huff_CodedBits(data, size);
+
+        Block result((totalBits + 7) / 8);
+        dbyte *out = result.data();
 
-        // Clear the first dbyte of the result.
-        out = huffEnc.data;
-        *out = 0;
+        // Bits waiting to be written, least significant bit first. Codes are
+        // shorter than 32 bits, so there is always room for one more code.
+        duint64 pending = 0;
+        duint pendingBits = 3;
 
-        for (i = 0; i < size; ++i)
+        for (dsize i = 0; i < size; ++i)
         {
-            remaining = huffCodes[data[i]].length;
-            code = huffCodes[data[i]].code;
+            HuffCode const &hc = huffCodes[data[i]];
+            pending |= duint64(hc.code) << pendingBits;
+            pendingBits += hc.length;
 
-            while (remaining > 0)
+            if (pendingBits >= 32)
             {
-                fits = 8 - bit;
-                if (fits > remaining)
-                    fits = remaining;
-
-                // Write the bits that fit the current dbyte.
-                *out |= code << bit;
-                code >>= fits;
-                remaining -= fits;
-
-                // Advance the bit position.
-                bit += fits;
-                if (bit == 8)
-                {
-                    bit = 0;
-                    *++out = 0;
-                }
+                // Write a full word.
+                out[0] = dbyte(pending);
+                out[1] = dbyte(pending >> 8);
+                out[2] = dbyte(pending >> 16);
+                out[3] = dbyte(pending >> 24);
+                out += 4;
+                pending >>= 32;
+                pendingBits -= 32;
             }
         }
 
-        // If the last dbyte is empty, back up.
-        if (bit == 0)
+        // Write the remaining bits.
+        while (pendingBits > 0)
         {
-            out--;
-            bit = 8;
+            *out++ = dbyte(pending);
+            pending >>= 8;
+            pendingBits = (pendingBits > 8? pendingBits - 8 : 0);
         }
+        DENG2_ASSERT(out == result.data() + result.size());
 
-        if (encodedSize)
-            *encodedSize = out - huffEnc.data + 1;
+        // The number of valid bits - 1 in the last byte.
+        result.data()[0] |= ((totalBits - 1) & 7);
 
-        // The number of valid bits - 1 in the last dbyte.
-        huffEnc.data[0] |= bit - 1;
+        return result;
+    }
 
-        return huffEnc.data;
+    /**
+     * Calculates the number of bits needed for encoding the data.
+     */
+    dsize Huff_CodedBits(dbyte const *data, dsize size) const
+    {
+        dsize bits = 0;
+        for (dsize i = 0; i < size; ++i)
+        {
+            bits += huffCodes[data[i]].length;
+        }
+        return bits;
     }
 
-    dbyte *decode(dbyte const *data, dsize size, dsize *decodedSize) const
+    Block decode(dbyte const *data, dsize size) const
     {
-        HuffBuffer huffDec;
-        HuffNode *node;
-        dsize outBytes = 0;
-        dbyte const *in = data;
-        dbyte const *lastIn = in + size - 1;
-        dbyte bit = 3, lastByteBits;
+        if (!data || size == 0) return Block();
 
-        if (!data || size == 0) return nullptr;
+        // The first three bits contain the number of valid bits in the last byte.
+        dsize const endBit = (size - 1) * 8 + (data[0] & 7) + 1;
+        dsize bitPos = 3;
 
-        zap(huffDec);
-        Huff_ResizeBuffer(&huffDec, 256);
+        // Every value needs at least the shortest code.
+        Block result(endBit / minCodeLength + 1);
+        dbyte *out = result.data();
 
-        // The first three bits contain the number of valid bits in
-        // the last dbyte.
-        lastByteBits = (*in & 7) + 1;
+        // Bits read from the input, least significant bit first.
+        duint64 window = 0;
+        duint windowBits = 0;
+        dsize nextByte = 0;
 
-        // Start from the root node.
-        node = huffRoot;
+        // Skip the header bits.
+        window = data[nextByte++] >> 3;
+        windowBits = 5;
 
-        while (in < lastIn || bit < lastByteBits)
+        while (bitPos < endBit)
         {
-            // Go left or right?
-            if (*in & (1 << bit))
+            // Make sure there are enough bits in the window for a table lookup.
+            while (windowBits <= 56 && nextByte < size)
             {
-                node = node->right;
+                window |= duint64(data[nextByte++]) << windowBits;
+                windowBits += 8;
             }
-            else
+
+            HuffDecodeEntry const &entry = decodeTable[window & (DECODE_TABLE_SIZE - 1)];
+            HuffNode const *node = entry.node;
+            duint length = entry.length;
+
+            // Longer codes continue one bit at a time.
+            while (node->left || node->right)
             {
-                node = node->left;
+                node = (window & (duint64(1) << length)? node->right : node->left);
+                DENG2_ASSERT(node);
+                ++length;
             }
 
-            // Did we arrive at a leaf?
-            DENG2_ASSERT(node);
-            if (!node->left && !node->right)
+            if (bitPos + length > endBit)
             {
-                // This node represents a value.
-                huffDec.data[outBytes++] = node->value;
-
-                // Should we allocate more memory?
-                if (outBytes == huffDec.size)
-                {
-                    Huff_ResizeBuffer(&huffDec, 2 * huffDec.size);
-                }
-
-                // Back to the root.
-                node = huffRoot;
+                // The rest is padding.
+                break;
             }
 
-            // Advance bit position.
-            if (++bit == 8)
-            {
-                bit = 0;
-                ++in;
+            // This node represents a value.
+            *out++ = node->value;
 
-                // Out of buffer?
-                if (in > lastIn)
-                    break;
-            }
-        }
-        if (decodedSize)
-        {
-            *decodedSize = outBytes;
+            window >>= length;
+            windowBits -= length;
+            bitPos += length;
         }
-        return huffDec.data;
+
+        result.resize(out - result.data());
+        return result;
     }
 };
 
@@ -504,28 +510,12 @@ static internal::Huffman huff;
 
 Block codec::huffmanEncode(Block const &data)
 {
-    Block result;
-    dsize size = 0;
-    dbyte *coded = huff.encode(data.data(), data.size(), &size);
-    if (coded)
-    {
-        result.copyFrom(ByteRefArray(coded, size), 0, size);
-        free(coded);
-    }
-    return result;
+    return huff.encode(data.data(), data.size());
 }
 
 Block codec::huffmanDecode(Block const &codedData)
 {
-    Block result;
-    dsize size = 0;
-    dbyte *decoded = huff.decode(codedData.data(), codedData.size(), &size);
-    if (decoded)
-    {
-        result.copyFrom(ByteRefArray(decoded, size), 0, size);
-        free(decoded);
-    }
-    return result;
+    return huff.decode(codedData.data(), codedData.size());
 }
 
 } // namespace de
@@ -65,6 +65,7 @@ DENG2_PIMPL(Record)
     Record::Members members;
     duint32 uniqueId; ///< Identifier to track serialized references.
     duint32 oldUniqueId;
+    std::atomic<duint32> membershipVersion { 0 };
     Flags flags = DefaultFlags;
 
     typedef QHash<duint32, Record *> RefMap;
@@ -113,6 +114,7 @@ DENG2_PIMPL(Record)
             }
 
             members = remaining;
+            membershipVersion++;
         }
     }
 
@@ -143,6 +145,7 @@ DENG2_PIMPL(Record)
                     {
                         members[i.key()] = var;
                     }
+                    membershipVersion++;
                 }
 
                 if (!alreadyExists)
@@ -206,6 +209,7 @@ DENG2_PIMPL(Record)
                     var = new Variable(*i.value());
                     var->audienceForDeletion() += this;
                     members[i.key()] = var;
+                    membershipVersion++;
                 }
             }
         }
@@ -222,6 +226,7 @@ DENG2_PIMPL(Record)
                 iter.remove();
                 var->audienceForDeletion() -= this;
                 delete var;
+                membershipVersion++;
             }
         }
     }
@@ -345,6 +350,7 @@ DENG2_PIMPL(Record)
         // Remove from our index.
         DENG2_GUARD(this);
         members.remove(variable.name());
+        membershipVersion++;
     }
 
     static String memberNameFromPath(String const &path)
@@ -532,6 +538,7 @@ Variable &Record::add(Variable *variable)
         }
         var->audienceForDeletion() += d;
         d->members[variable->name()] = var.release();
+        d->membershipVersion++;
     }
 
     DENG2_FOR_AUDIENCE2(Addition, i) i->recordMemberAdded(*this, *variable);
@@ -545,6 +552,7 @@ Variable *Record::remove(Variable &variable)
         DENG2_GUARD(d);
         variable.audienceForDeletion() -= d;
         d->members.remove(variable.name());
+        d->membershipVersion++;
     }
 
     DENG2_FOR_AUDIENCE2(Removal, i) i->recordMemberRemoved(*this, variable);
@@ -934,6 +942,16 @@ Record::Members const &Record::members() const
     return d->members;
 }
 
+duint32 Record::uniqueId() const
+{
+    return d->uniqueId;
+}
+
+duint32 Record::membershipVersion() const
+{
+    return d->membershipVersion;
+}
+
 LoopResult Record::forMembers(std::function<LoopResult (String const &, Variable &)> func)
 {
     for (Members::iterator i = d->members.begin(); i != d->members.end(); ++i)
@@ -29,13 +29,16 @@
 #include "de/LogBuffer"
 #include "de/MetadataBank"
 #include "de/Reader"
+#include "de/TaskScheduler"
 #include "de/Writer"
 #include "de/Zeroed"
 
 // Interpretations:
 #include "de/ArchiveFolder"
 
+#include <QThreadStorage>
 #include <cstring>
+#include <vector>
 #include <zlib.h>
 
 namespace de {
@@ -57,6 +60,12 @@ namespace internal {
 // Deflate minimum compression. Worse than this will be stored uncompressed.
 #define REQUIRED_DEFLATE_PERCENTAGE .98
 
+// Entries larger than this are compressed in several chunks concurrently.
+#define DEFLATE_CHUNK_SIZE      (256 * 1024)
+
+// Size of the deflate window (history available to a chunk).
+#define DEFLATE_WINDOW_SIZE     (1 << MAX_WBITS)
+
 // File header flags.
 #define ZFH_ENCRYPTED           0x1
 #define ZFH_COMPRESSION_OPTS    0x6
@@ -257,6 +266,60 @@ struct CentralEnd : public ISerializable {
     }
 };
 
+/**
+ * Raw inflate stream that is reused for all the entries inflated in a thread, so that
+ * the stream state doesn't have to be allocated and initialized for every entry.
+ */
+struct Inflater
+{
+    z_stream stream;
+    bool isReady;
+
+    Inflater()
+    {
+        zap(stream);
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+
+        /*
+         * Set up a raw inflate with a window of -15 bits.
+         *
+         * From zlib documentation:
+         *
+         * "windowBits can also be –8..–15 for raw inflate. In this case,
+         * -windowBits determines the window size. inflate() will then process
+         * raw deflate data, not looking for a zlib or gzip header, not
+         * generating a check value, and not looking for any check values for
+         * comparison at the end of the stream. This is for use with other
+         * formats that use the deflate compressed data format such as 'zip'."
+         */
+        isReady = (inflateInit2(&stream, -MAX_WBITS) == Z_OK);
+    }
+
+    ~Inflater()
+    {
+        if (isReady) inflateEnd(&stream);
+    }
+
+    /**
+     * Returns the calling thread's inflate stream, ready for a new entry.
+     */
+    static z_stream *get()
+    {
+        static QThreadStorage<Inflater *> inflaters;
+        if (!inflaters.hasLocalData())
+        {
+            inflaters.setLocalData(new Inflater);
+        }
+        Inflater *inflater = inflaters.localData();
+        if (!inflater->isReady || inflateReset(&inflater->stream) != Z_OK)
+        {
+            return nullptr;
+        }
+        return &inflater->stream;
+    }
+};
+
 } // namespace internal
 
 using namespace internal;
@@ -432,6 +495,156 @@ DENG2_PIMPL(ZipArchive)
         writer << duint32(SIG_END_OF_CENTRAL_DIR) << zipSummary;
     }
 
+    /**
+     * Determines if the data of an entry can be copied as-is from the source archive.
+     */
+    bool isReusable(ZipEntry const &entry) const
+    {
+        return (entry.dataInArchive || self().source()) && !entry.maybeChanged;
+    }
+
+    /**
+     * Compresses a chunk of an entry's data using raw deflate (no zlib header).
+     *
+     * A chunk that is not the last one ends with a sync flush, so it ends on a byte
+     * boundary with no end-of-stream marker. The chunks of an entry can then be
+     * joined together to form a single deflate stream. Each chunk is primed with the
+     * data preceding it, so matches may refer to the end of the previous chunk.
+     *
+     * @param data    Data of the entry.
+     * @param offset  Start of the chunk.
+     * @param size    Size of the chunk.
+     * @param last    This is the last chunk of the entry.
+     *
+     * @return Deflated chunk.
+     */
+    static Block deflateChunk(IByteArray::Byte const *data, dsize offset, dsize size, bool last)
+    {
+        z_stream stream;
+        zap(stream);
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+
+        /*
+         * The deflation is done in raw mode. From zlib documentation:
+         *
+         * "windowBits can also be –8..–15 for raw deflate. In this case,
+         * -windowBits determines the window size. deflate() will then
+         * generate raw deflate data with no zlib header or trailer, and
+         * will not compute an adler32 check value."
+         */
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                        -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            /// @throw DeflateError  zlib error: could not initialize deflate operation.
+            throw DeflateError("ZipArchive::deflateChunk", "Deflate init failed");
+        }
+        if (offset > 0)
+        {
+            dsize const history = de::min(offset, dsize(DEFLATE_WINDOW_SIZE));
+            deflateSetDictionary(&stream, data + offset - history, uInt(history));
+        }
+
+        // The sync flush adds an empty stored block on top of the worst case.
+        Block deflated(deflateBound(&stream, uLong(size)) + 16);
+        stream.next_in = const_cast<IByteArray::Byte *>(data + offset);
+        stream.avail_in = uInt(size);
+        stream.next_out = deflated.data();
+        stream.avail_out = uInt(deflated.size());
+
+        int const result = deflate(&stream, last? Z_FINISH : Z_SYNC_FLUSH);
+        deflated.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        if (result != (last? Z_STREAM_END : Z_OK) || stream.avail_in > 0)
+        {
+            /// @throw DeflateError  zlib error: compression failed.
+            throw DeflateError("ZipArchive::deflateChunk", "Deflate failed");
+        }
+        return deflated;
+    }
+
+    /**
+     * Compresses the contents of the entries that cannot be copied from the source
+     * archive, and updates the sizes and CRCs of all the entries. The work is done
+     * concurrently: entries are compressed in parallel, and large entries are split
+     * into chunks that are compressed in parallel (like pigz does).
+     *
+     * @param entries  Entries of the archive.
+     *
+     * @return Deflated contents of each entry. Empty for reusable entries.
+     */
+    QVector<Block> deflateEntries(QVector<ZipEntry *> const &entries) const
+    {
+        struct Chunk
+        {
+            int entry;
+            dsize offset;
+            dsize size;
+            Block deflated;
+            duint32 crc;
+        };
+
+        // Reusable entries only need updating; everything else is split into chunks.
+        std::vector<Chunk> chunks;
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            ZipEntry const &entry = *entries.at(i);
+            if (isReusable(entry))
+            {
+                chunks.push_back(Chunk { i, 0, 0, Block(), 0 });
+                continue;
+            }
+            DENG2_ASSERT(entry.data != NULL);
+            dsize const size = entry.data->size();
+            dsize offset = 0;
+            do
+            {
+                dsize const len = de::min(size - offset, dsize(DEFLATE_CHUNK_SIZE));
+                chunks.push_back(Chunk { i, offset, len, Block(), 0 });
+                offset += len;
+            }
+            while (offset < size);
+        }
+
+        parallelFor(chunks.size(), [this, &entries, &chunks] (dsize start, dsize end)
+        {
+            for (dsize c = start; c < end; ++c)
+            {
+                Chunk &chunk = chunks[c];
+                ZipEntry &entry = *entries.at(chunk.entry);
+                if (isReusable(entry))
+                {
+                    entry.update();
+                    continue;
+                }
+                IByteArray::Byte const *data = entry.data->data();
+                bool const last = (chunk.offset + chunk.size == entry.data->size());
+                chunk.deflated = deflateChunk(data, chunk.offset, chunk.size, last);
+                chunk.crc = ::crc32(0L, data + chunk.offset, uInt(chunk.size));
+            }
+        }, 1);
+
+        // Join the chunks of each entry.
+        QVector<Block> deflated(entries.size());
+        for (Chunk const &chunk : chunks)
+        {
+            ZipEntry &entry = *entries.at(chunk.entry);
+            if (isReusable(entry)) continue;
+            if (chunk.offset == 0)
+            {
+                entry.size  = entry.data->size();
+                entry.crc32 = chunk.crc;
+            }
+            else
+            {
+                entry.crc32 = ::crc32_combine(entry.crc32, chunk.crc, z_off_t(chunk.size));
+            }
+            deflated[chunk.entry] += chunk.deflated;
+        }
+        return deflated;
+    }
+
     /**
      * Writes a new central directory for a new ZIP archive as it will be written by
      * ZipArchive.
@@ -580,49 +793,33 @@ void ZipArchive::readFromSource(Entry const &e, Path const &, IBlock &uncompress
             entry.dataInArchive.reset(new Block(*source(), entry.offset, entry.sizeInArchive));
         }
 
-        z_stream stream;
-        zap(stream);
-        stream.next_in = const_cast<IByteArray::Byte *>(entry.dataInArchive->data());
-        stream.avail_in = entry.sizeInArchive;
-        stream.zalloc = Z_NULL;
-        stream.zfree = Z_NULL;
-        stream.next_out = const_cast<IByteArray::Byte *>(uncompressedData.data());
-        stream.avail_out = entry.size;
-
-        /*
-         * Set up a raw inflate with a window of -15 bits.
-         *
-         * From zlib documentation:
-         *
-         * "windowBits can also be –8..–15 for raw inflate. In this case,
-         * -windowBits determines the window size. inflate() will then process
-         * raw deflate data, not looking for a zlib or gzip header, not
-         * generating a check value, and not looking for any check values for
-         * comparison at the end of the stream. This is for use with other
-         * formats that use the deflate compressed data format such as 'zip'."
-         */
-        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        z_stream *stream = Inflater::get();
+        if (!stream)
         {
             /// @throw InflateError Problem with zlib: inflateInit2 failed.
             throw InflateError("ZipArchive::readEntry",
                                "Inflation failed because initialization failed");
         }
+        stream->next_in = const_cast<IByteArray::Byte *>(entry.dataInArchive->data());
+        stream->avail_in = entry.sizeInArchive;
+        stream->next_out = const_cast<IByteArray::Byte *>(uncompressedData.data());
+        stream->avail_out = entry.size;
 
         // Do the inflation in one call.
-        dint result = inflate(&stream, Z_FINISH);
+        dint result = inflate(stream, Z_FINISH);
 
-        if (stream.total_out != entry.size)
+        if (stream->total_out != entry.size)
         {
             /// @throw InflateError The actual decompressed size is not equal to the
             /// size listed in the central directory.
             throw InflateError("ZipArchive::readEntry",
                                "Failure due to " +
                                String((result == Z_DATA_ERROR ? "corrupt data in archive"
-                                                              : "zlib error")) + ": " + stream.msg);
+                                                              : "zlib error")) + ": " +
+                               (stream->msg? stream->msg : "unexpected size"));
         }
 
         // We're done.
-        inflateEnd(&stream);
         entry.dataInArchive.reset(); // Now have the decompressed version.
     }
 }
@@ -640,12 +837,20 @@ void ZipArchive::operator >> (Writer &to) const
      */
     Writer writer(to, littleEndianByteOrder);
 
-    // First write the local headers and entry contents.
+    QVector<ZipEntry *> entries;
     for (PathTreeIterator<Index> iter(index().leafNodes()); iter.hasNext(); )
     {
         // We will be updating relevant members of the entry.
-        ZipEntry &entry = iter.next();
-        entry.update();
+        entries << &iter.next();
+    }
+
+    // Compress everything beforehand, in parallel.
+    QVector<Block> const deflated = d->deflateEntries(entries);
+
+    // First write the local headers and entry contents.
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        ZipEntry &entry = *entries.at(i);
 
         String const fullPath = entry.path();
 
@@ -665,7 +870,7 @@ void ZipArchive::operator >> (Writer &to) const
         header.fileNameSize = fullPath.size();
 
         // Can we use the data already in the source archive?
-        if ((entry.dataInArchive || source()) && !entry.maybeChanged)
+        if (d->isReusable(entry))
         {
             // Yes, we can.
             writer << header << FixedByteArray(fullPath.toLatin1());
@@ -682,59 +887,23 @@ void ZipArchive::operator >> (Writer &to) const
             // Written to new location.
             entry.offset = newOffset;
         }
+        else if (deflated.at(i).size() <= Block::Size(REQUIRED_DEFLATE_PERCENTAGE * entry.data->size()))
+        {
+            // Compression was ok.
+            header.compression = entry.compression = DEFLATED;
+            header.compressedSize = entry.sizeInArchive = deflated.at(i).size();
+            writer << header << FixedByteArray(fullPath.toLatin1());
+            entry.offset = writer.offset();
+            writer << FixedByteArray(deflated.at(i));
+        }
         else
         {
-            DENG2_ASSERT(entry.data != NULL);
-
-            // Let's try and compress.
-            Block archived(Block::Size(REQUIRED_DEFLATE_PERCENTAGE * entry.data->size()));
-
-            z_stream stream;
-            zap(stream);
-            stream.next_in = const_cast<IByteArray::Byte *>(entry.data->data());
-            stream.avail_in = entry.data->size();
-            stream.zalloc = Z_NULL;
-            stream.zfree = Z_NULL;
-            stream.next_out = const_cast<IByteArray::Byte *>(archived.data());
-            stream.avail_out = archived.size();
-
-            /*
-             * The deflation is done in raw mode. From zlib documentation:
-             *
-             * "windowBits can also be –8..–15 for raw deflate. In this case,
-             * -windowBits determines the window size. deflate() will then
-             * generate raw deflate data with no zlib header or trailer, and
-             * will not compute an adler32 check value."
-             */
-            if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
-                            -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
-            {
-                /// @throw DeflateError  zlib error: could not initialize deflate operation.
-                throw DeflateError("ZipArchive::operator >>", "Deflate init failed");
-            }
-
-            int result = deflate(&stream, Z_FINISH);
-            if (result == Z_STREAM_END)
-            {
-                // Compression was ok.
-                header.compression = entry.compression = DEFLATED;
-                header.compressedSize = entry.sizeInArchive = stream.total_out;
-                writer << header << FixedByteArray(fullPath.toLatin1());
-                entry.offset = writer.offset();
-                writer << FixedByteArray(archived, 0, entry.sizeInArchive);
-            }
-            else
-            {
-                // We won't compress.
-                header.compression = entry.compression = NO_COMPRESSION;
-                header.compressedSize = entry.sizeInArchive = entry.data->size();
-                writer << header << FixedByteArray(fullPath.toLatin1());
-                entry.offset = writer.offset();
-                writer << FixedByteArray(*entry.data);
-            }
-
-            // Clean up.
-            deflateEnd(&stream);
+            // We won't compress.
+            header.compression = entry.compression = NO_COMPRESSION;
+            header.compressedSize = entry.sizeInArchive = entry.data->size();
+            writer << header << FixedByteArray(fullPath.toLatin1());
+            entry.offset = writer.offset();
+            writer << FixedByteArray(*entry.data);
         }
     }
 
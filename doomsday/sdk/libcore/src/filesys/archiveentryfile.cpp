@@ -133,7 +133,8 @@ void ArchiveEntryFile::uncache() const
 {
     DENG2_GUARD(this);
 
-    if (d->readBlock)
+    // Prefetched contents are released even if they were never read.
+    if (d->readBlock || archive().hasEntry(d->entryPath))
     {
         archive().uncacheBlock(d->entryPath);
         d->readBlock = nullptr;
@@ -19,6 +19,8 @@
 #include "de/PackageLoader"
 
 #include "de/App"
+#include "de/ArchiveEntryFile"
+#include "de/ArchiveFolder"
 #include "de/CommandLine"
 #include "de/Config"
 #include "de/DictionaryValue"
@@ -38,11 +40,18 @@ namespace de {
 
 static String const VAR_PACKAGE_VERSION("package.version");
 
+/// Maximum total amount of package contents decompressed in advance, for all the
+/// loaded packages.
+static dsize const PREFETCH_BUDGET = 32 * 1024 * 1024;
+
 DENG2_PIMPL(PackageLoader)
 , DENG2_OBSERVES(File, Deletion) // loaded package source file is deleted?
 {
     LoadedPackages loaded; ///< Identifiers are unversioned; only one version can be loaded at a time.
     int loadCounter;
+    bool prefetchEnabled = false;
+    QHash<String, dsize> prefetchedSizes; ///< Amount of prefetched contents per package.
+    dsize prefetchedTotal = 0;
 
     Impl(Public *i) : Base(i), loadCounter(0)
     {}
@@ -249,6 +258,7 @@ DENG2_PIMPL(PackageLoader)
         }
 
         Package *pkg = new Package(source);
+        prefetchContents(packageId, pkg->root());
         loaded.insert(packageId, pkg);
         pkg->setOrder(loadCounter++);
         pkg->didLoad();
@@ -257,6 +267,61 @@ DENG2_PIMPL(PackageLoader)
         return *pkg;
     }
 
+    static void collectEntryPaths(Folder const &folder, Archive const &archive,
+                                  QList<Path> &paths)
+    {
+        for (File *file : folder.contents().values())
+        {
+            // Interpreted files keep the entry as their source.
+            if (auto const *entryFile = maybeAs<ArchiveEntryFile>(file->source()))
+            {
+                if (&entryFile->archive() == &archive)
+                {
+                    paths << entryFile->entryPath();
+                }
+            }
+            else if (auto const *subfolder = maybeAs<Folder>(file))
+            {
+                collectEntryPaths(*subfolder, archive, paths);
+            }
+        }
+    }
+
+    /**
+     * Decompresses the contents of a package in advance, so that the files of the
+     * package can be read without decompressing them one at a time. The contents
+     * of all the loaded packages together are limited to PREFETCH_BUDGET.
+     *
+     * @param packageId  Identifier of the package.
+     * @param root       Root folder of the package.
+     */
+    void prefetchContents(String const &packageId, Folder const &root)
+    {
+        if (!prefetchEnabled || prefetchedTotal >= PREFETCH_BUDGET) return;
+
+        auto const *archiveFolder = maybeAs<ArchiveFolder>(root);
+        if (!archiveFolder) return;
+
+        try
+        {
+            Archive &archive = const_cast<ArchiveFolder *>(archiveFolder)->archive();
+            QList<Path> paths;
+            collectEntryPaths(root, archive, paths);
+            dsize const size = archive.prefetch(paths, PREFETCH_BUDGET - prefetchedTotal);
+            if (size)
+            {
+                prefetchedSizes.insert(packageId, size);
+                prefetchedTotal += size;
+            }
+            LOG_RES_XVERBOSE("Prefetched %i bytes of %s", size << root.description());
+        }
+        catch (Error const &er)
+        {
+            LOG_RES_WARNING("Failed to prefetch contents of %s: %s")
+                    << root.description() << er.asText();
+        }
+    }
+
     bool unload(String identifier)
     {
         LoadedPackages::iterator found = loaded.find(identifier);
@@ -270,6 +335,7 @@ DENG2_PIMPL(PackageLoader)
         }
         delete pkg;
         loaded.remove(identifier);
+        prefetchedTotal -= prefetchedSizes.take(identifier);
         return true;
     }
 
@@ -501,6 +567,11 @@ void PackageLoader::unload(String const &packageId)
     }
 }
 
+void PackageLoader::setPrefetchEnabled(bool enabled)
+{
+    d->prefetchEnabled = enabled;
+}
+
 void PackageLoader::unloadAll()
 {
     LOG_AS("PackageLoader");
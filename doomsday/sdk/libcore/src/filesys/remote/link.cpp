@@ -290,6 +290,9 @@ void Link::chunkReceived(QueryId id, duint64 startOffset, Block const &chunk, du
         if (!query->fileSize)
         {
             query->fileContents->call(0, Block(), fileSize);
+
+            // A resumed transfer begins after the previously received bytes.
+            query->receivedBytes = startOffset;
         }
 
         query->fileSize = fileSize;
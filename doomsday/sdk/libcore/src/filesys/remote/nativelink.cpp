@@ -160,6 +160,7 @@ void NativeLink::transmit(Query const &query)
     else if (query.fileContents)
     {
         packet.setQuery(RemoteFeedQueryPacket::FileContents);
+        packet.setStartOffset(query.startOffset);
     }
     d->socket.sendPacket(packet);
 }
@@ -27,28 +27,89 @@
 #include "de/TextValue"
 #include "de/TimeValue"
 
+#include <QSet>
+
 namespace de {
 
 using namespace de::filesys;
 
 String const RemoteFile::CACHE_PATH = "/home/cache/remote";
 
+/// Files whose contents are currently being downloaded (only accessed in the main thread).
+static QSet<RemoteFile *> downloadsInProgress;
+
 DENG2_PIMPL(RemoteFile)
 {
     String remotePath;
     Block remoteMetaId;
     String repositoryAddress; // If empty, use feed's repository.
     Block buffer;
+    duint64 receivedBytes = 0; ///< Contiguous bytes received at the start of the buffer.
     Request<FileContents> fetching;
 
     Impl(Public *i) : Base(i) {}
 
     ~Impl()
     {
+        // The file system may already be going away, so the received data is not
+        // kept here. RemoteFile::cancelAllDownloads() does that during shutdown.
         if (fetching)
         {
             fetching->cancel();
         }
+        downloadsInProgress.remove(&self());
+    }
+
+    String partialCachePath() const
+    {
+        return cachePath() + ".part";
+    }
+
+    /**
+     * Keeps the data received so far in the cache, so that an interrupted download
+     * can later be resumed.
+     */
+    void savePartialDownload()
+    {
+        if (!receivedBytes) return;
+        try
+        {
+            String const fn = partialCachePath();
+            File &data = FS::get().makeFolder(fn.fileNamePath()).replaceFile(fn);
+            data << buffer.left(receivedBytes);
+            data.flush();
+        }
+        catch (Error const &er)
+        {
+            LOG_NET_WARNING("Failed to keep partial download of \"%s\": %s")
+                    << remotePath << er.asText();
+        }
+    }
+
+    /**
+     * Loads the data of a previously interrupted download into the buffer.
+     *
+     * @return Number of bytes already available.
+     */
+    duint64 loadPartialDownload()
+    {
+        buffer.clear();
+        receivedBytes = 0;
+        try
+        {
+            if (File const *partial = FS::tryLocate<File const>(partialCachePath()))
+            {
+                *partial >> buffer;
+                receivedBytes = buffer.size();
+            }
+        }
+        catch (Error const &er)
+        {
+            LOG_NET_WARNING("Failed to read partial download of \"%s\": %s")
+                    << remotePath << er.asText();
+            buffer.clear();
+        }
+        return receivedBytes;
     }
 
     String cachePath() const
@@ -147,7 +208,18 @@ void RemoteFile::download()
         return;
     }
 
-    LOG_NET_MSG("Requesting download of \"%s\"") << name();
+    // Continue where an interrupted download left off.
+    duint64 const resumeOffset = d->loadPartialDownload();
+    if (resumeOffset)
+    {
+        LOG_NET_MSG("Resuming download of \"%s\" after %i bytes") << name() << resumeOffset;
+    }
+    else
+    {
+        LOG_NET_MSG("Requesting download of \"%s\"") << name();
+    }
+
+    downloadsInProgress.insert(this);
 
     d->fetching = filesys::RemoteFeedRelay::get().fetchFileContents
             (d->repository(),
@@ -168,20 +240,31 @@ void RemoteFile::download()
 
         d->buffer.set(startOffset, chunk.data(), chunk.size());
 
+        // Track how much of the beginning of the file has been received.
+        if (startOffset <= d->receivedBytes)
+        {
+            d->receivedBytes = de::max(d->receivedBytes, startOffset + chunk.size());
+        }
+
         // When fully transferred, the file can be cached locally and interpreted.
         if (remainingBytes == 0)
         {
             LOG_NET_MSG("\"%s\" downloaded (%i bytes)") << name() << d->buffer.size();
 
             d->fetching = nullptr;
+            downloadsInProgress.remove(this);
 
             String const fn = d->cachePath();
             Folder &cacheFolder = FS::get().makeFolder(fn.fileNamePath());
             File &data = cacheFolder.replaceFile(fn);
             data << d->buffer;
             d->buffer.clear();
+            d->receivedBytes = 0;
             data.flush();
 
+            // The partial download is no longer needed.
+            FS::get().root().tryDestroyFile(d->partialCachePath());
+
             // Override the last modified time.
             {
                 auto st = data.status();
@@ -204,7 +287,8 @@ void RemoteFile::download()
             // Now this RemoteFile can become the source of an interpreted file,
             // which replaces the RemoteFile within the parent folder.
         }
-    });
+    },
+    resumeOffset);
 }
 
 void RemoteFile::cancelDownload()
@@ -213,15 +297,29 @@ void RemoteFile::cancelDownload()
     {
         d->fetching->cancel();
         d->fetching = nullptr;
+        downloadsInProgress.remove(this);
+        d->savePartialDownload();
         d->buffer.clear();
+        d->receivedBytes = 0;
         setState(NotReady);
     }
 }
 
+void RemoteFile::cancelAllDownloads()
+{
+    DENG2_ASSERT_IN_MAIN_THREAD();
+
+    for (RemoteFile *file : QSet<RemoteFile *>(downloadsInProgress))
+    {
+        file->cancelDownload();
+    }
+}
+
 void RemoteFile::deleteCache()
 {
     setState(NotReady);
     FS::get().root().tryDestroyFile(d->cachePath());
+    FS::get().root().tryDestroyFile(d->partialCachePath());
 }
 
 IIStream const &RemoteFile::operator >> (IByteArray &bytes) const
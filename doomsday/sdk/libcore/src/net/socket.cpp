@@ -62,6 +62,16 @@
  * Messages larger than or equal to 2^22 bytes (about 4MB) must be broken into
  * smaller pieces before sending.
  *
+ * @par Preset dictionary
+ * If both ends of the connection have agreed to use the same preset deflate
+ * dictionary (see Socket::setDeflateDictionary()), deflate is also tried for
+ * messages that would fit in the small format, and the deflated payloads are
+ * compressed using the dictionary. The headers are unchanged: the zlib stream
+ * itself indicates that a dictionary is needed and identifies the dictionary.
+ * The dictionary used for inflating received messages is set separately
+ * (Socket::setInflateDictionary()), so that a peer can be ready to receive
+ * messages compressed with the dictionary before it starts sending them.
+ *
  * @see Protocol_Send()
  * @see Protocol_Receive()
  */
@@ -73,7 +83,11 @@
 #include "de/Reader"
 #include "de/data/huffman.h"
 
+#include <QPointer>
 #include <QThread>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace de {
 
@@ -191,15 +205,126 @@ struct MessageHeader : public ISerializable
     }
 };
 
+/**
+ * Chooses the appropriate compression method for a message payload and compresses it.
+ *
+ * @param header      Header of the message.
+ * @param payload     Payload to compress. Replaced with the compressed payload.
+ * @param dictionary  Preset deflate dictionary. May be empty.
+ */
+static void serializeMessage(MessageHeader &header, Block &payload, Block const &dictionary)
+{
+    Block huffData;
+
+    // Let's find the appropriate compression method of the payload. First see
+    // if the encoded contents are under 128 bytes as Huffman codes.
+    if (payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
+    {
+        huffData = codec::huffmanEncode(payload);
+
+        // With a preset dictionary, deflate may do better even on short messages.
+        bool const tryDeflate = !dictionary.isEmpty() && int(payload.size()) > MAX_SIZE_SMALL;
+
+        if (int(huffData.size()) <= MAX_SIZE_SMALL && !tryDeflate)
+        {
+            // We'll use this.
+            header.isHuffmanCoded = true;
+            header.size = huffData.size();
+            payload = huffData;
+        }
+        // Even if that didn't seem suitable, we'll keep it to compare against
+        // the deflated payload.
+    }
+
+    if (!header.size) // Try deflate.
+    {
+        int const level = 1; //(payload.size() < MAX_SIZE_BIG? 1 /*fast*/ : 9 /*best*/);
+        Block const deflated = payload.compressed(level, dictionary);
+
+        if (!deflated.size())
+        {
+            throw ProtocolError("Socket::send:", "Failed to deflate message payload");
+        }
+        if (deflated.size() > MAX_SIZE_LARGE)
+        {
+            throw ProtocolError("Socket::send",
+                                QString("Compressed payload is too large (%1 bytes)").arg(deflated.size()));
+        }
+
+        // Choose the smallest compression. Small Huffman coded messages have a
+        // shorter header.
+        dsize const huffHeader = (int(huffData.size()) <= MAX_SIZE_SMALL? 1 : 2);
+        if (huffData.size() && huffData.size() + huffHeader <= deflated.size() + 2 &&
+            int(huffData.size()) <= MAX_SIZE_MEDIUM)
+        {
+            // Huffman yielded smaller payload.
+            header.isHuffmanCoded = true;
+            header.size = huffData.size();
+            payload = huffData;
+        }
+        else
+        {
+            // Use the deflated payload.
+            header.isDeflated = true;
+            header.size = deflated.size();
+            payload = deflated;
+        }
+    }
+}
+
 } // namespace internal
 
 using namespace internal;
 
+struct Socket::PreparedMessage::Impl
+{
+    dsize originalSize;
+    Block payload;
+    Block dictionary;           ///< Preset deflate dictionary.
+    Block header;               ///< Serialized message header.
+    String errorMessage;        ///< Set if encoding failed.
+    std::atomic<bool> ready { false };
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    /// Sockets that are waiting for the message to be encoded. Only accessed in the
+    /// main thread.
+    QList<QPointer<Socket>> waitingSockets;
+
+    Impl(IByteArray const &packet, Block const &dictionary)
+        : originalSize(packet.size())
+        , payload(packet)
+        , dictionary(dictionary)
+    {}
+
+    void encode()
+    {
+        MessageHeader msgHeader;
+        serializeMessage(msgHeader, payload, dictionary);
+        Writer(header) << msgHeader;
+    }
+
+    void markReady()
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        ready = true;
+        finished.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lk(mutex);
+        finished.wait(lk, [this] () { return bool(ready); });
+    }
+};
+
 DENG2_PIMPL_NOREF(Socket)
 {
     Address peer;
     bool quiet = false;
     bool retainOrder = true;
+    Block deflateDictionary; ///< Preset dictionary for sent messages, agreed on with the peer.
+    Block inflateDictionary; ///< Preset dictionary available for received messages.
 
     enum ReceptionState { ReceivingHeader, ReceivingPayload };
     ReceptionState receptionState = ReceivingHeader;
@@ -222,90 +347,41 @@ DENG2_PIMPL_NOREF(Socket)
     /// Number of bytes written to the socket so far.
     dint64 totalBytesWritten = 0;
 
+    /// Messages waiting to be written to the socket, in the order they were sent.
+    QList<PreparedMessage> outgoing;
+
     ~Impl()
     {
         // Delete received messages left in the buffer.
         foreach (Message *msg, receivedMessages) delete msg;
     }
 
-    void serializeMessage(MessageHeader &header, Block &payload)
+    void sendMessage(PreparedMessage const &message)
     {
-        Block huffData;
+        DENG2_ASSERT(socket != nullptr);
+        DENG2_ASSERT(QThread::currentThread() == socket->thread());
 
-        // Let's find the appropriate compression method of the payload. First see
-        // if the encoded contents are under 128 bytes as Huffman codes.
-        if (payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
+        auto const &msg = *message.d;
+        if (msg.errorMessage)
         {
-            huffData = codec::huffmanEncode(payload);
-            if (int(huffData.size()) <= MAX_SIZE_SMALL)
-            {
-                // We'll use this.
-                header.isHuffmanCoded = true;
-                header.size = huffData.size();
-                payload = huffData;
-            }
-            // Even if that didn't seem suitable, we'll keep it to compare against
-            // the deflated payload.
+            LOG_NET_ERROR("Failed to send a message: %s") << msg.errorMessage;
+            return;
         }
 
-        /// @todo Messages broadcasted to multiple recipients are separately
-        /// compressed for each TCP send -- should do only one compression per
-        /// message.
-
-        if (!header.size) // Try deflate.
-        {
-            int const level = 1; //(payload.size() < MAX_SIZE_BIG? 1 /*fast*/ : 9 /*best*/);
-            Block const deflated = payload.compressed(level);
-
-            if (!deflated.size())
-            {
-                throw ProtocolError("Socket::send:", "Failed to deflate message payload");
-            }
-            if (deflated.size() > MAX_SIZE_LARGE)
-            {
-                throw ProtocolError("Socket::send",
-                                    QString("Compressed payload is too large (%1 bytes)").arg(deflated.size()));
-            }
-
-            // Choose the smallest compression.
-            if (huffData.size() && huffData.size() <= deflated.size() && int(huffData.size()) <= MAX_SIZE_MEDIUM)
-            {
-                // Huffman yielded smaller payload.
-                header.isHuffmanCoded = true;
-                header.size = huffData.size();
-                payload = huffData;
-            }
-            else
-            {
-                // Use the deflated payload.
-                header.isDeflated = true;
-                header.size = deflated.size();
-                payload = deflated;
-            }
-        }
-    }
-
-    void sendMessage(MessageHeader const &header,
-                     Block const &payload)
-    {
-        DENG2_ASSERT(socket != nullptr);
-        DENG2_ASSERT(QThread::currentThread() == socket->thread());
-
         // Write the message header.
-        Block dest;
-        Writer(dest) << header;
-        socket->write(dest);
+        socket->write(msg.header);
 
         // Update totals (for statistics).
-        dsize const total = dest.size() + payload.size();
+        dsize const total = msg.header.size() + msg.payload.size();
         bytesToBeWritten  += total;
         totalBytesWritten += total;
 
-        socket->write(payload);
+        socket->write(msg.payload);
 
         // Update total counters, too.
         {
             DENG2_GUARD(counters);
+            counters.value.sentUncompressedBytes += msg.originalSize;
             counters.value.sentPeriodBytes += total;
             counters.value.sentBytes       += total;
             // Update Bps counter.
@@ -320,39 +396,38 @@ DENG2_PIMPL_NOREF(Socket)
         }
     }
 
-    void serializeAndSendMessage(IByteArray const &packet)
+    /**
+     * Writes the outgoing messages that have been encoded to the socket.
+     */
+    void writeOutgoing()
     {
-        Block payload = packet;
+        for (auto i = outgoing.begin(); i != outgoing.end(); )
         {
-            DENG2_GUARD(counters);
-            counters.value.sentUncompressedBytes += payload.size();
-        }
-
-        if (!retainOrder && packet.size() >= MAX_SIZE_BIG)
-        {
-            async([this, payload] ()
+            if (!i->isReady())
             {
-                // Prepare for sending in a background thread, since it may take a moment.
-                MessageHeader header;
-                Block msgData = payload;
-                serializeMessage(header, msgData);
-                return std::make_pair(header, msgData);
-            },
-            [this] (std::pair<MessageHeader, Block> msg)
+                // Later messages must wait for this one, if the order is retained.
+                if (retainOrder) break;
+                ++i;
+                continue;
+            }
+            if (socket)
             {
-                if (socket)
-                {
-                    // Write to socket in main thread.
-                    sendMessage(msg.first, msg.second);
-                }
-            });
+                sendMessage(*i);
+            }
+            i = outgoing.erase(i);
         }
-        else
+    }
+
+    /**
+     * Waits until all the outgoing messages have been encoded, and writes them.
+     */
+    void finishOutgoing()
+    {
+        for (PreparedMessage const &msg : outgoing)
         {
-            MessageHeader header;
-            serializeMessage(header, payload);
-            sendMessage(header, payload);
+            msg.wait();
         }
+        writeOutgoing();
     }
 
     /**
@@ -404,7 +479,7 @@ DENG2_PIMPL_NOREF(Socket)
                     }
                     else if (incomingHeader.isDeflated)
                     {
-                        payload = qUncompress(payload);
+                        payload = payload.decompressed(inflateDictionary);
                         if (!payload.size())
                         {
                             throw ProtocolError("Socket::Impl::deserializeMessages", "Deflate failed");
@@ -428,6 +503,54 @@ DENG2_PIMPL_NOREF(Socket)
     }
 };
 
+Socket::PreparedMessage::PreparedMessage(IByteArray const &packet, Block const &deflateDictionary)
+    : d(std::make_shared<Impl>(packet, deflateDictionary))
+{
+    if (d->originalSize < MAX_SIZE_BIG || !App::inMainThread())
+    {
+        // Small messages are quick to compress. Background tasks can only be
+        // started in the main thread.
+        d->encode();
+        d->ready = true;
+        return;
+    }
+
+    auto inst = d;
+    async([inst] ()
+    {
+        // Compress in a background thread, since it may take a moment.
+        try
+        {
+            inst->encode();
+        }
+        catch (Error const &er)
+        {
+            inst->errorMessage = er.asText();
+        }
+        inst->markReady();
+        return 0;
+    },
+    [inst] (int)
+    {
+        // The waiting sockets can now write the message.
+        for (QPointer<Socket> const &socket : inst->waitingSockets)
+        {
+            if (socket) socket->d->writeOutgoing();
+        }
+        inst->waitingSockets.clear();
+    });
+}
+
+bool Socket::PreparedMessage::isReady() const
+{
+    return d->ready;
+}
+
+void Socket::PreparedMessage::wait() const
+{
+    d->wait();
+}
+
 Socket::Socket() : d(new Impl)
 {
     d->socket = new QTcpSocket;
@@ -560,6 +683,7 @@ void Socket::close()
     if (d->socket->state() == QAbstractSocket::ConnectedState)
     {
         // All pending data will be written to the socket before closing.
+        d->finishOutgoing();
         d->socket->disconnectFromHost();
     }
     else
@@ -621,6 +745,21 @@ void Socket::setRetainOrder(bool retainOrder)
     d->retainOrder = retainOrder;
 }
 
+void Socket::setDeflateDictionary(Block const &dictionary)
+{
+    d->deflateDictionary = dictionary;
+}
+
+Block Socket::deflateDictionary() const
+{
+    return d->deflateDictionary;
+}
+
+void Socket::setInflateDictionary(Block const &dictionary)
+{
+    d->inflateDictionary = dictionary;
+}
+
 void Socket::send(IByteArray const &packet)
 {
     send(packet, d->activeChannel);
@@ -633,6 +772,11 @@ Socket &Socket::operator << (IByteArray const &packet)
 }
 
 void Socket::send(IByteArray const &packet, duint /*channel*/)
+{
+    send(PreparedMessage(packet, d->deflateDictionary));
+}
+
+void Socket::send(PreparedMessage const &message)
 {
     if (!d->socket)
     {
@@ -643,7 +787,13 @@ void Socket::send(IByteArray const &packet, duint /*channel*/)
     // Sockets must be used only in their own thread.
     DENG2_ASSERT(thread() == QThread::currentThread());
 
-    d->serializeAndSendMessage(packet);
+    d->outgoing.append(message);
+    if (!message.isReady())
+    {
+        // The message will be written once it has been encoded.
+        message.d->waitingSockets.append(this);
+    }
+    d->writeOutgoing();
 }
 
 void Socket::readIncomingBytes()
@@ -703,6 +853,9 @@ void Socket::flush()
 {
     if (!d->socket) return;
 
+    // Messages may still be waiting to be compressed.
+    d->finishOutgoing();
+
     // Wait until data has been written.
     d->socket->flush();
     d->socket->waitForBytesWritten();
@@ -18,6 +18,7 @@
  */
 
 #include "de/ArrayExpression"
+#include "de/Bytecode"
 #include "de/Evaluator"
 #include "de/Expression"
 #include "de/ArrayValue"
@@ -78,6 +79,15 @@ Value *ArrayExpression::evaluate(Evaluator &evaluator) const
     return value;
 }
 
+void ArrayExpression::compile(Bytecode &code, bool scoped) const
+{
+    for (Expression const *arg : _arguments)
+    {
+        arg->compile(code);
+    }
+    code.add(Bytecode::MakeArray, this, scoped, duint32(_arguments.size()));
+}
+
 void ArrayExpression::operator >> (Writer &to) const
 {
     to << SerialId(ARRAY);
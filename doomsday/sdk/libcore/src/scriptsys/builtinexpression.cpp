@@ -21,6 +21,7 @@
 #include "de/App"
 #include "de/ArrayValue"
 #include "de/BlockValue"
+#include "de/Bytecode"
 #include "de/DictionaryValue"
 #include "de/Evaluator"
 #include "de/Folder"
@@ -355,6 +356,12 @@ Value *BuiltInExpression::evaluate(Evaluator &evaluator) const
     return NULL;
 }
 
+void BuiltInExpression::compile(Bytecode &code, bool scoped) const
+{
+    _arg->compile(code);
+    code.add(Bytecode::Evaluate, this, scoped);
+}
+
 void BuiltInExpression::operator >> (Writer &to) const
 {
     to << SerialId(BUILT_IN);
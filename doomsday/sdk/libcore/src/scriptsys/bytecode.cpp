@@ -0,0 +1,62 @@
+/** @file bytecode.cpp  Compiled form of an expression.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/Bytecode"
+
+namespace de {
+
+Bytecode::Bytecode()
+{}
+
+dsize Bytecode::add(OpCode op, Expression const *node, bool scoped, duint32 arg)
+{
+    _instructions.push_back(Instruction{ duint8(op), duint8(scoped? Scoped : 0), arg, node });
+    return _instructions.size() - 1;
+}
+
+void Bytecode::addConstant(Value const &value, Expression const *node, bool scoped)
+{
+    add(PushConstant, node, scoped, duint32(_constants.size()));
+    _constants.push_back(&value);
+}
+
+void Bytecode::addOperator(Operator op, Expression const *node, bool unary, bool byReference)
+{
+    _instructions.push_back(Instruction{ duint8(unary? UnaryOperator : BinaryOperator),
+                                         duint8(byReference? ByReference : 0),
+                                         duint32(op), node });
+}
+
+void Bytecode::setJumpTargetHere(dsize jump)
+{
+    DENG2_ASSERT(_instructions[jump].op == And || _instructions[jump].op == Or);
+    _instructions[jump].arg = duint32(_instructions.size());
+}
+
+Bytecode::Instructions const &Bytecode::instructions() const
+{
+    return _instructions;
+}
+
+Value const &Bytecode::constant(duint32 index) const
+{
+    DENG2_ASSERT(index < _constants.size());
+    return *_constants[index];
+}
+
+} // namespace de
@@ -18,6 +18,7 @@
  */
 
 #include "de/ConstantExpression"
+#include "de/Bytecode"
 #include "de/NumberValue"
 #include "de/NoneValue"
 #include "de/Writer"
@@ -43,6 +44,12 @@ Value *ConstantExpression::evaluate(Evaluator &) const
     return _value->duplicate();
 }
 
+void ConstantExpression::compile(Bytecode &code, bool scoped) const
+{
+    DENG2_ASSERT(_value != 0);
+    code.addConstant(*_value, this, scoped);
+}
+
 ConstantExpression *ConstantExpression::None()
 {
     return new ConstantExpression(new NoneValue());
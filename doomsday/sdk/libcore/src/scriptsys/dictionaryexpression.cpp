@@ -18,6 +18,7 @@
  */
 
 #include "de/DictionaryExpression"
+#include "de/Bytecode"
 #include "de/DictionaryValue"
 #include "de/Evaluator"
 #include "de/Writer"
@@ -92,6 +93,16 @@ Value *DictionaryExpression::evaluate(Evaluator &evaluator) const
     return dict.release();
 }
 
+void DictionaryExpression::compile(Bytecode &code, bool scoped) const
+{
+    for (ExpressionPair const &arg : _arguments)
+    {
+        arg.first->compile(code);
+        arg.second->compile(code);
+    }
+    code.add(Bytecode::MakeDictionary, this, scoped, duint32(_arguments.size()));
+}
+
 void DictionaryExpression::operator >> (Writer &to) const
 {
     to << SerialId(DICTIONARY);
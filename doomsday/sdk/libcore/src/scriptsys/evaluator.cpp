@@ -18,10 +18,15 @@
  */
 
 #include "de/Evaluator"
+#include "de/ArrayValue"
+#include "de/Bytecode"
+#include "de/DictionaryValue"
 #include "de/Expression"
 #include "de/Value"
+#include "de/NumberValue"
 #include "de/Context"
 #include "de/Process"
+#include "de/OperatorExpression"
 
 #include <QList>
 
@@ -53,7 +58,7 @@ DENG2_PIMPL(Evaluator)
     };
 
     typedef QList<ScopedExpression> Expressions;
-    typedef QList<ScopedResult> Results;
+    typedef std::vector<ScopedResult> Results;
 
     /// The expression that is currently being evaluated.
     Expression const *current;
@@ -61,9 +66,22 @@ DENG2_PIMPL(Evaluator)
     /// Namespace for the current expression.
     Record *names;
 
+    /// Expressions being evaluated with push() (see Bytecode::EvaluateTree).
     Expressions expressions;
+
+    /// The result stack is also the value stack of the bytecode.
     Results results;
 
+    /// Scopes set by the member operator, waiting to be used (owned).
+    std::vector<Value *> scopes;
+
+    /// Namespaces of the process, collected once per evaluation.
+    Namespaces processSpaces;
+    bool processSpacesValid = false;
+
+    /// Single namespace for evaluating in a specific scope.
+    Namespaces scopeSpaces { Namespace{ nullptr, Context::Namespace } };
+
     /// Returned when there is no result to give.
     NoneValue noResult;
 
@@ -72,13 +90,16 @@ DENG2_PIMPL(Evaluator)
         , context(owner)
         , current(0)
         , names(0)
-    {}
+    {
+        results.reserve(16);
+    }
 
     ~Impl()
     {
         DENG2_ASSERT(expressions.isEmpty());
         clearNames();
         clearResults();
+        clearScopes();
     }
 
     void clearNames()
@@ -91,7 +112,7 @@ DENG2_PIMPL(Evaluator)
 
     void clearResults()
     {
-        foreach (ScopedResult const &i, results)
+        for (ScopedResult const &i : results)
         {
             delete i.result;
             delete i.scope;
@@ -110,6 +131,12 @@ DENG2_PIMPL(Evaluator)
         }
     }
 
+    void clearScopes()
+    {
+        for (Value *scope : scopes) delete scope;
+        scopes.clear();
+    }
+
     void pushResult(Value *value, Value *scope = 0 /*take*/)
     {
         // NULLs are not pushed onto the results expressions as they indicate that
@@ -119,7 +146,7 @@ DENG2_PIMPL(Evaluator)
             /*qDebug() << "Evaluator: Pushing result" << value << value->asText() << "in scope"
                         << (scope? scope->asText() : "null")
                         << "result stack size:" << results.size();*/
-            results << ScopedResult(value, scope);
+            results.push_back(ScopedResult(value, scope));
         }
         else
         {
@@ -129,28 +156,53 @@ DENG2_PIMPL(Evaluator)
 
     Value &result()
     {
-        if (results.isEmpty())
+        if (results.empty())
         {
             return noResult;
         }
-        return *results.first().result;
+        return *results.front().result;
     }
 
-    Value &evaluate(Expression const *expression)
+    Namespaces const &processNamespaces()
     {
-        DENG2_ASSERT(names == nullptr);
-        DENG2_ASSERT(expressions.empty());
+        if (!processSpacesValid)
+        {
+            // The context stack below this evaluator's context remains the same
+            // during an evaluation, so the namespaces only need to be collected
+            // once per evaluation.
+            self().process().namespaces(processSpaces);
+            processSpacesValid = (current != nullptr);
+        }
+        return processSpaces;
+    }
 
-        //qDebug() << "Evaluator: Starting evaluation of" << expression;
+    Namespaces const &namespaces()
+    {
+        if (names)
+        {
+            // A specific namespace has been defined.
+            scopeSpaces.front().names = names;
+            return scopeSpaces;
+        }
+        return processNamespaces();
+    }
 
-        // Begin a new evaluation operation.
-        current = expression;
-        expression->push(self());
+    static Value *newBooleanValue(bool isTrue)
+    {
+        return new NumberValue(isTrue? NumberValue::True : NumberValue::False,
+                               NumberValue::Boolean);
+    }
 
-        // Clear the result stack.
-        clearResults();
+    /**
+     * Evaluates an expression by walking the expression tree.
+     */
+    void evaluateTree(Expression const *expression, Value *scope)
+    {
+        int const startSize = expressions.size();
 
-        while (!expressions.empty())
+        expression->push(self(), scope);
+
+        while (expressions.size() > startSize)
         {
             // Continue by processing the next step in the evaluation.
             ScopedExpression top = expressions.takeLast();
@@ -160,6 +212,138 @@ DENG2_PIMPL(Evaluator)
                      << "in" << (top.scope? names->asText() : "null scope");*/
             pushResult(top.expression->evaluate(self()), top.scope);
         }
+        clearNames();
+    }
+
+    void run(Bytecode const &code)
+    {
+        Bytecode::Instructions const &instructions = code.instructions();
+        dsize const count = instructions.size();
+
+        for (dsize pos = 0; pos < count; )
+        {
+            Bytecode::Instruction const &inst = instructions[pos++];
+
+            std::unique_ptr<Value> scope;
+            if (inst.flags & Bytecode::Scoped)
+            {
+                DENG2_ASSERT(!scopes.empty());
+                scope.reset(scopes.back());
+                scopes.pop_back();
+                names = scope->memberScope();
+            }
+
+            switch (inst.op)
+            {
+            case Bytecode::PushConstant:
+                pushResult(code.constant(inst.arg).duplicate(), scope.release());
+                break;
+
+            case Bytecode::Evaluate: {
+                Value *value = inst.node->evaluate(self());
+                pushResult(value, value? scope.release() : nullptr);
+                break; }
+
+            case Bytecode::EvaluateTree:
+                evaluateTree(inst.node, scope.release());
+                break;
+
+            case Bytecode::UnaryOperator:
+            case Bytecode::BinaryOperator: {
+                Value *right = self().popResult();
+                Value *leftScope = nullptr;
+                Value *left = (inst.op == Bytecode::BinaryOperator? self().popResult(&leftScope)
+                                                                  : nullptr);
+                pushResult(OperatorExpression::apply(self(), Operator(inst.arg), left, right,
+                                                     leftScope, inst.flags & Bytecode::ByReference));
+                break; }
+
+            case Bytecode::MakeArray: {
+                // The elements are on the stack in source order.
+                std::unique_ptr<ArrayValue> array(new ArrayValue);
+                for (duint32 i = 0; i < inst.arg; ++i)
+                {
+                    array->add(self().popResult());
+                }
+                array->reverse();
+                pushResult(array.release(), scope.release());
+                break; }
+
+            case Bytecode::MakeDictionary: {
+                // The keys and values are on the stack in source order.
+                std::vector<Value *> pairs(2 * inst.arg);
+                for (dsize i = pairs.size(); i > 0; --i)
+                {
+                    pairs[i - 1] = self().popResult();
+                }
+                std::unique_ptr<DictionaryValue> dict(new DictionaryValue);
+                for (dsize i = 0; i < pairs.size(); i += 2)
+                {
+                    dict->add(pairs[i], pairs[i + 1]);
+                }
+                pushResult(dict.release(), scope.release());
+                break; }
+
+            case Bytecode::SetScope: {
+                Value *leftScope = nullptr;
+                std::unique_ptr<Value> left(self().popResult(&leftScope));
+                delete leftScope;
+                if (!left->memberScope())
+                {
+                    throw OperatorExpression::ScopeError("OperatorExpression::evaluate",
+                        "Left side of " + operatorToText(MEMBER) + " does not have members [" +
+                        DENG2_TYPE_NAME(*left) + "]");
+                }
+                scopes.push_back(left.release());
+                break; }
+
+            case Bytecode::DropScope:
+                DENG2_ASSERT(!scopes.empty());
+                delete scopes.back();
+                scopes.pop_back();
+                break;
+
+            case Bytecode::And:
+            case Bytecode::Or: {
+                bool const isOr = (inst.op == Bytecode::Or);
+                std::unique_ptr<Value> left(self().popResult());
+                if (left->isTrue() == isOr)
+                {
+                    // Early termination.
+                    pushResult(newBooleanValue(isOr));
+                    pos = inst.arg;
+                }
+                break; }
+
+            case Bytecode::ToBoolean: {
+                std::unique_ptr<Value> value(self().popResult());
+                pushResult(newBooleanValue(value->isTrue()));
+                break; }
+
+            default:
+                DENG2_ASSERT(false);
+                break;
+            }
+
+            clearNames();
+        }
+    }
+
+    Value &evaluate(Expression const *expression)
+    {
+        DENG2_ASSERT(names == nullptr);
+        DENG2_ASSERT(expressions.empty());
+        DENG2_ASSERT(scopes.empty());
+
+        //qDebug() << "Evaluator: Starting evaluation of" << expression;
+
+        // Begin a new evaluation operation.
+        current = expression;
+
+        // Clear the result stack.
+        clearResults();
+
+        run(expression->bytecode());
 
         // During function call evaluation the process's context changes. We should
         // now be back at the level we started from.
@@ -168,9 +352,11 @@ DENG2_PIMPL(Evaluator)
         // Exactly one value should remain in the result stack: the result of the
         // evaluated expression.
         DENG2_ASSERT(self().hasResult());
+        DENG2_ASSERT(scopes.empty());
 
         clearNames();
         current = nullptr;
+        processSpacesValid = false;
         return result();
     }
 };
@@ -200,8 +386,10 @@ Process const &Evaluator::process() const
 void Evaluator::reset()
 {
     d->current = nullptr;
+    d->processSpacesValid = false;
 
     d->clearExpressions();
+    d->clearScopes();
     d->clearNames();
 }
 
@@ -212,23 +400,22 @@ Value &Evaluator::evaluate(Expression const *expression)
 
 void Evaluator::namespaces(Namespaces &spaces) const
 {
-    if (d->names)
-    {
-        // A specific namespace has been defined.
-        spaces.clear();
-        spaces.push_back({d->names, Context::Namespace});
-    }
-    else
-    {
-        // Collect namespaces from the process's call stack.
-        process().namespaces(spaces);
-    }
+    spaces = d->namespaces();
+}
+
+Evaluator::Namespaces const &Evaluator::namespaces() const
+{
+    return d->namespaces();
+}
+
+Evaluator::Namespaces const &Evaluator::processNamespaces() const
+{
+    return d->processNamespaces();
 }
 
 Record *Evaluator::localNamespace() const
 {
-    Namespaces spaces;
-    namespaces(spaces);
+    Namespaces const &spaces = d->namespaces();
     DENG2_ASSERT(!spaces.empty());
     DENG2_ASSERT(spaces.front().names != 0);
     return spaces.front().names;
@@ -258,7 +445,8 @@ Value *Evaluator::popResult(Value **evaluationScope)
 {
     DENG2_ASSERT(d->results.size() > 0);
 
-    Impl::ScopedResult result = d->results.takeLast();
+    Impl::ScopedResult result = d->results.back();
+    d->results.pop_back();
     /*qDebug() << "Evaluator: Popping result" << result.result << result.result->asText()
              << "in scope" << (result.scope? result.scope->asText() : "null");*/
 
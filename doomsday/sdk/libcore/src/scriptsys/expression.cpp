@@ -18,6 +18,7 @@
  */
 
 #include "de/Expression"
+#include "de/Bytecode"
 #include "de/Evaluator"
 #include "de/ArrayExpression"
 #include "de/BuiltInExpression"
@@ -30,17 +31,42 @@
 
 using namespace de;
 
-Expression::Expression()
+Expression::Expression() : _bytecode(nullptr)
 {}
 
 Expression::~Expression()
-{}
+{
+    delete _bytecode.load();
+}
 
 void Expression::push(Evaluator &evaluator, Value *scope) const
 {
     evaluator.push(this, scope);
 }
 
+void Expression::compile(Bytecode &code, bool scoped) const
+{
+    code.add(Bytecode::EvaluateTree, this, scoped);
+}
+
+Bytecode const &Expression::bytecode() const
+{
+    if (Bytecode const *code = _bytecode.load(std::memory_order_acquire))
+    {
+        return *code;
+    }
+    std::unique_ptr<Bytecode> compiled(new Bytecode);
+    compile(*compiled);
+
+    // Another thread may have compiled the expression at the same time.
+    Bytecode *existing = nullptr;
+    if (_bytecode.compare_exchange_strong(existing, compiled.get()))
+    {
+        return *compiled.release();
+    }
+    return *existing;
+}
+
 Expression *Expression::constructFrom(Reader &reader)
 {
     SerialId id;
@@ -108,4 +134,7 @@ void Expression::operator << (Reader &from)
     duint16 f;
     from >> f;
     _flags = Flags(f);
+
+    // The expression has changed, so any previously compiled code is obsolete.
+    delete _bytecode.exchange(nullptr);
 }
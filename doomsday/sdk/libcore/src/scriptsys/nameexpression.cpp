@@ -20,6 +20,7 @@
 #include "de/NameExpression"
 #include "de/App"
 #include "de/ArrayValue"
+#include "de/Bytecode"
 #include "de/Evaluator"
 #include "de/Module"
 #include "de/Process"
@@ -31,13 +32,102 @@
 #include "de/TextValue"
 #include "de/Writer"
 
+#include <atomic>
+
 namespace de {
 
 String const NameExpression::LOCAL_SCOPE = "-";
 
 DENG2_PIMPL_NOREF(NameExpression)
 {
+    /**
+     * Record that was looked into while searching for an identifier. Records are
+     * identified by their unique ID in case a new record is later allocated at the
+     * same address.
+     */
+    struct Dependency
+    {
+        Record const *record;
+        duint32 recordId;
+        duint32 version;
+        int parent;               ///< Dependency whose super-records include this one.
+        int superIndex;           ///< Index in the parent's super-records.
+        Variable const *supers;   ///< Super-records of this record that were looked into.
+        dsize superCount;
+    };
+
+    static int const MAX_DEPENDENCIES = 6;
+
+    /// Records looked into during a lookup, in the order they were visited.
+    struct LookupTrace
+    {
+        Dependency deps[MAX_DEPENDENCIES];
+        int count = 0;
+        bool overflow = false;
+
+        int add(Record const &record, int parent, int superIndex)
+        {
+            if (count == MAX_DEPENDENCIES)
+            {
+                overflow = true;
+                return -1;
+            }
+            deps[count] = Dependency{ &record, record.uniqueId(), record.membershipVersion(),
+                                      parent, superIndex, nullptr, 0 };
+            return count++;
+        }
+    };
+
+    /**
+     * Inline cache for the identifier lookups done by this expression. Remembers
+     * the result of the latest successful lookup. The result remains valid as long
+     * as none of the records looked into have had members added or removed, and
+     * the same super-records are still in place.
+     */
+    struct LookupCache
+    {
+        LookupTrace trace;
+        bool lookInClass = false;
+        Variable *variable = nullptr;
+        Record *foundIn = nullptr;
+
+        /// Only one thread at a time may use the cache.
+        std::atomic_flag busy = ATOMIC_FLAG_INIT;
+
+        bool isValid(Record const &where, bool lookInClassRequired) const
+        {
+            if (!variable || lookInClass != lookInClassRequired) return false;
+
+            for (int i = 0; i < trace.count; ++i)
+            {
+                Dependency const &dep = trace.deps[i];
+                Record const *record = &where;
+                if (dep.parent >= 0)
+                {
+                    // The parent's membership is unchanged, so its super-records
+                    // variable still exists.
+                    Dependency const &parent = trace.deps[dep.parent];
+                    auto const *supers = maybeAs<ArrayValue>(parent.supers->value());
+                    if (!supers || supers->size() != parent.superCount) return false;
+
+                    auto const *superValue = maybeAs<RecordValue>(supers->at(dep.superIndex));
+                    if (!superValue) return false;
+                    record = superValue->record();
+                }
+                if (record != dep.record                     ||
+                    record->uniqueId() != dep.recordId       ||
+                    record->membershipVersion() != dep.version)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
     StringList identifierSequence;
+    LookupCache cache;
+
     //String scopeIdentifier;
 
 //    Impl(String const &id      = "",
@@ -49,8 +139,13 @@ DENG2_PIMPL_NOREF(NameExpression)
     Variable *findInRecord(String const & name,
                            Record const & where,
                            Record *&      foundIn,
-                           bool           lookInClass = true) const
+                           bool           lookInClass = true,
+                           LookupTrace *  trace       = nullptr,
+                           int            parent      = -1,
+                           int            superIndex  = -1) const
     {
+        int const dep = (trace? trace->add(where, parent, superIndex) : -1);
+
         if (where.hasMember(name))
         {
             // The name exists in this namespace. Even though the lookup was done as
@@ -64,10 +159,16 @@ DENG2_PIMPL_NOREF(NameExpression)
             // super-record in turn. Check in reverse order; the superclass added last
             // overrides earlier ones.
             ArrayValue const &supers = where.geta(Record::VAR_SUPER);
+            if (dep >= 0)
+            {
+                trace->deps[dep].supers     = &where[Record::VAR_SUPER];
+                trace->deps[dep].superCount = supers.size();
+            }
             for (int i = int(supers.size() - 1); i >= 0; --i)
             {
                 if (Variable *found = findInRecord(
-                        name, supers.at(i).as<RecordValue>().dereference(), foundIn))
+                        name, supers.at(i).as<RecordValue>().dereference(), foundIn,
+                        true, trace, dep, i))
                 {
                     return found;
                 }
@@ -76,6 +177,43 @@ DENG2_PIMPL_NOREF(NameExpression)
         return 0;
     }
 
+    /**
+     * Looks up an identifier in a record, using the inline cache if possible.
+     */
+    Variable *findInRecordCached(String const & name,
+                                 Record const & where,
+                                 Record *&      foundIn,
+                                 bool           lookInClass)
+    {
+        if (cache.busy.test_and_set(std::memory_order_acquire))
+        {
+            // Another thread is using the cache.
+            return findInRecord(name, where, foundIn, lookInClass);
+        }
+        // Release the cache also if an exception is thrown.
+        struct Release {
+            std::atomic_flag &flag;
+            ~Release() { flag.clear(std::memory_order_release); }
+        } release { cache.busy };
+
+        if (cache.isValid(where, lookInClass))
+        {
+            foundIn = cache.foundIn;
+            return cache.variable;
+        }
+
+        LookupTrace trace;
+        Variable *found = findInRecord(name, where, foundIn, lookInClass, &trace);
+        if (found && !trace.overflow)
+        {
+            cache.trace       = trace;
+            cache.lookInClass = lookInClass;
+            cache.variable    = found;
+            cache.foundIn     = foundIn;
+        }
+        return found;
+    }
+
     Variable *findInNamespaces(String const & name,
                                Evaluator::Namespaces const &spaces,
                                bool           localOnly,
@@ -86,9 +224,9 @@ DENG2_PIMPL_NOREF(NameExpression)
         {
             Record &ns = *i->names;
             if (Variable *variable =
-                    findInRecord(name, ns, foundInNamespace,
-                                   // allow looking in class if local not required:
-                                   !localOnly))
+                    findInRecordCached(name, ns, foundInNamespace,
+                                       // allow looking in class if local not required:
+                                       !localOnly))
             {
                 // The name exists in this namespace.
                 // Also note the higher namespace (for export).
@@ -140,8 +278,8 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
     //LOG_AS("NameExpression::evaluate");
     //LOGDEV_SCR_XVERBOSE_DEBUGONLY("evaluating name:\"%s\" flags:%x", d->identifier << flags());
 
-    // Collect the namespaces to search.
-    Evaluator::Namespaces spaces;
+    // The namespaces to search.
+    Evaluator::Namespaces const *spaces = nullptr;
 
     Record *foundInNamespace = nullptr;
     Record *higherNamespace = nullptr;
@@ -156,22 +294,22 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
         {
             // This is the usual case: scope defined by the left side of the member
             // operator, or if that is not specified, the context's namespace stack.
-            evaluator.namespaces(spaces);
+            spaces = &evaluator.namespaces();
         }
         else
         {
             // Start with the context's local namespace.
-            evaluator.process().namespaces(spaces);
+            spaces = &evaluator.processNamespaces();
         }
-        variable = d->findInNamespaces(identifier, spaces, flags().testFlag(LocalOnly),
+        variable = d->findInNamespaces(identifier, *spaces, flags().testFlag(LocalOnly),
                                        foundInNamespace, &higherNamespace);
     }
     else
     {
         // An explicit scope has been defined; try to find it first. Look in the current
         // context of the process, ignoring any narrower scopes that may apply here.
-        evaluator.process().namespaces(spaces);
-        Variable *scope = d->findInNamespaces(scopeIdentifier, spaces, false, foundInNamespace);
+        spaces = &evaluator.processNamespaces();
+        Variable *scope = d->findInNamespaces(scopeIdentifier, *spaces, false, foundInNamespace);
         if (!scope)
         {
             throw NotFoundError("NameExpression::evaluate",
@@ -213,7 +351,7 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
        (flags().testFlag(NewSubrecordIfNotInScope) && !variable))
     {
         // Replaces existing member with this identifier.
-        Record &record = spaces.front().names->addSubrecord(identifier);
+        Record &record = spaces->front().names->addSubrecord(identifier);
         return new RecordValue(record);
     }
 
@@ -224,13 +362,13 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
         variable = new Variable(identifier);
 
         // Add it to the local namespace.
-        spaces.front().names->add(variable);
+        spaces->front().names->add(variable);
 
         // Take note of the namespaces.
-        foundInNamespace = spaces.front().names;
-        if (!higherNamespace && spaces.size() > 1)
+        foundInNamespace = spaces->front().names;
+        if (!higherNamespace && spaces->size() > 1)
         {
-            Evaluator::Namespaces::iterator i = spaces.begin();
+            Evaluator::Namespaces::const_iterator i = spaces->begin();
             higherNamespace = (++i)->names;
         }
     }
@@ -266,7 +404,7 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
             evaluator.process().globals()[Record::VAR_FILE].value().asText());
 
         // Overwrite any existing member with this identifier.
-        spaces.front().names->add(variable = new Variable(identifier));
+        spaces->front().names->add(variable = new Variable(identifier));
 
         if (flags().testFlag(ByValue))
         {
@@ -303,6 +441,11 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
                         "' does not exist");
 }
 
+void NameExpression::compile(Bytecode &code, bool scoped) const
+{
+    code.add(Bytecode::Evaluate, this, scoped);
+}
+
 void NameExpression::operator >> (Writer &to) const
 {
     to << SerialId(NAME);
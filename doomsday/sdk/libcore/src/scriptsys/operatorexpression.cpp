@@ -18,6 +18,7 @@
  */
 
 #include "de/OperatorExpression"
+#include "de/Bytecode"
 #include "de/Evaluator"
 #include "de/Value"
 #include "de/NumberValue"
@@ -116,21 +117,65 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
 {
     //qDebug() << "OperatorExpression:" << operatorToText(_op);
 
-    // Get the operands.
-    Value *rightValue = (_op == MEMBER || _op == AND || _op == OR? nullptr : evaluator.popResult());
-    Value *leftScopePtr = nullptr;
-    Value *leftValue = (_leftOperand? evaluator.popResult(&leftScopePtr) : nullptr);
+    if (_op != MEMBER && _op != AND && _op != OR)
+    {
+        // Get the operands.
+        Value *rightValue = evaluator.popResult();
+        Value *leftScope = nullptr;
+        Value *leftValue = (_leftOperand? evaluator.popResult(&leftScope) : nullptr);
+
+        return apply(evaluator, _op, leftValue, rightValue, leftScope,
+                     flags().testFlag(ByReference));
+    }
+
+    // Only the left operand has been evaluated so far.
+    QScopedPointer<Value> leftValue(evaluator.popResult());
+
+    switch (_op)
+    {
+    case AND:
+    case OR:
+        if (leftValue->isTrue() == (_op == OR))
+        {
+            // Early termination.
+            return newBooleanValue(_op == OR);
+        }
+        isResultTrue.push(evaluator);
+        _rightOperand->push(evaluator);
+        return nullptr;
+
+    default: // MEMBER
+        if (!leftValue->memberScope())
+        {
+            throw ScopeError("OperatorExpression::evaluate",
+                "Left side of " + operatorToText(_op) + " does not have members [" +
+                             DENG2_TYPE_NAME(*leftValue) + "]");
+        }
+
+        // Now that we know what the scope is, push the rest of the expression
+        // for evaluation (in this specific scope).
+        _rightOperand->push(evaluator, leftValue.take());
+
+        // The MEMBER operator does not evaluate to any result.
+        // Whatever is on the right side will be the result.
+        return nullptr;
+    }
+}
+
+Value *OperatorExpression::apply(Evaluator &evaluator, Operator op, Value *leftValue,
+                                 Value *rightValue, Value *leftScopePtr, bool byReference) // static
+{
     Value *result = (leftValue? leftValue : rightValue);
 
     QScopedPointer<Value> leftScope(leftScopePtr); // will be deleted if not needed
 
-    DENG2_ASSERT(_op == MEMBER || _op == AND || _op == OR ||
-                 (!isUnary(_op) && leftValue && rightValue) ||
-                 ( isUnary(_op) && rightValue));
+    DENG2_ASSERT(op != MEMBER && op != AND && op != OR);
+    DENG2_ASSERT((!isUnary(op) && leftValue && rightValue) ||
+                 ( isUnary(op) && rightValue));
 
     try
     {
-        switch (_op)
+        switch (op)
         {
         case PLUS:
             if (leftValue)
@@ -200,34 +245,6 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
             result = newBooleanValue(rightValue->isTrue());
             break;
 
-        case AND:
-            if (!leftValue->isTrue())
-            {
-                // Early termination.
-                result = newBooleanValue(false);
-            }
-            else
-            {
-                isResultTrue.push(evaluator);
-                _rightOperand->push(evaluator);
-                result = nullptr;
-            }
-            break;
-
-        case OR:
-            if (leftValue->isTrue())
-            {
-                // Early termination.
-                result = newBooleanValue(true);
-            }
-            else
-            {
-                isResultTrue.push(evaluator);
-                _rightOperand->push(evaluator);
-                result = nullptr;
-            }
-            break;
-
         case EQUAL:
             result = newBooleanValue(!leftValue->compare(*rightValue));
             break;
@@ -267,12 +284,12 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
             /*
             LOG_DEV_TRACE_DEBUGONLY("INDEX: types %s [ %s ] byref:%b",
                           DENG2_TYPE_NAME(*leftValue) << DENG2_TYPE_NAME(*rightValue)
-                          << flags().testFlag(ByReference));
+                          << byReference);
                           */
 
             // As a special case, records can be indexed also by reference.
             RecordValue *recValue = dynamic_cast<RecordValue *>(leftValue);
-            if (flags().testFlag(ByReference) && recValue)
+            if (byReference && recValue)
             {
                 result = new RefValue(&recValue->dereference()[rightValue->asText()]);
             }
@@ -288,32 +305,9 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
             result = performSlice(*leftValue, *rightValue);
             break;
 
-        case MEMBER:
-        {
-            Record *scope = (leftValue? leftValue->memberScope() : 0);
-            if (!scope)
-            {
-                throw ScopeError("OperatorExpression::evaluate",
-                    "Left side of " + operatorToText(_op) + " does not have members [" +
-                                 DENG2_TYPE_NAME(*leftValue) + "]");
-            }
-
-            // Now that we know what the scope is, push the rest of the expression
-            // for evaluation (in this specific scope).
-            _rightOperand->push(evaluator, leftValue);
-
-            // Cleanup.
-            //delete leftValue;
-            DENG2_ASSERT(rightValue == NULL);
-
-            // The MEMBER operator does not evaluate to any result.
-            // Whatever is on the right side will be the result.
-            return nullptr;
-        }
-
         default:
             throw Error("OperatorExpression::evaluate",
-                "Operator " + operatorToText(_op) + " not implemented");
+                "Operator " + operatorToText(op) + " not implemented");
         }
     }
     catch (Error const &)
@@ -330,6 +324,49 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
     return result;
 }
 
+void OperatorExpression::compile(Bytecode &code, bool scoped) const
+{
+    switch (_op)
+    {
+    case MEMBER:
+        // The result of the left side determines the scope of the right side.
+        _leftOperand->compile(code, scoped);
+        code.add(Bytecode::SetScope, this);
+        _rightOperand->compile(code, true);
+        break;
+
+    case AND:
+    case OR: {
+        // Early termination: the right operand is skipped if the left operand
+        // alone determines the result.
+        _leftOperand->compile(code, scoped);
+        dsize const jump = code.add(_op == AND? Bytecode::And : Bytecode::Or, this);
+        _rightOperand->compile(code);
+        code.add(Bytecode::ToBoolean, this);
+        code.setJumpTargetHere(jump);
+        break; }
+
+    case RESULT_TRUE:
+        if (scoped) code.add(Bytecode::DropScope, this);
+        code.add(Bytecode::ToBoolean, this);
+        break;
+
+    default:
+        if (_leftOperand)
+        {
+            _leftOperand->compile(code, scoped);
+        }
+        else if (scoped)
+        {
+            // Unary operators do not use a scope.
+            code.add(Bytecode::DropScope, this);
+        }
+        _rightOperand->compile(code);
+        code.addOperator(_op, this, !_leftOperand, flags().testFlag(ByReference));
+        break;
+    }
+}
+
 // Flags for serialization:
 static duint8 const HAS_LEFT_OPERAND = 0x80;
 static duint8 const OPERATOR_MASK    = 0x7f;
@@ -411,7 +448,7 @@ namespace internal {
     };
 }
 
-Value *OperatorExpression::performSlice(Value &leftValue, Value &rightValue) const
+Value *OperatorExpression::performSlice(Value &leftValue, Value &rightValue) // static
 {
     using internal::SliceTarget;
     using internal::TextSliceTarget;
@@ -441,7 +478,7 @@ Value *OperatorExpression::performSlice(Value &leftValue, Value &rightValue) con
         if (!step)
         {
             throw SliceError("OperatorExpression::evaluate",
-                operatorToText(_op) + " cannot use zero as step");
+                operatorToText(SLICE) + " cannot use zero as step");
         }
     }
 
@@ -149,6 +149,20 @@ DENG_PUBLIC void Sys_Lock(mutex_t mutexHandle);
 
 DENG_PUBLIC void Sys_Unlock(mutex_t mutexHandle);
 
+/**
+ * Attempts to lock a mutex without blocking.
+ *
+ * @return @c true, if the mutex was locked.
+ */
+DENG_PUBLIC dd_bool Sys_TryLock(mutex_t mutexHandle);
+
+/**
+ * Locks a mutex and measures how long the calling thread had to wait for it.
+ *
+ * @return Time spent waiting, in microseconds. Zero if the mutex was available.
+ */
+DENG_PUBLIC uint64_t Sys_LockMeasuringWait(mutex_t mutexHandle);
+
 #if 0
 /// @todo update these if/when needed
 sem_t Sem_Create(uint32_t initialValue);
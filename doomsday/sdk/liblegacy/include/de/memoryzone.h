@@ -176,6 +176,35 @@ DENG_PUBLIC void *ZBlockSet_Allocate(zblockset_t *set);
         Con_Error("Z_ChangeTag at " __FILE__ ":%i", __LINE__); \
     Z_ChangeTag2(p, t); }
 
+/**
+ * Statistics about the state of the memory zone.
+ */
+typedef struct memzonestats_s {
+    uint volumeCount;
+    uint arenaCount;
+    size_t totalBytes;          ///< Combined size of all volumes.
+    size_t allocatedBytes;
+    size_t freeBytes;
+    uint freeBlockCount;
+    size_t largestFreeBlock;    ///< Size of the largest contiguous free block.
+    size_t tagBytes[PU_PURGELEVEL + 1]; ///< Allocated bytes per purge level.
+    uint lockContentions;       ///< Times a thread had to wait for an arena lock.
+    double lockWaitSeconds;     ///< Total time spent waiting for arena locks.
+} MemoryZoneStats;
+
+/**
+ * Collects statistics about the memory zone. Walks through all the blocks in all
+ * volumes, so this should not be called very frequently.
+ *
+ * @param stats  Statistics are written here.
+ */
+DENG_PUBLIC void Z_GetStats(MemoryZoneStats *stats);
+
+/**
+ * Prints the memory zone statistics to the log, including the amount of memory
+ * used by each purge level, fragmentation of free memory, and time spent waiting
+ * for locks.
+ */
 DENG_PUBLIC void Z_PrintStatus(void);
 
 /**
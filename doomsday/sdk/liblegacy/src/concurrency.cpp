@@ -22,6 +22,7 @@
  */
 
 #include "de/concurrency.h"
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QCoreApplication>
 #include <QDebug>
@@ -228,3 +229,22 @@ void Sys_Unlock(mutex_t handle)
         m->unlock();
     }
 }
+
+dd_bool Sys_TryLock(mutex_t handle)
+{
+    QMutex *m = reinterpret_cast<QMutex *>(handle);
+    assert(m != 0);
+    return m && m->tryLock();
+}
+
+uint64_t Sys_LockMeasuringWait(mutex_t handle)
+{
+    QMutex *m = reinterpret_cast<QMutex *>(handle);
+    assert(m != 0);
+    if (!m || m->tryLock()) return 0;
+
+    QElapsedTimer waited;
+    waited.start();
+    m->lock();
+    return uint64_t(waited.nsecsElapsed() / 1000);
+}
@@ -31,6 +31,15 @@
  * all of them efficiently. This is possible because no block inside the
  * sequence could be purged by Z_Malloc() anyway.
  *
+ * @par Arenas
+ * The volumes are divided between a few allocation arenas, each with its own
+ * lock. The main thread allocates from the first arena and other threads are
+ * spread over the rest according to their IDs. If the preferred arena is busy,
+ * a thread may use any other arena not reserved for the main thread. Blocks can
+ * be freed in any thread by locking the arena that owns the block. The purge
+ * levels apply to all arenas alike, e.g., Z_FreeTags() frees the blocks in every
+ * arena and Z_Malloc() may purge any purgable blocks of the arena it is using.
+ *
  * @author Copyright &copy; 1999-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
  * @author Copyright &copy; 2006-2013 Daniel Swanson <danij@dengine.net>
  * @author Copyright &copy; 2006 Jamie Jones <jamie_jones_au@yahoo.com.au>
@@ -62,6 +71,13 @@
 // Size of one memory zone volume.
 #define MEMORY_VOLUME_SIZE  0x2000000   // 32 Mb
 
+// Volumes of the secondary arenas are smaller because they are mostly used by
+// background threads.
+#define MEMORY_ARENA_VOLUME_SIZE  0x800000  // 8 Mb
+
+// Number of allocation arenas. The first one is reserved for the main thread.
+#define MEMORY_ARENA_COUNT  4
+
 #define MINFRAGMENT (sizeof(memblock_t)+32)
 
 #define ALIGNED(x) (((x) + sizeof(void *) - 1)&(~(sizeof(void *) - 1)))
@@ -87,10 +103,13 @@ typedef struct zblockset_block_s {
 static memvolume_t *volumeRoot;
 static memvolume_t *volumeLast;
 
+static memarena_t arenas[MEMORY_ARENA_COUNT];
+
+/// Guards the list of all volumes. Arena locks must be acquired before this.
 static mutex_t zoneMutex = 0;
 
-static size_t Z_AllocatedMemory(void);
 static size_t allocatedMemoryInVolume(memvolume_t *volume);
+static void checkVolume(memvolume_t *volume);
 
 static __inline void lockZone(void)
 {
@@ -103,6 +122,89 @@ static __inline void unlockZone(void)
     Sys_Unlock(zoneMutex);
 }
 
+static void lockArena(memarena_t *arena)
+{
+    uint64_t const waited = Sys_LockMeasuringWait(arena->mutex);
+    if (waited)
+    {
+        // These are only modified while the arena is locked.
+        arena->contentionCount++;
+        arena->lockWaitMicros += waited;
+    }
+}
+
+static __inline void unlockArena(memarena_t *arena)
+{
+    Sys_Unlock(arena->mutex);
+}
+
+static __inline memarena_t *blockArena(memblock_t *block)
+{
+    DENG_ASSERT(block->volume);
+    return block->volume->arena;
+}
+
+/**
+ * Locks the arena from which the calling thread should allocate memory.
+ */
+static memarena_t *lockArenaForAllocation(void)
+{
+    memarena_t *arena;
+    int i;
+
+    if (Sys_InMainThread())
+    {
+        arena = &arenas[0];
+    }
+    else
+    {
+        // Spread the other threads evenly over the remaining arenas.
+        uint32_t id = Sys_CurrentThreadId();
+        id ^= id >> 16;
+        id *= 0x45d9f3b;
+        id ^= id >> 16;
+        arena = &arenas[1 + id % (MEMORY_ARENA_COUNT - 1)];
+
+        if (!Sys_TryLock(arena->mutex))
+        {
+            // Any other secondary arena will do, if one is available right away.
+            for (i = 1; i < MEMORY_ARENA_COUNT; ++i)
+            {
+                if (&arenas[i] != arena && Sys_TryLock(arenas[i].mutex))
+                {
+                    return &arenas[i];
+                }
+            }
+            lockArena(arena);
+        }
+        return arena;
+    }
+
+    lockArena(arena);
+    return arena;
+}
+
+/// Locks all the arenas and the volume list, for inspecting the entire zone.
+static void lockAll(void)
+{
+    int i;
+    for (i = 0; i < MEMORY_ARENA_COUNT; ++i)
+    {
+        lockArena(&arenas[i]);
+    }
+    lockZone();
+}
+
+static void unlockAll(void)
+{
+    int i;
+    unlockZone();
+    for (i = MEMORY_ARENA_COUNT - 1; i >= 0; --i)
+    {
+        unlockArena(&arenas[i]);
+    }
+}
+
 /**
  * Conversion from string to long, with the "k" and "m" suffixes.
  */
@@ -120,22 +222,20 @@ long superatol(char *s)
 
 /**
  * Create a new memory volume.  The new volume is added to the list of
- * memory volumes.
+ * memory volumes and to the volumes of @a arena. The arena must be locked.
  */
-static memvolume_t *createVolume(size_t volumeSize)
+static memvolume_t *createVolume(memarena_t *arena, size_t volumeSize)
 {
     memblock_t     *block;
     memvolume_t    *vol = M_Calloc(sizeof(memvolume_t));
 
-    lockZone();
-
-    // Append to the end of the volume list.
-    if (volumeLast)
-        volumeLast->next = vol;
-    volumeLast = vol;
-    vol->next = 0;
-    if (!volumeRoot)
-        volumeRoot = vol;
+    // Append to the end of the arena's volumes.
+    vol->arena = arena;
+    if (arena->volumeLast)
+        arena->volumeLast->arenaNext = vol;
+    arena->volumeLast = vol;
+    if (!arena->volumeRoot)
+        arena->volumeRoot = vol;
 
     // Allocate memory for the zone volume.
     vol->size = volumeSize;
@@ -162,12 +262,21 @@ static memvolume_t *createVolume(size_t volumeSize)
     block->seqFirst = block->seqLast = NULL;
     block->size = vol->zone->size - sizeof(memzone_t);
 
+    // Append to the end of the volume list.
+    lockZone();
+    if (volumeLast)
+        volumeLast->next = vol;
+    volumeLast = vol;
+    vol->next = 0;
+    if (!volumeRoot)
+        volumeRoot = vol;
     unlockZone();
 
     App_Log(DE2_LOG_MESSAGE,
-            "Created a new %.1f MB memory volume.", vol->size / 1024.0 / 1024.0);
+            "Created a new %.1f MB memory volume (arena %i).", vol->size / 1024.0 / 1024.0,
+            (int) (arena - arenas));
 
-    Z_CheckHeap();
+    checkVolume(vol);
 
     return vol;
 }
@@ -179,10 +288,20 @@ dd_bool Z_IsInited(void)
 
 int Z_Init(void)
 {
+    int i;
+
     zoneMutex = Sys_CreateMutex("ZONE_MUTEX");
 
-    // Create the first volume.
-    createVolume(MEMORY_VOLUME_SIZE);
+    memset(arenas, 0, sizeof(arenas));
+    for (i = 0; i < MEMORY_ARENA_COUNT; ++i)
+    {
+        arenas[i].mutex = Sys_CreateMutex("ZONE_ARENA_MUTEX");
+    }
+
+    // Create the first volume. The other arenas get their volumes when needed.
+    lockArena(&arenas[0]);
+    createVolume(&arenas[0], MEMORY_VOLUME_SIZE);
+    unlockArena(&arenas[0]);
     return true;
 }
 
@@ -190,10 +309,15 @@ void Z_Shutdown(void)
 {
     int             numVolumes = 0;
     size_t          totalMemory = 0;
+    int             i;
 
     // Get rid of possible zone-allocated memory in the garbage.
     Garbage_RecycleAllWithDestructor(Z_Free);
 
+#ifdef LIBDENG_FAKE_MEMORY_ZONE
+    Z_FreeTags(0, DDMAXINT);
+#endif
+
     // Destroy all the memory volumes.
     while (volumeRoot)
     {
@@ -204,17 +328,21 @@ void Z_Shutdown(void)
         numVolumes++;
         totalMemory += vol->size;
 
-#ifdef LIBDENG_FAKE_MEMORY_ZONE
-        Z_FreeTags(0, DDMAXINT);
-#endif
-
         M_Free(vol->zone);
         M_Free(vol);
     }
 
+    volumeLast = NULL;
+
     App_Log(DE2_LOG_NOTE,
             "Z_Shutdown: Used %i volumes, total %u bytes.", numVolumes, totalMemory);
 
+    for (i = 0; i < MEMORY_ARENA_COUNT; ++i)
+    {
+        Sys_DestroyMutex(arenas[i].mutex);
+    }
+    memset(arenas, 0, sizeof(arenas));
+
     Sys_DestroyMutex(zoneMutex);
     zoneMutex = 0;
 }
@@ -225,6 +353,7 @@ memblock_t *Z_GetBlock(void *ptr)
     memvolume_t    *volume;
     memblock_t     *block;
 
+    lockZone();
     for (volume = volumeRoot; volume; volume = volume->next)
     {
         for (block = volume->zone->blockList.next;
@@ -233,10 +362,12 @@ memblock_t *Z_GetBlock(void *ptr)
         {
             if (block->area == ptr)
             {
+                unlockZone();
                 return block;
             }
         }
     }
+    unlockZone();
     DENG_ASSERT(false); // There is no memory block for this.
     return NULL;
 }
@@ -253,15 +384,14 @@ static void freeBlock(void *ptr, memblock_t **tracked)
 {
     memblock_t     *block, *other;
     memvolume_t    *volume;
+    memarena_t     *arena;
 
     if (!ptr) return;
 
-    lockZone();
-
     block = Z_GetBlock(ptr);
-    if (block->id != LIBDENG_ZONEID)
+    volume = block->volume;
+    if (block->id != LIBDENG_ZONEID || !volume)
     {
-        unlockZone();
         DENG_ASSERT(block->id == LIBDENG_ZONEID);
         App_Log(DE2_LOG_WARNING,
                 "Attempted to free pointer without ZONEID.");
@@ -269,7 +399,21 @@ static void freeBlock(void *ptr, memblock_t **tracked)
     }
 
     // The block was allocated from this volume.
-    volume = block->volume;
+    arena = volume->arena;
+
+    lockArena(arena);
+
+    // The block might have been purged while waiting for the lock.
+    if (block->id != LIBDENG_ZONEID || block->volume != volume)
+    {
+        unlockArena(arena);
+        App_Log(DE2_LOG_WARNING,
+                "Attempted to free pointer without ZONEID.");
+        return;
+    }
+
+    // Keep tabs on how much memory is used.
+    arena->tagBytes[block->tag] -= block->size;
 
     if (block->user > (void **) 0x100) // Smaller values are not pointers.
         *block->user = 0; // Clear the user's mark.
@@ -343,7 +487,7 @@ static void freeBlock(void *ptr, memblock_t **tracked)
         }
     }
 
-    unlockZone();
+    unlockArena(arena);
 }
 
 void Z_Free(void *ptr)
@@ -402,11 +546,13 @@ static dd_bool isVolumeTooFull(memvolume_t *vol)
  * The static rovers should be rewound back near the beginning of the volume
  * periodically in order for them to be effective. Currently this is done
  * whenever tag ranges are purged (e.g., before map changes).
+ *
+ * @param arena  Arena whose volumes to rewind. Must be locked.
  */
-static void rewindStaticRovers(void)
+static void rewindStaticRovers(memarena_t *arena)
 {
     memvolume_t *volume;
-    for (volume = volumeRoot; volume; volume = volume->next)
+    for (volume = arena->volumeRoot; volume; volume = volume->arenaNext)
     {
         memblock_t *block;
         for (block = volume->zone->blockList.next;
@@ -442,24 +588,16 @@ static void splitFreeBlock(memblock_t *block, size_t size)
     block->size = size;
 }
 
-void *Z_Malloc(size_t size, int tag, void *user)
+/**
+ * Allocates a block of memory from the volumes of an arena.
+ *
+ * @param arena  Arena to allocate from. Must be locked.
+ */
+static void *allocFromArena(memarena_t *arena, size_t size, int tag, void *user)
 {
     memblock_t *start, *iter;
     memvolume_t *volume;
 
-    if (tag < PU_APPSTATIC || tag > PU_PURGELEVEL)
-    {
-        App_Log(DE2_LOG_WARNING, "Z_Malloc: Invalid purgelevel %i, cannot allocate memory.", tag);
-        return NULL;
-    }
-    if (!size)
-    {
-        // You can't allocate "nothing."
-        return NULL;
-    }
-
-    lockZone();
-
     // Align to pointer size.
     size = ALIGNED(size);
 
@@ -468,7 +606,7 @@ void *Z_Malloc(size_t size, int tag, void *user)
 
     // Iterate through memory volumes until we can find one with enough free
     // memory. (Note: we *will *find one that's large enough.)
-    for (volume = volumeRoot; ; volume = volume->next)
+    for (volume = arena->volumeRoot; ; volume = volume->arenaNext)
     {
         uint numChecked = 0;
         dd_bool gotoNextVolume = false;
@@ -477,12 +615,13 @@ void *Z_Malloc(size_t size, int tag, void *user)
         {
             // We've run out of volumes.  Let's allocate a new one
             // with enough memory.
-            size_t newVolumeSize = MEMORY_VOLUME_SIZE;
+            size_t newVolumeSize = (arena == &arenas[0]? MEMORY_VOLUME_SIZE
+                                                        : MEMORY_ARENA_VOLUME_SIZE);
 
             if (newVolumeSize < size + 0x1000)
                 newVolumeSize = size + 0x1000; // with some spare memory
 
-            volume = createVolume(newVolumeSize);
+            volume = createVolume(arena, newVolumeSize);
         }
 
         if (isVolumeTooFull(volume))
@@ -632,12 +771,11 @@ void *Z_Malloc(size_t size, int tag, void *user)
 
         // Keep tabs on how much memory is used.
         volume->allocatedBytes += iter->size;
+        arena->tagBytes[tag] += iter->size;
 
         iter->volume = volume;
         iter->id = LIBDENG_ZONEID;
 
-        unlockZone();
-
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
         return iter->area;
 #else
@@ -646,13 +784,33 @@ void *Z_Malloc(size_t size, int tag, void *user)
     }
 }
 
+void *Z_Malloc(size_t size, int tag, void *user)
+{
+    memarena_t *arena;
+    void *ptr;
+
+    if (tag < PU_APPSTATIC || tag > PU_PURGELEVEL)
+    {
+        App_Log(DE2_LOG_WARNING, "Z_Malloc: Invalid purgelevel %i, cannot allocate memory.", tag);
+        return NULL;
+    }
+    if (!size)
+    {
+        // You can't allocate "nothing."
+        return NULL;
+    }
+
+    arena = lockArenaForAllocation();
+    ptr = allocFromArena(arena, size, tag, user);
+    unlockArena(arena);
+    return ptr;
+}
+
 void *Z_Realloc(void *ptr, size_t n, int mallocTag)
 {
     int     tag = ptr ? Z_GetTag(ptr) : mallocTag;
     void   *p;
 
-    lockZone();
-
     n = ALIGNED(n);
     p = Z_Malloc(n, tag, 0);    // User always 0;
 
@@ -660,8 +818,11 @@ void *Z_Realloc(void *ptr, size_t n, int mallocTag)
     {
         size_t bsize;
 
-        // Has old data; copy it.
+        // Has old data; copy it. The old block's arena is kept locked so that
+        // the block cannot be purged during the copy.
         memblock_t *block = Z_GetBlock(ptr);
+        memarena_t *arena = blockArena(block);
+        lockArena(arena);
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
         bsize = block->areaSize;
 #else
@@ -669,9 +830,9 @@ void *Z_Realloc(void *ptr, size_t n, int mallocTag)
 #endif
         memcpy(p, ptr, MIN_OF(n, bsize));
         Z_Free(ptr);
+        unlockArena(arena);
     }
 
-    unlockZone();
     return p;
 }
 
@@ -679,171 +840,199 @@ void Z_FreeTags(int lowTag, int highTag)
 {
     memvolume_t *volume;
     memblock_t *block, *next;
+    int i;
 
     App_Log(DE2_LOG_DEBUG,
             "MemoryZone: Freeing all blocks in tag range:[%i, %i)",
             lowTag, highTag+1);
 
-    for (volume = volumeRoot; volume; volume = volume->next)
+    for (i = 0; i < MEMORY_ARENA_COUNT; ++i)
     {
-        for (block = volume->zone->blockList.next;
-            block != &volume->zone->blockList;
-            block = next)
-        {
-            next = block->next;
+        memarena_t *arena = &arenas[i];
 
-            if (block->user) // An allocated block?
+        lockArena(arena);
+        for (volume = arena->volumeRoot; volume; volume = volume->arenaNext)
+        {
+            for (block = volume->zone->blockList.next;
+                block != &volume->zone->blockList;
+                block = next)
             {
-                if (block->tag >= lowTag && block->tag <= highTag)
+                next = block->next;
+
+                if (block->user) // An allocated block?
+                {
+                    if (block->tag >= lowTag && block->tag <= highTag)
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
-                    Z_Free(block->area);
+                        Z_Free(block->area);
 #else
-                    Z_Free((byte *) block + sizeof(memblock_t));
+                        Z_Free((byte *) block + sizeof(memblock_t));
 #endif
+                }
             }
         }
-    }
 
-    // Now that there's plenty of new free space, let's keep the static
-    // rover near the beginning of the volume.
-    rewindStaticRovers();
+        // Now that there's plenty of new free space, let's keep the static
+        // rover near the beginning of the volume.
+        rewindStaticRovers(arena);
+        unlockArena(arena);
+    }
 }
 
-void Z_CheckHeap(void)
+/**
+ * Checks the consistency of a volume. The volume's arena must be locked.
+ */
+static void checkVolume(memvolume_t *volume)
 {
-    memvolume_t *volume;
     memblock_t *block;
     dd_bool     isDone;
+    size_t total = 0;
 
-    App_Log(DE2_LOG_TRACE, "Z_CheckHeap");
-
-    lockZone();
-
-    for (volume = volumeRoot; volume; volume = volume->next)
+    // Validate the counter.
+    if (allocatedMemoryInVolume(volume) != volume->allocatedBytes)
     {
-        size_t total = 0;
-
-        // Validate the counter.
-        if (allocatedMemoryInVolume(volume) != volume->allocatedBytes)
-        {
-            App_Log(DE2_LOG_CRITICAL,
-                "Z_CheckHeap: allocated bytes counter is off (counter:%u != actual:%u)",
-                volume->allocatedBytes, allocatedMemoryInVolume(volume));
-            App_FatalError("Z_CheckHeap: zone book-keeping is wrong");
-        }
+        App_Log(DE2_LOG_CRITICAL,
+            "Z_CheckHeap: allocated bytes counter is off (counter:%u != actual:%u)",
+            volume->allocatedBytes, allocatedMemoryInVolume(volume));
+        App_FatalError("Z_CheckHeap: zone book-keeping is wrong");
+    }
 
-        // Does the memory in the blocks sum up to the total volume size?
-        for (block = volume->zone->blockList.next;
-            block != &volume->zone->blockList; block = block->next)
-        {
-            total += block->size;
-        }
-        if (total != volume->size - sizeof(memzone_t))
-        {
-            App_Log(DE2_LOG_CRITICAL,
-                    "Z_CheckHeap: invalid total size of blocks (%u != %u)",
-                    total, volume->size - sizeof(memzone_t));
-            App_FatalError("Z_CheckHeap: zone book-keeping is wrong");
-        }
+    // Does the memory in the blocks sum up to the total volume size?
+    for (block = volume->zone->blockList.next;
+        block != &volume->zone->blockList; block = block->next)
+    {
+        total += block->size;
+    }
+    if (total != volume->size - sizeof(memzone_t))
+    {
+        App_Log(DE2_LOG_CRITICAL,
+                "Z_CheckHeap: invalid total size of blocks (%u != %u)",
+                total, volume->size - sizeof(memzone_t));
+        App_FatalError("Z_CheckHeap: zone book-keeping is wrong");
+    }
 
-        // Does the last block extend all the way to the end?
-        block = volume->zone->blockList.prev;
-        if ((byte *)block - ((byte *)volume->zone + sizeof(memzone_t)) + block->size != volume->size - sizeof(memzone_t))
-        {
-            App_Log(DE2_LOG_CRITICAL,
-                    "Z_CheckHeap: last block does not cover the end (%u != %u)",
-                     (byte *)block - ((byte *)volume->zone + sizeof(memzone_t)) + block->size,
-                     volume->size - sizeof(memzone_t));
-            App_FatalError("Z_CheckHeap: zone is corrupted");
-        }
+    // Does the last block extend all the way to the end?
+    block = volume->zone->blockList.prev;
+    if ((byte *)block - ((byte *)volume->zone + sizeof(memzone_t)) + block->size != volume->size - sizeof(memzone_t))
+    {
+        App_Log(DE2_LOG_CRITICAL,
+                "Z_CheckHeap: last block does not cover the end (%u != %u)",
+                 (byte *)block - ((byte *)volume->zone + sizeof(memzone_t)) + block->size,
+                 volume->size - sizeof(memzone_t));
+        App_FatalError("Z_CheckHeap: zone is corrupted");
+    }
 
-        block = volume->zone->blockList.next;
-        isDone = false;
+    block = volume->zone->blockList.next;
+    isDone = false;
 
-        while (!isDone)
+    while (!isDone)
+    {
+        if (block->next != &volume->zone->blockList)
         {
-            if (block->next != &volume->zone->blockList)
+            if (block->size == 0)
+                App_FatalError("Z_CheckHeap: zero-size block");
+            if ((byte *) block + block->size != (byte *) block->next)
+                App_FatalError("Z_CheckHeap: block size does not touch the "
+                          "next block");
+            if (block->next->prev != block)
+                App_FatalError("Z_CheckHeap: next block doesn't have proper "
+                          "back link");
+            if (!block->user && !block->next->user)
+                App_FatalError("Z_CheckHeap: two consecutive free blocks");
+            if (block->user == (void **) -1)
             {
-                if (block->size == 0)
-                    App_FatalError("Z_CheckHeap: zero-size block");
-                if ((byte *) block + block->size != (byte *) block->next)
-                    App_FatalError("Z_CheckHeap: block size does not touch the "
-                              "next block");
-                if (block->next->prev != block)
-                    App_FatalError("Z_CheckHeap: next block doesn't have proper "
-                              "back link");
-                if (!block->user && !block->next->user)
-                    App_FatalError("Z_CheckHeap: two consecutive free blocks");
-                if (block->user == (void **) -1)
-                {
-                    DENG_ASSERT(block->user != (void **) -1);
-                    App_FatalError("Z_CheckHeap: bad user pointer");
-                }
+                DENG_ASSERT(block->user != (void **) -1);
+                App_FatalError("Z_CheckHeap: bad user pointer");
+            }
 
-                /*
-                if (block->seqFirst == block)
+            /*
+            if (block->seqFirst == block)
+            {
+                // This is the first.
+                printf("sequence begins at (%p): start=%p, end=%p\n", block,
+                       block->seqFirst, block->seqLast);
+            }
+             */
+            if (block->seqFirst)
+            {
+                //printf("  seq member (%p): start=%p\n", block, block->seqFirst);
+                if (block->seqFirst->seqLast == block)
                 {
-                    // This is the first.
-                    printf("sequence begins at (%p): start=%p, end=%p\n", block,
-                           block->seqFirst, block->seqLast);
+                    //printf("  -=- last member of seq %p -=-\n", block->seqFirst);
                 }
-                 */
-                if (block->seqFirst)
+                else
                 {
-                    //printf("  seq member (%p): start=%p\n", block, block->seqFirst);
-                    if (block->seqFirst->seqLast == block)
+                    if (block->next->seqFirst != block->seqFirst)
                     {
-                        //printf("  -=- last member of seq %p -=-\n", block->seqFirst);
-                    }
-                    else
-                    {
-                        if (block->next->seqFirst != block->seqFirst)
-                        {
-                            App_FatalError("Z_CheckHeap: disconnected sequence");
-                        }
+                        App_FatalError("Z_CheckHeap: disconnected sequence");
                     }
                 }
-
-                block = block->next;
             }
-            else
-                isDone = true; // all blocks have been hit
+
+            block = block->next;
         }
+        else
+            isDone = true; // all blocks have been hit
     }
+}
 
-    unlockZone();
+void Z_CheckHeap(void)
+{
+    memvolume_t *volume;
+    int i;
+
+    App_Log(DE2_LOG_TRACE, "Z_CheckHeap");
+
+    for (i = 0; i < MEMORY_ARENA_COUNT; ++i)
+    {
+        lockArena(&arenas[i]);
+        for (volume = arenas[i].volumeRoot; volume; volume = volume->arenaNext)
+        {
+            checkVolume(volume);
+        }
+        unlockArena(&arenas[i]);
+    }
 }
 
 void Z_ChangeTag2(void *ptr, int tag)
 {
-    lockZone();
-    {
-        memblock_t *block = Z_GetBlock(ptr);
+    memblock_t *block = Z_GetBlock(ptr);
+    memarena_t *arena = blockArena(block);
 
+    lockArena(arena);
+    {
         DENG_ASSERT(block->id == LIBDENG_ZONEID);
 
-        if (tag >= PU_PURGELEVEL && PTR2INT(block->user) < 0x100)
+        if (tag < PU_APPSTATIC || tag > PU_PURGELEVEL)
+        {
+            App_Log(DE2_LOG_ERROR,
+                "Z_ChangeTag: Invalid purgelevel %i.", tag);
+        }
+        else if (tag >= PU_PURGELEVEL && PTR2INT(block->user) < 0x100)
         {
             App_Log(DE2_LOG_ERROR,
                 "Z_ChangeTag: An owner is required for purgable blocks.");
         }
         else
         {
+            arena->tagBytes[block->tag] -= block->size;
+            arena->tagBytes[tag]        += block->size;
             block->tag = tag;
         }
     }
-    unlockZone();
+    unlockArena(arena);
 }
 
 void Z_ChangeUser(void *ptr, void *newUser)
 {
-    lockZone();
+    memblock_t *block = Z_GetBlock(ptr);
+    memarena_t *arena = blockArena(block);
+
+    lockArena(arena);
     {
-        memblock_t *block = Z_GetBlock(ptr);
         DENG_ASSERT(block->id == LIBDENG_ZONEID);
         block->user = newUser;
     }
-    unlockZone();
+    unlockArena(arena);
 }
 
 uint Z_GetId(void *ptr)
@@ -881,14 +1070,17 @@ dd_bool Z_Contains(void *ptr)
         return false;
     }
     // Check which volume is it.
+    lockZone();
     for (volume = volumeRoot; volume; volume = volume->next)
     {
         if ((char *)ptr > (char *)volume->zone && (char *)ptr < (char *)volume->zone + volume->size)
         {
             // There it is.
+            unlockZone();
             return true;
         }
     }
+    unlockZone();
     return false;
 }
 
@@ -903,17 +1095,18 @@ void *Z_Calloc(size_t size, int tag, void *user)
 void *Z_Recalloc(void *ptr, size_t n, int callocTag)
 {
     memblock_t     *block;
+    memarena_t     *arena;
     void           *p;
     size_t          bsize;
 
-    lockZone();
-
     n = ALIGNED(n);
 
     if (ptr)                     // Has old data.
     {
         p = Z_Malloc(n, Z_GetTag(ptr), NULL);
         block = Z_GetBlock(ptr);
+        arena = blockArena(block);
+        lockArena(arena); // The old block must not be purged during the copy.
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
         bsize = block->areaSize;
 #else
@@ -930,14 +1123,13 @@ void *Z_Recalloc(void *ptr, size_t n, int callocTag)
             memcpy(p, ptr, n);
         }
         Z_Free(ptr);
+        unlockArena(arena);
     }
     else
     {   // Totally new allocation.
         p = Z_Calloc(n, callocTag, NULL);
     }
 
-    unlockZone();
-
     return p;
 }
 
@@ -991,61 +1183,98 @@ static size_t allocatedMemoryInVolume(memvolume_t *volume)
 }
 
 /**
- * Calculate the size of allocated memory blocks in all volumes combined.
+ * Calculate the amount of unused memory in all volumes combined.
  */
-static size_t Z_AllocatedMemory(void)
+size_t Z_FreeMemory(void)
 {
-    memvolume_t *volume;
-    size_t total = 0;
-
-    lockZone();
+    MemoryZoneStats stats;
 
-    for (volume = volumeRoot; volume; volume = volume->next)
-    {
-        total += allocatedMemoryInVolume(volume);
-    }
-
-    unlockZone();
-    return total;
+    Z_CheckHeap();
+    Z_GetStats(&stats);
+    return stats.freeBytes;
 }
 
-/**
- * Calculate the amount of unused memory in all volumes combined.
- */
-size_t Z_FreeMemory(void)
+void Z_GetStats(MemoryZoneStats *stats)
 {
-    memvolume_t    *volume;
-    memblock_t     *block;
-    size_t          free = 0;
+    memvolume_t *volume;
+    memblock_t *block;
+    int i, tag;
 
-    lockZone();
+    DENG_ASSERT(stats);
+    memset(stats, 0, sizeof(*stats));
+    stats->arenaCount = MEMORY_ARENA_COUNT;
 
-    Z_CheckHeap();
-    for (volume = volumeRoot; volume; volume = volume->next)
+    for (i = 0; i < MEMORY_ARENA_COUNT; ++i)
     {
-        for (block = volume->zone->blockList.next;
-            block != &volume->zone->blockList;
-            block = block->next)
+        memarena_t *arena = &arenas[i];
+
+        lockArena(arena);
+        for (volume = arena->volumeRoot; volume; volume = volume->arenaNext)
         {
-            if (!block->user)
+            stats->volumeCount++;
+            stats->totalBytes += volume->size;
+            stats->allocatedBytes += volume->allocatedBytes;
+
+            for (block = volume->zone->blockList.next;
+                !isRootBlock(volume, block); block = block->next)
             {
-                free += block->size;
+                if (isFreeBlock(block))
+                {
+                    stats->freeBytes += block->size;
+                    stats->freeBlockCount++;
+                    stats->largestFreeBlock = MAX_OF(stats->largestFreeBlock, block->size);
+                }
             }
         }
+        for (tag = 0; tag <= PU_PURGELEVEL; ++tag)
+        {
+            stats->tagBytes[tag] += arena->tagBytes[tag];
+        }
+        stats->lockContentions += arena->contentionCount;
+        stats->lockWaitSeconds += arena->lockWaitMicros / 1.0e6;
+        unlockArena(arena);
     }
-
-    unlockZone();
-    return free;
 }
 
 void Z_PrintStatus(void)
 {
-    size_t allocated = Z_AllocatedMemory();
-    size_t wasted    = Z_FreeMemory();
+    MemoryZoneStats stats;
+    size_t otherBytes;
+    int tag;
+
+    Z_GetStats(&stats);
 
     App_Log(DE2_LOG_DEBUG,
             "Memory zone status: %u volumes, %u bytes allocated, %u bytes free (%f%% in use)",
-            Z_VolumeCount(), (uint)allocated, (uint)wasted, (float)allocated/(float)(allocated+wasted)*100.f);
+            stats.volumeCount, (uint)stats.allocatedBytes, (uint)stats.freeBytes,
+            (float)stats.allocatedBytes/(float)(stats.allocatedBytes + stats.freeBytes)*100.f);
+
+    // Breakdown by purge level.
+    otherBytes = 0;
+    for (tag = 0; tag <= PU_PURGELEVEL; ++tag)
+    {
+        if (tag != PU_APPSTATIC && tag != PU_GAMESTATIC && tag != PU_MAP &&
+            tag != PU_MAPSTATIC && tag != PU_PURGELEVEL)
+        {
+            otherBytes += stats.tagBytes[tag];
+        }
+    }
+    App_Log(DE2_LOG_DEBUG,
+            "  Purge levels: %u bytes APPSTATIC, %u GAMESTATIC, %u MAP, %u MAPSTATIC, "
+            "%u PURGELEVEL, %u other",
+            (uint)stats.tagBytes[PU_APPSTATIC], (uint)stats.tagBytes[PU_GAMESTATIC],
+            (uint)stats.tagBytes[PU_MAP], (uint)stats.tagBytes[PU_MAPSTATIC],
+            (uint)stats.tagBytes[PU_PURGELEVEL], (uint)otherBytes);
+
+    // Fragmentation: how much of the free memory is not in the largest free block.
+    App_Log(DE2_LOG_DEBUG,
+            "  Free memory: %u blocks, largest %u bytes (%.1f%% fragmented)",
+            stats.freeBlockCount, (uint)stats.largestFreeBlock,
+            stats.freeBytes? (1.f - (float)stats.largestFreeBlock/(float)stats.freeBytes)*100.f : 0.f);
+
+    App_Log(DE2_LOG_DEBUG,
+            "  Arena locks: %u arenas, waited %u times for a total of %.3f seconds",
+            stats.arenaCount, stats.lockContentions, stats.lockWaitSeconds);
 }
 
 void Garbage_Trash(void *ptr)
@@ -1053,22 +1282,41 @@ void Garbage_Trash(void *ptr)
     Garbage_TrashInstance(ptr, Z_Contains(ptr)? Z_Free : free);
 }
 
+/**
+ * Returns the arena that owns the memory of a block set. All the memory of the
+ * set is allocated from the same arena, so locking it protects the entire set.
+ */
+static memarena_t *blockSetArena(zblockset_t *set)
+{
+    return blockArena(Z_GetBlock(set));
+}
+
 /**
  * Allocate a new block of memory to be used for linear object allocations.
  * A "zblock" (its from the zone).
  *
- * @param set   Block set into which the new block is added.
+ * @param set   Block set into which the new block is added. The set's arena
+ *              must be locked.
  */
 static void addBlockToSet(zblockset_t *set)
 {
     assert(set);
     {
+    memarena_t *arena = blockSetArena(set);
     zblockset_block_t *block = 0;
+    zblockset_block_t *oldBlocks = set->_blocks;
 
     // Get a new block by resizing the blocks array. This is done relatively
     // seldom, since there is a large number of elements per each block.
     set->_blockCount++;
-    set->_blocks = Z_Recalloc(set->_blocks, sizeof(zblockset_block_t) * set->_blockCount, set->_tag);
+    set->_blocks = allocFromArena(arena, sizeof(zblockset_block_t) * set->_blockCount,
+                                  set->_tag, NULL);
+    memset(set->_blocks, 0, sizeof(zblockset_block_t) * set->_blockCount);
+    if (oldBlocks)
+    {
+        memcpy(set->_blocks, oldBlocks, sizeof(zblockset_block_t) * (set->_blockCount - 1));
+        Z_Free(oldBlocks);
+    }
 
     App_Log(DE2_LOG_DEBUG,
             "addBlockToSet: set=%p blockCount=%u elemSize=%u elemCount=%u (total=%u)",
@@ -1079,7 +1327,7 @@ static void addBlockToSet(zblockset_t *set)
     block = &set->_blocks[set->_blockCount - 1];
     block->max = set->_elementsPerBlock;
     block->elementSize = set->_elementSize;
-    block->elements = Z_Malloc(block->elementSize * block->max, set->_tag, NULL);
+    block->elements = allocFromArena(arena, block->elementSize * block->max, set->_tag, NULL);
     block->count = 0;
     }
 }
@@ -1088,9 +1336,11 @@ void *ZBlockSet_Allocate(zblockset_t *set)
 {
     zblockset_block_t *block = 0;
     void *element = 0;
+    memarena_t *arena;
 
     assert(set);
-    lockZone();
+    arena = blockSetArena(set);
+    lockArena(arena);
 
     block = &set->_blocks[set->_blockCount - 1];
 
@@ -1111,13 +1361,14 @@ void *ZBlockSet_Allocate(zblockset_t *set)
         addBlockToSet(set);
     }
 
-    unlockZone();
+    unlockArena(arena);
     return element;
 }
 
 zblockset_t *ZBlockSet_New(size_t sizeOfElement, uint32_t batchSize, int tag)
 {
     zblockset_t *set;
+    memarena_t *arena;
 
     DENG_ASSERT(sizeOfElement > 0);
     DENG_ASSERT(batchSize > 0);
@@ -1129,15 +1380,21 @@ zblockset_t *ZBlockSet_New(size_t sizeOfElement, uint32_t batchSize, int tag)
     set->_tag = tag;
 
     // Allocate the first block right away.
+    arena = blockSetArena(set);
+    lockArena(arena);
     addBlockToSet(set);
+    unlockArena(arena);
 
     return set;
 }
 
 void ZBlockSet_Delete(zblockset_t *set)
 {
-    lockZone();
+    memarena_t *arena;
+
     assert(set);
+    arena = blockSetArena(set);
+    lockArena(arena);
 
     // Free the elements from each block.
     { uint i;
@@ -1147,7 +1404,7 @@ void ZBlockSet_Delete(zblockset_t *set)
 
     Z_Free(set->_blocks);
     Z_Free(set);
-    unlockZone();
+    unlockArena(arena);
 }
 
 #ifdef DENG_DEBUG
@@ -1155,8 +1412,8 @@ void Z_GetPrivateData(MemoryZonePrivateData *pd)
 {
     pd->volumeCount     = Z_VolumeCount();
     pd->volumeRoot      = volumeRoot;
-    pd->lock            = lockZone;
-    pd->unlock          = unlockZone;
+    pd->lock            = lockAll;
+    pd->unlock          = unlockAll;
     pd->isVolumeTooFull = isVolumeTooFull;
 }
 #endif
@@ -32,6 +32,7 @@
 #define LIBDENG_MEMORY_ZONE_PRIVATE_H
 
 #include <de/liblegacy.h>
+#include <de/concurrency.h>
 #include <de/memoryzone.h> // public API
 
 #ifdef __cplusplus
@@ -73,15 +74,31 @@ typedef struct {
 
 /**
  * The memory is composed of multiple volumes. New volumes are allocated when
- * necessary.
+ * necessary. Each volume belongs to one of the allocation arenas.
  */
 typedef struct memvolume_s {
     memzone_t *zone;
     size_t size;
     size_t allocatedBytes;  ///< Total number of allocated bytes.
-    struct memvolume_s *next;
+    struct memarena_s *arena;
+    struct memvolume_s *next;       ///< Next volume in the zone.
+    struct memvolume_s *arenaNext;  ///< Next volume in the same arena.
 } memvolume_t;
 
+/**
+ * Allocation arena. Threads allocate memory from the volumes of their own arena,
+ * so they don't need to contend for a single lock. A block may be freed in any
+ * thread; the arena that owns the block is locked while doing so.
+ */
+typedef struct memarena_s {
+    mutex_t mutex;
+    memvolume_t *volumeRoot;
+    memvolume_t *volumeLast;
+    size_t tagBytes[PU_PURGELEVEL + 1]; ///< Allocated bytes per purge level.
+    uint contentionCount;               ///< Times a thread had to wait for the lock.
+    uint64_t lockWaitMicros;            ///< Total time spent waiting for the lock.
+} memarena_t;
+
 struct zblockset_block_s;
 
 /**
@@ -118,7 +135,7 @@ memblock_t *Z_GetBlock(void *ptr);
  * This is only needed for debugging purposes.
  */
 struct memzone_private_s {
-    void (*lock)(void);
+    void (*lock)(void);     ///< Locks all the arenas.
     void (*unlock)(void);
     dd_bool (*isVolumeTooFull)(memvolume_t *);
     int volumeCount;
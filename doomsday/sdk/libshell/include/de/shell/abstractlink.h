@@ -90,6 +90,26 @@ public:
      */
     Time connectedAt() const;
 
+    /**
+     * Sets the preset dictionary used for deflating messages sent over the link.
+     * The dictionary must have been agreed on with the peer.
+     *
+     * @param dictionary  Preset deflate dictionary. Empty to not use a dictionary.
+     *
+     * @see Socket::setDeflateDictionary()
+     */
+    void setDeflateDictionary(Block const &dictionary);
+
+    /**
+     * Sets the preset dictionary available for inflating messages received over
+     * the link.
+     *
+     * @param dictionary  Preset deflate dictionary. Empty to not use a dictionary.
+     *
+     * @see Socket::setInflateDictionary()
+     */
+    void setInflateDictionary(Block const &dictionary);
+
     /**
      * Returns the next received packet. The packet has been interpreted
      * using the virtual interpret() method.
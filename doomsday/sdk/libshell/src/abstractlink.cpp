@@ -148,6 +148,16 @@ Time AbstractLink::connectedAt() const
     return d->connectedAt;
 }
 
+void AbstractLink::setDeflateDictionary(Block const &dictionary)
+{
+    if (d->socket) d->socket->setDeflateDictionary(dictionary);
+}
+
+void AbstractLink::setInflateDictionary(Block const &dictionary)
+{
+    if (d->socket) d->socket->setInflateDictionary(dictionary);
+}
+
 Packet *AbstractLink::nextPacket()
 {
     if (!d->socket->hasIncoming()) return 0;
@@ -135,6 +135,32 @@ int main(int argc, char **argv)
 
         FS::copySerialized(updated.path(), "home/copied.zip");
         LOG_MSG("Normal copy: ") << App::rootFolder().locate<File const>("home/copied.zip").description();
+
+        // Large entries are compressed in several chunks.
+        {
+            Block large;
+            for (int i = 0; i < 1000000; ++i)
+            {
+                large.append(char((i * 7) ^ (i >> 10)));
+            }
+            ZipArchive chunked;
+            chunked.add(Path("large.bin"), large);
+            chunked.add(Path("small.txt"), content.toUtf8());
+            Block serialized;
+            Writer(serialized) << chunked;
+
+            ZipArchive readBack(serialized);
+            dsize const prefetched = readBack.prefetch(QList<Path>() << Path("large.bin")
+                                                                     << Path("small.txt")
+                                                                     << Path("missing.txt"),
+                                                       2 * large.size());
+            DENG2_ASSERT(prefetched == large.size() + content.toUtf8().size());
+            DENG2_UNUSED(prefetched);
+            DENG2_ASSERT(readBack.entryBlock(Path("large.bin")) == large);
+            DENG2_ASSERT(readBack.entryBlock(Path("small.txt")) == content.toUtf8());
+            LOG_MSG("Chunked entry: %i bytes compressed to an archive of %i bytes")
+                    << large.size() << serialized.size();
+        }
     }
     catch (Error const &err)
     {
@@ -0,0 +1,198 @@
+/**
+ * @file main.cpp
+ *
+ * Huffman codec tests and benchmark. @ingroup tests
+ *
+ * The codec is compared against its previous implementation (oldhuffman.cpp):
+ * the coded output must be identical, and the throughput of both is reported.
+ *
+ * The optional argument is a file of captured packets, each preceded by its
+ * size as a 32-bit little-endian integer. Without it, packets resembling game
+ * deltas are generated.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "oldhuffman.h"
+
+#include <de/data/huffman.h>
+#include <de/Time>
+#include <QDebug>
+#include <QFile>
+#include <QList>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace de;
+
+static int failures = 0;
+
+static void check(bool condition, char const *what)
+{
+    if (!condition)
+    {
+        qWarning() << "FAILED:" << what;
+        failures++;
+    }
+}
+
+static QList<Block> readCorpus(char const *fileName)
+{
+    QList<Block> packets;
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+    {
+        throw Error("readCorpus", String("Cannot open ") + fileName);
+    }
+    Block const data = file.readAll();
+    dbyte const *bytes = data.data();
+    for (dsize pos = 0; pos + 4 <= data.size(); )
+    {
+        duint32 const size = duint32(bytes[pos])
+                           | duint32(bytes[pos + 1]) << 8
+                           | duint32(bytes[pos + 2]) << 16
+                           | duint32(bytes[pos + 3]) << 24;
+        pos += 4;
+        if (pos + size > data.size()) break;
+        packets << Block(bytes + pos, size);
+        pos += size;
+    }
+    return packets;
+}
+
+static QList<Block> generateCorpus()
+{
+    QList<Block> packets;
+    std::srand(1);
+    for (int i = 0; i < 10000; ++i)
+    {
+        // Mostly zeroes, like the delta packets the codec was tuned with.
+        Block packet(i < 300? i : std::rand() % 1400);
+        for (dsize k = 0; k < packet.size(); ++k)
+        {
+            packet.data()[k] = (std::rand() % 3 == 0? dbyte(std::rand()) : 0);
+        }
+        packets << packet;
+    }
+    return packets;
+}
+
+struct Timing
+{
+    TimeSpan encode;
+    TimeSpan decode;
+};
+
+/**
+ * Codes all the packets with the given codec, checking that each packet is decoded
+ * back to the original.
+ */
+template <typename Encoder, typename Decoder>
+static Timing benchmark(QList<Block> const &packets, QList<Block> &coded,
+                        Encoder encode, Decoder decode)
+{
+    Timing timing;
+    coded.clear();
+
+    Time startedAt;
+    for (Block const &packet : packets)
+    {
+        coded << encode(packet);
+    }
+    timing.encode = startedAt.since();
+
+    QList<Block> decoded;
+    startedAt = Time();
+    for (Block const &c : coded)
+    {
+        decoded << decode(c);
+    }
+    timing.decode = startedAt.since();
+
+    check(decoded == packets, "decoded packets match the originals");
+    return timing;
+}
+
+static double megabytesPerSecond(dsize bytes, TimeSpan span)
+{
+    return bytes / 1.0e6 / de::max(1.0e-6, double(span));
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        // Coded data must stay the same, as it is sent over the network.
+        {
+            struct { char const *plain; int plainSize; char const *coded; int codedSize; }
+            const known[] = {
+                { "\x00\x00\x00\x00", 4, "\xfa\x07", 2 },
+                { "Doomsday", 8, "\x2d\x42\x84\xc4\x72\xcd\x9f\x28\x18", 9 },
+                { "\x12\x00\x08\x00\xff\x01", 6, "\xc0\xd3\x19\xf9\x00", 5 },
+            };
+            for (auto const &k : known)
+            {
+                Block const plain(k.plain, k.plainSize);
+                Block const coded(k.coded, k.codedSize);
+                check(codec::huffmanEncode(plain) == coded, "known vector is encoded");
+                check(codec::huffmanDecode(coded) == plain, "known vector is decoded");
+                check(oldcodec::huffmanEncode(plain) == coded, "known vector matches old encoder");
+            }
+            check(codec::huffmanDecode(Block()).isEmpty(), "empty input is decoded as empty");
+        }
+
+        QList<Block> const packets = (argc > 1? readCorpus(argv[1]) : generateCorpus());
+        dsize plainBytes = 0;
+        for (Block const &packet : packets) plainBytes += packet.size();
+
+        QList<Block> oldCoded;
+        QList<Block> newCoded;
+        Timing const oldTiming = benchmark(packets, oldCoded,
+                                           oldcodec::huffmanEncode, oldcodec::huffmanDecode);
+        Timing const newTiming = benchmark(packets, newCoded,
+                                           codec::huffmanEncode, codec::huffmanDecode);
+
+        // The new codec must be a drop-in replacement for the old one.
+        check(oldCoded == newCoded, "old and new encoders produce identical output");
+
+        dsize codedBytes = 0;
+        for (Block const &c : newCoded) codedBytes += c.size();
+
+        std::printf("%i packets, %u bytes coded to %u bytes\n",
+                    packets.size(), unsigned(plainBytes), unsigned(codedBytes));
+        std::printf("Encoding: old %8.2f MB/s, new %8.2f MB/s (%.2fx)\n",
+                    megabytesPerSecond(plainBytes, oldTiming.encode),
+                    megabytesPerSecond(plainBytes, newTiming.encode),
+                    double(oldTiming.encode) / de::max(1.0e-9, double(newTiming.encode)));
+        std::printf("Decoding: old %8.2f MB/s, new %8.2f MB/s (%.2fx)\n",
+                    megabytesPerSecond(plainBytes, oldTiming.decode),
+                    megabytesPerSecond(plainBytes, newTiming.decode),
+                    double(oldTiming.decode) / de::max(1.0e-9, double(newTiming.decode)));
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        failures++;
+    }
+
+    if (failures)
+    {
+        std::printf("%i checks failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
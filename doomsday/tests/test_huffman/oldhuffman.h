@@ -0,0 +1,38 @@
+/**
+ * @file oldhuffman.h
+ * Previous implementation of the Huffman codec. @ingroup tests
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef TEST_HUFFMAN_OLDHUFFMAN_H
+#define TEST_HUFFMAN_OLDHUFFMAN_H
+
+#include <de/Block>
+
+namespace de {
+namespace oldcodec {
+
+/// Encodes @a data with the previous bit-by-bit encoder.
+Block huffmanEncode(Block const &data);
+
+/// Decodes @a codedData with the previous tree-walking decoder.
+Block huffmanDecode(Block const &codedData);
+
+} // namespace oldcodec
+} // namespace de
+
+#endif // TEST_HUFFMAN_OLDHUFFMAN_H
@@ -77,6 +77,17 @@ int main(int argc, char **argv)
         LOG_MSG("Copied:\n") << copied;
 
         LOG_MSG("...and as JSON:\n") << composeJSON(copied).constData();
+
+        // Adding and removing members changes the membership version.
+        duint32 const version = rec.membershipVersion();
+        rec["size"].set(NumberValue(2048));
+        DENG2_ASSERT(rec.membershipVersion() == version);
+        rec.add(new Variable("extra"));
+        DENG2_ASSERT(rec.membershipVersion() != version);
+        duint32 const versionAfterAdd = rec.membershipVersion();
+        delete rec.remove("extra");
+        DENG2_ASSERT(rec.membershipVersion() != versionAfterAdd);
+        DENG2_ASSERT(rec.uniqueId() != copied.uniqueId());
     }
     catch (Error const &err)
     {
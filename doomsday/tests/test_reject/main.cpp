@@ -0,0 +1,100 @@
+/**
+ * @file main.cpp
+ *
+ * Sector reject LUT unit tests. @ingroup tests
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "world/reject.h"
+
+#include <QDebug>
+
+using namespace de;
+using namespace world;
+
+static int failures = 0;
+
+static void check(bool condition, char const *what)
+{
+    if (!condition)
+    {
+        qWarning() << "FAILED:" << what;
+        failures++;
+    }
+}
+
+int main(int, char **)
+{
+    try
+    {
+        // Two 64x64 sectors side by side: sector 0 is at x = [0, 64] and sector 1
+        // at x = [64, 128]. The portals face the sector on their left side.
+        Reject::Portal const toRight{ Vector2d(64, 64), Vector2d(64, 0), 0, 1, 1 };
+        Reject::Portal const toLeft { Vector2d(64, 0), Vector2d(64, 64), 1, 0, 0 };
+
+        // Separated by a solid wall, i.e., there is no portal between the sectors.
+        {
+            Reject const reject = Reject::build(2, Reject::Portals());
+            check(reject.sectorCount() == 2, "LUT covers all sectors");
+            check(reject.isRejected(0, 1), "solid wall blocks sight from the first sector");
+            check(reject.isRejected(1, 0), "solid wall blocks sight from the second sector");
+            check(!reject.isRejected(0, 0) && !reject.isRejected(1, 1),
+                  "sectors can see themselves");
+        }
+
+        // Connected by a two-sided line.
+        {
+            Reject const reject = Reject::build(2, Reject::Portals{ toRight, toLeft });
+            check(reject.sectorCount() == 2, "LUT covers all sectors");
+            check(!reject.isRejected(0, 1), "first sector sees through the two-sided line");
+            check(!reject.isRejected(1, 0), "second sector sees through the two-sided line");
+        }
+
+        // Sight that only passes one way is allowed both ways.
+        {
+            Reject::Portal oneWay = toRight;
+            oneWay.twin = -1;
+            Reject const reject = Reject::build(2, Reject::Portals{ oneWay });
+            check(!reject.isRejected(0, 1) && !reject.isRejected(1, 0),
+                  "lines of sight work both ways");
+        }
+
+        // REJECT lump of the original map format (rows are not padded).
+        {
+            // Bits 2 (sector 0 to 2) and 7 (sector 2 to 1) are set. The lump is
+            // truncated: the bit for sector 2 to 2 is missing.
+            Block const lump(QByteArray(1, char(0x84)));
+            Reject const reject = Reject::fromLump(lump, 3);
+            check(reject.sectorCount() == 3, "LUT covers all sectors");
+            check(reject.isRejected(0, 2), "lump rejects sector 0 to 2");
+            check(reject.isRejected(2, 1), "lump rejects sector 2 to 1");
+            check(!reject.isRejected(2, 0) && !reject.isRejected(0, 1),
+                  "lump does not reject cleared bits");
+            check(!reject.isRejected(2, 2), "truncated lump does not reject missing bits");
+            check(Reject::fromLump(Block(), 3).isEmpty(), "empty lump rejects nothing");
+        }
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        failures++;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return failures? 1 : 0;
+}
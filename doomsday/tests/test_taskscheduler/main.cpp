@@ -0,0 +1,151 @@
+/**
+ * @file main.cpp
+ *
+ * TaskScheduler unit tests. @ingroup tests
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/TaskScheduler>
+#include <de/TaskPool>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace de;
+
+static int failures = 0;
+
+static void check(bool condition, char const *what)
+{
+    if (!condition)
+    {
+        qWarning() << "FAILED:" << what;
+        failures++;
+    }
+}
+
+/// Set while the thread is waiting for a group (see the unrelated tasks test).
+static thread_local bool waitingForGroup = false;
+
+int main(int, char **)
+{
+    try
+    {
+        qDebug() << "Worker threads:" << TaskScheduler::get().workerCount();
+
+        // Every index is visited exactly once.
+        {
+            std::vector<int> visits(100000);
+            parallelFor(visits.size(), [&visits] (dsize start, dsize end)
+            {
+                for (dsize i = start; i < end; ++i) visits[i]++;
+            });
+            check(std::all_of(visits.begin(), visits.end(), [] (int v) { return v == 1; }),
+                  "parallelFor visits every index once");
+        }
+
+        // Groups started from inside other groups' tasks.
+        {
+            std::atomic<int> count { 0 };
+            TaskGroup outer;
+            for (int i = 0; i < 16; ++i)
+            {
+                outer.run([&count] ()
+                {
+                    TaskGroup inner;
+                    for (int j = 0; j < 16; ++j)
+                    {
+                        inner.run([&count] () { count++; });
+                    }
+                    inner.wait();
+                });
+            }
+            outer.wait();
+            check(count == 16 * 16, "nested group tasks are all run");
+            qDebug() << "Nested group tasks run:" << count;
+        }
+
+        // Pools waiting for other pools inside their tasks.
+        {
+            std::atomic<int> count { 0 };
+            TaskPool pool;
+            for (int i = 0; i < 64; ++i)
+            {
+                pool.start([&count] ()
+                {
+                    TaskPool sub;
+                    sub.start([&count] () { count++; });
+                    sub.waitForDone();
+                });
+            }
+            pool.waitForDone();
+            check(pool.isDone(), "pool is done");
+            check(count == 64, "nested pool tasks are all run");
+        }
+
+        // Waiting for a group in a worker does not run unrelated tasks.
+        {
+            std::atomic<int> reentered { 0 };
+            TaskGroup outer;
+            for (int i = 0; i < 16; ++i)
+            {
+                outer.run([&reentered] ()
+                {
+                    TaskGroup unrelated;
+                    unrelated.run([&reentered] ()
+                    {
+                        if (waitingForGroup) reentered++;
+                    });
+                    TaskGroup own;
+                    own.run([] () {});
+                    waitingForGroup = true;
+                    own.wait();
+                    waitingForGroup = false;
+                    unrelated.wait();
+                });
+            }
+            outer.wait();
+            check(reentered == 0, "waiting does not run unrelated tasks");
+        }
+
+        // Exceptions are passed to the caller of parallelFor.
+        {
+            bool caught = false;
+            try
+            {
+                parallelFor(1000, [] (dsize start, dsize) {
+                    if (start == 0) throw Error("test", "Failure in the first chunk");
+                }, 10);
+            }
+            catch (Error const &)
+            {
+                caught = true;
+            }
+            check(caught, "parallelFor rethrows exceptions");
+        }
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        failures++;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return failures? 1 : 0;
+}
@@ -0,0 +1,269 @@
+/** @file main.cpp  Network deflate dictionary builder.
+ *
+ * Builds a preset deflate dictionary for network messages from a capture of frame
+ * packets. A capture can be made by starting the server with the option
+ * "-capturedeltas <file>"; it contains the packets one after another, each preceded
+ * by its size as a 32-bit little-endian integer.
+ *
+ * The dictionary is composed of the segments of packet data that are common to the
+ * largest number of packets. The captured packets are split into epochs, and the
+ * best segment of each epoch is chosen based on the byte sequences (k-mers) it
+ * contains that have not yet been covered by previously chosen segments. Deflate
+ * prefers matches at short distances, so the most useful segments are placed at
+ * the end of the dictionary.
+ *
+ * The resulting file should be placed in net.dengine.base as "netdeltas.dict".
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/Block>
+#include <QFile>
+#include <QList>
+#include <QTextStream>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace de;
+
+/// Length of the byte sequences whose frequencies are counted.
+static int const KMER_SIZE = 6;
+
+/// Deflate only uses the last 32 KB of a dictionary.
+static int const MAX_DICTIONARY_SIZE = 32768;
+
+/// Level used for compressing network messages (see de::Socket).
+static int const DEFLATE_LEVEL = 1;
+
+static QTextStream out(stdout);
+
+struct Segment
+{
+    Block data;
+    duint64 score;
+};
+
+static duint64 kmerAt(Block::Byte const *pos)
+{
+    duint64 kmer = 0;
+    for (int i = 0; i < KMER_SIZE; ++i)
+    {
+        kmer = (kmer << 8) | pos[i];
+    }
+    return kmer;
+}
+
+static QList<Block> readCapture(QString const &fileName)
+{
+    QList<Block> packets;
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+    {
+        out << "Cannot open " << fileName << "\n";
+        return packets;
+    }
+    Block const data = file.readAll();
+    Block::Byte const *bytes = data.data();
+    for (dsize pos = 0; pos + 4 <= data.size(); )
+    {
+        duint32 const size = duint32(bytes[pos])
+                           | duint32(bytes[pos + 1]) << 8
+                           | duint32(bytes[pos + 2]) << 16
+                           | duint32(bytes[pos + 3]) << 24;
+        pos += 4;
+        if (pos + size > data.size()) break;
+        packets << Block(bytes + pos, size);
+        pos += size;
+    }
+    return packets;
+}
+
+/**
+ * Counts the number of packets where each k-mer appears.
+ */
+static std::unordered_map<duint64, duint64> countKmers(QList<Block> const &packets)
+{
+    std::unordered_map<duint64, duint64> freqs;
+    std::unordered_set<duint64> seen;
+    for (Block const &packet : packets)
+    {
+        seen.clear();
+        for (dsize i = 0; i + KMER_SIZE <= packet.size(); ++i)
+        {
+            duint64 const kmer = kmerAt(packet.data() + i);
+            if (seen.insert(kmer).second)
+            {
+                freqs[kmer]++;
+            }
+        }
+    }
+    return freqs;
+}
+
+/**
+ * Finds the segment of the packets that has the highest total frequency of distinct
+ * k-mers. The packets are scanned with a sliding window.
+ */
+static Segment bestSegment(QList<Block> const &packets, int begin, int end, int segmentSize,
+                           std::unordered_map<duint64, duint64> const &freqs)
+{
+    Segment best { Block(), 0 };
+    std::unordered_map<duint64, int> active; // k-mers in the window
+
+    for (int p = begin; p < end; ++p)
+    {
+        Block const &packet = packets.at(p);
+        if (int(packet.size()) < KMER_SIZE) continue;
+
+        int const kmerCount = int(packet.size()) - KMER_SIZE + 1;
+        int const window    = std::min(segmentSize - KMER_SIZE + 1, kmerCount);
+        duint64 score = 0;
+        active.clear();
+
+        auto addKmer = [&] (int i) {
+            duint64 const kmer = kmerAt(packet.data() + i);
+            if (active[kmer]++ == 0)
+            {
+                auto found = freqs.find(kmer);
+                if (found != freqs.end()) score += found->second;
+            }
+        };
+        auto removeKmer = [&] (int i) {
+            duint64 const kmer = kmerAt(packet.data() + i);
+            if (--active[kmer] == 0)
+            {
+                auto found = freqs.find(kmer);
+                if (found != freqs.end()) score -= found->second;
+            }
+        };
+
+        for (int i = 0; i < window; ++i) addKmer(i);
+        for (int start = 0; ; ++start)
+        {
+            if (score > best.score)
+            {
+                best.score = score;
+                best.data  = Block(packet.mid(start, window + KMER_SIZE - 1));
+            }
+            if (start + window >= kmerCount) break;
+            removeKmer(start);
+            addKmer(start + window);
+        }
+    }
+    return best;
+}
+
+static Block buildDictionary(QList<Block> const &packets, int dictSize, int segmentSize)
+{
+    auto freqs = countKmers(packets);
+
+    // Only sequences shared by several packets are useful in the dictionary.
+    for (auto &kmer : freqs)
+    {
+        if (kmer.second < 2) kmer.second = 0;
+    }
+
+    int const epochCount = std::max(1, std::min(packets.size(), dictSize / segmentSize));
+    std::vector<Segment> segments;
+    for (int epoch = 0; epoch < epochCount; ++epoch)
+    {
+        int const begin = epoch * packets.size() / epochCount;
+        int const end   = (epoch + 1) * packets.size() / epochCount;
+
+        Segment seg = bestSegment(packets, begin, end, segmentSize, freqs);
+        if (!seg.score) continue;
+
+        // The chosen k-mers are now covered by the dictionary.
+        for (dsize i = 0; i + KMER_SIZE <= seg.data.size(); ++i)
+        {
+            freqs[kmerAt(seg.data.data() + i)] = 0;
+        }
+        segments.push_back(seg);
+    }
+
+    // The best segments go last, where they are closest to the compressed data.
+    std::stable_sort(segments.begin(), segments.end(), [] (Segment const &a, Segment const &b) {
+        return a.score < b.score;
+    });
+
+    Block dict;
+    for (Segment const &seg : segments) dict += seg.data;
+    if (int(dict.size()) > dictSize)
+    {
+        dict.remove(0, int(dict.size()) - dictSize);
+    }
+    return dict;
+}
+
+static dsize compressedSize(QList<Block> const &packets, Block const &dictionary)
+{
+    dsize total = 0;
+    for (Block const &packet : packets)
+    {
+        total += packet.compressed(DEFLATE_LEVEL, dictionary).size();
+    }
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        out << "Usage: netdict <capture> <output> [size] [segment]\n"
+               "  capture  Frame packets captured with the server option -capturedeltas.\n"
+               "  output   Dictionary file to write.\n"
+               "  size     Maximum size of the dictionary in bytes (default: 16384).\n"
+               "  segment  Size of the segments picked from the packets (default: 64).\n";
+        return 1;
+    }
+
+    int const dictSize    = std::min(argc > 3? atoi(argv[3]) : 16384, MAX_DICTIONARY_SIZE);
+    int const segmentSize = std::max(argc > 4? atoi(argv[4]) : 64, KMER_SIZE);
+
+    QList<Block> const packets = readCapture(argv[1]);
+    if (packets.isEmpty())
+    {
+        out << "No packets found in " << argv[1] << "\n";
+        return 1;
+    }
+
+    dsize totalSize = 0;
+    for (Block const &packet : packets) totalSize += packet.size();
+    out << packets.size() << " packets, " << totalSize << " bytes\n";
+
+    Block const dictionary = buildDictionary(packets, dictSize, segmentSize);
+
+    QFile file(argv[2]);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        out << "Cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    file.write(dictionary);
+    file.close();
+    out << "Wrote a dictionary of " << dictionary.size() << " bytes to " << argv[2] << "\n";
+
+    // Compare against deflating the packets without a dictionary.
+    dsize const plain = compressedSize(packets, Block());
+    dsize const withDict = compressedSize(packets, dictionary);
+    out << "Deflated without dictionary: " << plain << " bytes\n"
+        << "Deflated with dictionary:    " << withDict << " bytes ("
+        << QString::number(100.0 * withDict / std::max(dsize(1), plain), 'f', 1) << "%)\n";
+    return 0;
+}